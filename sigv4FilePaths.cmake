@@ -13,3 +13,20 @@ set( SIGV4_SOURCES
 # SigV4 library public include directories.
 set( SIGV4_INCLUDE_PUBLIC_DIRS
      "${CMAKE_CURRENT_LIST_DIR}/source/include" )
+
+# Optional crypto adapter source files, which implement the crypto interface of
+# the library on a SHA-256 implementation. Only the adapter used by an
+# application needs to be built; the OpenSSL and mbedTLS adapters also need
+# those libraries.
+set( SIGV4_CRYPTO_SHA256_SOURCES
+     "${CMAKE_CURRENT_LIST_DIR}/source/crypto/sigv4_crypto_sha256.c" )
+
+set( SIGV4_CRYPTO_OPENSSL_SOURCES
+     "${CMAKE_CURRENT_LIST_DIR}/source/crypto/sigv4_crypto_openssl.c" )
+
+set( SIGV4_CRYPTO_MBEDTLS_SOURCES
+     "${CMAKE_CURRENT_LIST_DIR}/source/crypto/sigv4_crypto_mbedtls.c" )
+
+# Crypto adapter public include directories.
+set( SIGV4_CRYPTO_INCLUDE_PUBLIC_DIRS
+     "${CMAKE_CURRENT_LIST_DIR}/source/crypto/include" )
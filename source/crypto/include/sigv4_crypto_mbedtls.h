@@ -0,0 +1,95 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_mbedtls.h
+ * @brief #SigV4CryptoInterface_t implementation on mbedTLS.
+ *
+ * Hashes use the SHA-256 module, so an accelerated implementation selected
+ * with MBEDTLS_SHA256_ALT is used as well. HMACs go through the native HMAC
+ * interfaces of #SigV4CryptoInterface_t and the mbedTLS message digest module.
+ */
+
+#ifndef SIGV4_CRYPTO_MBEDTLS_H_
+#define SIGV4_CRYPTO_MBEDTLS_H_
+
+/* mbedTLS includes. */
+#include "mbedtls/md.h"
+#include "mbedtls/sha256.h"
+
+/* Include the SigV4 interface. */
+#include "sigv4.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The mbedTLS contexts used by the mbedTLS adapter.
+ *
+ * @note The members are internal to the adapter; the application only
+ * provides the memory for them.
+ */
+typedef struct SigV4MbedTLSContext
+{
+    mbedtls_sha256_context sha256Context; /**< @brief The context reused for each hash. */
+    mbedtls_md_context_t hmacContext;     /**< @brief The context reused for each HMAC. */
+} SigV4MbedTLSContext_t;
+
+/**
+ * @brief Fill a crypto interface with the mbedTLS SHA-256 and HMAC-SHA256
+ * implementation.
+ *
+ * @param[out] pCryptoInterface The crypto interface to fill.
+ * @param[out] pContext The mbedTLS contexts used by @p pCryptoInterface, to be
+ * released with #SigV4_MbedTLSCryptoCleanup. It must not be used by another
+ * crypto interface at the same time.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if an argument
+ * is NULL, or #SigV4HashError if mbedTLS fails to set up the HMAC context.
+ */
+/* @[declare_sigV4_mbedTLSCryptoInit_function] */
+SigV4Status_t SigV4_MbedTLSCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                       SigV4MbedTLSContext_t * pContext );
+/* @[declare_sigV4_mbedTLSCryptoInit_function] */
+
+/**
+ * @brief Release the mbedTLS contexts of the mbedTLS adapter.
+ *
+ * @param[in] pContext The mbedTLS contexts to release. NULL is ignored.
+ */
+/* @[declare_sigV4_mbedTLSCryptoCleanup_function] */
+void SigV4_MbedTLSCryptoCleanup( SigV4MbedTLSContext_t * pContext );
+/* @[declare_sigV4_mbedTLSCryptoCleanup_function] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SIGV4_CRYPTO_MBEDTLS_H_ */
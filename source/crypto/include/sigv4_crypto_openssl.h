@@ -0,0 +1,198 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_openssl.h
+ * @brief #SigV4CryptoInterface_t implementation on the OpenSSL 3 EVP
+ * interfaces.
+ *
+ * The digest and MAC algorithms are fetched once and the EVP contexts are
+ * allocated once, when the adapter is initialized, and then reused for every
+ * hash and HMAC. HMACs go through the native HMAC interfaces of
+ * #SigV4CryptoInterface_t.
+ *
+ * The adapter also provides a #SigV4EcdsaInterface_t for SigV4A, which keeps
+ * the imported key pair and a signing context ready between requests.
+ */
+
+#ifndef SIGV4_CRYPTO_OPENSSL_H_
+#define SIGV4_CRYPTO_OPENSSL_H_
+
+/* OpenSSL includes. */
+#include <openssl/evp.h>
+
+/* Include the SigV4 interface. */
+#include "sigv4.h"
+
+#if OPENSSL_VERSION_NUMBER < 0x30000000L
+    #error "The SigV4 OpenSSL crypto adapter requires OpenSSL 3.0 or later."
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The OpenSSL objects used by the OpenSSL adapter.
+ *
+ * @note The members are internal to the adapter; the application only
+ * provides the memory for them.
+ */
+typedef struct SigV4OpenSSLContext
+{
+    EVP_MD * pDigest;             /**< @brief The fetched SHA-256 implementation. */
+    EVP_MD_CTX * pDigestContext;  /**< @brief The context reused for each hash. */
+    EVP_MAC * pMac;               /**< @brief The fetched HMAC implementation. */
+    EVP_MAC_CTX * pMacContext;    /**< @brief The context reused for each HMAC. */
+} SigV4OpenSSLContext_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The OpenSSL objects used by the ECDSA interface of the OpenSSL
+ * adapter.
+ *
+ * @note The members are internal to the adapter; the application only
+ * provides the memory for them.
+ */
+typedef struct SigV4OpenSSLEcdsaContext
+{
+    EVP_PKEY * pKey;             /**< @brief The imported key pair, NULL until a key is imported. */
+    EVP_PKEY_CTX * pSignContext; /**< @brief The context reused for each signature. */
+} SigV4OpenSSLEcdsaContext_t;
+
+/**
+ * @brief Fill a crypto interface with the OpenSSL SHA-256 and HMAC-SHA256
+ * implementation.
+ *
+ * @param[out] pCryptoInterface The crypto interface to fill.
+ * @param[out] pContext The OpenSSL objects used by @p pCryptoInterface, to
+ * be released with #SigV4_OpenSSLCryptoCleanup. It must not be used by another
+ * crypto interface at the same time.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if an argument
+ * is NULL, or #SigV4HashError if OpenSSL fails to provide the algorithms.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * SigV4OpenSSLContext_t opensslContext;
+ * SigV4CryptoInterface_t cryptoInterface;
+ *
+ * if( SigV4_OpenSSLCryptoInit( &cryptoInterface, &opensslContext ) == SigV4Success )
+ * {
+ *     params.pCryptoInterface = &cryptoInterface;
+ *     // Sign any number of requests.
+ *     SigV4_OpenSSLCryptoCleanup( &opensslContext );
+ * }
+ * @endcode
+ */
+/* @[declare_sigV4_openSSLCryptoInit_function] */
+SigV4Status_t SigV4_OpenSSLCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                       SigV4OpenSSLContext_t * pContext );
+/* @[declare_sigV4_openSSLCryptoInit_function] */
+
+/**
+ * @brief Fill a crypto interface with a duplicate of the OpenSSL objects of
+ * another one, e.g. for another thread.
+ *
+ * The algorithms are shared with @p pOriginal instead of being fetched again,
+ * and the contexts are copies of those of @p pOriginal.
+ *
+ * @param[out] pCryptoInterface The crypto interface to fill.
+ * @param[out] pContext The duplicate OpenSSL objects, to be released with
+ * #SigV4_OpenSSLCryptoCleanup.
+ * @param[in] pOriginal The OpenSSL objects to duplicate, initialized by
+ * #SigV4_OpenSSLCryptoInit or #SigV4_OpenSSLCryptoDuplicate.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if an argument
+ * is NULL, or #SigV4HashError if OpenSSL fails to copy the contexts.
+ */
+/* @[declare_sigV4_openSSLCryptoDuplicate_function] */
+SigV4Status_t SigV4_OpenSSLCryptoDuplicate( SigV4CryptoInterface_t * pCryptoInterface,
+                                            SigV4OpenSSLContext_t * pContext,
+                                            const SigV4OpenSSLContext_t * pOriginal );
+/* @[declare_sigV4_openSSLCryptoDuplicate_function] */
+
+/**
+ * @brief Release the OpenSSL objects of the OpenSSL adapter.
+ *
+ * @param[in] pContext The OpenSSL objects to release. NULL is ignored.
+ */
+/* @[declare_sigV4_openSSLCryptoCleanup_function] */
+void SigV4_OpenSSLCryptoCleanup( SigV4OpenSSLContext_t * pContext );
+/* @[declare_sigV4_openSSLCryptoCleanup_function] */
+
+/**
+ * @brief Fill an ECDSA interface with the OpenSSL ECDSA P-256 implementation.
+ *
+ * The key pair is created when the library imports a key, including its
+ * public point, and a signing context is prepared for it, so that signing a
+ * request is a single OpenSSL call.
+ *
+ * @param[out] pEcdsaInterface The ECDSA interface to fill.
+ * @param[out] pContext The OpenSSL objects used by @p pEcdsaInterface, to be
+ * released with #SigV4_OpenSSLEcdsaCleanup.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if an argument
+ * is NULL.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * SigV4OpenSSLEcdsaContext_t ecdsaContext;
+ * SigV4EcdsaInterface_t ecdsaInterface;
+ * SigV4EcdsaKeyCache_t ecdsaKeyCache = { 0 };
+ *
+ * ( void ) SigV4_OpenSSLEcdsaInit( &ecdsaInterface, &ecdsaContext );
+ * params.pAlgorithm = SIGV4_AWS4_ECDSA_P256_SHA256;
+ * params.algorithmLen = SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH;
+ * params.pEcdsaInterface = &ecdsaInterface;
+ * params.pEcdsaKeyCache = &ecdsaKeyCache;
+ * // Sign any number of requests.
+ * SigV4_OpenSSLEcdsaCleanup( &ecdsaContext );
+ * @endcode
+ */
+/* @[declare_sigV4_openSSLEcdsaInit_function] */
+SigV4Status_t SigV4_OpenSSLEcdsaInit( SigV4EcdsaInterface_t * pEcdsaInterface,
+                                      SigV4OpenSSLEcdsaContext_t * pContext );
+/* @[declare_sigV4_openSSLEcdsaInit_function] */
+
+/**
+ * @brief Release the OpenSSL objects of the ECDSA interface of the OpenSSL
+ * adapter.
+ *
+ * @param[in] pContext The OpenSSL objects to release. NULL is ignored.
+ */
+/* @[declare_sigV4_openSSLEcdsaCleanup_function] */
+void SigV4_OpenSSLEcdsaCleanup( SigV4OpenSSLEcdsaContext_t * pContext );
+/* @[declare_sigV4_openSSLEcdsaCleanup_function] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SIGV4_CRYPTO_OPENSSL_H_ */
@@ -0,0 +1,109 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_sha256.h
+ * @brief Portable SHA-256 implementation of #SigV4CryptoInterface_t.
+ *
+ * The implementation has no dependencies besides the standard C library, so it
+ * can be used on platforms without a crypto library and serves as the baseline
+ * that the other crypto adapters are measured against.
+ */
+
+#ifndef SIGV4_CRYPTO_SHA256_H_
+#define SIGV4_CRYPTO_SHA256_H_
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Include the SigV4 interface. */
+#include "sigv4.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * @ingroup sigv4_constants
+ * @brief The block length of SHA-256 in bytes.
+ */
+#define SIGV4_SHA256_BLOCK_LENGTH     64U
+
+/**
+ * @ingroup sigv4_constants
+ * @brief The digest length of SHA-256 in bytes.
+ */
+#define SIGV4_SHA256_DIGEST_LENGTH    32U
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The state of a SHA-256 calculation of the portable adapter.
+ *
+ * @note The members are internal to the adapter; the application only
+ * provides the memory for them.
+ */
+typedef struct SigV4Sha256Context
+{
+    uint32_t state[ 8 ];                           /**< @brief The intermediate hash value. */
+    uint32_t bitCountLow;                          /**< @brief The low 32 bits of the number of hashed bits. */
+    uint32_t bitCountHigh;                         /**< @brief The high 32 bits of the number of hashed bits. */
+    uint8_t block[ SIGV4_SHA256_BLOCK_LENGTH ];    /**< @brief The input that does not fill a block yet. */
+    size_t blockLen;                               /**< @brief The number of bytes in block. */
+} SigV4Sha256Context_t;
+
+/**
+ * @brief Fill a crypto interface with the portable SHA-256 implementation.
+ *
+ * @param[out] pCryptoInterface The crypto interface to fill. The optional
+ * members are cleared.
+ * @param[in] pContext The hash context used by @p pCryptoInterface. It must
+ * not be used by another crypto interface at the same time.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if an argument
+ * is NULL.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * SigV4Sha256Context_t sha256Context;
+ * SigV4CryptoInterface_t cryptoInterface;
+ *
+ * ( void ) SigV4_Sha256CryptoInit( &cryptoInterface, &sha256Context );
+ * params.pCryptoInterface = &cryptoInterface;
+ * @endcode
+ */
+/* @[declare_sigV4_sha256CryptoInit_function] */
+SigV4Status_t SigV4_Sha256CryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                      SigV4Sha256Context_t * pContext );
+/* @[declare_sigV4_sha256CryptoInit_function] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SIGV4_CRYPTO_SHA256_H_ */
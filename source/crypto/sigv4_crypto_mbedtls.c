@@ -0,0 +1,269 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_mbedtls.c
+ * @brief #SigV4CryptoInterface_t implementation on mbedTLS 2.x and 3.x.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+
+/* mbedTLS includes. */
+#include "mbedtls/version.h"
+
+#include "sigv4_crypto_mbedtls.h"
+
+/**
+ * @brief The block length of SHA-256 in bytes.
+ */
+#define MBEDTLS_SHA256_BLOCK_LENGTH     64U
+
+/**
+ * @brief The digest length of SHA-256 in bytes.
+ */
+#define MBEDTLS_SHA256_DIGEST_LENGTH    32U
+
+/* mbedTLS 3 dropped the _ret suffix of the SHA-256 functions that return a
+ * status. */
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+    #define mbedtls_sha256_starts    mbedtls_sha256_starts_ret
+    #define mbedtls_sha256_update    mbedtls_sha256_update_ret
+    #define mbedtls_sha256_finish    mbedtls_sha256_finish_ret
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashInit.
+ *
+ * @param[in] pHashContext The #SigV4MbedTLSContext_t.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHashInit( void * pHashContext );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashUpdate.
+ *
+ * @param[in] pHashContext The #SigV4MbedTLSContext_t.
+ * @param[in] pInput Buffer holding the data to hash.
+ * @param[in] inputLen Length of @p pInput.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHashUpdate( void * pHashContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashFinal.
+ *
+ * @param[in] pHashContext The #SigV4MbedTLSContext_t.
+ * @param[out] pOutput The buffer for the digest.
+ * @param[in] outputLen Length of @p pOutput.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHashFinal( void * pHashContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacInit.
+ *
+ * @param[in] pHmacContext The #SigV4MbedTLSContext_t.
+ * @param[in] pKey The HMAC key.
+ * @param[in] keyLen Length of @p pKey.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHmacInit( void * pHmacContext,
+                                const uint8_t * pKey,
+                                size_t keyLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacUpdate.
+ *
+ * @param[in] pHmacContext The #SigV4MbedTLSContext_t.
+ * @param[in] pInput Buffer holding the data to authenticate.
+ * @param[in] inputLen Length of @p pInput.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHmacUpdate( void * pHmacContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacFinal.
+ *
+ * @param[in] pHmacContext The #SigV4MbedTLSContext_t.
+ * @param[out] pOutput The buffer for the HMAC.
+ * @param[in] outputLen Length of @p pOutput.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t mbedtlsHmacFinal( void * pHmacContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen );
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHashInit( void * pHashContext )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHashContext;
+
+    assert( pContext != NULL );
+
+    return ( int32_t ) mbedtls_sha256_starts( &pContext->sha256Context, 0 /* Not SHA-224. */ );
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHashUpdate( void * pHashContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHashContext;
+
+    assert( pContext != NULL );
+
+    return ( int32_t ) mbedtls_sha256_update( &pContext->sha256Context, pInput, inputLen );
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHashFinal( void * pHashContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHashContext;
+    int32_t returnStatus = -1;
+
+    assert( pContext != NULL );
+
+    if( outputLen >= MBEDTLS_SHA256_DIGEST_LENGTH )
+    {
+        returnStatus = ( int32_t ) mbedtls_sha256_finish( &pContext->sha256Context, pOutput );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHmacInit( void * pHmacContext,
+                                const uint8_t * pKey,
+                                size_t keyLen )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHmacContext;
+
+    assert( pContext != NULL );
+
+    return ( int32_t ) mbedtls_md_hmac_starts( &pContext->hmacContext, pKey, keyLen );
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHmacUpdate( void * pHmacContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHmacContext;
+
+    assert( pContext != NULL );
+
+    return ( int32_t ) mbedtls_md_hmac_update( &pContext->hmacContext, pInput, inputLen );
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t mbedtlsHmacFinal( void * pHmacContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen )
+{
+    SigV4MbedTLSContext_t * pContext = ( SigV4MbedTLSContext_t * ) pHmacContext;
+    int32_t returnStatus = -1;
+
+    assert( pContext != NULL );
+
+    if( outputLen >= MBEDTLS_SHA256_DIGEST_LENGTH )
+    {
+        returnStatus = ( int32_t ) mbedtls_md_hmac_finish( &pContext->hmacContext, pOutput );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_MbedTLSCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                       SigV4MbedTLSContext_t * pContext )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+
+    if( ( pCryptoInterface == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface and pContext must not be NULL." ) );
+    }
+    else
+    {
+        mbedtls_sha256_init( &pContext->sha256Context );
+        mbedtls_md_init( &pContext->hmacContext );
+
+        if( mbedtls_md_setup( &pContext->hmacContext,
+                              mbedtls_md_info_from_type( MBEDTLS_MD_SHA256 ),
+                              1 /* Use HMAC. */ ) != 0 )
+        {
+            LogError( ( "Failed to set up the mbedTLS HMAC context of the crypto interface." ) );
+            SigV4_MbedTLSCryptoCleanup( pContext );
+            returnStatus = SigV4HashError;
+        }
+        else
+        {
+            ( void ) memset( pCryptoInterface, 0, sizeof( SigV4CryptoInterface_t ) );
+            pCryptoInterface->hashInit = mbedtlsHashInit;
+            pCryptoInterface->hashUpdate = mbedtlsHashUpdate;
+            pCryptoInterface->hashFinal = mbedtlsHashFinal;
+            pCryptoInterface->pHashContext = pContext;
+            pCryptoInterface->hashBlockLen = MBEDTLS_SHA256_BLOCK_LENGTH;
+            pCryptoInterface->hashDigestLen = MBEDTLS_SHA256_DIGEST_LENGTH;
+            pCryptoInterface->hmacInit = mbedtlsHmacInit;
+            pCryptoInterface->hmacUpdate = mbedtlsHmacUpdate;
+            pCryptoInterface->hmacFinal = mbedtlsHmacFinal;
+            pCryptoInterface->pHmacContext = pContext;
+            returnStatus = SigV4Success;
+        }
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+void SigV4_MbedTLSCryptoCleanup( SigV4MbedTLSContext_t * pContext )
+{
+    if( pContext != NULL )
+    {
+        mbedtls_md_free( &pContext->hmacContext );
+        mbedtls_sha256_free( &pContext->sha256Context );
+    }
+}
@@ -0,0 +1,576 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_openssl.c
+ * @brief #SigV4CryptoInterface_t implementation on the OpenSSL 3 EVP
+ * interfaces.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+
+/* OpenSSL includes. */
+#include <openssl/core_names.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <openssl/param_build.h>
+#include <openssl/params.h>
+
+#include "sigv4_crypto_openssl.h"
+
+/**
+ * @brief The name of the digest algorithm, as fetched from OpenSSL.
+ */
+#define OPENSSL_DIGEST_NAME    "SHA256"
+
+/**
+ * @brief The name of the MAC algorithm, as fetched from OpenSSL.
+ */
+#define OPENSSL_MAC_NAME       "HMAC"
+
+/**
+ * @brief The name of the key type of SigV4A keys, as created by OpenSSL.
+ */
+#define OPENSSL_EC_KEY_NAME    "EC"
+
+/**
+ * @brief The name of the curve of SigV4A keys.
+ */
+#define OPENSSL_EC_GROUP_NAME    "prime256v1"
+
+/**
+ * @brief The length of an uncompressed P-256 public point.
+ */
+#define OPENSSL_EC_PUBLIC_KEY_LENGTH    65U
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashInit.
+ *
+ * The digest context is reset and reused, which avoids allocating a context
+ * and looking up the algorithm for every hash.
+ *
+ * @param[in] pHashContext The #SigV4OpenSSLContext_t.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHashInit( void * pHashContext );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashUpdate.
+ *
+ * @param[in] pHashContext The #SigV4OpenSSLContext_t.
+ * @param[in] pInput Buffer holding the data to hash.
+ * @param[in] inputLen Length of @p pInput.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHashUpdate( void * pHashContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashFinal.
+ *
+ * @param[in] pHashContext The #SigV4OpenSSLContext_t.
+ * @param[out] pOutput The buffer for the digest.
+ * @param[in] outputLen Length of @p pOutput.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHashFinal( void * pHashContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacInit.
+ *
+ * @param[in] pHmacContext The #SigV4OpenSSLContext_t.
+ * @param[in] pKey The HMAC key.
+ * @param[in] keyLen Length of @p pKey.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHmacInit( void * pHmacContext,
+                                const uint8_t * pKey,
+                                size_t keyLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacUpdate.
+ *
+ * @param[in] pHmacContext The #SigV4OpenSSLContext_t.
+ * @param[in] pInput Buffer holding the data to authenticate.
+ * @param[in] inputLen Length of @p pInput.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHmacUpdate( void * pHmacContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hmacFinal.
+ *
+ * @param[in] pHmacContext The #SigV4OpenSSLContext_t.
+ * @param[out] pOutput The buffer for the HMAC.
+ * @param[in] outputLen Length of @p pOutput.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslHmacFinal( void * pHmacContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen );
+
+/**
+ * @brief Fill a crypto interface with the OpenSSL objects if all of them were
+ * created, or release them otherwise.
+ *
+ * @param[out] pCryptoInterface The crypto interface to fill.
+ * @param[in] pContext The OpenSSL objects.
+ * @param[in] created Whether all OpenSSL objects were created.
+ * @return #SigV4Success if @p created, #SigV4HashError otherwise.
+ */
+static SigV4Status_t completeCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                         SigV4OpenSSLContext_t * pContext,
+                                         bool created );
+
+/**
+ * @brief Compute the uncompressed public point of a P-256 private key.
+ *
+ * @param[in] pPrivateKey The private key.
+ * @param[out] pPublicKey The buffer of #OPENSSL_EC_PUBLIC_KEY_LENGTH bytes for
+ * the public point.
+ * @return true on success, false on failure.
+ */
+static bool computeEcdsaPublicKey( const BIGNUM * pPrivateKey,
+                                   uint8_t * pPublicKey );
+
+/**
+ * @brief Create a P-256 key pair from its private key and public point.
+ *
+ * @param[in] pPrivateKey The private key.
+ * @param[in] pPublicKey The uncompressed public point.
+ * @return The key pair, or NULL on failure.
+ */
+static EVP_PKEY * createEcdsaKeyPair( const BIGNUM * pPrivateKey,
+                                      const uint8_t * pPublicKey );
+
+/**
+ * @brief Implements #SigV4EcdsaInterface_t.loadKey.
+ *
+ * @param[in] pEcdsaContext The #SigV4OpenSSLEcdsaContext_t.
+ * @param[in] pPrivateKey The big-endian private key.
+ * @param[in] privateKeyLen Length of @p pPrivateKey.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslEcdsaLoadKey( void * pEcdsaContext,
+                                    const uint8_t * pPrivateKey,
+                                    size_t privateKeyLen );
+
+/**
+ * @brief Implements #SigV4EcdsaInterface_t.sign.
+ *
+ * @param[in] pEcdsaContext The #SigV4OpenSSLEcdsaContext_t.
+ * @param[in] pDigest The digest to sign.
+ * @param[in] digestLen Length of @p pDigest.
+ * @param[out] pSignature The buffer for the DER-encoded signature.
+ * @param[in, out] pSignatureLen Length of @p pSignature, then of the signature.
+ * @return Zero on success, -1 on failure.
+ */
+static int32_t opensslEcdsaSign( void * pEcdsaContext,
+                                 const uint8_t * pDigest,
+                                 size_t digestLen,
+                                 uint8_t * pSignature,
+                                 size_t * pSignatureLen );
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHashInit( void * pHashContext )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHashContext;
+
+    assert( pContext != NULL );
+
+    return ( EVP_DigestInit_ex2( pContext->pDigestContext, pContext->pDigest, NULL ) == 1 ) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHashUpdate( void * pHashContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHashContext;
+
+    assert( pContext != NULL );
+
+    return ( EVP_DigestUpdate( pContext->pDigestContext, pInput, inputLen ) == 1 ) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHashFinal( void * pHashContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHashContext;
+    int32_t returnStatus = -1;
+
+    assert( pContext != NULL );
+
+    if( ( outputLen >= ( size_t ) EVP_MD_get_size( pContext->pDigest ) ) &&
+        ( EVP_DigestFinal_ex( pContext->pDigestContext, pOutput, NULL ) == 1 ) )
+    {
+        returnStatus = 0;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHmacInit( void * pHmacContext,
+                                const uint8_t * pKey,
+                                size_t keyLen )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHmacContext;
+
+    assert( pContext != NULL );
+
+    return ( EVP_MAC_init( pContext->pMacContext, pKey, keyLen, NULL ) == 1 ) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHmacUpdate( void * pHmacContext,
+                                  const uint8_t * pInput,
+                                  size_t inputLen )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHmacContext;
+
+    assert( pContext != NULL );
+
+    return ( EVP_MAC_update( pContext->pMacContext, pInput, inputLen ) == 1 ) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslHmacFinal( void * pHmacContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen )
+{
+    const SigV4OpenSSLContext_t * pContext = ( const SigV4OpenSSLContext_t * ) pHmacContext;
+    size_t macLen = 0U;
+
+    assert( pContext != NULL );
+
+    return ( EVP_MAC_final( pContext->pMacContext, pOutput, &macLen, outputLen ) == 1 ) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t completeCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                         SigV4OpenSSLContext_t * pContext,
+                                         bool created )
+{
+    SigV4Status_t returnStatus = SigV4HashError;
+
+    if( created )
+    {
+        ( void ) memset( pCryptoInterface, 0, sizeof( SigV4CryptoInterface_t ) );
+        pCryptoInterface->hashInit = opensslHashInit;
+        pCryptoInterface->hashUpdate = opensslHashUpdate;
+        pCryptoInterface->hashFinal = opensslHashFinal;
+        pCryptoInterface->pHashContext = pContext;
+        pCryptoInterface->hashBlockLen = ( size_t ) EVP_MD_get_block_size( pContext->pDigest );
+        pCryptoInterface->hashDigestLen = ( size_t ) EVP_MD_get_size( pContext->pDigest );
+        pCryptoInterface->hmacInit = opensslHmacInit;
+        pCryptoInterface->hmacUpdate = opensslHmacUpdate;
+        pCryptoInterface->hmacFinal = opensslHmacFinal;
+        pCryptoInterface->pHmacContext = pContext;
+        returnStatus = SigV4Success;
+    }
+    else
+    {
+        LogError( ( "Failed to create the OpenSSL objects of the crypto interface." ) );
+        SigV4_OpenSSLCryptoCleanup( pContext );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_OpenSSLCryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                       SigV4OpenSSLContext_t * pContext )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+    OSSL_PARAM macParams[ 2 ];
+    bool created = false;
+
+    if( ( pCryptoInterface == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface and pContext must not be NULL." ) );
+    }
+    else
+    {
+        ( void ) memset( pContext, 0, sizeof( SigV4OpenSSLContext_t ) );
+        pContext->pDigest = EVP_MD_fetch( NULL, OPENSSL_DIGEST_NAME, NULL );
+        pContext->pDigestContext = EVP_MD_CTX_new();
+        pContext->pMac = EVP_MAC_fetch( NULL, OPENSSL_MAC_NAME, NULL );
+
+        if( pContext->pMac != NULL )
+        {
+            pContext->pMacContext = EVP_MAC_CTX_new( pContext->pMac );
+        }
+
+        /* The digest context is initialized once so that it can be
+         * duplicated before it hashes anything. */
+        macParams[ 0 ] = OSSL_PARAM_construct_utf8_string( OSSL_MAC_PARAM_DIGEST, OPENSSL_DIGEST_NAME, 0U );
+        macParams[ 1 ] = OSSL_PARAM_construct_end();
+        created = ( pContext->pDigest != NULL ) &&
+                  ( pContext->pDigestContext != NULL ) &&
+                  ( pContext->pMacContext != NULL ) &&
+                  ( EVP_DigestInit_ex2( pContext->pDigestContext, pContext->pDigest, NULL ) == 1 ) &&
+                  ( EVP_MAC_CTX_set_params( pContext->pMacContext, macParams ) == 1 );
+
+        returnStatus = completeCryptoInit( pCryptoInterface, pContext, created );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_OpenSSLCryptoDuplicate( SigV4CryptoInterface_t * pCryptoInterface,
+                                            SigV4OpenSSLContext_t * pContext,
+                                            const SigV4OpenSSLContext_t * pOriginal )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+    bool created = false;
+
+    if( ( pCryptoInterface == NULL ) || ( pContext == NULL ) || ( pOriginal == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface, pContext and pOriginal must not be NULL." ) );
+    }
+    else
+    {
+        ( void ) memset( pContext, 0, sizeof( SigV4OpenSSLContext_t ) );
+
+        if( EVP_MD_up_ref( pOriginal->pDigest ) == 1 )
+        {
+            pContext->pDigest = pOriginal->pDigest;
+        }
+
+        if( EVP_MAC_up_ref( pOriginal->pMac ) == 1 )
+        {
+            pContext->pMac = pOriginal->pMac;
+        }
+
+        pContext->pDigestContext = EVP_MD_CTX_new();
+        pContext->pMacContext = EVP_MAC_CTX_dup( pOriginal->pMacContext );
+        created = ( pContext->pDigest != NULL ) &&
+                  ( pContext->pMac != NULL ) &&
+                  ( pContext->pDigestContext != NULL ) &&
+                  ( pContext->pMacContext != NULL ) &&
+                  ( EVP_MD_CTX_copy_ex( pContext->pDigestContext, pOriginal->pDigestContext ) == 1 );
+
+        returnStatus = completeCryptoInit( pCryptoInterface, pContext, created );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+void SigV4_OpenSSLCryptoCleanup( SigV4OpenSSLContext_t * pContext )
+{
+    if( pContext != NULL )
+    {
+        EVP_MAC_CTX_free( pContext->pMacContext );
+        EVP_MAC_free( pContext->pMac );
+        EVP_MD_CTX_free( pContext->pDigestContext );
+        EVP_MD_free( pContext->pDigest );
+        ( void ) memset( pContext, 0, sizeof( SigV4OpenSSLContext_t ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool computeEcdsaPublicKey( const BIGNUM * pPrivateKey,
+                                   uint8_t * pPublicKey )
+{
+    EC_GROUP * pGroup = EC_GROUP_new_by_curve_name( NID_X9_62_prime256v1 );
+    EC_POINT * pPoint = NULL;
+    bool computed = false;
+
+    if( pGroup != NULL )
+    {
+        pPoint = EC_POINT_new( pGroup );
+    }
+
+    if( ( pPoint != NULL ) &&
+        ( EC_POINT_mul( pGroup, pPoint, pPrivateKey, NULL, NULL, NULL ) == 1 ) )
+    {
+        computed = EC_POINT_point2oct( pGroup, pPoint, POINT_CONVERSION_UNCOMPRESSED,
+                                       pPublicKey, OPENSSL_EC_PUBLIC_KEY_LENGTH, NULL ) == OPENSSL_EC_PUBLIC_KEY_LENGTH;
+    }
+
+    EC_POINT_free( pPoint );
+    EC_GROUP_free( pGroup );
+
+    return computed;
+}
+
+/*-----------------------------------------------------------*/
+
+static EVP_PKEY * createEcdsaKeyPair( const BIGNUM * pPrivateKey,
+                                      const uint8_t * pPublicKey )
+{
+    OSSL_PARAM_BLD * pBuilder = OSSL_PARAM_BLD_new();
+    OSSL_PARAM * pParams = NULL;
+    EVP_PKEY_CTX * pKeyContext = EVP_PKEY_CTX_new_from_name( NULL, OPENSSL_EC_KEY_NAME, NULL );
+    EVP_PKEY * pKey = NULL;
+
+    if( ( pBuilder != NULL ) &&
+        ( OSSL_PARAM_BLD_push_utf8_string( pBuilder, OSSL_PKEY_PARAM_GROUP_NAME, OPENSSL_EC_GROUP_NAME, 0U ) == 1 ) &&
+        ( OSSL_PARAM_BLD_push_BN( pBuilder, OSSL_PKEY_PARAM_PRIV_KEY, pPrivateKey ) == 1 ) &&
+        ( OSSL_PARAM_BLD_push_octet_string( pBuilder, OSSL_PKEY_PARAM_PUB_KEY, pPublicKey, OPENSSL_EC_PUBLIC_KEY_LENGTH ) == 1 ) )
+    {
+        pParams = OSSL_PARAM_BLD_to_param( pBuilder );
+    }
+
+    /* pKey is left NULL if the key pair cannot be created. */
+    if( ( pParams != NULL ) && ( pKeyContext != NULL ) &&
+        ( EVP_PKEY_fromdata_init( pKeyContext ) == 1 ) )
+    {
+        ( void ) EVP_PKEY_fromdata( pKeyContext, &pKey, EVP_PKEY_KEYPAIR, pParams );
+    }
+
+    EVP_PKEY_CTX_free( pKeyContext );
+    OSSL_PARAM_free( pParams );
+    OSSL_PARAM_BLD_free( pBuilder );
+
+    return pKey;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslEcdsaLoadKey( void * pEcdsaContext,
+                                    const uint8_t * pPrivateKey,
+                                    size_t privateKeyLen )
+{
+    SigV4OpenSSLEcdsaContext_t * pContext = ( SigV4OpenSSLEcdsaContext_t * ) pEcdsaContext;
+    uint8_t publicKey[ OPENSSL_EC_PUBLIC_KEY_LENGTH ];
+    BIGNUM * pScalar = BN_bin2bn( pPrivateKey, ( int ) privateKeyLen, NULL );
+    EVP_PKEY * pKey = NULL;
+    EVP_PKEY_CTX * pSignContext = NULL;
+    int32_t returnStatus = -1;
+
+    assert( pContext != NULL );
+
+    /* The public point is computed once here rather than for each signature. */
+    if( ( pScalar != NULL ) && computeEcdsaPublicKey( pScalar, publicKey ) )
+    {
+        pKey = createEcdsaKeyPair( pScalar, publicKey );
+    }
+
+    if( pKey != NULL )
+    {
+        pSignContext = EVP_PKEY_CTX_new_from_pkey( NULL, pKey, NULL );
+    }
+
+    if( ( pSignContext != NULL ) && ( EVP_PKEY_sign_init( pSignContext ) == 1 ) )
+    {
+        EVP_PKEY_CTX_free( pContext->pSignContext );
+        EVP_PKEY_free( pContext->pKey );
+        pContext->pKey = pKey;
+        pContext->pSignContext = pSignContext;
+        returnStatus = 0;
+    }
+    else
+    {
+        EVP_PKEY_CTX_free( pSignContext );
+        EVP_PKEY_free( pKey );
+    }
+
+    BN_clear_free( pScalar );
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t opensslEcdsaSign( void * pEcdsaContext,
+                                 const uint8_t * pDigest,
+                                 size_t digestLen,
+                                 uint8_t * pSignature,
+                                 size_t * pSignatureLen )
+{
+    const SigV4OpenSSLEcdsaContext_t * pContext = ( const SigV4OpenSSLEcdsaContext_t * ) pEcdsaContext;
+    int32_t returnStatus = -1;
+
+    assert( pContext != NULL );
+
+    if( ( pContext->pSignContext != NULL ) &&
+        ( EVP_PKEY_sign( pContext->pSignContext, pSignature, pSignatureLen, pDigest, digestLen ) == 1 ) )
+    {
+        returnStatus = 0;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_OpenSSLEcdsaInit( SigV4EcdsaInterface_t * pEcdsaInterface,
+                                      SigV4OpenSSLEcdsaContext_t * pContext )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+
+    if( ( pEcdsaInterface == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pEcdsaInterface and pContext must not be NULL." ) );
+    }
+    else
+    {
+        ( void ) memset( pContext, 0, sizeof( SigV4OpenSSLEcdsaContext_t ) );
+        pEcdsaInterface->loadKey = opensslEcdsaLoadKey;
+        pEcdsaInterface->sign = opensslEcdsaSign;
+        pEcdsaInterface->pEcdsaContext = pContext;
+        returnStatus = SigV4Success;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+void SigV4_OpenSSLEcdsaCleanup( SigV4OpenSSLEcdsaContext_t * pContext )
+{
+    if( pContext != NULL )
+    {
+        EVP_PKEY_CTX_free( pContext->pSignContext );
+        EVP_PKEY_free( pContext->pKey );
+        ( void ) memset( pContext, 0, sizeof( SigV4OpenSSLEcdsaContext_t ) );
+    }
+}
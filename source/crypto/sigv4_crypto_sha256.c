@@ -0,0 +1,381 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_crypto_sha256.c
+ * @brief Portable SHA-256 implementation of #SigV4CryptoInterface_t, as
+ * specified in FIPS 180-4.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+
+#include "sigv4_crypto_sha256.h"
+
+/**
+ * @brief Rotate a 32-bit word right.
+ */
+#define ROTR32( x, n )         ( ( ( x ) >> ( n ) ) | ( ( x ) << ( 32U - ( n ) ) ) )
+
+/**
+ * @brief The SHA-256 choose function.
+ */
+#define CH( x, y, z )          ( ( ( x ) & ( y ) ) ^ ( ( ~( x ) ) & ( z ) ) )
+
+/**
+ * @brief The SHA-256 majority function.
+ */
+#define MAJ( x, y, z )         ( ( ( x ) & ( y ) ) ^ ( ( x ) & ( z ) ) ^ ( ( y ) & ( z ) ) )
+
+/**
+ * @brief The SHA-256 upper-case sigma 0 function.
+ */
+#define BSIG0( x )             ( ROTR32( x, 2U ) ^ ROTR32( x, 13U ) ^ ROTR32( x, 22U ) )
+
+/**
+ * @brief The SHA-256 upper-case sigma 1 function.
+ */
+#define BSIG1( x )             ( ROTR32( x, 6U ) ^ ROTR32( x, 11U ) ^ ROTR32( x, 25U ) )
+
+/**
+ * @brief The SHA-256 lower-case sigma 0 function.
+ */
+#define SSIG0( x )             ( ROTR32( x, 7U ) ^ ROTR32( x, 18U ) ^ ( ( x ) >> 3U ) )
+
+/**
+ * @brief The SHA-256 lower-case sigma 1 function.
+ */
+#define SSIG1( x )             ( ROTR32( x, 17U ) ^ ROTR32( x, 19U ) ^ ( ( x ) >> 10U ) )
+
+/**
+ * @brief The offset in the last block at which the message length is written.
+ */
+#define SHA256_LENGTH_OFFSET    56U
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The SHA-256 round constants.
+ */
+static const uint32_t roundConstants[ 64 ] =
+{
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+    0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+    0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+    0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+    0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+    0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+};
+
+/**
+ * @brief The SHA-256 initial hash value.
+ */
+static const uint32_t initialState[ 8 ] =
+{
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU, 0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read a big-endian 32-bit word.
+ *
+ * @param[in] pBytes The four bytes of the word.
+ * @return The word.
+ */
+static uint32_t readWord( const uint8_t * pBytes );
+
+/**
+ * @brief Write a 32-bit word in big-endian order.
+ *
+ * @param[in] word The word.
+ * @param[out] pBytes The four bytes to write.
+ */
+static void writeWord( uint32_t word,
+                       uint8_t * pBytes );
+
+/**
+ * @brief Process one block of input.
+ *
+ * @param[in, out] pState The intermediate hash value.
+ * @param[in] pBlock The #SIGV4_SHA256_BLOCK_LENGTH bytes of input.
+ */
+static void compressBlock( uint32_t * pState,
+                           const uint8_t * pBlock );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashInit.
+ *
+ * @param[in] pHashContext The #SigV4Sha256Context_t.
+ * @return Zero.
+ */
+static int32_t sha256Init( void * pHashContext );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashUpdate.
+ *
+ * @param[in] pHashContext The #SigV4Sha256Context_t.
+ * @param[in] pInput Buffer holding the data to hash.
+ * @param[in] inputLen Length of @p pInput.
+ * @return Zero.
+ */
+static int32_t sha256Update( void * pHashContext,
+                             const uint8_t * pInput,
+                             size_t inputLen );
+
+/**
+ * @brief Implements #SigV4CryptoInterface_t.hashFinal.
+ *
+ * @param[in] pHashContext The #SigV4Sha256Context_t.
+ * @param[out] pOutput The buffer for the digest.
+ * @param[in] outputLen Length of @p pOutput.
+ * @return Zero on success, or -1 if @p pOutput is shorter than the digest.
+ */
+static int32_t sha256Final( void * pHashContext,
+                            uint8_t * pOutput,
+                            size_t outputLen );
+
+/*-----------------------------------------------------------*/
+
+static uint32_t readWord( const uint8_t * pBytes )
+{
+    return ( ( uint32_t ) pBytes[ 0 ] << 24U ) |
+           ( ( uint32_t ) pBytes[ 1 ] << 16U ) |
+           ( ( uint32_t ) pBytes[ 2 ] << 8U ) |
+           ( uint32_t ) pBytes[ 3 ];
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeWord( uint32_t word,
+                       uint8_t * pBytes )
+{
+    pBytes[ 0 ] = ( uint8_t ) ( word >> 24U );
+    pBytes[ 1 ] = ( uint8_t ) ( word >> 16U );
+    pBytes[ 2 ] = ( uint8_t ) ( word >> 8U );
+    pBytes[ 3 ] = ( uint8_t ) word;
+}
+
+/*-----------------------------------------------------------*/
+
+static void compressBlock( uint32_t * pState,
+                           const uint8_t * pBlock )
+{
+    uint32_t schedule[ 64 ];
+    uint32_t a, b, c, d, e, f, g, h, t1, t2;
+    size_t i;
+
+    for( i = 0U; i < 16U; i++ )
+    {
+        schedule[ i ] = readWord( &pBlock[ i * 4U ] );
+    }
+
+    for( i = 16U; i < 64U; i++ )
+    {
+        schedule[ i ] = SSIG1( schedule[ i - 2U ] ) + schedule[ i - 7U ] +
+                        SSIG0( schedule[ i - 15U ] ) + schedule[ i - 16U ];
+    }
+
+    a = pState[ 0 ];
+    b = pState[ 1 ];
+    c = pState[ 2 ];
+    d = pState[ 3 ];
+    e = pState[ 4 ];
+    f = pState[ 5 ];
+    g = pState[ 6 ];
+    h = pState[ 7 ];
+
+    for( i = 0U; i < 64U; i++ )
+    {
+        t1 = h + BSIG1( e ) + CH( e, f, g ) + roundConstants[ i ] + schedule[ i ];
+        t2 = BSIG0( a ) + MAJ( a, b, c );
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    pState[ 0 ] += a;
+    pState[ 1 ] += b;
+    pState[ 2 ] += c;
+    pState[ 3 ] += d;
+    pState[ 4 ] += e;
+    pState[ 5 ] += f;
+    pState[ 6 ] += g;
+    pState[ 7 ] += h;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t sha256Init( void * pHashContext )
+{
+    SigV4Sha256Context_t * pContext = ( SigV4Sha256Context_t * ) pHashContext;
+
+    assert( pContext != NULL );
+
+    ( void ) memcpy( pContext->state, initialState, sizeof( initialState ) );
+    pContext->bitCountLow = 0U;
+    pContext->bitCountHigh = 0U;
+    pContext->blockLen = 0U;
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t sha256Update( void * pHashContext,
+                             const uint8_t * pInput,
+                             size_t inputLen )
+{
+    SigV4Sha256Context_t * pContext = ( SigV4Sha256Context_t * ) pHashContext;
+    size_t copyLen = 0U, index = 0U;
+    uint32_t bitCountLow = 0U;
+
+    assert( pContext != NULL );
+    assert( ( pInput != NULL ) || ( inputLen == 0U ) );
+    assert( pContext->blockLen < SIGV4_SHA256_BLOCK_LENGTH );
+
+    /* Count the hashed bits with carry into the high word. */
+    bitCountLow = pContext->bitCountLow + ( uint32_t ) ( inputLen << 3U );
+    pContext->bitCountHigh += ( uint32_t ) ( inputLen >> 29U );
+
+    if( bitCountLow < pContext->bitCountLow )
+    {
+        pContext->bitCountHigh++;
+    }
+
+    pContext->bitCountLow = bitCountLow;
+
+    /* Complete the block left over from the previous update. */
+    if( ( pContext->blockLen > 0U ) && ( inputLen > 0U ) )
+    {
+        copyLen = SIGV4_SHA256_BLOCK_LENGTH - pContext->blockLen;
+        copyLen = ( inputLen < copyLen ) ? inputLen : copyLen;
+        ( void ) memcpy( &pContext->block[ pContext->blockLen ], pInput, copyLen );
+        pContext->blockLen += copyLen;
+        index = copyLen;
+
+        if( pContext->blockLen == SIGV4_SHA256_BLOCK_LENGTH )
+        {
+            compressBlock( pContext->state, pContext->block );
+            pContext->blockLen = 0U;
+        }
+    }
+
+    /* Hash whole blocks straight from the input. */
+    while( ( inputLen - index ) >= SIGV4_SHA256_BLOCK_LENGTH )
+    {
+        compressBlock( pContext->state, &pInput[ index ] );
+        index += SIGV4_SHA256_BLOCK_LENGTH;
+    }
+
+    /* Keep the rest for the next update. */
+    if( index < inputLen )
+    {
+        ( void ) memcpy( &pContext->block[ pContext->blockLen ], &pInput[ index ], inputLen - index );
+        pContext->blockLen += inputLen - index;
+    }
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t sha256Final( void * pHashContext,
+                            uint8_t * pOutput,
+                            size_t outputLen )
+{
+    SigV4Sha256Context_t * pContext = ( SigV4Sha256Context_t * ) pHashContext;
+    int32_t returnStatus = -1;
+    size_t i;
+
+    assert( pContext != NULL );
+    assert( pOutput != NULL );
+    assert( pContext->blockLen < SIGV4_SHA256_BLOCK_LENGTH );
+
+    if( outputLen >= SIGV4_SHA256_DIGEST_LENGTH )
+    {
+        /* Append the 1 bit, then zeros up to the length field, which
+         * moves to another block if it does not fit in this one. */
+        pContext->block[ pContext->blockLen ] = 0x80U;
+        pContext->blockLen++;
+
+        if( pContext->blockLen > SHA256_LENGTH_OFFSET )
+        {
+            ( void ) memset( &pContext->block[ pContext->blockLen ], 0, SIGV4_SHA256_BLOCK_LENGTH - pContext->blockLen );
+            compressBlock( pContext->state, pContext->block );
+            pContext->blockLen = 0U;
+        }
+
+        ( void ) memset( &pContext->block[ pContext->blockLen ], 0, SHA256_LENGTH_OFFSET - pContext->blockLen );
+        writeWord( pContext->bitCountHigh, &pContext->block[ SHA256_LENGTH_OFFSET ] );
+        writeWord( pContext->bitCountLow, &pContext->block[ SHA256_LENGTH_OFFSET + 4U ] );
+        compressBlock( pContext->state, pContext->block );
+        pContext->blockLen = 0U;
+
+        for( i = 0U; i < 8U; i++ )
+        {
+            writeWord( pContext->state[ i ], &pOutput[ i * 4U ] );
+        }
+
+        returnStatus = 0;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_Sha256CryptoInit( SigV4CryptoInterface_t * pCryptoInterface,
+                                      SigV4Sha256Context_t * pContext )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+
+    if( ( pCryptoInterface == NULL ) || ( pContext == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface and pContext must not be NULL." ) );
+    }
+    else
+    {
+        ( void ) memset( pCryptoInterface, 0, sizeof( SigV4CryptoInterface_t ) );
+        pCryptoInterface->hashInit = sha256Init;
+        pCryptoInterface->hashUpdate = sha256Update;
+        pCryptoInterface->hashFinal = sha256Final;
+        pCryptoInterface->pHashContext = pContext;
+        pCryptoInterface->hashBlockLen = SIGV4_SHA256_BLOCK_LENGTH;
+        pCryptoInterface->hashDigestLen = SIGV4_SHA256_DIGEST_LENGTH;
+        ( void ) sha256Init( pContext );
+        returnStatus = SigV4Success;
+    }
+
+    return returnStatus;
+}
@@ -60,7 +60,10 @@
  */
 #define SIGV4_AWS4_HMAC_SHA256                      "AWS4-HMAC-SHA256"                                              /**< AWS identifier for SHA256 signing algorithm. */
 #define SIGV4_AWS4_HMAC_SHA256_LENGTH               ( sizeof( SIGV4_AWS4_HMAC_SHA256 ) - 1U )                       /**< Length of AWS identifier for SHA256 signing algorithm. */
+#define SIGV4_AWS4_ECDSA_P256_SHA256                "AWS4-ECDSA-P256-SHA256"                                        /**< AWS identifier for the SigV4A ECDSA P-256 signing algorithm. */
+#define SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH         ( sizeof( SIGV4_AWS4_ECDSA_P256_SHA256 ) - 1U )                 /**< Length of AWS identifier for the SigV4A ECDSA P-256 signing algorithm. */
 #define SIGV4_HTTP_X_AMZ_DATE_HEADER                "x-amz-date"                                                    /**< AWS identifier for HTTP date header. */
+#define SIGV4_HTTP_X_AMZ_REGION_SET_HEADER          "x-amz-region-set"                                              /**< AWS identifier for the SigV4A region set header. */
 #define SIGV4_HTTP_X_AMZ_SECURITY_TOKEN_HEADER      "x-amz-security-token"                                          /**< AWS identifier for security token. */
 
 #define SIGV4_STREAMING_AWS4_HMAC_SHA256_PAYLOAD    "STREAMING-AWS4-HMAC-SHA256-PAYLOAD"                            /**< S3 identifier for chunked payloads. */
@@ -79,6 +82,20 @@
 #define SIGV4_EXPECTED_LEN_RFC_5322                      29U
 /**< Length of RFC 5322 date input. */
 
+#define SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH              32U                                                        /**< Length of a SigV4A ECDSA P-256 private key. */
+#define SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH            72U                                                        /**< Maximum length of a DER-encoded ECDSA P-256 signature. */
+
+#define SIGV4_AUTHORIZATION_IOVEC_COUNT                  13U                                                        /**< Number of segments written by #SigV4_GenerateHTTPAuthorizationIov. */
+
+/**
+ * @brief Maximum length of a hex-encoded signature, of SigV4 or of SigV4A.
+ */
+#if ( SIGV4_HASH_MAX_DIGEST_LENGTH > SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH )
+    #define SIGV4_MAX_ENCODED_SIGNATURE_LENGTH    ( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U )
+#else
+    #define SIGV4_MAX_ENCODED_SIGNATURE_LENGTH    ( SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH * 2U )
+#endif
+
 /** @}*/
 
 /**
@@ -135,6 +152,37 @@
  */
 #define SIGV4_HTTP_IS_PRESIGNED_URL              0x10U
 
+/**
+ * @ingroup sigv4_canonical_flags
+ * @brief Set this flag to indicate that #SigV4HttpParameters_t.pPayload holds
+ * the lowercase hex-encoded hash of the HTTP request payload instead of the
+ * payload itself.
+ *
+ * This allows the payload to be hashed ahead of signing, e.g. on a worker
+ * thread with #SigV4_HashPayload, so that signing does not block on large
+ * payloads. Unlike #SIGV4_HTTP_PAYLOAD_IS_HASH, the request does not need to
+ * carry an "x-amz-content-sha256" header.
+ *
+ * This flag is valid only for #SigV4HttpParameters_t.flags.
+ */
+#define SIGV4_HTTP_PAYLOAD_IS_DIGEST             0x20U
+
+/**
+ * @ingroup sigv4_canonical_flags
+ * @brief Set this flag to indicate that the HTTP request headers are in raw
+ * HTTP format and in any order, but that the header names are already
+ * lowercase and the header names and values are already trimmed.
+ *
+ * Trimmed means that there are no spaces around a header name or value, and
+ * no sequential spaces within a header value, e.g.
+ * "host:iam.amazonaws.com\r\nx-amz-date:20150830T123600Z\r\n\r\n". The library still sorts the
+ * headers and writes them in canonical form, but copies each header name and
+ * value as a whole instead of checking every character.
+ *
+ * This flag is valid only for #SigV4HttpParameters_t.flags.
+ */
+#define SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG      0x40U
+
 /**
  * @ingroup sigv4_canonical_flags
  * @brief Set this flag to indicate that the HTTP request path, query, and
@@ -157,6 +205,11 @@ typedef enum SigV4Status
      * - #SigV4_GenerateHTTPAuthorization
      * - #SigV4_AwsIotDateToIso8601
      * - #SigV4_EncodeURI
+     * - #SigV4_HashPayload
+     * - #SigV4_FinishPayloadHash
+     * - #SigV4_InitQueryBuilder
+     * - #SigV4_SetQueryParameter
+     * - #SigV4_RemoveQueryParameter
      */
     SigV4Success,
 
@@ -167,6 +220,11 @@ typedef enum SigV4Status
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
      * - #SigV4_AwsIotDateToIso8601
+     * - #SigV4_HashPayload
+     * - #SigV4_FinishPayloadHash
+     * - #SigV4_InitQueryBuilder
+     * - #SigV4_SetQueryParameter
+     * - #SigV4_RemoveQueryParameter
      */
     SigV4InvalidParameter,
 
@@ -177,6 +235,10 @@ typedef enum SigV4Status
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
      * - #SigV4_EncodeURI
+     * - #SigV4_HashPayload
+     * - #SigV4_FinishPayloadHash
+     * - #SigV4_SetQueryParameter
+     * - #SigV4_RemoveQueryParameter
      */
     SigV4InsufficientMemory,
 
@@ -213,10 +275,13 @@ typedef enum SigV4Status
     SigV4MaxQueryPairCountExceeded,
 
     /**
-     * @brief An error occurred while performing a hash operation.
+     * @brief An error occurred while performing a hash operation, or an ECDSA
+     * operation of #SigV4EcdsaInterface_t.
      *
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
+     * - #SigV4_HashPayload
+     * - #SigV4_FinishPayloadHash
      */
     SigV4HashError,
 
@@ -226,9 +291,32 @@ typedef enum SigV4Status
      * Functions that may return this value:
      * - #SigV4_GenerateHTTPAuthorization
      */
-    SigV4InvalidHttpHeaders
+    SigV4InvalidHttpHeaders,
+
+    /**
+     * @brief The HTTP request payload could not be read from its source, such
+     * as a file. The C library itself does not read payloads; this value is
+     * reported by the helpers of sigv4_file.hpp, with errno describing the
+     * failure.
+     */
+    SigV4PayloadReadError
 } SigV4Status_t;
 
+/**
+ * @ingroup sigv4_struct_types
+ * @brief A segment of memory, such as a part of the HTTP Authorization
+ * header value written by #SigV4_GenerateHTTPAuthorizationIov or an input of
+ * #SigV4CryptoInterface_t.hashUpdateV.
+ *
+ * The members are in the same order as those of the POSIX struct iovec, so
+ * the segments can be passed on to writev() or sendmsg() member by member.
+ */
+typedef struct SigV4IoVec
+{
+    const char * pData; /**< @brief Start of the segment. */
+    size_t dataLen;     /**< @brief Length of the segment. */
+} SigV4IoVec_t;
+
 /**
  * @ingroup sigv4_struct_types
  * @brief The cryptography interface used to supply the user-defined hash
@@ -291,8 +379,137 @@ typedef struct SigV4CryptoInterface
      * @brief The digest length of the hash function.
      */
     size_t hashDigestLen;
+
+    /**
+     * @brief Optional. Starts an HMAC operation keyed with @p pKey, using the
+     * same hash function as the hash interfaces above.
+     *
+     * If hmacInit, hmacUpdate, and hmacFinal are all set, every HMAC of the
+     * signing process, including the four rounds that derive the signing key,
+     * is computed through them instead of the library's own HMAC built on
+     * hashInit, hashUpdate, and hashFinal. Leave them NULL to use the built-in
+     * implementation.
+     *
+     * @param[in] pHmacContext Context used to maintain the HMAC's current state
+     * during incremental updates.
+     * @param[in] pKey The HMAC key. Keys longer than the hash block length are
+     * hashed down by the library first, so @p keyLen never exceeds it.
+     * @param[in] keyLen The length of @p pKey.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * hmacInit )( void * pHmacContext,
+                            const uint8_t * pKey,
+                            size_t keyLen );
+
+    /**
+     * @brief Optional. Adds data to the HMAC started by hmacInit.
+     *
+     * @param[in] pHmacContext Context used to maintain the HMAC's current state
+     * during incremental updates.
+     * @param[in] pInput Buffer holding the data to authenticate.
+     * @param[in] inputLen length of the input buffer data.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * hmacUpdate )( void * pHmacContext,
+                              const uint8_t * pInput,
+                              size_t inputLen );
+
+    /**
+     * @brief Optional. Calculates the final binary HMAC from the context.
+     *
+     * @param[in] pHmacContext Context used to maintain the HMAC's current state
+     * during incremental updates.
+     * @param[out] pOutput The buffer used to place the binary HMAC, which is
+     * the hash digest length long.
+     * @param[in] outputLen The length of the pOutput buffer.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * hmacFinal )( void * pHmacContext,
+                             uint8_t * pOutput,
+                             size_t outputLen );
+
+    /**
+     * @brief Context for the hmacInit, hmacUpdate, and hmacFinal interfaces.
+     */
+    void * pHmacContext;
+
+    /**
+     * @brief Optional. Calculates an ongoing hash update over several segments
+     * in one call, as if hashUpdate was called for each segment in order.
+     *
+     * Where the library hashes several pieces of memory in a row, such as the
+     * lines of the canonical request or the padded key and data of an HMAC, it
+     * passes them all to this function if it is set, e.g. to hand them to a
+     * hash engine as one descriptor list. Otherwise, hashUpdate is called for
+     * each segment.
+     *
+     * @param[in] pHashContext Context used to maintain the hash's current state
+     * during incremental updates.
+     * @param[in] pSegments The segments to hash, in order.
+     * @param[in] segmentCount The number of entries of @p pSegments.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * hashUpdateV )( void * pHashContext,
+                               const SigV4IoVec_t * pSegments,
+                               size_t segmentCount );
 } SigV4CryptoInterface_t;
 
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The ECDSA interface used to supply the user-defined ECDSA P-256
+ * implementation for SigV4A signing.
+ *
+ * The library derives the private key from the credentials and hands it to
+ * loadKey, then signs each request with sign. The implementation is expected
+ * to import the key and precompute whatever it needs for signing, such as the
+ * public point, in loadKey, so that sign only performs the signing operation.
+ */
+typedef struct SigV4EcdsaInterface
+{
+    /**
+     * @brief Imports the private key that the following signatures are
+     * computed with, replacing the one imported before.
+     *
+     * @param[in] pEcdsaContext Context holding the imported key.
+     * @param[in] pPrivateKey The big-endian private key scalar.
+     * @param[in] privateKeyLen The length of @p pPrivateKey, which is
+     * #SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * loadKey )( void * pEcdsaContext,
+                           const uint8_t * pPrivateKey,
+                           size_t privateKeyLen );
+
+    /**
+     * @brief Signs a SHA-256 digest with the imported key.
+     *
+     * @param[in] pEcdsaContext Context holding the imported key.
+     * @param[in] pDigest The digest to sign.
+     * @param[in] digestLen The length of @p pDigest.
+     * @param[out] pSignature The buffer for the DER-encoded signature.
+     * @param[in, out] pSignatureLen Input: the length of @p pSignature, which
+     * is #SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH. Output: the length of the
+     * signature.
+     *
+     * @return Zero on success, all other return values are failures.
+     */
+    int32_t ( * sign )( void * pEcdsaContext,
+                        const uint8_t * pDigest,
+                        size_t digestLen,
+                        uint8_t * pSignature,
+                        size_t * pSignatureLen );
+
+    /**
+     * @brief Context for the loadKey and sign interfaces.
+     */
+    void * pEcdsaContext;
+} SigV4EcdsaInterface_t;
+
 /**
  * @ingroup sigv4_struct_types
  * @brief Configurations of the HTTP request used to create the Canonical
@@ -307,12 +524,14 @@ typedef struct SigV4HttpParameters
      * @brief These flags are used to indicate if the path, query, or headers are already
      * in the canonical form. This is to bypass the internal sorting, white space
      * trimming, and encoding done by the library. This is a performance optimization
-     * option. Please see https://docs.aws.amazon.com/general/latest/gr/sigv4-create-canonical-request.html
+     * option. Inputs flagged as canonical are hashed directly from the application's
+     * memory, so they do not take space in #SIGV4_PROCESSING_BUFFER_LENGTH. Please see https://docs.aws.amazon.com/general/latest/gr/sigv4-create-canonical-request.html
      * for information on generating a canonical path, query, and headers string.
      * - #SIGV4_HTTP_PATH_IS_CANONICAL_FLAG     0x1
      * - #SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG    0x2
      * - #SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG 0x4
      * - #SIGV4_HTTP_ALL_ARE_CANONICAL_FLAG     0x7
+     * - #SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG   0x40
      */
     uint32_t flags;
 
@@ -345,9 +564,12 @@ typedef struct SigV4HttpParameters
      * @brief The headers from the HTTP request that we want to sign. This
      * should be the raw headers in HTTP request format. If
      * SIGV4_HTTP_HEADERS_IS_CANONICAL_FLAG is set, then this input must
-     * already be in canonical form.
+     * already be in canonical form. If #SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG
+     * is set, then the header names must already be lowercase and the header
+     * names and values must already be trimmed.
      *
-     * @note The headers data MUST NOT be empty. For HTTP/1.1 requests, it is
+     * @note The headers data MUST NOT be empty, counting pHeadersWrap. For
+     * HTTP/1.1 requests, it is
      * required that the "host" header MUST be part of the SigV4 signature.
      */
     const char * pHeaders;
@@ -356,10 +578,46 @@ typedef struct SigV4HttpParameters
     /**
      * @brief The HTTP response body, if one exists (ex. PUT request). If this
      * body is chunked, then this field should be set with
-     * STREAMING-AWS4-HMAC-SHA256-PAYLOAD.
+     * STREAMING-AWS4-HMAC-SHA256-PAYLOAD. If #SIGV4_HTTP_PAYLOAD_IS_DIGEST is
+     * set, then this field holds the hex-encoded hash of the body.
      */
     const char * pPayload;
     size_t payloadLen; /**< @brief Length of pPayload. */
+
+    /**
+     * @brief The rest of the query, when the query wraps around the end of a
+     * ring buffer. It is signed as if it directly followed pQuery, without
+     * being copied into a contiguous buffer. If the ring buffer wrapped right
+     * at the start of the query, pQuery may be NULL or empty and this holds
+     * the whole query.
+     *
+     * @note This is ignored if it is NULL.
+     */
+    const char * pQueryWrap;
+    size_t queryWrapLen; /**< @brief Length of pQueryWrap. */
+
+    /**
+     * @brief The rest of the headers, when the headers wrap around the end of
+     * a ring buffer. It is signed as if it directly followed pHeaders. Only
+     * the header line that straddles the end of pHeaders is copied, to the
+     * end of the processing buffer, so it must fit in
+     * #SIGV4_PROCESSING_BUFFER_LENGTH along with the canonical request. If
+     * the ring buffer wrapped right at the start of the headers, pHeaders may
+     * be NULL or empty and this holds the whole headers.
+     *
+     * @note This is ignored if it is NULL.
+     */
+    const char * pHeadersWrap;
+    size_t headersWrapLen; /**< @brief Length of pHeadersWrap. */
+
+    /**
+     * @brief The rest of the payload, when the payload wraps around the end
+     * of a ring buffer. It is hashed directly after pPayload.
+     *
+     * @note This is ignored if it is NULL.
+     */
+    const char * pPayloadWrap;
+    size_t payloadWrapLen; /**< @brief Length of pPayloadWrap. */
 } SigV4HttpParameters_t;
 
 /**
@@ -383,6 +641,240 @@ typedef struct SigV4Credentials
     size_t secretAccessKeyLen; /**< @brief Length of pSecretAccessKey. */
 } SigV4Credentials_t;
 
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Application-owned cache of the most recently derived signing key.
+ *
+ * The signing key only depends on the secret access key, the date, the region,
+ * and the service, so it stays valid for a whole day of requests to the same
+ * service. When a cache is supplied through #SigV4Parameters_t.pSigningKeyCache,
+ * the four HMAC operations that derive the key are skipped as long as the
+ * credential scope and the digest of the secret access key match those the
+ * cached key was derived for. A secret rotated under the same access key ID
+ * therefore derives a new key, at the cost of one hash of the secret per call.
+ *
+ * @note The cache must be zero-initialized before first use. It is not
+ * thread-safe; use one cache per signing thread.
+ */
+typedef struct SigV4SigningKeyCache
+{
+    /**
+     * @brief The "<access key ID>/<YYYYMMDD>/<region>/<service>" identity
+     * that pSigningKey was derived for.
+     */
+    char pScopeId[ SIGV4_SIGNING_KEY_CACHE_ID_LENGTH ];
+    size_t scopeIdLen; /**< @brief Length of pScopeId. */
+
+    uint8_t pSecretDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ]; /**< @brief Digest of the secret access key that pSigningKey was derived from. */
+    size_t secretAccessKeyLen;                             /**< @brief Length of the secret access key that pSigningKey was derived from. */
+
+    uint8_t pSigningKey[ SIGV4_HASH_MAX_DIGEST_LENGTH ]; /**< @brief The cached signing key. */
+    size_t signingKeyLen;                                /**< @brief Length of pSigningKey, zero if the cache is empty. */
+} SigV4SigningKeyCache_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Application-owned record of the credentials whose SigV4A private key
+ * is imported in an ECDSA interface.
+ *
+ * Unlike the SigV4 signing key, the SigV4A private key only depends on the
+ * access key ID and the secret access key, so it stays valid for as long as
+ * the credentials do. When a cache is supplied through
+ * #SigV4Parameters_t.pEcdsaKeyCache, the key derivation and
+ * #SigV4EcdsaInterface_t.loadKey are skipped as long as the access key ID, the
+ * digest of the secret access key and the #SigV4EcdsaInterface_t.pEcdsaContext
+ * match those whose key was imported last.
+ *
+ * @note The cache must be zero-initialized before first use, and must be
+ * zeroed again if the key held by its ECDSA context is replaced other than
+ * through this library. It is not thread-safe; use one cache and one ECDSA
+ * context per signing thread.
+ */
+typedef struct SigV4EcdsaKeyCache
+{
+    /**
+     * @brief The access key ID that the imported key was derived for.
+     */
+    char pAccessKeyId[ SIGV4_SIGNING_KEY_CACHE_ID_LENGTH ];
+    size_t accessKeyIdLen; /**< @brief Length of pAccessKeyId, zero if no key is imported. */
+
+    uint8_t pSecretDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ]; /**< @brief Digest of the secret access key that the imported key was derived from. */
+    size_t secretAccessKeyLen;                             /**< @brief Length of the secret access key that the imported key was derived from. */
+    const void * pEcdsaContext;                            /**< @brief The #SigV4EcdsaInterface_t.pEcdsaContext the key was imported into. */
+} SigV4EcdsaKeyCache_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The parts of the credential scope that are fixed for a region,
+ * service and algorithm, computed ahead of signing.
+ *
+ * When supplied through #SigV4Parameters_t.pPrecomputedScope, the credential
+ * scope and the Authorization header prefix are copied from it instead of
+ * being built from the region, service and algorithm of each request, and the
+ * service is not compared against S3. Only the date and the signature are then
+ * filled in per request. The C++ CredentialScope template builds one at
+ * compile time.
+ *
+ * @note The parts must match #SigV4Parameters_t.pRegion,
+ * #SigV4Parameters_t.pService and #SigV4Parameters_t.pAlgorithm, which are
+ * still used to derive the signing key.
+ */
+typedef struct SigV4PrecomputedScope
+{
+    /**
+     * @brief "/<region>/<service>/aws4_request", the credential scope after
+     * its date; "/<service>/aws4_request" with SigV4A.
+     */
+    const char * pScopeSuffix;
+    size_t scopeSuffixLen; /**< @brief Length of pScopeSuffix. */
+
+    /**
+     * @brief "<algorithm> Credential=", the start of the Authorization header
+     * value.
+     */
+    const char * pAuthPrefix;
+    size_t authPrefixLen; /**< @brief Length of pAuthPrefix. */
+
+    /**
+     * @brief Whether the path is URI-encoded once, as for S3, instead of
+     * twice.
+     */
+    bool encodePathOnce;
+} SigV4PrecomputedScope_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief A path held by a #SigV4PathCache_t, along with its canonical form.
+ */
+typedef struct SigV4PathCacheEntry
+{
+    uint32_t pathHash;                                   /**< @brief FNV-1a hash of pPath. */
+    uint32_t lastUsed;                                   /**< @brief Value of the cache use counter when the entry was last used. */
+    bool encodedTwice;                                   /**< @brief Whether pCanonicalPath is double-encoded. */
+    char pPath[ SIGV4_PATH_CACHE_PATH_LENGTH ];          /**< @brief The path as given in #SigV4HttpParameters_t.pPath. */
+    size_t pathLen;                                      /**< @brief Length of pPath. */
+    char pCanonicalPath[ SIGV4_PATH_CACHE_PATH_LENGTH ]; /**< @brief The canonical form of pPath. */
+    size_t canonicalPathLen;                             /**< @brief Length of pCanonicalPath, zero if the entry is empty. */
+} SigV4PathCacheEntry_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Application-owned cache of the canonical form of recently signed
+ * paths.
+ *
+ * Devices often sign requests to a small set of paths, such as their shadow
+ * documents. When a cache is supplied through #SigV4Parameters_t.pPathCache,
+ * a path found in the cache is copied to the canonical request as is, skipping
+ * both URI-encoding passes. Lookups compare a hash of the path first, and then
+ * the path itself, so a hash collision never yields the wrong canonical path.
+ *
+ * @note The cache must be zero-initialized before first use. It is not
+ * thread-safe; use one cache per signing thread.
+ */
+typedef struct SigV4PathCache
+{
+    SigV4PathCacheEntry_t entries[ SIGV4_PATH_CACHE_ENTRY_COUNT ]; /**< @brief The cached paths. */
+    uint32_t useCounter;                                           /**< @brief Counter that orders the entries by last use. */
+} SigV4PathCache_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Application-owned cache of the sort order and signed headers list of
+ * the most recently signed set of header names.
+ *
+ * Most requests of an application sign the same header names in the same
+ * order, with only the values changing. When a cache is supplied through
+ * #SigV4Parameters_t.pSignedHeadersCache and the header names match those of
+ * the cached request, the headers are put in canonical order without being
+ * sorted, and the signed headers list is copied instead of being rebuilt.
+ * Header names are looked up by a fingerprint and then compared, so a
+ * fingerprint collision never yields the wrong order. The cache is not used
+ * when #SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG is set.
+ *
+ * @note The cache must be zero-initialized before first use. It is not
+ * thread-safe; use one cache per signing thread.
+ */
+typedef struct SigV4SignedHeadersCache
+{
+    /**
+     * @brief FNV-1a hash of the header names in the order they were given.
+     */
+    uint32_t fingerprint;
+
+    /**
+     * @brief The header names as given, in canonical order, each followed by
+     * ':'.
+     */
+    char pHeaderNames[ SIGV4_SIGNED_HEADERS_CACHE_LENGTH ];
+    size_t headerNamesLen; /**< @brief Length of pHeaderNames. */
+    size_t headerCount;    /**< @brief Number of headers in pHeaderNames. */
+
+    /**
+     * @brief The position in the request of the header at each position of the
+     * canonical order.
+     */
+    size_t pSortedOrder[ SIGV4_MAX_HTTP_HEADER_COUNT ];
+
+    char pSignedHeaders[ SIGV4_SIGNED_HEADERS_CACHE_LENGTH ]; /**< @brief The signed headers list. */
+    size_t signedHeadersLen;                                  /**< @brief Length of pSignedHeaders, zero if the cache is empty. */
+} SigV4SignedHeadersCache_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief A presigned URL signature held by a #SigV4PresignCache_t.
+ */
+typedef struct SigV4PresignCacheEntry
+{
+    /**
+     * @brief Digest of the request the signature was generated for, covering
+     * everything that is signed except the X-Amz-Date query parameter.
+     */
+    uint8_t pRequestDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+    uint32_t lastUsed;                                     /**< @brief Value of the cache use counter when the entry was last used. */
+    uint32_t signingTime;                                  /**< @brief pSigningDate, in seconds since the Unix epoch. */
+    uint32_t expires;                                      /**< @brief The X-Amz-Expires query parameter of the request, in seconds. */
+    char pSigningDate[ SIGV4_ISO_STRING_LEN ];             /**< @brief The ISO 8601 date that the signature was generated for. */
+    char pSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ]; /**< @brief The hex-encoded signature. */
+    size_t signatureLen;                                   /**< @brief Length of pSignature, zero if the entry is empty. */
+} SigV4PresignCacheEntry_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief Application-owned cache of recently generated presigned URL
+ * signatures.
+ *
+ * Presigned URLs to popular objects are often handed out many times a minute,
+ * and each one is valid for X-Amz-Expires seconds. When a cache is supplied to
+ * #SigV4_GeneratePresignedSignature, a request that was signed earlier in the
+ * same time bucket reuses that signature, along with the date it was generated
+ * for, as long as at least minRemainingSeconds of its validity remain. Requests
+ * are looked up by a digest, computed with the crypto interface, of their
+ * method, path, query without X-Amz-Date, headers, flags and credential scope.
+ *
+ * @note The cache must be zero-initialized before first use, after which
+ * bucketSeconds and minRemainingSeconds are set by the application. It must be
+ * zeroed again if the secret access key associated with an access key ID
+ * changes. It is not thread-safe; use one cache per signing thread.
+ */
+typedef struct SigV4PresignCache
+{
+    /**
+     * @brief Length of the time buckets, in seconds since the Unix epoch. A
+     * signature is only reused within the bucket it was generated in. Zero
+     * disables the cache.
+     */
+    uint32_t bucketSeconds;
+
+    /**
+     * @brief The shortest validity, in seconds, that a reused signature must
+     * have left.
+     */
+    uint32_t minRemainingSeconds;
+
+    SigV4PresignCacheEntry_t entries[ SIGV4_PRESIGN_CACHE_ENTRY_COUNT ]; /**< @brief The cached signatures. */
+    uint32_t useCounter;                                                 /**< @brief Counter that orders the entries by last use. */
+} SigV4PresignCache_t;
+
 /**
  * @ingroup sigv4_struct_types
  * @brief Complete configurations required for generating "String to Sign" and
@@ -409,6 +901,11 @@ typedef struct SigV4Parameters
     /**
      * @brief The algorithm used for SigV4 authentication. If set to NULL,
      * this will automatically be set to "AWS4-HMAC-SHA256" by default.
+     *
+     * If set to #SIGV4_AWS4_ECDSA_P256_SHA256, the request is signed with
+     * SigV4A through pEcdsaInterface. The credential scope then leaves out the
+     * region, and the regions the signature is valid in are given by the
+     * application in the #SIGV4_HTTP_X_AMZ_REGION_SET_HEADER header.
      */
     const char * pAlgorithm;
 
@@ -417,7 +914,7 @@ typedef struct SigV4Parameters
     /**
      * @brief The target AWS region for the request. Please see
      * https://docs.aws.amazon.com/general/latest/gr/rande.html for a list of
-     * region names and codes.
+     * region names and codes. It is not used by SigV4A, and may be NULL then.
      */
     const char * pRegion;
     size_t regionLen; /**< @brief Length of pRegion. */
@@ -441,8 +938,144 @@ typedef struct SigV4Parameters
      * @brief HTTP specific SigV4 parameters for canonical request calculation.
      */
     SigV4HttpParameters_t * pHttpParameters;
+
+    /**
+     * @brief Optional cache of the signing key derived for the most recent
+     * credential scope. If set to NULL, the signing key is derived on every
+     * call.
+     */
+    SigV4SigningKeyCache_t * pSigningKeyCache;
+
+    /**
+     * @brief Optional cache of the canonical form of recently signed paths.
+     * If set to NULL, the path is encoded on every call. It is not used when
+     * #SIGV4_HTTP_PATH_IS_CANONICAL_FLAG is set.
+     */
+    SigV4PathCache_t * pPathCache;
+
+    /**
+     * @brief Optional cache of the sort order and signed headers list of the
+     * most recently signed set of header names. If set to NULL, the headers
+     * are sorted on every call.
+     */
+    SigV4SignedHeadersCache_t * pSignedHeadersCache;
+
+    /**
+     * @brief The ECDSA interface, required by SigV4A and not used otherwise.
+     */
+    SigV4EcdsaInterface_t * pEcdsaInterface;
+
+    /**
+     * @brief Optional record of the credentials whose SigV4A private key is
+     * imported in pEcdsaInterface. If set to NULL, the key is derived and
+     * imported on every call.
+     */
+    SigV4EcdsaKeyCache_t * pEcdsaKeyCache;
+
+    /**
+     * @brief Optional credential scope and Authorization header prefix
+     * computed ahead of signing. If set to NULL, they are built from
+     * pRegion, pService and pAlgorithm on every call.
+     */
+    const SigV4PrecomputedScope_t * pPrecomputedScope;
 } SigV4Parameters_t;
 
+/**
+ * @ingroup sigv4_struct_types
+ * @brief The credentials and output buffer of one Authorization header value
+ * generated by #SigV4_GenerateHTTPAuthorizations.
+ */
+typedef struct SigV4Authorization
+{
+    SigV4Credentials_t * pCredentials; /**< @brief The credentials to sign the request with. */
+
+    /**
+     * @brief Optional cache of the signing key of pCredentials. If set to NULL,
+     * the signing key is derived on every call.
+     */
+    SigV4SigningKeyCache_t * pSigningKeyCache;
+
+    char * pAuthBuf; /**< @brief Buffer to hold the generated Authorization header value. */
+
+    /**
+     * @brief Input: the length of pAuthBuf, output: the length of the
+     * Authorization header value written to the buffer.
+     */
+    size_t authBufLen;
+
+    char * pSignature;   /**< @brief Output: location of the signature in pAuthBuf. */
+    size_t signatureLen; /**< @brief Output: length of pSignature. */
+} SigV4Authorization_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief A canonical query string that is kept sorted and encoded while query
+ * parameters are set and removed one at a time.
+ *
+ * Requests that are repeated with a single parameter changing, such as
+ * pagination with a continuation token, then only encode the changed parameter
+ * instead of parsing, sorting and encoding the whole query for every request.
+ * Initialize with #SigV4_InitQueryBuilder, and pass pQuery and queryLen to
+ * #SigV4HttpParameters_t along with #SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG.
+ *
+ * @note Parameters are sorted by their encoded names, as the SigV4
+ * specification requires, and each name appears at most once.
+ */
+typedef struct SigV4QueryBuilder
+{
+    /**
+     * @brief The canonical query string, stored in the buffer given to
+     * #SigV4_InitQueryBuilder.
+     */
+    char * pQuery;
+    size_t queryLen;  /**< @brief Length of the canonical query in pQuery. */
+    size_t bufferLen; /**< @brief Size of the buffer pointed to by pQuery. */
+
+    /**
+     * @brief Whether '=' characters in parameter values are double-encoded,
+     * which is the case unless the query belongs to a presigned URL.
+     */
+    bool doubleEncodeEquals;
+} SigV4QueryBuilder_t;
+
+/**
+ * @ingroup sigv4_struct_types
+ * @brief State of a request signed with the push-style signer, which takes
+ * the parts of the request as they become available.
+ *
+ * The parts are pushed in the order in which they appear in the canonical
+ * request: the method, the path, the query parameters, the headers, and the
+ * payload. Each part may be pushed in any number of calls, and pushing a part
+ * closes the parts before it. The path and query parameters are canonicalized
+ * as they are pushed, the headers are copied, and the payload is hashed, all
+ * into the buffer given to #SigV4_InitSigner and the hash context, so pushed
+ * data does not need to remain valid after the call that pushes it.
+ *
+ * A call rejected with #SigV4InvalidParameter leaves the signer unchanged. Any
+ * other error loses a part of the request, so the signer fails: every later
+ * push and #SigV4_SignerFinish returns that first error.
+ *
+ * @note The members are managed by the library and must not be changed by the
+ * application.
+ */
+typedef struct SigV4Signer
+{
+    const SigV4Parameters_t * pParams; /**< @brief The parameters given to #SigV4_InitSigner. */
+    char * pBuffer;                    /**< @brief Holds the method, the canonical path, the canonical query, and the headers, in order. */
+    size_t bufferLen;                  /**< @brief Size of pBuffer. */
+    size_t bufferUsed;                 /**< @brief Length of the data in pBuffer, not counting the query while it is built. */
+    size_t methodLen;                  /**< @brief Length of the method at the start of pBuffer. */
+    size_t pathLen;                    /**< @brief Length of the canonical path after the method. */
+    SigV4QueryBuilder_t query;         /**< @brief The canonical query after the path. */
+
+    /**
+     * @brief The hex-encoded payload digest, once the last part is pushed.
+     */
+    char pPayloadDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    uint8_t state;        /**< @brief The part of the request being pushed. */
+    SigV4Status_t status; /**< @brief The first error of the signer, once it failed. */
+} SigV4Signer_t;
+
 /**
  * @brief Generates the HTTP Authorization header value.
  * @note The API does not support HTTP headers containing empty HTTP header keys or values.
@@ -507,6 +1140,231 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
                                                size_t * signatureLen );
 /* @[declare_sigV4_generateHTTPAuthorization_function] */
 
+/**
+ * @brief Generates the HTTP Authorization header values of one request for
+ * several sets of credentials.
+ *
+ * The canonical request, its hash and the string to sign only depend on the
+ * request and the credential scope, so they are computed once. Only the
+ * signing key, unless cached, and the final HMAC are computed for each set of
+ * credentials, which suits brokers that forward the same request on behalf of
+ * several accounts.
+ *
+ * @note The request must not carry per-credential headers, such as
+ * x-amz-security-token, since the canonical request is shared. SigV4A and
+ * presigned URLs, whose X-Amz-Credential query parameter names one access key
+ * ID, are not supported. #SigV4Parameters_t.pCredentials and
+ * #SigV4Parameters_t.pSigningKeyCache of @p pParams are not used; each
+ * #SigV4Authorization_t names its own.
+ *
+ * @param[in] pParams Parameters for generating the SigV4 signature.
+ * @param[in, out] pAuthorizations The credentials and output buffers, one per
+ * Authorization header value.
+ * @param[in] authorizationCount The number of entries of @p pAuthorizations.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if a parameter
+ * is NULL, @p authorizationCount is zero, the algorithm is SigV4A or
+ * #SIGV4_HTTP_IS_PRESIGNED_URL is set, error code
+ * of #SigV4_GenerateHTTPAuthorization otherwise. On error, the entries of
+ * @p pAuthorizations may be partially written.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * SigV4Authorization_t pAuthorizations[ 2 ] = { 0 };
+ * char pAuthBufs[ 2 ][ 512U ];
+ * size_t i;
+ *
+ * for( i = 0U; i < 2U; i++ )
+ * {
+ *     pAuthorizations[ i ].pCredentials = &pTenantCredentials[ i ];
+ *     pAuthorizations[ i ].pSigningKeyCache = &pTenantSigningKeyCaches[ i ];
+ *     pAuthorizations[ i ].pAuthBuf = pAuthBufs[ i ];
+ *     pAuthorizations[ i ].authBufLen = sizeof( pAuthBufs[ i ] );
+ * }
+ *
+ * status = SigV4_GenerateHTTPAuthorizations( &sigv4Params, pAuthorizations, 2U );
+ *
+ * // Forward the request of tenant i with pAuthorizations[ i ].pAuthBuf, of
+ * // pAuthorizations[ i ].authBufLen characters, as its Authorization header.
+ * @endcode
+ */
+/* @[declare_sigV4_generateHTTPAuthorizations_function] */
+SigV4Status_t SigV4_GenerateHTTPAuthorizations( const SigV4Parameters_t * pParams,
+                                                SigV4Authorization_t * pAuthorizations,
+                                                size_t authorizationCount );
+/* @[declare_sigV4_generateHTTPAuthorizations_function] */
+
+/**
+ * @brief Generates the HTTP Authorization header value as a list of segments,
+ * so that it can be sent with scatter-gather I/O without being assembled.
+ *
+ * The segments, in order, make up the same value as the one written by
+ * #SigV4_GenerateHTTPAuthorization. They point to the algorithm, the access
+ * key ID, the date, the region and the service in @p pParams, to constant
+ * strings of the library, and to @p pBuf, which receives the signed headers
+ * list followed by the hex-encoded signature. @p pParams and the data it
+ * points to must therefore remain valid and unchanged while the segments are
+ * in use. With SigV4A, the region segment and the separator after it are
+ * empty. With #SigV4Parameters_t.pPrecomputedScope, the segments point to its
+ * Authorization prefix and scope suffix instead, and those they replace are
+ * empty.
+ *
+ * @note The API does not support HTTP headers containing empty HTTP header keys or values.
+ *
+ * @param[in] pParams Parameters for generating the SigV4 signature.
+ * @param[out] pIov Segments of the Authorization header value.
+ * @param[in, out] pIovCount Input: the number of entries of @p pIov, which
+ * must be at least #SIGV4_AUTHORIZATION_IOVEC_COUNT. Output: the number of
+ * segments written to @p pIov.
+ * @param[out] pBuf Buffer to hold the signed headers list and the signature.
+ * The signature is the last segment written to @p pIov.
+ * @param[in] bufLen The length of @p pBuf, which must be at least the length
+ * of the signed headers list plus twice the digest length, or plus twice
+ * #SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH with SigV4A.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * SigV4IoVec_t authIov[ SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+ * size_t authIovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+ * char signedHeadersAndSignature[ 256U ];
+ * struct iovec requestIov[ 2U + SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+ *
+ * status = SigV4_GenerateHTTPAuthorizationIov( &sigv4Params, authIov, &authIovCount,
+ *                                              signedHeadersAndSignature,
+ *                                              sizeof( signedHeadersAndSignature ) );
+ *
+ * // requestIov[ 0 ] ends with "Authorization: ", and the segments follow it.
+ * for( i = 0U; i < authIovCount; i++ )
+ * {
+ *     requestIov[ i + 1U ].iov_base = ( void * ) authIov[ i ].pData;
+ *     requestIov[ i + 1U ].iov_len = authIov[ i ].dataLen;
+ * }
+ * @endcode
+ */
+/* @[declare_sigV4_generateHTTPAuthorizationIov_function] */
+SigV4Status_t SigV4_GenerateHTTPAuthorizationIov( const SigV4Parameters_t * pParams,
+                                                  SigV4IoVec_t * pIov,
+                                                  size_t * pIovCount,
+                                                  char * pBuf,
+                                                  size_t bufLen );
+/* @[declare_sigV4_generateHTTPAuthorizationIov_function] */
+
+/**
+ * @brief Generates the HTTP Authorization header value of a raw HTTP/1.1
+ * request, i.e. a buffer holding the request line, the header block, the empty
+ * line and the body.
+ *
+ * The request is signed in place: the method, path, query, headers and
+ * payload are taken from @p pRequest without being copied, and are signed as
+ * if they were given to #SigV4_GenerateHTTPAuthorization. An absolute-form
+ * request target, as sent to proxies, is signed by its path. The payload is
+ * everything after the empty line that ends the header block.
+ *
+ * @note The API does not support HTTP headers containing empty HTTP header keys or values.
+ *
+ * @param[in] pParams Parameters for generating the SigV4 signature. Its
+ * pHttpParameters member may be NULL; otherwise only its flags are used.
+ * @param[in] pRequest The raw HTTP request.
+ * @param[in] requestLen The length of @p pRequest.
+ * @param[out] pAuthBuf Buffer to hold the generated Authorization header value.
+ * @param[in, out] authBufLen Input: the length of @p pAuthBuf, output: the length
+ * of the authorization value written to the buffer. The signature is the last
+ * twice-the-digest-length characters of the value, or everything after
+ * "Signature=" with SigV4A.
+ * @param[out] pAuthInsertIndex The index in @p pRequest of the empty line that
+ * ends the header block, which is where the "Authorization: <value>\r\n"
+ * header line is to be inserted.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if the request
+ * line is malformed, #SigV4InvalidHttpHeaders if the header block is empty or
+ * not terminated, error code of #SigV4_GenerateHTTPAuthorization otherwise.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * // pRequest holds "GET /path?a=b HTTP/1.1\r\nHost: example.com\r\n...\r\n\r\n<body>".
+ * status = SigV4_SignRawHttpRequest( &sigv4Params, pRequest, requestLen,
+ *                                    pSigv4Auth, &sigv4AuthLen, &insertIndex );
+ *
+ * // Send pRequest[ 0 : insertIndex ], "Authorization: ", pSigv4Auth, "\r\n",
+ * // then pRequest[ insertIndex : requestLen ].
+ * @endcode
+ */
+/* @[declare_sigV4_signRawHttpRequest_function] */
+SigV4Status_t SigV4_SignRawHttpRequest( const SigV4Parameters_t * pParams,
+                                        const char * pRequest,
+                                        size_t requestLen,
+                                        char * pAuthBuf,
+                                        size_t * authBufLen,
+                                        size_t * pAuthInsertIndex );
+/* @[declare_sigV4_signRawHttpRequest_function] */
+
+/**
+ * @brief Generates the signature of a presigned URL, reusing one from a
+ * #SigV4PresignCache_t when the same request was signed recently.
+ *
+ * The query of the request must hold the presigned URL parameters:
+ * X-Amz-Algorithm, X-Amz-Credential, X-Amz-Date, X-Amz-Expires and
+ * X-Amz-SignedHeaders, with X-Amz-Date equal to
+ * #SigV4Parameters_t.pDateIso8601, but not X-Amz-Signature. The
+ * #SIGV4_HTTP_IS_PRESIGNED_URL flag must be set.
+ *
+ * A cached signature is reused when the request matches the one it was
+ * generated for in everything but X-Amz-Date, when
+ * #SigV4Parameters_t.pDateIso8601 falls in the same bucket of
+ * #SigV4PresignCache_t.bucketSeconds as the date it was generated for, and
+ * when at least #SigV4PresignCache_t.minRemainingSeconds of its X-Amz-Expires
+ * remain. Otherwise, the request is signed and the signature is cached. The
+ * cache is not used for queries without a decimal X-Amz-Expires, or for
+ * requests with wrapped query or headers.
+ *
+ * @note A reused signature is only valid with the date it was generated for,
+ * which is written to @p pSigningDate. The X-Amz-Date parameter of the URL
+ * handed out must be set to that date.
+ *
+ * @param[in] pParams Parameters for generating the SigV4 signature.
+ * @param[in, out] pPresignCache Optional cache of presigned URL signatures;
+ * may be NULL.
+ * @param[out] pSignature Buffer to hold the hex-encoded signature.
+ * @param[in, out] pSignatureLen Input: the length of @p pSignature, which must
+ * be at least twice the digest length, or #SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH
+ * times two with SigV4A. Output: the length of the signature.
+ * @param[out] pSigningDate Buffer of #SIGV4_ISO_STRING_LEN characters to hold
+ * the ISO 8601 date that the signature is valid with.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if a parameter
+ * is NULL or the request is not a presigned URL, #SigV4InsufficientMemory if
+ * @p pSignature is too short, error code of #SigV4_GenerateHTTPAuthorization
+ * otherwise.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * static SigV4PresignCache_t presignCache = { 0 };
+ * char pSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ];
+ * size_t signatureLen = sizeof( pSignature );
+ * char pSigningDate[ SIGV4_ISO_STRING_LEN ];
+ *
+ * presignCache.bucketSeconds = 300U;
+ * presignCache.minRemainingSeconds = 600U;
+ *
+ * // The query holds "...&X-Amz-Date=<pDateIso8601>&X-Amz-Expires=3600&...".
+ * status = SigV4_GeneratePresignedSignature( &sigv4Params, &presignCache,
+ *                                            pSignature, &signatureLen,
+ *                                            pSigningDate );
+ *
+ * // Hand out the URL with X-Amz-Date set to pSigningDate, and with
+ * // "&X-Amz-Signature=" followed by pSignature appended.
+ * @endcode
+ */
+/* @[declare_sigV4_generatePresignedSignature_function] */
+SigV4Status_t SigV4_GeneratePresignedSignature( const SigV4Parameters_t * pParams,
+                                                SigV4PresignCache_t * pPresignCache,
+                                                char * pSignature,
+                                                size_t * pSignatureLen,
+                                                char * pSigningDate );
+/* @[declare_sigV4_generatePresignedSignature_function] */
+
 /**
  * @brief Parse the date header value from the AWS IoT response, and generate
  * the formatted ISO 8601 date required for authentication.
@@ -577,6 +1435,74 @@ SigV4Status_t SigV4_AwsIotDateToIso8601( const char * pDate,
                                          size_t dateISO8601Len );
 /* @[declare_sigV4_awsIotDateToIso8601_function] */
 
+/**
+ * @brief Hash an HTTP request payload and hex-encode the digest, as expected in
+ * #SigV4HttpParameters_t.pPayload with the #SIGV4_HTTP_PAYLOAD_IS_DIGEST flag.
+ *
+ * This function only uses @p pCryptoInterface and the buffers passed to it, so
+ * it can run on a different thread than #SigV4_GenerateHTTPAuthorization, as
+ * long as the two calls do not share a hash context.
+ *
+ * @param[in] pCryptoInterface The hash implementation.
+ * @param[in] pPayload The HTTP request payload; may be NULL if @p payloadLen is 0.
+ * @param[in] payloadLen Length of @p pPayload.
+ * @param[out] pHexDigest Buffer to write the hex-encoded digest to.
+ * @param[in, out] pHexDigestLen Input: the length of @p pHexDigest, which must
+ * be at least twice the digest length. Output: the length of the hex-encoded
+ * digest.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if a parameter is
+ * invalid, #SigV4InsufficientMemory if @p pHexDigest is too small, or
+ * #SigV4HashError if a hash operation failed.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * char payloadHash[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+ * size_t payloadHashLen = sizeof( payloadHash );
+ *
+ * // On a worker thread, with its own hash context:
+ * status = SigV4_HashPayload( &workerCryptoInterface, pBody, bodyLen,
+ *                             payloadHash, &payloadHashLen );
+ *
+ * // When signing:
+ * httpParams.flags |= SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+ * httpParams.pPayload = payloadHash;
+ * httpParams.payloadLen = payloadHashLen;
+ * @endcode
+ */
+/* @[declare_sigV4_hashPayload_function] */
+SigV4Status_t SigV4_HashPayload( const SigV4CryptoInterface_t * pCryptoInterface,
+                                 const char * pPayload,
+                                 size_t payloadLen,
+                                 char * pHexDigest,
+                                 size_t * pHexDigestLen );
+/* @[declare_sigV4_hashPayload_function] */
+
+/**
+ * @brief Finish a payload hash that the application fed incrementally, and
+ * hex-encode the digest as #SigV4_HashPayload does.
+ *
+ * This is for payloads that are not contiguous in memory, e.g. read from a
+ * file in blocks: the application calls #SigV4CryptoInterface_t.hashInit and
+ * #SigV4CryptoInterface_t.hashUpdate itself, then this function.
+ *
+ * @param[in] pCryptoInterface The hash implementation, whose hash context holds
+ * the payload hashed so far.
+ * @param[out] pHexDigest Buffer to write the hex-encoded digest to.
+ * @param[in, out] pHexDigestLen Input: the length of @p pHexDigest, which must
+ * be at least twice the digest length. Output: the length of the hex-encoded
+ * digest.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if a parameter is
+ * invalid, #SigV4InsufficientMemory if @p pHexDigest is too small, or
+ * #SigV4HashError if the hash operation failed.
+ */
+/* @[declare_sigV4_finishPayloadHash_function] */
+SigV4Status_t SigV4_FinishPayloadHash( const SigV4CryptoInterface_t * pCryptoInterface,
+                                       char * pHexDigest,
+                                       size_t * pHexDigestLen );
+/* @[declare_sigV4_finishPayloadHash_function] */
+
 #if ( SIGV4_USE_CANONICAL_SUPPORT == 1 )
 
 /**
@@ -602,6 +1528,258 @@ SigV4Status_t SigV4_AwsIotDateToIso8601( const char * pDate,
                                    bool doubleEncodeEquals );
 /* @[declare_sigV4_encodeURI_function] */
 
+/**
+ * @brief Initialize a #SigV4QueryBuilder_t with an empty canonical query.
+ *
+ * @param[out] pBuilder The query builder to initialize.
+ * @param[in] pBuffer Buffer that holds the canonical query. Besides the
+ * canonical query itself, it needs one spare byte, and room to encode the
+ * parameter being set or removed.
+ * @param[in] bufferLen Size of pBuffer.
+ * @param[in] doubleEncodeEquals Whether '=' characters in parameter values are
+ * double-encoded. Pass false for the query of a presigned URL.
+ *
+ * @return #SigV4Success code if successful, error code otherwise.
+ */
+/* @[declare_sigV4_initQueryBuilder_function] */
+    SigV4Status_t SigV4_InitQueryBuilder( SigV4QueryBuilder_t * pBuilder,
+                                          char * pBuffer,
+                                          size_t bufferLen,
+                                          bool doubleEncodeEquals );
+/* @[declare_sigV4_initQueryBuilder_function] */
+
+/**
+ * @brief Insert a query parameter into the canonical query of a
+ * #SigV4QueryBuilder_t, or replace the value of the parameter if it is already
+ * present. Only this parameter is encoded.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * char queryBuffer[ 256 ];
+ * SigV4QueryBuilder_t query;
+ *
+ * ( void ) SigV4_InitQueryBuilder( &query, queryBuffer, sizeof( queryBuffer ), true );
+ * ( void ) SigV4_SetQueryParameter( &query, "MaxItems", 8U, "100", 3U );
+ *
+ * do
+ * {
+ *     httpParams.pQuery = query.pQuery;
+ *     httpParams.queryLen = query.queryLen;
+ *     httpParams.flags |= SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+ *     // Sign and send the request, and read the next token from the response.
+ *     status = SigV4_SetQueryParameter( &query, "Marker", 6U, pMarker, markerLen );
+ * } while( ( status == SigV4Success ) && ( markerLen > 0U ) );
+ * @endcode
+ *
+ * @param[in, out] pBuilder The query builder.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey; must not be 0.
+ * @param[in] pValue The unencoded parameter value; may be NULL if valueLen is 0.
+ * @param[in] valueLen Length of pValue.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * encoded parameter does not fit in the buffer, or #SigV4InvalidParameter.
+ * The canonical query is left unchanged on failure.
+ */
+/* @[declare_sigV4_setQueryParameter_function] */
+    SigV4Status_t SigV4_SetQueryParameter( SigV4QueryBuilder_t * pBuilder,
+                                           const char * pKey,
+                                           size_t keyLen,
+                                           const char * pValue,
+                                           size_t valueLen );
+/* @[declare_sigV4_setQueryParameter_function] */
+
+/**
+ * @brief Remove a query parameter from the canonical query of a
+ * #SigV4QueryBuilder_t. Removing a parameter that is not present succeeds
+ * without changing the canonical query.
+ *
+ * @param[in, out] pBuilder The query builder.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey; must not be 0.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * encoded name does not fit in the buffer, or #SigV4InvalidParameter.
+ */
+/* @[declare_sigV4_removeQueryParameter_function] */
+    SigV4Status_t SigV4_RemoveQueryParameter( SigV4QueryBuilder_t * pBuilder,
+                                              const char * pKey,
+                                              size_t keyLen );
+/* @[declare_sigV4_removeQueryParameter_function] */
+
+/**
+ * @brief Initialize a #SigV4Signer_t to sign a request pushed in parts.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * char signerBuffer[ 512 ];
+ * SigV4Signer_t signer;
+ *
+ * // The HTTP parameters of sigv4Params are only used for their flags, and may be NULL.
+ * status = SigV4_InitSigner( &signer, &sigv4Params, signerBuffer, sizeof( signerBuffer ) );
+ * ( void ) SigV4_SignerPushMethod( &signer, "PUT", 3U );
+ * ( void ) SigV4_SignerPushPath( &signer, "/bucket/", 8U );
+ * ( void ) SigV4_SignerPushPath( &signer, pKey, keyLen );
+ * ( void ) SigV4_SignerPushHeader( &signer, "Host", 4U, pHost, hostLen );
+ * ( void ) SigV4_SignerPushHeader( &signer, "X-Amz-Date", 10U, pDate, SIGV4_ISO_STRING_LEN );
+ *
+ * while( readBody( &pChunk, &chunkLen ) )
+ * {
+ *     ( void ) SigV4_SignerPushPayload( &signer, pChunk, chunkLen );
+ * }
+ *
+ * status = SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen );
+ * @endcode
+ *
+ * @param[out] pSigner The signer to initialize.
+ * @param[in] pParams Parameters for generating the SigV4 signature; they must
+ * remain valid until the request is signed. Only the flags of
+ * #SigV4Parameters_t.pHttpParameters are used, if it is not NULL.
+ * @param[in] pBuffer Buffer that holds the method, the canonical path, the
+ * canonical query with room to encode the parameter being pushed, and the
+ * headers.
+ * @param[in] bufferLen Size of pBuffer.
+ *
+ * @return #SigV4Success code if successful, #SigV4InvalidParameter otherwise.
+ *
+ * @note The hash context of the crypto interface in @p pParams is used from the
+ * first pushed payload fragment until the request is signed, so it must not be
+ * used for anything else in between.
+ */
+/* @[declare_sigV4_initSigner_function] */
+    SigV4Status_t SigV4_InitSigner( SigV4Signer_t * pSigner,
+                                    const SigV4Parameters_t * pParams,
+                                    char * pBuffer,
+                                    size_t bufferLen );
+/* @[declare_sigV4_initSigner_function] */
+
+/**
+ * @brief Push the HTTP method, or the next part of it, to a #SigV4Signer_t.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] pMethod The method, or the next part of it.
+ * @param[in] methodLen Length of pMethod.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * signer buffer is full, or #SigV4InvalidParameter, including when a later
+ * part of the request was already pushed.
+ */
+/* @[declare_sigV4_signerPushMethod_function] */
+    SigV4Status_t SigV4_SignerPushMethod( SigV4Signer_t * pSigner,
+                                          const char * pMethod,
+                                          size_t methodLen );
+/* @[declare_sigV4_signerPushMethod_function] */
+
+/**
+ * @brief Push the path of the request, or the next part of it, to a
+ * #SigV4Signer_t, which URI-encodes it right away.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] pPath The unencoded path, or the next part of it.
+ * @param[in] pathLen Length of pPath.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * encoded path does not fit in the signer buffer, or #SigV4InvalidParameter,
+ * including when the method was not pushed yet or when a later part of the
+ * request was already pushed.
+ */
+/* @[declare_sigV4_signerPushPath_function] */
+    SigV4Status_t SigV4_SignerPushPath( SigV4Signer_t * pSigner,
+                                        const char * pPath,
+                                        size_t pathLen );
+/* @[declare_sigV4_signerPushPath_function] */
+
+/**
+ * @brief Push a query parameter to a #SigV4Signer_t, which encodes it and
+ * inserts it in sorted position right away, like #SigV4_SetQueryParameter.
+ *
+ * Unlike #SigV4_SetQueryParameter, pushing a name again does not replace its
+ * value: every value is signed, sorted by value, as the request sends them all.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey; must not be 0.
+ * @param[in] pValue The unencoded parameter value; may be NULL if valueLen is 0.
+ * @param[in] valueLen Length of pValue.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * encoded parameter does not fit in the signer buffer, or
+ * #SigV4InvalidParameter, including when the method was not pushed yet or when
+ * a later part of the request was already pushed.
+ */
+/* @[declare_sigV4_signerPushQueryParameter_function] */
+    SigV4Status_t SigV4_SignerPushQueryParameter( SigV4Signer_t * pSigner,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen );
+/* @[declare_sigV4_signerPushQueryParameter_function] */
+
+/**
+ * @brief Push an HTTP header to a #SigV4Signer_t.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] pName The header name.
+ * @param[in] nameLen Length of pName; must not be 0.
+ * @param[in] pValue The header value.
+ * @param[in] valueLen Length of pValue; must not be 0.
+ *
+ * @return #SigV4Success code if successful, #SigV4InsufficientMemory if the
+ * header does not fit in the signer buffer, or #SigV4InvalidParameter,
+ * including when the method was not pushed yet or when the payload was already
+ * pushed.
+ */
+/* @[declare_sigV4_signerPushHeader_function] */
+    SigV4Status_t SigV4_SignerPushHeader( SigV4Signer_t * pSigner,
+                                          const char * pName,
+                                          size_t nameLen,
+                                          const char * pValue,
+                                          size_t valueLen );
+/* @[declare_sigV4_signerPushHeader_function] */
+
+/**
+ * @brief Push the next fragment of the payload to a #SigV4Signer_t, which
+ * hashes it right away.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] pPayload The payload fragment; may be NULL if payloadLen is 0.
+ * @param[in] payloadLen Length of pPayload.
+ *
+ * @return #SigV4Success code if successful, #SigV4HashError if a hash
+ * operation failed, or #SigV4InvalidParameter, including when the method was
+ * not pushed yet or when the request was already signed.
+ */
+/* @[declare_sigV4_signerPushPayload_function] */
+    SigV4Status_t SigV4_SignerPushPayload( SigV4Signer_t * pSigner,
+                                           const char * pPayload,
+                                           size_t payloadLen );
+/* @[declare_sigV4_signerPushPayload_function] */
+
+/**
+ * @brief Sign the request pushed to a #SigV4Signer_t, producing the same
+ * output as #SigV4_GenerateHTTPAuthorization.
+ *
+ * Once this is called, nothing more can be pushed, but it may be called again,
+ * e.g. with a larger @p pAuthBuf. An error in signing the complete request does
+ * not fail the signer, but an error in finishing the payload digest does.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[out] pAuthBuf Buffer to hold the generated Authorization header value.
+ * @param[in, out] authBufLen Input: the length of @p pAuthBuf, output: the length
+ * of the authorization value written to the buffer.
+ * @param[out] pSignature Location of the signature in the authorization string.
+ * @param[out] signatureLen The length of @p pSignature.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+/* @[declare_sigV4_signerFinish_function] */
+    SigV4Status_t SigV4_SignerFinish( SigV4Signer_t * pSigner,
+                                      char * pAuthBuf,
+                                      size_t * authBufLen,
+                                      char ** pSignature,
+                                      size_t * signatureLen );
+/* @[declare_sigV4_signerFinish_function] */
+
 #endif /* #if (SIGV4_USE_CANONICAL_SUPPORT == 1) */
 
 /* *INDENT-OFF* */
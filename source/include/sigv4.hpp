@@ -0,0 +1,778 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4.hpp
+ * @brief Optional header-only C++17 interface for the SigV4 Library.
+ *
+ * The interface wraps #SigV4_GenerateHTTPAuthorization without allocating:
+ * inputs are taken as views, HTTP headers are serialized into a workspace
+ * owned by the signer, and results are returned as views into that workspace.
+ */
+
+#ifndef SIGV4_HPP_
+#define SIGV4_HPP_
+
+/* Standard includes. */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+
+#if defined( __has_include )
+    #if __has_include( <span> ) && ( __cplusplus > 201703L )
+        #include <span>
+    #endif
+#endif
+
+/* Include the C interface. */
+#include "sigv4.h"
+
+namespace sigv4
+{
+    #if defined( __cpp_lib_span )
+
+        /**
+         * @brief Contiguous view type used for array inputs.
+         */
+        template< typename T >
+        using Span = std::span< T >;
+
+    #else
+
+        /**
+         * @brief Minimal stand-in for std::span on C++17 toolchains.
+         */
+        template< typename T >
+        class Span
+        {
+        public:
+            constexpr Span() noexcept = default;
+
+            constexpr Span( T * pData,
+                            std::size_t size ) noexcept : pData_( pData ), size_( size )
+            {
+            }
+
+            template< typename Container >
+            constexpr Span( Container & container ) noexcept : pData_( std::data( container ) ), size_( std::size( container ) )
+            {
+            }
+
+            constexpr T * data() const noexcept
+            {
+                return pData_;
+            }
+
+            constexpr std::size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            constexpr bool empty() const noexcept
+            {
+                return size_ == 0U;
+            }
+
+            constexpr T & operator[]( std::size_t index ) const noexcept
+            {
+                return pData_[ index ];
+            }
+
+            constexpr T * begin() const noexcept
+            {
+                return pData_;
+            }
+
+            constexpr T * end() const noexcept
+            {
+                return pData_ + size_;
+            }
+
+        private:
+            T * pData_ = nullptr;
+            std::size_t size_ = 0U;
+        };
+
+    #endif /* if defined( __cpp_lib_span ) */
+
+    /**
+     * @brief A single HTTP header to sign.
+     */
+    struct Header
+    {
+        std::string_view name;  /**< @brief Header name, e.g. "Host". */
+        std::string_view value; /**< @brief Header value. */
+    };
+
+    /**
+     * @brief The AWS credentials used to derive the signing key.
+     */
+    struct Credentials
+    {
+        std::string_view accessKeyId;     /**< @brief The access key ID. */
+        std::string_view secretAccessKey; /**< @brief The secret access key. */
+    };
+
+    /**
+     * @brief The HTTP request to sign.
+     *
+     * Equivalent of #SigV4HttpParameters_t, with the raw header blob replaced by
+     * a list of #Header entries.
+     */
+    struct Request
+    {
+        std::string_view method;         /**< @brief The HTTP method: GET, POST, PUT, etc. */
+        std::string_view path;           /**< @brief The absolute request path, may be empty. */
+        std::string_view query;          /**< @brief The query string without the leading '?', may be empty. */
+        Span< const Header > headers;    /**< @brief The headers to sign; must not be empty. */
+        std::string_view payload;        /**< @brief The request payload, may be empty. */
+        std::uint32_t flags = 0U;        /**< @brief SIGV4_HTTP_*_FLAG values, see #SigV4HttpParameters_t.flags. */
+    };
+
+    /**
+     * @brief The outcome of a signing operation.
+     *
+     * @note The views refer to memory owned by the signer that produced them, and
+     * stay valid until the next call to sign() on that signer, or until the
+     * signer is moved or destroyed.
+     */
+    struct Authorization
+    {
+        SigV4Status_t status = SigV4InvalidParameter; /**< @brief Status returned by the library. */
+        std::string_view value;                       /**< @brief The Authorization header value. */
+        std::string_view signature;                   /**< @brief The signature within @ref value. */
+
+        /**
+         * @brief Whether the request was signed successfully.
+         */
+        explicit operator bool() const noexcept
+        {
+            return status == SigV4Success;
+        }
+    };
+
+    /**
+     * @brief The hex-encoded hash of an HTTP request payload, computed ahead of
+     * signing.
+     */
+    struct PayloadDigest
+    {
+        SigV4Status_t status = SigV4InvalidParameter;                  /**< @brief Status returned by #SigV4_HashPayload. */
+        std::array< char, SIGV4_HASH_MAX_DIGEST_LENGTH * 2U > hex {}; /**< @brief The hex-encoded digest. */
+        std::size_t length = 0U;                                       /**< @brief Length of the digest in @ref hex. */
+
+        /**
+         * @brief View of the hex-encoded digest.
+         */
+        std::string_view view() const noexcept
+        {
+            return std::string_view( hex.data(), length );
+        }
+
+        /**
+         * @brief Whether the payload was hashed successfully.
+         */
+        explicit operator bool() const noexcept
+        {
+            return status == SigV4Success;
+        }
+    };
+
+    /**
+     * @brief Hash an HTTP request payload with #SigV4_HashPayload.
+     *
+     * This can run on a different thread than the signer, provided
+     * @p cryptoInterface points to a hash context that is not used by the signer.
+     *
+     * @param[in] cryptoInterface The hash implementation.
+     * @param[in] payload The HTTP request payload.
+     *
+     * @return The hex-encoded digest of @p payload.
+     */
+    inline PayloadDigest hashPayload( const SigV4CryptoInterface_t & cryptoInterface,
+                                      std::string_view payload ) noexcept
+    {
+        PayloadDigest digest;
+
+        digest.length = digest.hex.size();
+        digest.status = SigV4_HashPayload( &cryptoInterface,
+                                           payload.data(),
+                                           payload.size(),
+                                           digest.hex.data(),
+                                           &digest.length );
+
+        if( digest.status != SigV4Success )
+        {
+            digest.length = 0U;
+        }
+
+        return digest;
+    }
+
+    /**
+     * @brief Reusable, move-only signer for a fixed credential scope.
+     *
+     * A signer owns the workspace into which headers are serialized, the buffer
+     * holding the Authorization header value, a #SigV4SigningKeyCache_t, a
+     * #SigV4PathCache_t and a #SigV4SignedHeadersCache_t, so signing a request
+     * does not allocate, the signing key is only derived once per day, recently
+     * signed paths are not encoded again, and requests with the same header
+     * names are not sorted again.
+     *
+     * The credentials, region and service are stored as views and must outlive
+     * the signer. A signer is not thread-safe; use one signer per thread.
+     *
+     * @tparam HeaderBufferLength Size of the workspace for serialized headers.
+     * @tparam AuthBufferLength Size of the Authorization header value buffer.
+     */
+    template< std::size_t HeaderBufferLength,
+              std::size_t AuthBufferLength >
+    class BasicSigner
+    {
+    public:
+
+        /**
+         * @brief Create a signer.
+         *
+         * @param[in] cryptoInterface The hash implementation. It is copied, but the
+         * hash context it points to must outlive the signer.
+         * @param[in] credentials The AWS credentials.
+         * @param[in] region The target AWS region.
+         * @param[in] service The target AWS service.
+         * @param[in] algorithm The signing algorithm; if empty, "AWS4-HMAC-SHA256"
+         * is used.
+         */
+        BasicSigner( const SigV4CryptoInterface_t & cryptoInterface,
+                     Credentials credentials,
+                     std::string_view region,
+                     std::string_view service,
+                     std::string_view algorithm = std::string_view() ) noexcept
+            : cryptoInterface_( cryptoInterface ),
+            credentials_( credentials ),
+            region_( region ),
+            service_( service ),
+            algorithm_( algorithm )
+        {
+        }
+
+        /**
+         * @brief Create a signer whose credential scope, Authorization prefix
+         * and S3 decision were computed ahead of signing.
+         *
+         * @param[in] cryptoInterface The hash implementation.
+         * @param[in] credentials The AWS credentials.
+         * @param[in] region The target AWS region.
+         * @param[in] service The target AWS service.
+         * @param[in] algorithm The signing algorithm.
+         * @param[in] precomputedScope The parts of the scope for @p region,
+         * @p service and @p algorithm. It must outlive the signer.
+         */
+        BasicSigner( const SigV4CryptoInterface_t & cryptoInterface,
+                     Credentials credentials,
+                     std::string_view region,
+                     std::string_view service,
+                     std::string_view algorithm,
+                     const SigV4PrecomputedScope_t & precomputedScope ) noexcept
+            : cryptoInterface_( cryptoInterface ),
+            credentials_( credentials ),
+            region_( region ),
+            service_( service ),
+            algorithm_( algorithm ),
+            pPrecomputedScope_( &precomputedScope )
+        {
+        }
+
+        BasicSigner( const BasicSigner & ) = delete;
+        BasicSigner & operator=( const BasicSigner & ) = delete;
+        BasicSigner( BasicSigner && ) noexcept = default;
+        BasicSigner & operator=( BasicSigner && ) noexcept = default;
+        ~BasicSigner() = default;
+
+        /**
+         * @brief Sign an HTTP request.
+         *
+         * @param[in] request The HTTP request to sign.
+         * @param[in] dateIso8601 The request date in ISO 8601 format, e.g.
+         * "20150830T123600Z"; the same value must be sent in the X-Amz-Date header.
+         *
+         * @return The Authorization header value on success. #SigV4InsufficientMemory
+         * is reported if the headers do not fit in the workspace, and
+         * #SigV4InvalidHttpHeaders if a header name contains ':'.
+         */
+        Authorization sign( const Request & request,
+                            std::string_view dateIso8601 ) noexcept
+        {
+            return signWithExtraHeader( request, dateIso8601, nullptr );
+        }
+
+        /**
+         * @brief Sign an HTTP request whose payload was hashed ahead of time,
+         * e.g. with hashPayload() on a worker thread.
+         *
+         * @param[in] request The HTTP request to sign; its payload is ignored.
+         * @param[in] dateIso8601 The request date in ISO 8601 format.
+         * @param[in] payloadDigest The hex-encoded digest of the payload.
+         * @param[in] addContentSha256Header Whether to sign an
+         * "x-amz-content-sha256" header holding the digest, as S3 requires. The
+         * application must send the same header. Not supported together with
+         * #SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG, as the header would have to be
+         * inserted in sorted order.
+         *
+         * @return The Authorization header value on success, or the status of
+         * @p payloadDigest if hashing the payload failed.
+         */
+        Authorization sign( const Request & request,
+                            std::string_view dateIso8601,
+                            const PayloadDigest & payloadDigest,
+                            bool addContentSha256Header = false ) noexcept
+        {
+            Authorization result;
+            Request digestRequest = request;
+            const Header contentSha256Header = { SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER, payloadDigest.view() };
+
+            if( !payloadDigest )
+            {
+                result.status = payloadDigest.status;
+            }
+            else if( addContentSha256Header &&
+                     ( ( request.flags & SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG ) != 0U ) )
+            {
+                result.status = SigV4InvalidParameter;
+            }
+            else
+            {
+                digestRequest.payload = payloadDigest.view();
+                digestRequest.flags |= SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+                result = signWithExtraHeader( digestRequest,
+                                              dateIso8601,
+                                              addContentSha256Header ? &contentSha256Header : nullptr );
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Discard the cached signing key, e.g. to clear it from memory
+         * once the credentials are no longer used. A rotated secret access key
+         * derives a new key without it.
+         */
+        void invalidateSigningKey() noexcept
+        {
+            signingKeyCache_ = SigV4SigningKeyCache_t {};
+        }
+
+    private:
+
+        /**
+         * @brief Sign @p request, with @p pExtraHeader appended to its headers if
+         * it is not NULL.
+         */
+        Authorization signWithExtraHeader( const Request & request,
+                                           std::string_view dateIso8601,
+                                           const Header * pExtraHeader ) noexcept
+        {
+            Authorization result;
+            SigV4Credentials_t credentials = {};
+            SigV4HttpParameters_t httpParams = {};
+            SigV4Parameters_t params = {};
+            std::size_t headersLen = 0U;
+            std::size_t authLen = authBuffer_.size();
+            char * pSignature = nullptr;
+            std::size_t signatureLen = 0U;
+
+            if( dateIso8601.size() != SIGV4_ISO_STRING_LEN )
+            {
+                result.status = SigV4InvalidParameter;
+            }
+            else
+            {
+                result.status = serializeHeaders( request, pExtraHeader, &headersLen );
+            }
+
+            if( result.status == SigV4Success )
+            {
+                credentials.pAccessKeyId = credentials_.accessKeyId.data();
+                credentials.accessKeyIdLen = credentials_.accessKeyId.size();
+                credentials.pSecretAccessKey = credentials_.secretAccessKey.data();
+                credentials.secretAccessKeyLen = credentials_.secretAccessKey.size();
+
+                httpParams.pHttpMethod = request.method.data();
+                httpParams.httpMethodLen = request.method.size();
+                httpParams.flags = request.flags;
+                httpParams.pPath = request.path.data();
+                httpParams.pathLen = request.path.size();
+                httpParams.pQuery = request.query.data();
+                httpParams.queryLen = request.query.size();
+                httpParams.pHeaders = headerBuffer_.data();
+                httpParams.headersLen = headersLen;
+                httpParams.pPayload = request.payload.data();
+                httpParams.payloadLen = request.payload.size();
+
+                params.pCredentials = &credentials;
+                params.pDateIso8601 = dateIso8601.data();
+
+                if( !algorithm_.empty() )
+                {
+                    params.pAlgorithm = algorithm_.data();
+                    params.algorithmLen = algorithm_.size();
+                }
+
+                params.pRegion = region_.data();
+                params.regionLen = region_.size();
+                params.pService = service_.data();
+                params.serviceLen = service_.size();
+                params.pCryptoInterface = &cryptoInterface_;
+                params.pHttpParameters = &httpParams;
+                params.pSigningKeyCache = &signingKeyCache_;
+                params.pPathCache = &pathCache_;
+                params.pSignedHeadersCache = &signedHeadersCache_;
+                params.pPrecomputedScope = pPrecomputedScope_;
+
+                result.status = SigV4_GenerateHTTPAuthorization( &params,
+                                                                 authBuffer_.data(),
+                                                                 &authLen,
+                                                                 &pSignature,
+                                                                 &signatureLen );
+            }
+
+            if( result.status == SigV4Success )
+            {
+                result.value = std::string_view( authBuffer_.data(), authLen );
+                result.signature = std::string_view( pSignature, signatureLen );
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Serialize @p request headers, followed by @p pExtraHeader if it
+         * is not NULL, in the HTTP header format expected by the library, or in
+         * canonical form if the request says they are.
+         */
+        SigV4Status_t serializeHeaders( const Request & request,
+                                        const Header * pExtraHeader,
+                                        std::size_t * pHeadersLen ) noexcept
+        {
+            SigV4Status_t status = SigV4Success;
+            const bool isCanonical = ( request.flags & SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG ) != 0U;
+            const std::string_view lineEnding = isCanonical ? std::string_view( "\n" ) : std::string_view( "\r\n" );
+            std::size_t written = 0U;
+
+            for( const Header & header : request.headers )
+            {
+                status = serializeHeader( header, lineEnding, &written );
+
+                if( status != SigV4Success )
+                {
+                    break;
+                }
+            }
+
+            if( ( status == SigV4Success ) && ( pExtraHeader != nullptr ) )
+            {
+                status = serializeHeader( *pExtraHeader, lineEnding, &written );
+            }
+
+            *pHeadersLen = written;
+
+            return status;
+        }
+
+        /**
+         * @brief Serialize one header at @p pOffset in the header workspace.
+         */
+        SigV4Status_t serializeHeader( const Header & header,
+                                       std::string_view lineEnding,
+                                       std::size_t * pOffset ) noexcept
+        {
+            SigV4Status_t status = SigV4Success;
+            const std::size_t entryLen = header.name.size() + 1U + header.value.size() + lineEnding.size();
+
+            if( header.name.find( ':' ) != std::string_view::npos )
+            {
+                status = SigV4InvalidHttpHeaders;
+            }
+            else if( entryLen > ( headerBuffer_.size() - *pOffset ) )
+            {
+                status = SigV4InsufficientMemory;
+            }
+            else
+            {
+                append( pOffset, header.name );
+                headerBuffer_[ *pOffset ] = ':';
+                ( *pOffset )++;
+                append( pOffset, header.value );
+                append( pOffset, lineEnding );
+            }
+
+            return status;
+        }
+
+        /**
+         * @brief Copy @p data to the header workspace at @p pOffset.
+         */
+        void append( std::size_t * pOffset,
+                     std::string_view data ) noexcept
+        {
+            if( !data.empty() )
+            {
+                ( void ) std::memcpy( &headerBuffer_[ *pOffset ], data.data(), data.size() );
+                *pOffset += data.size();
+            }
+        }
+
+        SigV4CryptoInterface_t cryptoInterface_;
+        Credentials credentials_;
+        std::string_view region_;
+        std::string_view service_;
+        std::string_view algorithm_;
+        const SigV4PrecomputedScope_t * pPrecomputedScope_ = nullptr;
+        SigV4SigningKeyCache_t signingKeyCache_ {};
+        SigV4PathCache_t pathCache_ {};
+        SigV4SignedHeadersCache_t signedHeadersCache_ {};
+        std::array< char, HeaderBufferLength > headerBuffer_ {};
+        std::array< char, AuthBufferLength > authBuffer_ {};
+    };
+
+    /**
+     * @brief Signer with workspaces sized for typical AWS requests.
+     */
+    using Signer = BasicSigner< 2048U, 1024U >;
+
+    namespace detail
+    {
+        /**
+         * @brief Concatenate @p parts into an array of @p N characters at compile time.
+         */
+        template< std::size_t N >
+        constexpr std::array< char, N > concat( std::initializer_list< std::string_view > parts ) noexcept
+        {
+            std::array< char, N > out {};
+            std::size_t offset = 0U;
+
+            for( std::string_view part : parts )
+            {
+                for( char c : part )
+                {
+                    out[ offset ] = c;
+                    offset++;
+                }
+            }
+
+            return out;
+        }
+    } /* namespace detail */
+
+    /**
+     * @brief The default signing algorithm, usable as a template argument.
+     */
+    inline constexpr char kAws4HmacSha256[] = SIGV4_AWS4_HMAC_SHA256;
+
+    /**
+     * @brief Credential scope whose region, service and algorithm are known at
+     * compile time.
+     *
+     * Malformed names are rejected with static_assert. The scope suffix
+     * "/<region>/<service>/aws4_request", the "<algorithm> Credential=" prefix
+     * of the Authorization header and whether the path is encoded once, as for
+     * S3, are all computed at compile time. #ScopedSigner hands them to the C
+     * library as a #SigV4PrecomputedScope_t, so that only the date and the
+     * signature are filled in per request.
+     *
+     * The arguments must be character arrays with static storage, e.g.
+     * @code{cpp}
+     * inline constexpr char kRegion[] = "us-east-1";
+     * inline constexpr char kService[] = "s3";
+     * using S3Scope = sigv4::CredentialScope< kRegion, kService >;
+     * @endcode
+     *
+     * @tparam Region The target AWS region.
+     * @tparam Service The target AWS service.
+     * @tparam Algorithm The signing algorithm.
+     */
+    template< const char * Region,
+              const char * Service,
+              const char * Algorithm = kAws4HmacSha256 >
+    class CredentialScope
+    {
+    private:
+
+        static constexpr std::string_view kTerminator = "aws4_request";
+        static constexpr std::string_view kCredentialPrefix = " Credential=";
+        static constexpr std::string_view kSigV4A = SIGV4_AWS4_ECDSA_P256_SHA256;
+
+        static constexpr bool isValidName( std::string_view name ) noexcept
+        {
+            bool valid = !name.empty();
+
+            for( char c : name )
+            {
+                if( ( c == '/' ) || ( c == ' ' ) || ( c == ',' ) )
+                {
+                    valid = false;
+                }
+            }
+
+            return valid;
+        }
+
+    public:
+
+        static constexpr std::string_view region = Region;       /**< @brief The target AWS region. */
+        static constexpr std::string_view service = Service;     /**< @brief The target AWS service. */
+        static constexpr std::string_view algorithm = Algorithm; /**< @brief The signing algorithm. */
+
+        static_assert( isValidName( region ), "Region must be non-empty and must not contain '/', ' ' or ','." );
+        static_assert( isValidName( service ), "Service must be non-empty and must not contain '/', ' ' or ','." );
+        static_assert( isValidName( algorithm ), "Algorithm must be non-empty and must not contain '/', ' ' or ','." );
+
+        /**
+         * @brief Whether the region is part of the scope, which it is not with
+         * SigV4A.
+         */
+        static constexpr bool scopesRegion = ( algorithm != kSigV4A );
+
+        /**
+         * @brief The length of "/<region>/<service>/aws4_request".
+         */
+        static constexpr std::size_t suffixLength = ( scopesRegion ? ( 1U + region.size() ) : 0U ) +
+                                                    2U + service.size() + kTerminator.size();
+
+        /**
+         * @brief The length of "<YYYYMMDD>/<region>/<service>/aws4_request".
+         */
+        static constexpr std::size_t scopeLength = 8U + suffixLength;
+
+        /**
+         * @brief The length of "<algorithm> Credential=".
+         */
+        static constexpr std::size_t authPrefixLength = algorithm.size() + kCredentialPrefix.size();
+
+        /**
+         * @brief "/<region>/<service>/aws4_request", or
+         * "/<service>/aws4_request" with SigV4A, built at compile time.
+         */
+        static constexpr std::array< char, suffixLength > suffix =
+            scopesRegion ? detail::concat< suffixLength >( { "/", region, "/", service, "/", kTerminator } ) :
+                           detail::concat< suffixLength >( { "/", service, "/", kTerminator } );
+
+        /**
+         * @brief "<algorithm> Credential=", built at compile time.
+         */
+        static constexpr std::array< char, authPrefixLength > authPrefix =
+            detail::concat< authPrefixLength >( { algorithm, kCredentialPrefix } );
+
+        /**
+         * @brief Whether the path is URI-encoded once, which only S3 does,
+         * instead of twice.
+         */
+        static constexpr bool encodesPathOnce = ( service == "s3" );
+
+        /**
+         * @brief The suffix, the prefix and the S3 decision, as taken by
+         * #SigV4Parameters_t.pPrecomputedScope.
+         */
+        static constexpr SigV4PrecomputedScope_t precomputed =
+        {
+            suffix.data(), suffix.size(), authPrefix.data(), authPrefix.size(), encodesPathOnce
+        };
+
+        /**
+         * @brief Write the credential "<access key ID>/<YYYYMMDD><suffix>",
+         * e.g. for the X-Amz-Credential query parameter of a presigned URL.
+         *
+         * @param[in] accessKeyId The access key ID.
+         * @param[in] dateIso8601 The request date in ISO 8601 format.
+         * @param[out] out Buffer to write the credential to.
+         *
+         * @return A view of the credential in @p out, or an empty view if
+         * @p dateIso8601 is malformed or @p out is too small.
+         */
+        static std::string_view credential( std::string_view accessKeyId,
+                                            std::string_view dateIso8601,
+                                            Span< char > out ) noexcept
+        {
+            std::string_view result;
+            const std::size_t length = accessKeyId.size() + 1U + scopeLength;
+
+            if( ( dateIso8601.size() == SIGV4_ISO_STRING_LEN ) && ( out.size() >= length ) )
+            {
+                char * pWrite = out.data();
+
+                ( void ) std::memcpy( pWrite, accessKeyId.data(), accessKeyId.size() );
+                pWrite += accessKeyId.size();
+                *pWrite = '/';
+                pWrite++;
+                ( void ) std::memcpy( pWrite, dateIso8601.data(), 8U );
+                pWrite += 8U;
+                ( void ) std::memcpy( pWrite, suffix.data(), suffix.size() );
+
+                result = std::string_view( out.data(), length );
+            }
+
+            return result;
+        }
+    };
+
+    /**
+     * @brief Signer bound to a compile-time #CredentialScope.
+     *
+     * @tparam Scope A #CredentialScope specialization.
+     * @tparam HeaderBufferLength Size of the workspace for serialized headers.
+     * @tparam AuthBufferLength Size of the Authorization header value buffer.
+     */
+    template< typename Scope,
+              std::size_t HeaderBufferLength = 2048U,
+              std::size_t AuthBufferLength = 1024U >
+    class ScopedSigner : public BasicSigner< HeaderBufferLength, AuthBufferLength >
+    {
+    public:
+
+        static_assert( AuthBufferLength > ( Scope::authPrefixLength + Scope::scopeLength ),
+                       "AuthBufferLength cannot hold the credential scope." );
+
+        /**
+         * @brief Create a signer for the credential scope @p Scope.
+         *
+         * @param[in] cryptoInterface The hash implementation.
+         * @param[in] credentials The AWS credentials.
+         */
+        ScopedSigner( const SigV4CryptoInterface_t & cryptoInterface,
+                      Credentials credentials ) noexcept
+            : BasicSigner< HeaderBufferLength, AuthBufferLength >( cryptoInterface,
+                                                                   credentials,
+                                                                   Scope::region,
+                                                                   Scope::service,
+                                                                   Scope::algorithm,
+                                                                   Scope::precomputed )
+        {
+        }
+    };
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_HPP_ */
@@ -0,0 +1,187 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_async.hpp
+ * @brief Optional C++ helpers to hash HTTP request payloads off the calling
+ * thread.
+ *
+ * Hashing is the only part of signing whose cost grows with the request, so it
+ * is the part that is offloaded: the payload is hashed by an executor, and the
+ * request is then signed with BasicSigner::sign() taking the resulting
+ * #sigv4::PayloadDigest, which does not touch the payload again.
+ *
+ * The crypto interface given to these helpers must point to a hash context
+ * that is not used by any signer or by another hashing job at the same time.
+ */
+
+#ifndef SIGV4_ASYNC_HPP_
+#define SIGV4_ASYNC_HPP_
+
+/* Standard includes. */
+#include <atomic>
+#include <future>
+#include <string_view>
+#include <utility>
+
+#if defined( __has_include )
+    #if __has_include( <coroutine> ) && ( __cplusplus > 201703L )
+        #include <coroutine>
+    #endif
+#endif
+
+/* Include the C++ interface. */
+#include "sigv4.hpp"
+
+namespace sigv4
+{
+    /**
+     * @brief Hash @p payload on the executor @p submit, then invoke @p onDone
+     * with the #PayloadDigest on the executor's thread.
+     *
+     * @param[in] cryptoInterface The hash implementation, copied into the job.
+     * @param[in] payload The HTTP request payload; must stay valid until
+     * @p onDone is invoked.
+     * @param[in] submit Callable that runs the job it is given, e.g. by posting
+     * it to a thread pool or an I/O context.
+     * @param[in] onDone Callable invoked with the #PayloadDigest.
+     */
+    template< typename Submit,
+              typename Callback >
+    void hashPayloadAsync( const SigV4CryptoInterface_t & cryptoInterface,
+                           std::string_view payload,
+                           Submit && submit,
+                           Callback && onDone )
+    {
+        std::forward< Submit >( submit )(
+            [ cryptoInterface, payload, onDone = std::forward< Callback >( onDone ) ]() mutable
+            {
+                onDone( hashPayload( cryptoInterface, payload ) );
+            } );
+    }
+
+    /**
+     * @brief Hash @p payload on a new thread.
+     *
+     * @param[in] cryptoInterface The hash implementation, copied into the job.
+     * @param[in] payload The HTTP request payload; must stay valid until the
+     * future is ready.
+     *
+     * @return A future holding the #PayloadDigest.
+     */
+    inline std::future< PayloadDigest > hashPayloadAsync( const SigV4CryptoInterface_t & cryptoInterface,
+                                                          std::string_view payload )
+    {
+        return std::async( std::launch::async,
+                           [ cryptoInterface, payload ]() noexcept
+                           {
+                               return hashPayload( cryptoInterface, payload );
+                           } );
+    }
+
+    #if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine )
+
+        /**
+         * @brief Awaitable that hashes a payload on an executor and resumes the
+         * awaiting coroutine with the #PayloadDigest.
+         *
+         * The coroutine is resumed on the executor's thread, unless the job
+         * completes before the executor returns from submitting it, e.g. when
+         * the executor runs it inline; the coroutine then continues on its own
+         * thread once the executor has returned, without suspending.
+         *
+         * @code{cpp}
+         * sigv4::PayloadDigest digest =
+         *     co_await sigv4::HashPayloadAwaitable( crypto, body, postToPool );
+         * auto authorization = signer.sign( request, date, digest );
+         * @endcode
+         *
+         * @tparam Submit Callable that runs the job it is given.
+         */
+        template< typename Submit >
+        class HashPayloadAwaitable
+        {
+        public:
+
+            /**
+             * @brief Create the awaitable.
+             *
+             * @param[in] cryptoInterface The hash implementation.
+             * @param[in] payload The HTTP request payload.
+             * @param[in] submit Callable that runs the job it is given.
+             */
+            HashPayloadAwaitable( const SigV4CryptoInterface_t & cryptoInterface,
+                                  std::string_view payload,
+                                  Submit submit ) noexcept
+                : cryptoInterface_( cryptoInterface ),
+                payload_( payload ),
+                submit_( std::move( submit ) )
+            {
+            }
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            /**
+             * @brief Submit the job, and suspend unless it already completed.
+             *
+             * The job and this function each mark their end; whichever ends
+             * second resumes the coroutine, the job by resuming it and this
+             * function by not suspending it. Neither touches the awaitable
+             * after marking its end, as the coroutine may then destroy it.
+             */
+            bool await_suspend( std::coroutine_handle<> awaiting )
+            {
+                submit_( [ this, awaiting ]() noexcept
+                         {
+                             digest_ = hashPayload( cryptoInterface_, payload_ );
+
+                             if( isDone_.exchange( true, std::memory_order_acq_rel ) )
+                             {
+                                 awaiting.resume();
+                             }
+                         } );
+
+                return !isDone_.exchange( true, std::memory_order_acq_rel );
+            }
+
+            PayloadDigest await_resume() const noexcept
+            {
+                return digest_;
+            }
+
+        private:
+            SigV4CryptoInterface_t cryptoInterface_;
+            std::string_view payload_;
+            Submit submit_;
+            PayloadDigest digest_;
+            std::atomic< bool > isDone_ { false };
+        };
+
+    #endif /* if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine ) */
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_ASYNC_HPP_ */
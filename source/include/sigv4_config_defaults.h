@@ -113,6 +113,8 @@
  * the ones digit if the decimal is greater than 0.
  * @note If updating #SIGV4_MAX_QUERY_PAIR_COUNT or #SIGV4_MAX_HTTP_HEADER_COUNT,
  * be sure to update this value based on the formula above.
+ * @note The sort also keeps the partition depth of each subarray on the
+ * stack, which takes half as many entries again.
  */
 #ifndef SIGV4_WORST_CASE_SORT_STACK_SIZE
     #define SIGV4_WORST_CASE_SORT_STACK_SIZE    14U
@@ -146,6 +148,74 @@
     #define SIGV4_HASH_MAX_DIGEST_LENGTH    32U
 #endif
 
+/**
+ * @brief Macro defining the maximum length of the credential scope identity,
+ * "<access key ID>/<YYYYMMDD>/<region>/<service>", that a signing key stored
+ * in a #SigV4SigningKeyCache_t is bound to.
+ *
+ * Signing keys for credential scopes longer than this value are derived on
+ * every call and are never cached.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `128`
+ */
+#ifndef SIGV4_SIGNING_KEY_CACHE_ID_LENGTH
+    #define SIGV4_SIGNING_KEY_CACHE_ID_LENGTH    128U
+#endif
+
+/**
+ * @brief Macro defining the number of paths a #SigV4PathCache_t holds.
+ *
+ * When the cache is full, the least recently used path is replaced.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `4`
+ */
+#ifndef SIGV4_PATH_CACHE_ENTRY_COUNT
+    #define SIGV4_PATH_CACHE_ENTRY_COUNT    4U
+#endif
+
+/**
+ * @brief Macro defining the maximum length of a path, and of its canonical
+ * form, that a #SigV4PathCache_t can hold.
+ *
+ * Paths that are longer, or whose canonical form is longer, are encoded on
+ * every call and are never cached.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `128`
+ */
+#ifndef SIGV4_PATH_CACHE_PATH_LENGTH
+    #define SIGV4_PATH_CACHE_PATH_LENGTH    128U
+#endif
+
+/**
+ * @brief Macro defining the maximum length of the signed headers list, and of
+ * the header names it is derived from, that a #SigV4SignedHeadersCache_t can
+ * hold.
+ *
+ * Requests with longer header names are sorted on every call and their signed
+ * headers list is never cached.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `128`
+ */
+#ifndef SIGV4_SIGNED_HEADERS_CACHE_LENGTH
+    #define SIGV4_SIGNED_HEADERS_CACHE_LENGTH    128U
+#endif
+
+/**
+ * @brief Macro defining the number of signatures a #SigV4PresignCache_t holds.
+ *
+ * When the cache is full, the least recently used signature is replaced.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. <br>
+ * <b>Default value:</b> `4`
+ */
+#ifndef SIGV4_PRESIGN_CACHE_ENTRY_COUNT
+    #define SIGV4_PRESIGN_CACHE_ENTRY_COUNT    4U
+#endif
+
 /**
  * @brief Macro to statically enable support for canonicalizing the URI,
  * headers, and query in this library.
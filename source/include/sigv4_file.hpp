@@ -0,0 +1,400 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file sigv4_file.hpp
+ * @brief Optional C++ helpers to sign HTTP requests whose payload is a local
+ * file, without reading the file into memory first.
+ *
+ * On POSIX systems, files up to a configurable size are memory-mapped with
+ * sequential read-ahead advice and hashed in place. Larger files, and files
+ * that cannot be mapped, are streamed into the hash in blocks read with
+ * pread(). Elsewhere, files are streamed with the C standard library.
+ */
+
+#ifndef SIGV4_FILE_HPP_
+#define SIGV4_FILE_HPP_
+
+/* Standard includes. */
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <string_view>
+
+#ifndef SIGV4_FILE_USE_POSIX
+    #if defined( __has_include )
+        #if __has_include( <sys/mman.h> ) && __has_include( <sys/stat.h> ) && __has_include( <fcntl.h> ) && __has_include( <unistd.h> )
+
+/**
+ * @brief Whether files are read with the POSIX mmap() and pread() interfaces.
+ * Define to 0 to always stream files with the C standard library.
+ */
+            #define SIGV4_FILE_USE_POSIX    1
+        #endif
+    #endif
+#endif
+
+#ifndef SIGV4_FILE_USE_POSIX
+    #define SIGV4_FILE_USE_POSIX    0
+#endif
+
+#if SIGV4_FILE_USE_POSIX
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/* Include the C++ interface. */
+#include "sigv4.hpp"
+
+namespace sigv4
+{
+    /**
+     * @brief Size of the block that hashFile() streams a file through when the
+     * caller does not provide one. Large blocks keep the number of reads low.
+     */
+    inline constexpr std::size_t kFileBlockLength = 64U * 1024U;
+
+    /**
+     * @brief Alignment of the block that hashFile() allocates, so that it
+     * starts on a page.
+     */
+    inline constexpr std::size_t kFileBlockAlignment = 4096U;
+
+    /**
+     * @brief Default size above which files are streamed instead of mapped.
+     */
+    inline constexpr std::uint64_t kMaxMappedFileLength = 1024U * 1024U * 1024U;
+
+    namespace detail
+    {
+        /**
+         * @brief A page-aligned #kFileBlockLength block.
+         */
+        struct FileBlock
+        {
+            alignas( kFileBlockAlignment ) unsigned char data[ kFileBlockLength ];
+        };
+
+        /**
+         * @brief Incremental payload hash over a #SigV4CryptoInterface_t,
+         * producing a #PayloadDigest.
+         */
+        class PayloadHasher
+        {
+        public:
+
+            /**
+             * @brief Start hashing with @p cryptoInterface.
+             */
+            explicit PayloadHasher( const SigV4CryptoInterface_t & cryptoInterface ) noexcept
+                : cryptoInterface_( cryptoInterface )
+            {
+                if( ( cryptoInterface_.hashInit == nullptr ) ||
+                    ( cryptoInterface_.hashUpdate == nullptr ) ||
+                    ( cryptoInterface_.hashFinal == nullptr ) ||
+                    ( cryptoInterface_.hashDigestLen > SIGV4_HASH_MAX_DIGEST_LENGTH ) )
+                {
+                    status_ = SigV4InvalidParameter;
+                }
+                else if( cryptoInterface_.hashInit( cryptoInterface_.pHashContext ) != 0 )
+                {
+                    status_ = SigV4HashError;
+                }
+                else
+                {
+                    status_ = SigV4Success;
+                }
+            }
+
+            /**
+             * @brief Whether hashing has not failed so far.
+             */
+            bool ok() const noexcept
+            {
+                return status_ == SigV4Success;
+            }
+
+            /**
+             * @brief Feed @p length bytes at @p pData into the hash.
+             */
+            void update( const void * pData,
+                         std::size_t length ) noexcept
+            {
+                if( ( status_ == SigV4Success ) &&
+                    ( cryptoInterface_.hashUpdate( cryptoInterface_.pHashContext,
+                                                   static_cast< const std::uint8_t * >( pData ),
+                                                   length ) != 0 ) )
+                {
+                    status_ = SigV4HashError;
+                }
+            }
+
+            /**
+             * @brief Finish hashing with #SigV4_FinishPayloadHash, or report
+             * @p failure if reading the payload failed.
+             */
+            PayloadDigest finish( SigV4Status_t failure = SigV4Success ) noexcept
+            {
+                PayloadDigest digest;
+
+                if( failure != SigV4Success )
+                {
+                    status_ = failure;
+                }
+
+                if( status_ == SigV4Success )
+                {
+                    digest.length = digest.hex.size();
+                    status_ = SigV4_FinishPayloadHash( &cryptoInterface_,
+                                                       digest.hex.data(),
+                                                       &digest.length );
+                }
+
+                if( status_ != SigV4Success )
+                {
+                    digest.length = 0U;
+                }
+
+                digest.status = status_;
+
+                return digest;
+            }
+
+        private:
+            SigV4CryptoInterface_t cryptoInterface_;
+            SigV4Status_t status_ = SigV4InvalidParameter;
+        };
+    } /* namespace detail */
+
+    /**
+     * @brief Hash the contents of the file at @p path, streaming it through
+     * @p block when it is not memory-mapped.
+     *
+     * @param[in] cryptoInterface The hash implementation.
+     * @param[in] path Path of the file; must be NUL-terminated.
+     * @param[in] block Buffer the file is read into; larger blocks take fewer
+     * reads. Must not be empty.
+     * @param[in] maxMappedLength Files larger than this are streamed instead of
+     * memory-mapped.
+     *
+     * @return The hex-encoded digest of the file contents. Its status is
+     * #SigV4PayloadReadError if the file cannot be opened or read, in which case
+     * errno describes the failure, and #SigV4InvalidParameter if @p block is
+     * empty.
+     */
+    inline PayloadDigest hashFile( const SigV4CryptoInterface_t & cryptoInterface,
+                                   const char * path,
+                                   Span< unsigned char > block,
+                                   std::uint64_t maxMappedLength = kMaxMappedFileLength ) noexcept
+    {
+        detail::PayloadHasher hasher( cryptoInterface );
+        SigV4Status_t readStatus = block.empty() ? SigV4InvalidParameter : SigV4Success;
+        int readError = 0;
+
+        #if SIGV4_FILE_USE_POSIX
+            const int fd = ( readStatus == SigV4Success ) ? ::open( path, O_RDONLY | O_CLOEXEC ) : -1;
+            struct stat fileStat = {};
+            bool isMapped = false;
+
+            if( readStatus != SigV4Success )
+            {
+                /* The block is empty. */
+            }
+            else if( ( fd < 0 ) || ( ::fstat( fd, &fileStat ) != 0 ) )
+            {
+                readStatus = SigV4PayloadReadError;
+                readError = errno;
+            }
+            else if( ( fileStat.st_size > 0 ) &&
+                     ( static_cast< std::uint64_t >( fileStat.st_size ) <= maxMappedLength ) &&
+                     ( static_cast< std::uint64_t >( fileStat.st_size ) <= SIZE_MAX ) )
+            {
+                const std::size_t length = static_cast< std::size_t >( fileStat.st_size );
+                void * pMapped = ::mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+                if( pMapped != MAP_FAILED )
+                {
+                    ( void ) ::madvise( pMapped, length, MADV_SEQUENTIAL );
+                    hasher.update( pMapped, length );
+                    ( void ) ::munmap( pMapped, length );
+                    isMapped = true;
+                }
+            }
+            else
+            {
+                /* Empty file, or too large to map: stream it below. */
+            }
+
+            if( ( readStatus == SigV4Success ) && !isMapped )
+            {
+                off_t offset = 0;
+                ssize_t readLen = 0;
+
+                #if defined( POSIX_FADV_SEQUENTIAL )
+                    ( void ) ::posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+                #endif
+
+                do
+                {
+                    do
+                    {
+                        readLen = ::pread( fd, block.data(), block.size(), offset );
+                    } while( ( readLen < 0 ) && ( errno == EINTR ) );
+
+                    if( readLen > 0 )
+                    {
+                        hasher.update( block.data(), static_cast< std::size_t >( readLen ) );
+                        offset += readLen;
+                    }
+                } while( ( readLen > 0 ) && hasher.ok() );
+
+                if( readLen < 0 )
+                {
+                    readStatus = SigV4PayloadReadError;
+                    readError = errno;
+                }
+            }
+
+            if( fd >= 0 )
+            {
+                ( void ) ::close( fd );
+            }
+        #else /* if SIGV4_FILE_USE_POSIX */
+            std::FILE * pFile = ( readStatus == SigV4Success ) ? std::fopen( path, "rb" ) : nullptr;
+
+            ( void ) maxMappedLength;
+
+            if( readStatus != SigV4Success )
+            {
+                /* The block is empty. */
+            }
+            else if( pFile == nullptr )
+            {
+                readStatus = SigV4PayloadReadError;
+                readError = errno;
+            }
+            else
+            {
+                std::size_t readLen = 0U;
+
+                do
+                {
+                    readLen = std::fread( block.data(), 1U, block.size(), pFile );
+                    hasher.update( block.data(), readLen );
+                } while( ( readLen == block.size() ) && hasher.ok() );
+
+                if( std::ferror( pFile ) != 0 )
+                {
+                    readStatus = SigV4PayloadReadError;
+                    readError = errno;
+                }
+
+                ( void ) std::fclose( pFile );
+            }
+        #endif /* if SIGV4_FILE_USE_POSIX */
+
+        /* Closing the file must not overwrite the cause of a read failure. */
+        if( readStatus == SigV4PayloadReadError )
+        {
+            errno = readError;
+        }
+
+        return hasher.finish( readStatus );
+    }
+
+    /**
+     * @brief Hash the contents of the file at @p path, streaming it through a
+     * page-aligned #kFileBlockLength block on the heap when it is not
+     * memory-mapped.
+     *
+     * @param[in] cryptoInterface The hash implementation.
+     * @param[in] path Path of the file; must be NUL-terminated.
+     * @param[in] maxMappedLength Files larger than this are streamed instead of
+     * memory-mapped.
+     *
+     * @return See the overload taking a block. Its status is
+     * #SigV4InsufficientMemory if the block cannot be allocated.
+     */
+    inline PayloadDigest hashFile( const SigV4CryptoInterface_t & cryptoInterface,
+                                   const char * path,
+                                   std::uint64_t maxMappedLength = kMaxMappedFileLength ) noexcept
+    {
+        PayloadDigest digest;
+        const std::unique_ptr< detail::FileBlock > pBlock( new( std::nothrow ) detail::FileBlock );
+
+        if( pBlock == nullptr )
+        {
+            digest = detail::PayloadHasher( cryptoInterface ).finish( SigV4InsufficientMemory );
+        }
+        else
+        {
+            digest = hashFile( cryptoInterface, path, Span< unsigned char >( pBlock->data, sizeof( pBlock->data ) ), maxMappedLength );
+        }
+
+        return digest;
+    }
+
+    /**
+     * @brief Sign an HTTP request whose payload is the file at @p path.
+     *
+     * The file is hashed with hashFile() and the request is signed with the
+     * digest overload of BasicSigner::sign(); the payload of @p request is
+     * ignored. The application then sends the file as the request body.
+     *
+     * @param[in] signer The signer.
+     * @param[in] request The HTTP request to sign.
+     * @param[in] dateIso8601 The request date in ISO 8601 format.
+     * @param[in] cryptoInterface The hash implementation for the file. It may
+     * share its hash context with @p signer, as hashing completes before signing
+     * starts.
+     * @param[in] path Path of the file; must be NUL-terminated.
+     * @param[in] addContentSha256Header Whether to sign an "x-amz-content-sha256"
+     * header holding the digest, as S3 requires.
+     *
+     * @return The Authorization header value on success, or the status of
+     * hashFile() if the file could not be hashed.
+     */
+    template< std::size_t HeaderBufferLength,
+              std::size_t AuthBufferLength >
+    Authorization signFile( BasicSigner< HeaderBufferLength, AuthBufferLength > & signer,
+                            const Request & request,
+                            std::string_view dateIso8601,
+                            const SigV4CryptoInterface_t & cryptoInterface,
+                            const char * path,
+                            bool addContentSha256Header = false ) noexcept
+    {
+        return signer.sign( request,
+                            dateIso8601,
+                            hashFile( cryptoInterface, path ),
+                            addContentSha256Header );
+    }
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_FILE_HPP_ */
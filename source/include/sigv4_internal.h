@@ -73,6 +73,11 @@
 
 #define ISO_DATE_SCOPE_LEN     8U                                               /**< Length of date substring used in credential scope. */
 
+#define EPOCH_YEAR             1970U                                            /**< The year of the Unix epoch, from which presigned URL signing times are counted. */
+#define MAX_EPOCH_YEAR         2105U                                            /**< The last year whose times fit in 32 bits of seconds since the Unix epoch. */
+#define SECONDS_PER_DAY        86400U                                           /**< The number of seconds in a day. */
+#define MAX_DECIMAL_DIGITS     9U                                               /**< The number of decimal digits that always fit in 32 bits. */
+
 /* SigV4 related string literals and lengths. */
 
 /**
@@ -101,6 +106,10 @@
 
 #define HTTP_REQUEST_LINE_ENDING               "\r\n"                                           /**< The string used in non-canonicalized HTTP headers to separate header entries in HTTP request. */
 #define HTTP_REQUEST_LINE_ENDING_LEN           ( sizeof( HTTP_REQUEST_LINE_ENDING ) - 1U )      /**< The length of #HTTP_REQUEST_LINE_ENDING. */
+#define HTTP_VERSION_PREFIX                    "HTTP/"                                          /**< The prefix of the HTTP version that ends an HTTP request line. */
+#define HTTP_VERSION_PREFIX_LEN                ( sizeof( HTTP_VERSION_PREFIX ) - 1U )           /**< The length of #HTTP_VERSION_PREFIX. */
+#define HTTP_SCHEME_SEPARATOR                  "://"                                            /**< The separator between the scheme and the authority of an absolute-form request target. */
+#define HTTP_SCHEME_SEPARATOR_LEN              ( sizeof( HTTP_SCHEME_SEPARATOR ) - 1U )         /**< The length of #HTTP_SCHEME_SEPARATOR. */
 
 #define SPACE_CHAR                             ' '                                              /**< A linefeed character used to build the Authorization header value. */
 #define SPACE_CHAR_LEN                         1U                                               /**< The length of #SPACE_CHAR. */
@@ -108,8 +117,29 @@
 #define S3_SERVICE_NAME                        "s3"                                             /**< S3 is the only service where the URI must only be encoded once. */
 #define S3_SERVICE_NAME_LEN                    ( sizeof( S3_SERVICE_NAME ) - 1U )               /**< The length of #S3_SERVICE_NAME. */
 
+#define PRESIGN_DATE_PARAMETER                 "X-Amz-Date"                                     /**< The query parameter holding the date of a presigned URL. */
+#define PRESIGN_DATE_PARAMETER_LEN             ( sizeof( PRESIGN_DATE_PARAMETER ) - 1U )        /**< The length of #PRESIGN_DATE_PARAMETER. */
+#define PRESIGN_EXPIRES_PARAMETER              "X-Amz-Expires"                                  /**< The query parameter holding the validity of a presigned URL, in seconds. */
+#define PRESIGN_EXPIRES_PARAMETER_LEN          ( sizeof( PRESIGN_EXPIRES_PARAMETER ) - 1U )     /**< The length of #PRESIGN_EXPIRES_PARAMETER. */
+#define PRESIGN_CACHE_KEY_FIELD_COUNT          11U                                              /**< The number of variable-length fields hashed to look up a presigned URL signature. */
+#define PRESIGN_CACHE_KEY_SEGMENT_COUNT        ( PRESIGN_CACHE_KEY_FIELD_COUNT + 3U )           /**< The number of segments hashed to look up a presigned URL signature: the fields, their lengths, the flags and the date. */
+
+#define WELL_KNOWN_HEADER_COUNT                7U                                               /**< The number of well-known header names, which are ranked 1 to 7 in canonical order. */
+#define WELL_KNOWN_HEADER_SLOT_COUNT           16U                                              /**< The number of slots in the perfect hash table of well-known header names. */
+#define WELL_KNOWN_HEADER_RANK_CONTENT_SHA256  4U                                               /**< The rank of the x-amz-content-sha256 header name. */
+
+#define MAX_REFERENCED_CANONICAL_LINES         4U                                               /**< The number of canonical request lines that can be hashed from application memory: method, path, query and headers. */
+#define MAX_CANONICAL_REQUEST_SEGMENTS         ( ( MAX_REFERENCED_CANONICAL_LINES * 4U ) + 1U ) /**< The number of segments the canonical request is hashed in: up to four per referenced line, and the buffered tail. */
+
+#define FNV1A_32_OFFSET_BASIS                  2166136261U                                      /**< The offset basis of the 32-bit FNV-1a hash used to look up cached data. */
+#define FNV1A_32_PRIME                         16777619U                                        /**< The prime of the 32-bit FNV-1a hash used to look up cached data. */
+
 #define SIGV4_HMAC_SIGNING_KEY_PREFIX          "AWS4"                                           /**< HMAC signing key prefix. */
 #define SIGV4_HMAC_SIGNING_KEY_PREFIX_LEN      ( sizeof( SIGV4_HMAC_SIGNING_KEY_PREFIX ) - 1U ) /**< The length of #SIGV4_HMAC_SIGNING_KEY_PREFIX. */
+#define SIGV4A_HMAC_KEY_PREFIX                 "AWS4A"                                          /**< HMAC key prefix of the SigV4A private key derivation. */
+#define SIGV4A_HMAC_KEY_PREFIX_LEN             ( sizeof( SIGV4A_HMAC_KEY_PREFIX ) - 1U )        /**< The length of #SIGV4A_HMAC_KEY_PREFIX. */
+#define SIGV4A_KDF_FIXED_INPUT_LEN             ( 4U + SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH + 1U + 1U + 4U ) /**< The length of the SigV4A key derivation input, not counting the access key ID. */
+#define SIGV4A_KDF_MAX_COUNTER                 254U                                             /**< The last counter value tried by the SigV4A key derivation. */
 
 #define AUTH_CREDENTIAL_PREFIX                 "Credential="                                    /**< The prefix that goes before the credential value in the Authorization header value. */
 #define AUTH_CREDENTIAL_PREFIX_LEN             ( sizeof( AUTH_CREDENTIAL_PREFIX ) - 1U )        /**< The length of #AUTH_CREDENTIAL_PREFIX. */
@@ -120,6 +150,17 @@
 #define AUTH_SIGNATURE_PREFIX                  "Signature="                                     /**< The prefix that goes before the signature in the Authorization header value. */
 #define AUTH_SIGNATURE_PREFIX_LEN              ( sizeof( AUTH_SIGNATURE_PREFIX ) - 1U )         /**< The length of #AUTH_SIGNATURE_PREFIX. */
 
+#define AUTH_CREDENTIAL_SEGMENT                " " AUTH_CREDENTIAL_PREFIX                                                              /**< The segment of the Authorization header value between the algorithm and the access key ID. */
+#define AUTH_CREDENTIAL_SEGMENT_LEN            ( sizeof( AUTH_CREDENTIAL_SEGMENT ) - 1U )                                              /**< The length of #AUTH_CREDENTIAL_SEGMENT. */
+#define AUTH_SCOPE_SEPARATOR_SEGMENT           "/"                                                                                     /**< The segment of the Authorization header value between the parts of the credential. */
+#define AUTH_SCOPE_SEPARATOR_SEGMENT_LEN       ( sizeof( AUTH_SCOPE_SEPARATOR_SEGMENT ) - 1U )                                         /**< The length of #AUTH_SCOPE_SEPARATOR_SEGMENT. */
+#define AUTH_SIGNED_HEADERS_SEGMENT            "/" CREDENTIAL_SCOPE_TERMINATOR AUTH_SEPARATOR AUTH_SIGNED_HEADERS_PREFIX               /**< The segment of the Authorization header value between the service and the signed headers. */
+#define AUTH_SIGNED_HEADERS_SEGMENT_LEN        ( sizeof( AUTH_SIGNED_HEADERS_SEGMENT ) - 1U )                                          /**< The length of #AUTH_SIGNED_HEADERS_SEGMENT. */
+#define AUTH_SCOPE_SIGNED_HEADERS_SEGMENT      AUTH_SEPARATOR AUTH_SIGNED_HEADERS_PREFIX                                               /**< The segment of the Authorization header value between a precomputed credential scope and the signed headers. */
+#define AUTH_SCOPE_SIGNED_HEADERS_SEGMENT_LEN  ( sizeof( AUTH_SCOPE_SIGNED_HEADERS_SEGMENT ) - 1U )                                    /**< The length of #AUTH_SCOPE_SIGNED_HEADERS_SEGMENT. */
+#define AUTH_SIGNATURE_SEGMENT                 AUTH_SEPARATOR AUTH_SIGNATURE_PREFIX                                                    /**< The segment of the Authorization header value between the signed headers and the signature. */
+#define AUTH_SIGNATURE_SEGMENT_LEN             ( sizeof( AUTH_SIGNATURE_SEGMENT ) - 1U )                                               /**< The length of #AUTH_SIGNATURE_SEGMENT. */
+
 #define HMAC_INNER_PAD_BYTE                    ( 0x36U )                                        /**< The "ipad" byte used for generating the inner key in the HMAC calculation process. */
 #define HMAC_OUTER_PAD_BYTE                    ( 0x5CU )                                        /**< The "opad" byte used for generating the outer key in the HMAC calculation process. */
 #define HMAX_IPAD_XOR_OPAD_BYTE                ( 0x6AU )                                        /**< The XOR of the "ipad" and "opad" bytes to extract outer key from inner key. */
@@ -194,8 +235,54 @@ typedef struct SigV4KeyValuePair
 {
     SigV4ConstString_t key;   /**< SigV4 string identifier */
     SigV4ConstString_t value; /**< SigV4 data */
+    uint8_t keyRank;          /**< Sort rank of a well-known header name, or 0 for any other key. */
+    size_t parseIndex;        /**< Position of a header in the request, which stays with it when the headers are sorted. */
 } SigV4KeyValuePair_t;
 
+/**
+ * @brief A line of the canonical request that is hashed from application
+ * memory instead of being copied into the processing buffer.
+ */
+typedef struct SigV4ReferencedLine
+{
+    SigV4ConstString_t line; /**< The line, without its newline character. */
+    SigV4ConstString_t wrap; /**< The rest of the line when it wraps around a ring buffer, or empty. */
+    size_t uxInsertIndex;    /**< The pBufProcessing index at which the line and its newline character belong. */
+} SigV4ReferencedLine_t;
+
+/* The states of a SigV4Signer_t, named after the part of the request it takes
+ * next. A signer moves through them in order, and takes the parts of its state
+ * and of the states after it. */
+#define SIGNER_STATE_METHOD      0U /**< Taking the method. */
+#define SIGNER_STATE_PATH        1U /**< Taking the path. */
+#define SIGNER_STATE_QUERY       2U /**< Taking query parameters. */
+#define SIGNER_STATE_HEADERS     3U /**< Taking headers. */
+#define SIGNER_STATE_PAYLOAD     4U /**< Taking payload fragments, which are hashed. */
+#define SIGNER_STATE_FINISHED    5U /**< The payload digest is final. */
+#define SIGNER_STATE_FAILED      6U /**< A part of the request was lost, so the signer only reports the error. */
+
+/**
+ * @brief The number of pieces that an input wrapping around the end of a ring
+ * buffer is split into.
+ */
+#define WRAPPED_INPUT_PIECE_COUNT    3U
+
+/**
+ * @brief An input that wraps around the end of a ring buffer, split at the
+ * separators nearest to the end of the ring buffer into pieces that can each
+ * be parsed on their own.
+ */
+typedef struct SigV4WrappedInput
+{
+    /**
+     * @brief In order: the entries that end before the end of the ring buffer,
+     * the entry that straddles it, and the entries that follow that entry.
+     * Any piece may be empty.
+     */
+    SigV4ConstString_t pieces[ WRAPPED_INPUT_PIECE_COUNT ];
+    size_t stagedLen; /**< The length of the straddling entry copied to the end of the processing buffer, or 0. */
+} SigV4WrappedInput_t;
+
 /**
  * @brief An aggregator to maintain the internal state of canonicalization
  * during intermediate calculations.
@@ -210,6 +297,9 @@ typedef struct CanonicalContext
     size_t bufRemaining;                                            /**< pBufProcessing value used during internal calculation. */
     const char * pHashPayloadLoc;                                   /**< Pointer used to store the location of hashed HTTP request payload. */
     size_t hashPayloadLen;                                          /**< Length of hashed HTTP request payload. */
+
+    SigV4ReferencedLine_t referencedLines[ MAX_REFERENCED_CANONICAL_LINES ]; /**< Lines hashed in place from application memory, in order. */
+    size_t referencedLineCount;                                               /**< The number of entries in referencedLines. */
 } CanonicalContext_t;
 
 /**
@@ -234,6 +324,29 @@ typedef struct HmacContext
     size_t keyLen;
 } HmacContext_t;
 
+/**
+ * @brief What a presigned URL signature is looked up by in a
+ * #SigV4PresignCache_t.
+ */
+typedef struct PresignCacheKey
+{
+    /**
+     * @brief Digest of the request, covering everything that is signed except
+     * the X-Amz-Date query parameter.
+     */
+    uint8_t pRequestDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+
+    /**
+     * @brief #SigV4Parameters_t.pDateIso8601, in seconds since the Unix epoch.
+     */
+    uint32_t signingTime;
+
+    /**
+     * @brief The X-Amz-Expires query parameter of the request, in seconds.
+     */
+    uint32_t expires;
+} PresignCacheKey_t;
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
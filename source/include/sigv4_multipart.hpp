@@ -0,0 +1,188 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file sigv4_multipart.hpp
+ * @brief Optional C++ helper to sign the parts of a multipart upload, e.g. the
+ * UploadPart requests of an S3 multipart upload.
+ *
+ * Hashing the part payloads is the only step whose cost grows with the upload,
+ * so only that step is run in parallel on an executor provided by the
+ * application. The parts are then signed one after the other by a single
+ * BasicSigner, whose #SigV4SigningKeyCache_t makes every part after the first
+ * skip the signing key derivation.
+ */
+
+#ifndef SIGV4_MULTIPART_HPP_
+#define SIGV4_MULTIPART_HPP_
+
+/* Standard includes. */
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+/* Include the C++ interface. */
+#include "sigv4.hpp"
+
+namespace sigv4
+{
+    /**
+     * @brief Hash the payloads of @p parts concurrently on the executor
+     * @p submit, then sign every part with @p signer on the calling thread.
+     *
+     * One hashing job is submitted per entry of @p hashers, and job k hashes the
+     * parts k, k + N, k + 2N, ... with hashers[ k ], where N is the number of
+     * hashers. Every hasher must therefore point to its own hash context, which
+     * must not be used by @p signer. The call blocks until all jobs completed.
+     *
+     * Each part is signed with an "x-amz-content-sha256" header holding its
+     * payload digest, which the application must send along with the part; the
+     * headers of @p parts must not be canonical.
+     *
+     * @code{cpp}
+     * status = sigv4::signUploadParts( signer, parts, date, hashers, digests,
+     *                                  []( auto job ) { pool.post( std::move( job ) ); },
+     *                                  [ & ]( std::size_t i, const sigv4::Authorization & auth,
+     *                                         const sigv4::PayloadDigest & digest )
+     *                                  {
+     *                                      sendPart( i, auth.value, digest.view() );
+     *                                  } );
+     * @endcode
+     *
+     * @param[in] signer The signer used for every part.
+     * @param[in] parts The UploadPart requests, with their payloads.
+     * @param[in] dateIso8601 The request date in ISO 8601 format, shared by all
+     * parts.
+     * @param[in] hashers The hash implementations, one per concurrent job.
+     * @param[out] digests Receives the payload digest of each part; must hold at
+     * least as many entries as @p parts.
+     * @param[in] submit Callable that runs the job it is given, e.g. by posting
+     * it to a thread pool.
+     * @param[in] onSigned Callable invoked on the calling thread, in order, with
+     * the index, #Authorization and #PayloadDigest of each part. The
+     * #Authorization is only valid until the next part is signed.
+     *
+     * @return #SigV4Success if every part was signed, #SigV4InvalidParameter if
+     * @p hashers is empty or @p digests is too small, or else the status of the
+     * first part that failed. Every part is reported to @p onSigned either way.
+     *
+     * @throw Any exception thrown by @p submit, once the jobs it already
+     * accepted completed; no part is signed then. A job is assumed not to run
+     * if @p submit throws while given it.
+     */
+    template< std::size_t HeaderBufferLength,
+              std::size_t AuthBufferLength,
+              typename Submit,
+              typename OnSigned >
+    SigV4Status_t signUploadParts( BasicSigner< HeaderBufferLength, AuthBufferLength > & signer,
+                                   Span< const Request > parts,
+                                   std::string_view dateIso8601,
+                                   Span< const SigV4CryptoInterface_t > hashers,
+                                   Span< PayloadDigest > digests,
+                                   Submit && submit,
+                                   OnSigned && onSigned )
+    {
+        SigV4Status_t status = SigV4Success;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t pendingJobs = 0U;
+        std::exception_ptr submitError;
+
+        if( hashers.empty() || ( digests.size() < parts.size() ) )
+        {
+            status = SigV4InvalidParameter;
+        }
+        else
+        {
+            const std::size_t jobCount = ( hashers.size() < parts.size() ) ? hashers.size() : parts.size();
+
+            for( std::size_t job = 0U; ( job < jobCount ) && ( submitError == nullptr ); job++ )
+            {
+                {
+                    std::lock_guard< std::mutex > lock( mutex );
+                    pendingJobs++;
+                }
+
+                try
+                {
+                    submit( [ job, jobCount, parts, hashers, digests, &mutex, &done, &pendingJobs ]() noexcept
+                            {
+                                for( std::size_t i = job; i < parts.size(); i += jobCount )
+                                {
+                                    digests[ i ] = hashPayload( hashers[ job ], parts[ i ].payload );
+                                }
+
+                                /* Notify under the lock, as the waiter owns the
+                                 * condition variable and may return as soon as it
+                                 * sees the last job complete. */
+                                std::lock_guard< std::mutex > lock( mutex );
+                                pendingJobs--;
+                                done.notify_one();
+                            } );
+                }
+                catch( ... )
+                {
+                    std::lock_guard< std::mutex > lock( mutex );
+                    pendingJobs--;
+                    submitError = std::current_exception();
+                }
+            }
+
+            /* The jobs refer to this frame, so it is only left once they all
+             * completed, even when a submission failed. */
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                done.wait( lock, [ &pendingJobs ]() noexcept
+                           {
+                               return pendingJobs == 0U;
+                           } );
+            }
+
+            if( submitError != nullptr )
+            {
+                std::rethrow_exception( submitError );
+            }
+
+            for( std::size_t i = 0U; i < parts.size(); i++ )
+            {
+                const Authorization authorization = signer.sign( parts[ i ], dateIso8601, digests[ i ], true );
+
+                if( ( status == SigV4Success ) && ( authorization.status != SigV4Success ) )
+                {
+                    status = authorization.status;
+                }
+
+                onSigned( i, authorization, static_cast< const PayloadDigest & >( digests[ i ] ) );
+            }
+        }
+
+        return status;
+    }
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_MULTIPART_HPP_ */
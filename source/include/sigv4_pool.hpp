@@ -0,0 +1,505 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_pool.hpp
+ * @brief Optional C++ pool of signing workers.
+ *
+ * Each worker owns a #sigv4::BasicSigner, and therefore its own workspace,
+ * signing key cache and hash context. Jobs submitted from any thread are
+ * spread over bounded lock-free per-worker queues; idle workers steal from the
+ * queues of busy ones. Results are delivered through a completion callback
+ * invoked on the worker thread.
+ */
+
+#ifndef SIGV4_POOL_HPP_
+#define SIGV4_POOL_HPP_
+
+/* Standard includes. */
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined( __linux__ )
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+/* Include the C++ interface. */
+#include "sigv4.hpp"
+
+namespace sigv4
+{
+    namespace detail
+    {
+        /**
+         * @brief Bounded lock-free multi-producer multi-consumer queue.
+         *
+         * Every cell carries a sequence number that tells producers and
+         * consumers whether the cell is free for the current lap of the ring.
+         *
+         * @tparam T Trivially copyable element type.
+         * @tparam Capacity Number of cells, a power of two.
+         */
+        template< typename T,
+                  std::size_t Capacity >
+        class BoundedQueue
+        {
+        public:
+            static_assert( ( Capacity >= 2U ) && ( ( Capacity & ( Capacity - 1U ) ) == 0U ),
+                           "Capacity must be a power of two." );
+
+            BoundedQueue() noexcept
+            {
+                for( std::size_t i = 0U; i < Capacity; i++ )
+                {
+                    cells_[ i ].sequence.store( i, std::memory_order_relaxed );
+                }
+            }
+
+            BoundedQueue( const BoundedQueue & ) = delete;
+            BoundedQueue & operator=( const BoundedQueue & ) = delete;
+
+            /**
+             * @brief Append @p item, or return false if the queue is full.
+             */
+            bool tryPush( const T & item ) noexcept
+            {
+                bool pushed = false;
+                bool done = false;
+                std::size_t pos = enqueuePos_.load( std::memory_order_relaxed );
+                Cell * pCell = nullptr;
+
+                while( !done )
+                {
+                    pCell = &cells_[ pos & ( Capacity - 1U ) ];
+                    const std::size_t sequence = pCell->sequence.load( std::memory_order_acquire );
+                    const std::intptr_t diff = static_cast< std::intptr_t >( sequence ) - static_cast< std::intptr_t >( pos );
+
+                    if( diff == 0 )
+                    {
+                        /* The cell is free for this lap; claim it. */
+                        pushed = enqueuePos_.compare_exchange_weak( pos, pos + 1U, std::memory_order_relaxed );
+                        done = pushed;
+                    }
+                    else if( diff < 0 )
+                    {
+                        /* The consumer of the previous lap has not freed the cell. */
+                        done = true;
+                    }
+                    else
+                    {
+                        pos = enqueuePos_.load( std::memory_order_relaxed );
+                    }
+                }
+
+                if( pushed )
+                {
+                    pCell->data = item;
+                    pCell->sequence.store( pos + 1U, std::memory_order_release );
+                }
+
+                return pushed;
+            }
+
+            /**
+             * @brief Remove the oldest item into @p pItem, or return false if the
+             * queue is empty.
+             */
+            bool tryPop( T * pItem ) noexcept
+            {
+                bool popped = false;
+                bool done = false;
+                std::size_t pos = dequeuePos_.load( std::memory_order_relaxed );
+                Cell * pCell = nullptr;
+
+                while( !done )
+                {
+                    pCell = &cells_[ pos & ( Capacity - 1U ) ];
+                    const std::size_t sequence = pCell->sequence.load( std::memory_order_acquire );
+                    const std::intptr_t diff = static_cast< std::intptr_t >( sequence ) - static_cast< std::intptr_t >( pos + 1U );
+
+                    if( diff == 0 )
+                    {
+                        /* The cell was published for this lap; claim it. */
+                        popped = dequeuePos_.compare_exchange_weak( pos, pos + 1U, std::memory_order_relaxed );
+                        done = popped;
+                    }
+                    else if( diff < 0 )
+                    {
+                        /* No producer has published this cell yet. */
+                        done = true;
+                    }
+                    else
+                    {
+                        pos = dequeuePos_.load( std::memory_order_relaxed );
+                    }
+                }
+
+                if( popped )
+                {
+                    *pItem = pCell->data;
+                    pCell->sequence.store( pos + Capacity, std::memory_order_release );
+                }
+
+                return popped;
+            }
+
+            /**
+             * @brief Whether an item was claimed by a producer but not yet by a
+             * consumer. The result is approximate under concurrent access.
+             */
+            bool hasPending() const noexcept
+            {
+                return enqueuePos_.load( std::memory_order_seq_cst ) != dequeuePos_.load( std::memory_order_seq_cst );
+            }
+
+        private:
+
+            struct Cell
+            {
+                std::atomic< std::size_t > sequence { 0U };
+                T data {};
+            };
+
+            std::array< Cell, Capacity > cells_;
+            alignas( 64 ) std::atomic< std::size_t > enqueuePos_ { 0U };
+            alignas( 64 ) std::atomic< std::size_t > dequeuePos_ { 0U };
+        };
+    } /* namespace detail */
+
+    /**
+     * @brief Pool of threads, each signing requests with its own signer.
+     *
+     * @code{cpp}
+     * sigv4::SigningPool<> pool( 4U,
+     *                            []( std::size_t worker ) { return cryptoInterfaces[ worker ]; },
+     *                            credentials, "us-east-1", "execute-api" );
+     *
+     * sigv4::SigningPool<>::Job job;
+     * job.request = request;
+     * job.dateIso8601 = date;
+     * job.onDone = onSigned;
+     * job.pContext = pConnection;
+     *
+     * if( !pool.submit( job ) )
+     * {
+     *     // All queues are full; retry later or sign inline.
+     * }
+     * @endcode
+     *
+     * @tparam QueueCapacity Number of jobs each worker queue holds, a power of two.
+     * @tparam SignerType A #BasicSigner specialization.
+     */
+    template< std::size_t QueueCapacity = 256U,
+              typename SignerType = Signer >
+    class SigningPool
+    {
+    public:
+
+        /**
+         * @brief Completion callback, invoked on the worker thread.
+         *
+         * The views in @p authorization are only valid for the duration of the
+         * call.
+         */
+        using Completion = void ( * )( void * pContext,
+                                       const Authorization & authorization );
+
+        /**
+         * @brief A request to sign.
+         *
+         * Everything the request refers to must stay valid until @ref onDone
+         * is invoked.
+         */
+        struct Job
+        {
+            Request request;              /**< @brief The HTTP request to sign. */
+            std::string_view dateIso8601; /**< @brief The request date in ISO 8601 format. */
+            Completion onDone = nullptr;  /**< @brief Callback receiving the result. */
+            void * pContext = nullptr;    /**< @brief Application context passed to @ref onDone. */
+        };
+
+        /**
+         * @brief Start @p workerCount workers.
+         *
+         * @param[in] workerCount Number of worker threads, at least one.
+         * @param[in] cryptoFor Callable returning the #SigV4CryptoInterface_t of
+         * the worker whose index it is given; every worker needs its own hash
+         * context.
+         * @param[in] credentials The AWS credentials.
+         * @param[in] region The target AWS region.
+         * @param[in] service The target AWS service.
+         * @param[in] pinToCores Whether to pin worker i to CPU i modulo the number
+         * of CPUs. Only supported on Linux; ignored elsewhere.
+         *
+         * @throw std::system_error if a worker thread cannot be started, once
+         * the workers already started were stopped and joined.
+         */
+        template< typename CryptoFactory >
+        SigningPool( std::size_t workerCount,
+                     CryptoFactory && cryptoFor,
+                     Credentials credentials,
+                     std::string_view region,
+                     std::string_view service,
+                     bool pinToCores = false )
+        {
+            const std::size_t count = ( workerCount > 0U ) ? workerCount : 1U;
+
+            workers_.reserve( count );
+
+            for( std::size_t i = 0U; i < count; i++ )
+            {
+                workers_.push_back( std::make_unique< Worker >( cryptoFor( i ), credentials, region, service ) );
+            }
+
+            /* Threads are started once all queues exist, as workers steal from each other. */
+            try
+            {
+                for( std::size_t i = 0U; i < count; i++ )
+                {
+                    workers_[ i ]->thread = std::thread( [ this, i ]() noexcept
+                                                         {
+                                                             run( i );
+                                                         } );
+
+                    if( pinToCores )
+                    {
+                        pin( workers_[ i ]->thread, i );
+                    }
+                }
+            }
+            catch( ... )
+            {
+                /* Destroying a joinable thread terminates the program. */
+                stop();
+                throw;
+            }
+        }
+
+        SigningPool( const SigningPool & ) = delete;
+        SigningPool & operator=( const SigningPool & ) = delete;
+
+        /**
+         * @brief Complete all submitted jobs, then stop the workers.
+         */
+        ~SigningPool()
+        {
+            stop();
+        }
+
+        /**
+         * @brief Queue @p job for signing.
+         *
+         * @return true if the job was queued, false if the pool is stopping or
+         * all worker queues are full.
+         */
+        bool submit( const Job & job ) noexcept
+        {
+            bool queued = false;
+            const std::size_t count = workers_.size();
+            const std::size_t start = nextWorker_.fetch_add( 1U, std::memory_order_relaxed );
+
+            if( !stopping_.load( std::memory_order_relaxed ) )
+            {
+                for( std::size_t i = 0U; ( i < count ) && !queued; i++ )
+                {
+                    queued = workers_[ ( start + i ) % count ]->queue.tryPush( job );
+                }
+            }
+
+            if( queued )
+            {
+                /* A read-modify-write, so that it is ordered against the one in
+                 * park(): either a parking worker sees the job, or this thread
+                 * sees the worker parking. */
+                if( sleepers_.fetch_add( 0U, std::memory_order_seq_cst ) > 0U )
+                {
+                    std::lock_guard< std::mutex > lock( parkMutex_ );
+                    parkCondition_.notify_one();
+                }
+            }
+
+            return queued;
+        }
+
+        /**
+         * @brief The number of workers.
+         */
+        std::size_t workerCount() const noexcept
+        {
+            return workers_.size();
+        }
+
+    private:
+
+        struct Worker
+        {
+            Worker( const SigV4CryptoInterface_t & cryptoInterface,
+                    Credentials credentials,
+                    std::string_view region,
+                    std::string_view service ) noexcept
+                : signer( cryptoInterface, credentials, region, service )
+            {
+            }
+
+            detail::BoundedQueue< Job, QueueCapacity > queue;
+            SignerType signer;
+            std::thread thread;
+        };
+
+        /**
+         * @brief Take a job from worker @p self's queue, or steal one from the
+         * other workers.
+         */
+        bool take( std::size_t self,
+                   Job * pJob ) noexcept
+        {
+            bool found = false;
+            const std::size_t count = workers_.size();
+
+            for( std::size_t i = 0U; ( i < count ) && !found; i++ )
+            {
+                found = workers_[ ( self + i ) % count ]->queue.tryPop( pJob );
+            }
+
+            return found;
+        }
+
+        bool hasPending() const noexcept
+        {
+            bool pending = false;
+
+            for( const std::unique_ptr< Worker > & pWorker : workers_ )
+            {
+                pending = pending || pWorker->queue.hasPending();
+            }
+
+            return pending;
+        }
+
+        /**
+         * @brief Block until a job may be available or the pool is stopping.
+         */
+        void park() noexcept
+        {
+            std::unique_lock< std::mutex > lock( parkMutex_ );
+
+            ( void ) sleepers_.fetch_add( 1U, std::memory_order_seq_cst );
+
+            if( !hasPending() && !stopping_.load( std::memory_order_relaxed ) )
+            {
+                parkCondition_.wait( lock );
+            }
+
+            ( void ) sleepers_.fetch_sub( 1U, std::memory_order_relaxed );
+        }
+
+        /**
+         * @brief Let the workers complete the queued jobs and exit, and join
+         * the workers that were started.
+         */
+        void stop() noexcept
+        {
+            stopping_.store( true, std::memory_order_seq_cst );
+
+            {
+                std::lock_guard< std::mutex > lock( parkMutex_ );
+                parkCondition_.notify_all();
+            }
+
+            for( std::unique_ptr< Worker > & pWorker : workers_ )
+            {
+                if( pWorker->thread.joinable() )
+                {
+                    pWorker->thread.join();
+                }
+            }
+        }
+
+        void run( std::size_t self ) noexcept
+        {
+            Worker & worker = *workers_[ self ];
+            Job job;
+            bool running = true;
+
+            while( running )
+            {
+                if( take( self, &job ) )
+                {
+                    const Authorization authorization = worker.signer.sign( job.request, job.dateIso8601 );
+
+                    if( job.onDone != nullptr )
+                    {
+                        job.onDone( job.pContext, authorization );
+                    }
+                }
+                else if( stopping_.load( std::memory_order_seq_cst ) && !hasPending() )
+                {
+                    running = false;
+                }
+                else
+                {
+                    park();
+                }
+            }
+        }
+
+        static void pin( std::thread & thread,
+                         std::size_t index ) noexcept
+        {
+            #if defined( __linux__ )
+                const unsigned int cpuCount = std::thread::hardware_concurrency();
+                cpu_set_t cpus;
+
+                if( cpuCount > 0U )
+                {
+                    CPU_ZERO( &cpus );
+                    CPU_SET( static_cast< int >( index % cpuCount ), &cpus );
+                    ( void ) pthread_setaffinity_np( thread.native_handle(), sizeof( cpus ), &cpus );
+                }
+            #else
+                ( void ) thread;
+                ( void ) index;
+            #endif
+        }
+
+        std::vector< std::unique_ptr< Worker > > workers_;
+        std::atomic< std::size_t > nextWorker_ { 0U };
+        std::atomic< std::size_t > sleepers_ { 0U };
+        std::atomic< bool > stopping_ { false };
+        std::mutex parkMutex_;
+        std::condition_variable parkCondition_;
+    };
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_POOL_HPP_ */
@@ -66,6 +66,9 @@ typedef int32_t ( * ComparisonFunc_t )( const void * pFirstVal,
 /**
  * @brief Perform quicksort on an array.
  *
+ * Subarrays on which quicksort degenerates are finished with heapsort, so the
+ * number of comparisons is O(n log n) for any order of the items.
+ *
  * @param[in] pArray The array to be sorted.
  * @param[in] numItems The number of items in an array.
  * @param[in] itemSize The amount of memory per entry in the array.
@@ -0,0 +1,368 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_replay.hpp
+ * @brief Optional C++ index of recently seen signatures, for local verifiers
+ * of SigV4 requests to reject replays within the allowed clock skew.
+ *
+ * The index is a time wheel with one bucket per second of x-amz-date. Each
+ * bucket is an open-addressed set of 64-bit slots, each holding a fingerprint
+ * of a signature and a tag of its second, so the slots of seconds that slid
+ * out of the window are recognized as free and reused without being cleared.
+ * Inserts and lookups probe a bounded number of adjacent slots with atomic
+ * loads and compare-and-swap, and never block.
+ */
+
+#ifndef SIGV4_REPLAY_HPP_
+#define SIGV4_REPLAY_HPP_
+
+/* Standard includes. */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/* Include the C++ interface. */
+#include "sigv4.hpp"
+
+namespace sigv4
+{
+    namespace detail
+    {
+        /**
+         * @brief Convert an ISO 8601 date of the "YYYYMMDD'T'HHMMSS'Z'" form,
+         * as sent in x-amz-date, to seconds since the Unix epoch.
+         *
+         * @return false if the date is malformed, does not exist, or is before
+         * 1970.
+         */
+        inline bool iso8601ToEpochSeconds( std::string_view date,
+                                           std::uint64_t * pSeconds ) noexcept
+        {
+            constexpr std::size_t kOffsets[ 6 ] = { 0U, 4U, 6U, 9U, 11U, 13U };
+            constexpr std::size_t kWidths[ 6 ] = { 4U, 2U, 2U, 2U, 2U, 2U };
+            constexpr std::uint64_t kMonthDays[ 12 ] = { 31U, 28U, 31U, 30U, 31U, 30U, 31U, 31U, 30U, 31U, 30U, 31U };
+            std::uint64_t fields[ 6 ] = {};
+            bool isValid = ( date.size() == SIGV4_ISO_STRING_LEN ) &&
+                           ( date[ 8 ] == 'T' ) &&
+                           ( date[ SIGV4_ISO_STRING_LEN - 1U ] == 'Z' );
+
+            for( std::size_t i = 0U; isValid && ( i < 6U ); i++ )
+            {
+                for( std::size_t j = 0U; isValid && ( j < kWidths[ i ] ); j++ )
+                {
+                    const char digit = date[ kOffsets[ i ] + j ];
+                    isValid = ( digit >= '0' ) && ( digit <= '9' );
+                    fields[ i ] = ( fields[ i ] * 10U ) + static_cast< std::uint64_t >( digit - '0' );
+                }
+            }
+
+            const std::uint64_t year = fields[ 0 ], month = fields[ 1 ], day = fields[ 2 ];
+            const bool isLeapYear = ( ( year % 4U ) == 0U ) && ( ( ( year % 100U ) != 0U ) || ( ( year % 400U ) == 0U ) );
+
+            isValid = isValid && ( year >= 1970U ) &&
+                      ( month >= 1U ) && ( month <= 12U ) &&
+                      ( day >= 1U ) &&
+                      ( day <= ( kMonthDays[ month - 1U ] + ( ( ( month == 2U ) && isLeapYear ) ? 1U : 0U ) ) ) &&
+                      ( fields[ 3 ] < 24U ) && ( fields[ 4 ] < 60U ) && ( fields[ 5 ] < 60U );
+
+            if( isValid )
+            {
+                /* Days since the epoch, counting years from March so that the
+                 * leap day is the last day of the year. */
+                const std::uint64_t marchYear = ( month <= 2U ) ? ( year - 1U ) : year;
+                const std::uint64_t marchMonth = ( month <= 2U ) ? ( month + 9U ) : ( month - 3U );
+                const std::uint64_t dayOfYear = ( ( ( 153U * marchMonth ) + 2U ) / 5U ) + day - 1U;
+                const std::uint64_t days = ( 365U * marchYear ) + ( marchYear / 4U ) - ( marchYear / 100U ) +
+                                           ( marchYear / 400U ) + dayOfYear - 719468U;
+
+                *pSeconds = ( days * 86400U ) + ( fields[ 3 ] * 3600U ) + ( fields[ 4 ] * 60U ) + fields[ 5 ];
+            }
+
+            return isValid;
+        }
+    } /* namespace detail */
+
+    /**
+     * @brief Outcome of recording a signature in a #ReplayIndex.
+     */
+    enum class ReplayStatus
+    {
+        Fresh,         /**< @brief The signature was not seen before, and is now recorded. */
+        Replayed,      /**< @brief The signature was already recorded for the same date. */
+        OutsideWindow, /**< @brief The date is malformed, or further from now than the window. */
+        Full           /**< @brief The probed slots of the date's second are all taken. */
+    };
+
+    /**
+     * @brief Fixed-memory index of the signatures seen within a clock-skew
+     * window, to reject replayed requests.
+     *
+     * Signatures are recorded in the bucket of their x-amz-date second. The
+     * wheel has a power of two of buckets, at least twice the window plus one,
+     * so a bucket is only reused by a second that is out of the window of
+     * every date still accepted in it. Each slot holds a 47-bit fingerprint of
+     * the signature, a top bit always set so that no slot in use is zero, and
+     * the 16 low bits of the lap of the wheel its second is in; a slot tagged
+     * with another lap is free. A false replay needs two signatures of the
+     * same second to share a fingerprint, which happens with a probability of
+     * about n^2 / 2^48 for n signatures in that second: once in 2^34 seconds
+     * at 128 requests per second.
+     *
+     * The index takes the wheel size times the slots per second times eight
+     * bytes, allocated once by the constructor; size the slots per second to
+     * about twice the peak number of requests per second. Both are rounded up
+     * to powers of two, so each can nearly double the memory: a 900 second
+     * window takes a 2048 second wheel, not 1801. Any number of threads may
+     * call #insert and #contains concurrently.
+     *
+     * @code{cpp}
+     * // A 2048 second wheel of 256 slots of 8 bytes takes 4 MiB, for up to
+     * // about 128 requests per second.
+     * static sigv4::ReplayIndex replays( 900U, 256U );
+     *
+     * // After the signature of the request was verified:
+     * switch( replays.insert( signature, amzDate, time( nullptr ) ) )
+     * {
+     *     case sigv4::ReplayStatus::Fresh:
+     *         // Accept the request.
+     *         break;
+     *
+     *     default:
+     *         // Reject the request; a full bucket is treated as a replay.
+     *         break;
+     * }
+     * @endcode
+     */
+    class ReplayIndex
+    {
+    public:
+
+        /**
+         * @brief The largest number of slots probed by an insert or a lookup.
+         */
+        static constexpr std::size_t kMaxProbes = 32U;
+
+        /**
+         * @brief Create an empty index.
+         *
+         * @param[in] windowSeconds The largest accepted difference, in seconds,
+         * between the date of a request and now.
+         * @param[in] slotsPerSecond The number of signatures each second holds,
+         * rounded up to a power of two.
+         */
+        ReplayIndex( std::uint32_t windowSeconds,
+                     std::size_t slotsPerSecond )
+            : windowSeconds_( windowSeconds ),
+            wheelSeconds_( roundUpToPowerOfTwo( ( 2U * static_cast< std::size_t >( windowSeconds ) ) + 1U ) ),
+            slotsPerSecond_( roundUpToPowerOfTwo( slotsPerSecond ) ),
+            probes_( ( slotsPerSecond_ < kMaxProbes ) ? slotsPerSecond_ : kMaxProbes ),
+            slots_( std::make_unique< std::atomic< std::uint64_t >[] >( wheelSeconds_ * slotsPerSecond_ ) )
+        {
+        }
+
+        ReplayIndex( const ReplayIndex & ) = delete;
+        ReplayIndex & operator=( const ReplayIndex & ) = delete;
+
+        /**
+         * @brief Record a signature, unless it was already recorded for the same
+         * date.
+         *
+         * @param[in] signature The signature, raw or hex-encoded; the same
+         * encoding must be used for every call.
+         * @param[in] dateIso8601 The x-amz-date of the request.
+         * @param[in] nowSeconds The current time, in seconds since the Unix epoch.
+         *
+         * @return #ReplayStatus::Fresh if the request is not a replay.
+         */
+        ReplayStatus insert( std::string_view signature,
+                             std::string_view dateIso8601,
+                             std::uint64_t nowSeconds ) noexcept
+        {
+            ReplayStatus status = ReplayStatus::OutsideWindow;
+            std::uint64_t second = 0U;
+
+            if( secondInWindow( dateIso8601, nowSeconds, &second ) )
+            {
+                const std::uint64_t hash = fingerprint( signature );
+                const std::uint64_t value = slotValue( hash, second );
+                std::atomic< std::uint64_t > * pBucket = bucket( second );
+                std::size_t probe = 0U;
+
+                status = ReplayStatus::Full;
+
+                while( probe < probes_ )
+                {
+                    std::atomic< std::uint64_t > & slot = pBucket[ ( hash + probe ) & ( slotsPerSecond_ - 1U ) ];
+                    std::uint64_t current = slot.load( std::memory_order_acquire );
+
+                    if( current == value )
+                    {
+                        status = ReplayStatus::Replayed;
+                        probe = probes_;
+                    }
+                    else if( isLive( current, second ) )
+                    {
+                        probe++;
+                    }
+                    else if( slot.compare_exchange_strong( current, value,
+                                                           std::memory_order_acq_rel,
+                                                           std::memory_order_acquire ) )
+                    {
+                        status = ReplayStatus::Fresh;
+                        probe = probes_;
+                    }
+                    else
+                    {
+                        /* Another insert took the slot first; look at it again,
+                         * as it may hold the same signature. */
+                    }
+                }
+            }
+
+            return status;
+        }
+
+        /**
+         * @brief Whether a signature is recorded for a date.
+         *
+         * Dates outside the window are never found, as #insert does not record
+         * them and the buckets of their seconds may already be reused.
+         *
+         * @param[in] signature The signature, encoded as for #insert.
+         * @param[in] dateIso8601 The x-amz-date of the request.
+         * @param[in] nowSeconds The current time, in seconds since the Unix epoch.
+         */
+        bool contains( std::string_view signature,
+                       std::string_view dateIso8601,
+                       std::uint64_t nowSeconds ) const noexcept
+        {
+            bool isFound = false;
+            std::uint64_t second = 0U;
+
+            if( secondInWindow( dateIso8601, nowSeconds, &second ) )
+            {
+                const std::uint64_t hash = fingerprint( signature );
+                const std::uint64_t value = slotValue( hash, second );
+                const std::atomic< std::uint64_t > * pBucket = bucket( second );
+                std::size_t probe = 0U;
+
+                /* Inserts take the first free slot, so the search ends at one. */
+                while( probe < probes_ )
+                {
+                    const std::uint64_t current = pBucket[ ( hash + probe ) & ( slotsPerSecond_ - 1U ) ].load( std::memory_order_acquire );
+
+                    isFound = ( current == value );
+                    probe = ( isFound || !isLive( current, second ) ) ? probes_ : ( probe + 1U );
+                }
+            }
+
+            return isFound;
+        }
+
+    private:
+
+        /**
+         * @brief Bits of a slot holding the lap tag of its second.
+         */
+        static constexpr std::uint64_t kLapMask = 0xFFFFU;
+
+        /**
+         * @brief Get the second of @p dateIso8601, if it is well formed and
+         * within the window around @p nowSeconds.
+         */
+        bool secondInWindow( std::string_view dateIso8601,
+                             std::uint64_t nowSeconds,
+                             std::uint64_t * pSecond ) const noexcept
+        {
+            return detail::iso8601ToEpochSeconds( dateIso8601, pSecond ) &&
+                   ( *pSecond <= ( nowSeconds + windowSeconds_ ) ) &&
+                   ( ( *pSecond + windowSeconds_ ) >= nowSeconds );
+        }
+
+        static std::size_t roundUpToPowerOfTwo( std::size_t value ) noexcept
+        {
+            std::size_t rounded = 1U;
+
+            while( rounded < value )
+            {
+                rounded <<= 1U;
+            }
+
+            return rounded;
+        }
+
+        /**
+         * @brief 64-bit FNV-1a hash of the signature.
+         */
+        static std::uint64_t fingerprint( std::string_view signature ) noexcept
+        {
+            std::uint64_t hash = 14695981039346656037ULL;
+
+            for( const char c : signature )
+            {
+                hash ^= static_cast< std::uint8_t >( c );
+                hash *= 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+        /**
+         * @brief The slot value of a signature for a second: bits 16 to 62 of
+         * its hash, the top bit always set so that no value is zero, and the
+         * lap tag of the second.
+         */
+        std::uint64_t slotValue( std::uint64_t hash,
+                                 std::uint64_t second ) const noexcept
+        {
+            return ( ( hash | ( 1ULL << 63 ) ) & ~kLapMask ) | ( ( second / wheelSeconds_ ) & kLapMask );
+        }
+
+        /**
+         * @brief Whether a slot of the bucket of @p second holds a signature of
+         * that second, rather than nothing or one of an earlier lap.
+         */
+        bool isLive( std::uint64_t slot,
+                     std::uint64_t second ) const noexcept
+        {
+            return ( slot != 0U ) && ( ( slot & kLapMask ) == ( ( second / wheelSeconds_ ) & kLapMask ) );
+        }
+
+        std::atomic< std::uint64_t > * bucket( std::uint64_t second ) const noexcept
+        {
+            return &slots_[ static_cast< std::size_t >( second & ( wheelSeconds_ - 1U ) ) * slotsPerSecond_ ];
+        }
+
+        std::uint64_t windowSeconds_;
+        std::size_t wheelSeconds_;
+        std::size_t slotsPerSecond_;
+        std::size_t probes_;
+        std::unique_ptr< std::atomic< std::uint64_t >[] > slots_;
+    };
+} /* namespace sigv4 */
+
+#endif /* ifndef SIGV4_REPLAY_HPP_ */
@@ -65,15 +65,63 @@
  *
  * @param[in] pQuery HTTP request query.
  * @param[in] queryLen Length of pQuery.
+ * @param[in] pQueryWrap The rest of the query, or NULL.
+ * @param[in] queryWrapLen Length of pQueryWrap.
  * @param[in] doubleEncodeEqualsInParmsValues whether to double-encode any equals ( = ) characters in parameter values.
  * @param[in, out] pCanonicalContext Struct to maintain intermediary buffer
  * and state of canonicalization.
  */
     static SigV4Status_t generateCanonicalQuery( const char * pQuery,
                                                  size_t queryLen,
+                                                 const char * pQueryWrap,
+                                                 size_t queryWrapLen,
                                                  const bool doubleEncodeEqualsInParmsValues,
                                                  CanonicalContext_t * pCanonicalContext );
 
+/**
+ * @brief URI-encode the parsed query parameters at the cursor of the
+ * canonical request, each followed by '&', and point the parsed parameters to
+ * their encoded form.
+ *
+ * @param[in, out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[in] numberOfParameters Number of parsed query parameters.
+ * @param[in] doubleEncodeEqualsInParmsValues whether to double-encode any equals ( = ) characters in parameter values.
+ * @param[out] pEncodedQueryLen Length of the encoded parameters.
+ *
+ * @return #SigV4Success if the parameters were encoded, #SigV4InsufficientMemory
+ * if the processing buffer cannot hold them.
+ */
+    static SigV4Status_t encodeQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                                size_t numberOfParameters,
+                                                const bool doubleEncodeEqualsInParmsValues,
+                                                size_t * pEncodedQueryLen );
+
+/**
+ * @brief Put the sorted encoded query parameters in order by copying them to
+ * the free space after them, and then back.
+ *
+ * @param[in, out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[in] numberOfParameters Number of query parameters.
+ * @param[in] encodedQueryLen Length of the encoded parameters, which must not
+ * exceed half of the remaining processing buffer.
+ */
+    static void copySortedQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                           size_t numberOfParameters,
+                                           size_t encodedQueryLen );
+
+/**
+ * @brief Put the sorted encoded query parameters in order in place, by
+ * rotating each one in front of the parameters that were stored before it.
+ *
+ * @param[in, out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[in] numberOfParameters Number of query parameters.
+ */
+    static void rotateSortedQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                             size_t numberOfParameters );
+
 /**
  * @brief Determine if a character can be written without needing URI encoding when generating Canonical Request.
  *
@@ -87,17 +135,232 @@
 
 /**
  * @brief Compare two SigV4 data structures lexicographically, without case-sensitivity.
+ * Two well-known header names are compared by their rank, and a name sorts
+ * before the longer names that start with it.
  *
  * @param[in] pFirstVal SigV4 key value data structure to sort.
  * @param[in] pSecondVal SigV4 key value data structure to sort.
  *
  * @return Returns a value less than 0 if @pFirstVal < @pSecondVal, or
- * a value greater than 0 if @pSecondVal < @pFirstVal. 0 is never returned in
- * order to provide stability to quickSort() calls.
+ * a value greater than 0 if @pSecondVal < @pFirstVal. 0 is only returned for
+ * names that are equal without case-sensitivity.
  */
     static int32_t cmpHeaderField( const void * pFirstVal,
                                    const void * pSecondVal );
 
+/**
+ * @brief Verify the input parameters of the query builder functions.
+ *
+ * @param[in] pBuilder The query builder.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey.
+ * @param[in] pValue The unencoded parameter value.
+ * @param[in] valueLen Length of pValue.
+ *
+ * @return #SigV4Success if the parameters are valid, #SigV4InvalidParameter
+ * otherwise.
+ */
+    static SigV4Status_t verifyQueryBuilderParams( const SigV4QueryBuilder_t * pBuilder,
+                                                   const char * pKey,
+                                                   size_t keyLen,
+                                                   const char * pValue,
+                                                   size_t valueLen );
+
+/**
+ * @brief Length of the query builder buffer that is in use: the canonical
+ * query and, if it is not empty, the '&' separator that follows its last
+ * parameter.
+ *
+ * @param[in] pBuilder The query builder.
+ *
+ * @return The number of bytes in use.
+ */
+    static size_t queryBuilderStoredLength( const SigV4QueryBuilder_t * pBuilder );
+
+/**
+ * @brief Encode a query parameter as "name=value&" right after the
+ * parameters stored in a query builder.
+ *
+ * @param[in] pBuilder The query builder.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey.
+ * @param[in] pValue The unencoded parameter value.
+ * @param[in] valueLen Length of pValue.
+ * @param[out] pEncodedKeyLen The length of the encoded name.
+ * @param[out] pEntryLen The length of the encoded parameter, including the
+ * trailing '&'.
+ *
+ * @return #SigV4Success if the parameter was encoded,
+ * #SigV4InsufficientMemory if it does not fit in the buffer.
+ */
+    static SigV4Status_t encodeQueryBuilderEntry( const SigV4QueryBuilder_t * pBuilder,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen,
+                                                  size_t * pEncodedKeyLen,
+                                                  size_t * pEntryLen );
+
+/**
+ * @brief Compare two encoded query parameter names, or two encoded values, by
+ * byte value; one that is a prefix of the other sorts first.
+ *
+ * @param[in] pFirstKey The first name.
+ * @param[in] firstKeyLen Length of pFirstKey.
+ * @param[in] pSecondKey The second name.
+ * @param[in] secondKeyLen Length of pSecondKey.
+ *
+ * @return A value less than, equal to, or greater than 0 if the first name
+ * sorts before, the same as, or after the second name.
+ */
+    static int32_t cmpEncodedQueryKey( const char * pFirstKey,
+                                       size_t firstKeyLen,
+                                       const char * pSecondKey,
+                                       size_t secondKeyLen );
+
+/**
+ * @brief Find the stored parameter with an encoded name, or the position at
+ * which it would be inserted.
+ *
+ * @param[in] pQuery The stored "name=value&" parameters, sorted by name.
+ * @param[in] storedLen Length of pQuery.
+ * @param[in] pKey The encoded parameter name.
+ * @param[in] keyLen Length of pKey.
+ * @param[out] pFoundLen Length of the stored parameter with the name,
+ * including its trailing '&', or 0 if there is none.
+ *
+ * @return The offset of the stored parameter, or of the insertion position.
+ */
+    static size_t findQueryBuilderEntry( const char * pQuery,
+                                         size_t storedLen,
+                                         const char * pKey,
+                                         size_t keyLen,
+                                         size_t * pFoundLen );
+
+/**
+ * @brief Skip the stored parameters that have the name of a new parameter and
+ * a value that does not sort after its value, so that a repeated name keeps all
+ * of its values, sorted by value.
+ *
+ * @param[in] pQuery The stored "name=value&" parameters, sorted by name and
+ * then by value.
+ * @param[in] storedLen Length of pQuery.
+ * @param[in] offset The offset of the first stored parameter that does not
+ * sort before the name.
+ * @param[in] pEntry The new encoded "name=value&" parameter.
+ * @param[in] keyLen Length of the name in pEntry.
+ * @param[in] entryLen Length of pEntry, including its trailing '&'.
+ *
+ * @return The offset at which the new parameter is inserted.
+ */
+    static size_t skipRepeatedQueryBuilderEntries( const char * pQuery,
+                                                   size_t storedLen,
+                                                   size_t offset,
+                                                   const char * pEntry,
+                                                   size_t keyLen,
+                                                   size_t entryLen );
+
+/**
+ * @brief Encode a query parameter and insert it in sorted position in a query
+ * builder.
+ *
+ * @param[in, out] pBuilder The query builder.
+ * @param[in] pKey The unencoded parameter name.
+ * @param[in] keyLen Length of pKey.
+ * @param[in] pValue The unencoded parameter value.
+ * @param[in] valueLen Length of pValue.
+ * @param[in] replaceKey Whether the parameter replaces a stored one with the
+ * same name, or is kept along with it.
+ *
+ * @return #SigV4Success if the parameter was inserted, or the error of
+ * #SigV4_SetQueryParameter otherwise.
+ */
+    static SigV4Status_t insertQueryBuilderEntry( SigV4QueryBuilder_t * pBuilder,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen,
+                                                  bool replaceKey );
+
+/**
+ * @brief Reverse a sequence of characters in place.
+ *
+ * @param[in, out] pData The characters to reverse.
+ * @param[in] dataLen Length of pData.
+ */
+    static void reverseCharacters( char * pData,
+                                   size_t dataLen );
+
+/**
+ * @brief Add data to a 32-bit FNV-1a hash, which is used to look up paths and
+ * header names in the application-owned caches.
+ *
+ * @param[in] hash The hash so far, or #FNV1A_32_OFFSET_BASIS to start a hash.
+ * @param[in] pData The data to hash.
+ * @param[in] dataLen Length of pData.
+ *
+ * @return The updated hash.
+ */
+    static uint32_t updateFnv1aHash( uint32_t hash,
+                                     const char * pData,
+                                     size_t dataLen );
+
+/**
+ * @brief Find a path in a path cache.
+ *
+ * @param[in] pPathCache The path cache.
+ * @param[in] pathHash The hash of pPath.
+ * @param[in] pPath The path to look up.
+ * @param[in] pathLen Length of pPath.
+ * @param[in] encodeTwice Whether the canonical path must be double-encoded.
+ *
+ * @return The entry holding the canonical form of the path, or NULL if the
+ * path is not cached.
+ */
+    static SigV4PathCacheEntry_t * findPathCacheEntry( SigV4PathCache_t * pPathCache,
+                                                       uint32_t pathHash,
+                                                       const char * pPath,
+                                                       size_t pathLen,
+                                                       bool encodeTwice );
+
+/**
+ * @brief Store a path and its canonical form in a path cache, replacing the
+ * least recently used entry. Paths that do not fit in an entry are not stored.
+ *
+ * @param[in, out] pPathCache The path cache.
+ * @param[in] pathHash The hash of pPath.
+ * @param[in] pPath The path.
+ * @param[in] pathLen Length of pPath.
+ * @param[in] encodeTwice Whether pCanonicalPath is double-encoded.
+ * @param[in] pCanonicalPath The canonical form of pPath.
+ * @param[in] canonicalPathLen Length of pCanonicalPath.
+ */
+    static void storePathCacheEntry( SigV4PathCache_t * pPathCache,
+                                     uint32_t pathHash,
+                                     const char * pPath,
+                                     size_t pathLen,
+                                     bool encodeTwice,
+                                     const char * pCanonicalPath,
+                                     size_t canonicalPathLen );
+
+/**
+ * @brief Write the canonical URI to the canonical request, from the path
+ * cache if it holds the path, or else by encoding the path with
+ * generateCanonicalURI() and caching the result.
+ *
+ * @param[in, out] pPathCache Optional path cache; may be NULL.
+ * @param[in] pUri HTTP request URI.
+ * @param[in] uriLen Length of pUri.
+ * @param[in] encodeTwice Whether the URI is encoded twice.
+ * @param[in, out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ */
+    static SigV4Status_t writeCanonicalURI( SigV4PathCache_t * pPathCache,
+                                            const char * pUri,
+                                            size_t uriLen,
+                                            bool encodeTwice,
+                                            CanonicalContext_t * pCanonicalRequest );
+
 #endif /* #if (SIGV4_USE_CANONICAL_SUPPORT == 1) */
 
 /**
@@ -120,8 +383,12 @@ static void intToAscii( int32_t value,
  *
  * @param[in] pHeaders HTTP headers to canonicalize.
  * @param[in] headersLen Length of HTTP headers to canonicalize.
+ * @param[in] pHeadersWrap The rest of the HTTP headers, or NULL.
+ * @param[in] headersWrapLen Length of pHeadersWrap.
  * @param[in] flags Flag to indicate if headers are already
  * in the canonical form.
+ * @param[in, out] pSignedHeadersCache Optional cache of the sort order and
+ * signed headers list; may be NULL.
  * @param[out] canonicalRequest Struct to maintain intermediary buffer
  * and state of canonicalization.
  * @param[out] pSignedHeaders The starting location of the signed headers.
@@ -136,11 +403,104 @@ static void intToAscii( int32_t value,
  */
 static SigV4Status_t generateCanonicalAndSignedHeaders( const char * pHeaders,
                                                         size_t headersLen,
+                                                        const char * pHeadersWrap,
+                                                        size_t headersWrapLen,
                                                         uint32_t flags,
+                                                        SigV4SignedHeadersCache_t * pSignedHeadersCache,
                                                         CanonicalContext_t * canonicalRequest,
                                                         char ** pSignedHeaders,
                                                         size_t * pSignedHeadersLen );
 
+/**
+ * @brief Put the parsed headers in canonical order: from the signed headers
+ * cache if it holds the same header names, or else by sorting them.
+ *
+ * @param[in] pSignedHeadersCache Optional signed headers cache; may be NULL.
+ * @param[in] headerCount Number of parsed headers.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[out] pFingerprint The fingerprint of the header names, if
+ * pSignedHeadersCache is not NULL.
+ *
+ * @return The canonical order of the headers held by the cache, or NULL if the
+ * headers were sorted in place.
+ */
+static const size_t * sortHeaders( const SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                   size_t headerCount,
+                                   CanonicalContext_t * pCanonicalRequest,
+                                   uint32_t * pFingerprint );
+
+/**
+ * @brief Write the signed headers list to the canonical request: from the
+ * signed headers cache on a hit, or else from the sorted headers, in which
+ * case the result is stored in the cache.
+ *
+ * @param[in, out] pSignedHeadersCache Optional signed headers cache; may be NULL.
+ * @param[in] pSortedOrder The order returned by sortHeaders().
+ * @param[in] fingerprint The fingerprint of the header names.
+ * @param[in] headerCount Number of parsed headers.
+ * @param[in] flags Flag to indicate if headers are already
+ * in the canonical form.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[out] pSignedHeaders The starting location of the signed headers.
+ * @param[out] pSignedHeadersLen The length of the signed headers.
+ */
+static SigV4Status_t writeSignedHeaders( SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                         const size_t * pSortedOrder,
+                                         uint32_t fingerprint,
+                                         size_t headerCount,
+                                         uint32_t flags,
+                                         CanonicalContext_t * pCanonicalRequest,
+                                         char ** pSignedHeaders,
+                                         size_t * pSignedHeadersLen );
+
+/**
+ * @brief Compute the fingerprint of the parsed header names, in the order they
+ * were given.
+ *
+ * @param[in] headerCount Number of parsed headers.
+ * @param[in] pCanonicalRequest Struct holding the parsed headers.
+ *
+ * @return The FNV-1a hash of the header names, each followed by ':'.
+ */
+static uint32_t fingerprintHeaderNames( size_t headerCount,
+                                        const CanonicalContext_t * pCanonicalRequest );
+
+/**
+ * @brief Check whether the signed headers cache holds the parsed header names.
+ *
+ * @param[in] pSignedHeadersCache The signed headers cache.
+ * @param[in] fingerprint The fingerprint of the parsed header names.
+ * @param[in] headerCount Number of parsed headers.
+ * @param[in] pCanonicalRequest Struct holding the parsed headers.
+ *
+ * @return `true` if the cached sort order puts the parsed header names in the
+ * cached canonical order, `false` otherwise.
+ */
+static bool matchSignedHeadersCache( const SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                     uint32_t fingerprint,
+                                     size_t headerCount,
+                                     const CanonicalContext_t * pCanonicalRequest );
+
+/**
+ * @brief Store the sort order, header names and signed headers list of the
+ * sorted headers in the signed headers cache, if they fit.
+ *
+ * @param[out] pSignedHeadersCache The signed headers cache.
+ * @param[in] fingerprint The fingerprint of the header names.
+ * @param[in] headerCount Number of parsed headers.
+ * @param[in] pCanonicalRequest Struct holding the sorted headers.
+ * @param[in] pSignedHeaders The signed headers list.
+ * @param[in] signedHeadersLen Length of pSignedHeaders.
+ */
+static void storeSignedHeadersCache( SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                     uint32_t fingerprint,
+                                     size_t headerCount,
+                                     const CanonicalContext_t * pCanonicalRequest,
+                                     const char * pSignedHeaders,
+                                     size_t signedHeadersLen );
+
 /**
  * @brief Append Signed Headers to the Canonical Request buffer.
  *
@@ -164,6 +524,8 @@ static SigV4Status_t appendSignedHeaders( size_t headerCount,
  * @param[in] headerCount Number of headers which needs to be appended.
  * @param[in] flags Flag to indicate if headers are already
  * in the canonical form.
+ * @param[in] pSortedOrder The position of the header at each position of the
+ * canonical order, or NULL if the headers are already in canonical order.
  * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
  * and state of canonicalization.
  *
@@ -173,22 +535,63 @@ static SigV4Status_t appendSignedHeaders( size_t headerCount,
  */
 static SigV4Status_t appendCanonicalizedHeaders( size_t headerCount,
                                                  uint32_t flags,
+                                                 const size_t * pSortedOrder,
                                                  CanonicalContext_t * pCanonicalRequest );
 
 /**
  * @brief Store the location of HTTP request hashed payload in the HTTP request.
  *
  * @param[in] headerIndex Index of request Header in the list of parsed headers.
- * @param[in] pAmzSHA256Header Literal for x-amz-content-sha256 header in HTTP request.
- * @param[in] amzSHA256HeaderLen Length of @p pAmzSHA256Header.
  * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
  * and state of canonicalization.
  */
 static void storeHashedPayloadLocation( size_t headerIndex,
-                                        const char * pAmzSHA256Header,
-                                        size_t amzSHA256HeaderLen,
                                         CanonicalContext_t * pCanonicalRequest );
 
+/**
+ * @brief Get the lowercase name of a well-known header.
+ *
+ * @param[in] rank The rank of the well-known header name, from 1 to
+ * #WELL_KNOWN_HEADER_COUNT.
+ *
+ * @return The lowercase header name.
+ */
+static const SigV4ConstString_t * getWellKnownHeaderName( uint8_t rank );
+
+/**
+ * @brief Look up a header name in the perfect hash table of well-known header
+ * names, without case-sensitivity.
+ *
+ * @param[in] pKey The header name.
+ * @param[in] keyLen Length of pKey.
+ *
+ * @return The rank of the header name in canonical order if it is well-known,
+ * 0 otherwise.
+ */
+static uint8_t rankWellKnownHeader( const char * pKey,
+                                    size_t keyLen );
+
+/**
+ * @brief Copy a header key to the Canonical Request buffer, using the lowercase
+ * name of a well-known header instead of lowercasing it.
+ *
+ * @param[in] pHeader The parsed header.
+ * @param[in] flags Flag to indicate if headers are already
+ * in the canonical form.
+ * @param[in] separator Character following the header key.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ *
+ * @return Following statuses will be returned by the function:
+ * #SigV4Success if the header key is successfully added to the canonical request.
+ * #SigV4InsufficientMemory if canonical request buffer cannot accommodate the header key.
+ * #SigV4InvalidParameter if the header key only holds spaces.
+ */
+static SigV4Status_t copyHeaderKeyToCanonicalBuffer( const SigV4KeyValuePair_t * pHeader,
+                                                     uint32_t flags,
+                                                     char separator,
+                                                     CanonicalContext_t * pCanonicalRequest );
+
 /**
  * @brief Parse each header key and value pair from HTTP headers.
  *
@@ -205,6 +608,7 @@ static void storeHashedPayloadLocation( size_t headerIndex,
  * #SigV4InsufficientMemory if canonical request buffer cannot accommodate the header.
  * #SigV4MaxHeaderPairCountExceeded if number of key-value entries in the headers data
  * exceeds the SIGV4_MAX_HTTP_HEADER_COUNT macro defined in the config file.
+ * #SigV4InvalidHttpHeaders if a header has no name, or no header is found.
  */
 static SigV4Status_t parseHeaderKeyValueEntries( const char * pHeaders,
                                                  size_t headersDataLen,
@@ -212,6 +616,177 @@ static SigV4Status_t parseHeaderKeyValueEntries( const char * pHeaders,
                                                  size_t * headerCount,
                                                  CanonicalContext_t * pCanonicalRequest );
 
+/**
+ * @brief Parse HTTP headers that may wrap around the end of a ring buffer,
+ * extracting the header keys and values into the canonical request.
+ *
+ * @param[in] pHeaders HTTP headers to parse.
+ * @param[in] headersDataLen Length of @p pHeaders.
+ * @param[in] pHeadersWrap The rest of the HTTP headers, or NULL.
+ * @param[in] headersWrapLen Length of @p pHeadersWrap.
+ * @param[in] flags Flag to indicate if headers are already
+ * in the canonical form.
+ * @param[out] headerCount Count of key-value pairs parsed from the headers.
+ * @param[out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ *
+ * @return #SigV4InsufficientMemory if the header line that straddles the end
+ * of @p pHeaders does not fit in the processing buffer, or else the status of
+ * parseHeaderKeyValueEntries().
+ */
+static SigV4Status_t parseWrappedHeaderKeyValueEntries( const char * pHeaders,
+                                                        size_t headersDataLen,
+                                                        const char * pHeadersWrap,
+                                                        size_t headersWrapLen,
+                                                        uint32_t flags,
+                                                        size_t * headerCount,
+                                                        CanonicalContext_t * pCanonicalRequest );
+
+/**
+ * @brief Parse a query string that may wrap around the end of a ring buffer,
+ * extracting the query parameters into the canonical request.
+ *
+ * @param[in] pQuery HTTP request query to parse.
+ * @param[in] queryLen Length of @p pQuery.
+ * @param[in] pQueryWrap The rest of the query, or NULL.
+ * @param[in] queryWrapLen Length of @p pQueryWrap.
+ * @param[out] pNumberOfParameters Number of query parameters parsed.
+ * @param[out] pStagedLen Length of the query parameter copied to the end of
+ * the processing buffer, which must be released once the query is encoded.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ *
+ * @return #SigV4InsufficientMemory if the query parameter that straddles the
+ * end of @p pQuery does not fit in the processing buffer, or else the status of
+ * parseQueryString().
+ */
+static SigV4Status_t parseWrappedQueryString( const char * pQuery,
+                                              size_t queryLen,
+                                              const char * pQueryWrap,
+                                              size_t queryWrapLen,
+                                              size_t * pNumberOfParameters,
+                                              size_t * pStagedLen,
+                                              CanonicalContext_t * pCanonicalRequest );
+
+/**
+ * @brief Split an input that wraps around the end of a ring buffer into
+ * pieces that each hold whole entries.
+ *
+ * @note The entry that straddles the end of the ring buffer is the only data
+ * that is copied, to the end of the processing buffer, where it is out of the
+ * way of the canonical request.
+ *
+ * @param[in] pData The start of the input.
+ * @param[in] dataLen Length of @p pData.
+ * @param[in] pWrap The rest of the input.
+ * @param[in] wrapLen Length of @p pWrap; must not be zero.
+ * @param[in] separator The character that ends each entry.
+ * @param[in] keepSeparator Whether the separators stay part of the pieces.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[out] pWrappedInput The pieces of the input.
+ *
+ * @return #SigV4Success, or #SigV4InsufficientMemory if the straddling entry
+ * does not fit in the processing buffer.
+ */
+static SigV4Status_t splitWrappedInput( const char * pData,
+                                        size_t dataLen,
+                                        const char * pWrap,
+                                        size_t wrapLen,
+                                        char separator,
+                                        bool keepSeparator,
+                                        CanonicalContext_t * pCanonicalRequest,
+                                        SigV4WrappedInput_t * pWrappedInput );
+
+/**
+ * @brief Set the seam of a wrapped input to the entry that straddles the end
+ * of the ring buffer, copying the entry only if it has bytes on both sides.
+ *
+ * @param[in] pDataTail The part of the entry before the end of the ring buffer.
+ * @param[in] dataTailLen Length of @p pDataTail.
+ * @param[in] pWrapHead The part of the entry after the end of the ring buffer.
+ * @param[in] wrapHeadLen Length of @p pWrapHead.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ * @param[out] pWrappedInput The wrapped input whose seam is set.
+ *
+ * @return #SigV4Success, or #SigV4InsufficientMemory if the entry does not
+ * fit in the processing buffer.
+ */
+static SigV4Status_t stageWrappedSeam( const char * pDataTail,
+                                       size_t dataTailLen,
+                                       const char * pWrapHead,
+                                       size_t wrapHeadLen,
+                                       CanonicalContext_t * pCanonicalRequest,
+                                       SigV4WrappedInput_t * pWrappedInput );
+
+/**
+ * @brief Check whether the request is signed for S3, the only service for
+ * which the path must be URI-encoded once instead of twice. A precomputed
+ * scope carries the answer, so that the service is not compared.
+ *
+ * @param[in] pParams Parameters for generating the SigV4 signature.
+ *
+ * @return `true` if the service is S3, `false` otherwise.
+ */
+static bool isS3Service( const SigV4Parameters_t * pParams );
+
+/**
+ * @brief Move a #SigV4Signer_t to @p state, closing the parts of the request
+ * of the states before it.
+ *
+ * @param[in, out] pSigner The signer.
+ * @param[in] state The state in which the next part of the request is taken.
+ *
+ * @return #SigV4Success if the signer is in @p state, #SigV4InvalidParameter
+ * if the signer is past @p state or the method was not pushed yet, the first
+ * error of a failed signer, or the status of enterNextSignerState().
+ */
+static SigV4Status_t advanceSigner( SigV4Signer_t * pSigner,
+                                    uint8_t state );
+
+/**
+ * @brief Move a #SigV4Signer_t to the state that follows its current state.
+ *
+ * @param[in, out] pSigner The signer.
+ *
+ * @return #SigV4Success, #SigV4InsufficientMemory if there is no room left
+ * for the query, or #SigV4HashError if the payload hash could not be started
+ * or finished.
+ */
+static SigV4Status_t enterNextSignerState( SigV4Signer_t * pSigner );
+
+/**
+ * @brief Get the flags of the HTTP parameters given to a #SigV4Signer_t.
+ *
+ * @param[in] pSigner The signer.
+ *
+ * @return The flags, or 0 if the signer has no HTTP parameters.
+ */
+static uint32_t signerHttpFlags( const SigV4Signer_t * pSigner );
+
+/**
+ * @brief Finish the payload hash of a #SigV4Signer_t and hex-encode the digest.
+ *
+ * @param[in, out] pSigner The signer.
+ *
+ * @return #SigV4Success, or #SigV4HashError if a hash operation failed.
+ */
+static SigV4Status_t finalizeSignerPayloadDigest( SigV4Signer_t * pSigner );
+
+/**
+ * @brief Fail a #SigV4Signer_t on an error that loses a part of the request,
+ * which is any error but a rejected parameter.
+ *
+ * @param[in, out] pSigner The signer; it is not used for #SigV4Success and
+ * #SigV4InvalidParameter, so it may be NULL then.
+ * @param[in] status The status of the call to the signer.
+ *
+ * @return @p status.
+ */
+static SigV4Status_t failSignerOnError( SigV4Signer_t * pSigner,
+                                        SigV4Status_t status );
+
 /**
  * @brief Copy header key or header value to the Canonical Request buffer.
  *
@@ -233,6 +808,48 @@ static SigV4Status_t copyHeaderStringToCanonicalBuffer( const char * pData,
                                                         char separator,
                                                         CanonicalContext_t * pCanonicalRequest );
 
+/**
+ * @brief Trim a header key or header value, lowercasing a header key, while
+ * copying it to the Canonical Request buffer.
+ *
+ * @param[in] pData Header Key or value to be copied to the canonical request.
+ * @param[in] dataLen Length of Header Key or value.
+ * @param[in] flags Flag to indicate if headers are already
+ * in the canonical form.
+ * @param[in] separator Character separating the multiple key-value pairs or key and values.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ *
+ * @return Following statuses will be returned by the function:
+ * #SigV4Success if the headers are successfully added to the canonical request.
+ * #SigV4InsufficientMemory if canonical request buffer cannot accommodate the header.
+ * #SigV4InvalidParameter if the header key or value only holds spaces.
+ */
+static SigV4Status_t trimHeaderStringToCanonicalBuffer( const char * pData,
+                                                        size_t dataLen,
+                                                        uint32_t flags,
+                                                        char separator,
+                                                        CanonicalContext_t * pCanonicalRequest );
+
+/**
+ * @brief Copy a header key or header value that is already lowercase and
+ * trimmed to the Canonical Request buffer as a whole.
+ *
+ * @param[in] pData Header Key or value to be copied to the canonical request.
+ * @param[in] dataLen Length of Header Key or value.
+ * @param[in] separator Character separating the multiple key-value pairs or key and values.
+ * @param[in,out] pCanonicalRequest Struct to maintain intermediary buffer
+ * and state of canonicalization.
+ *
+ * @return Following statuses will be returned by the function:
+ * #SigV4Success if the headers are successfully added to the canonical request.
+ * #SigV4InsufficientMemory if canonical request buffer cannot accommodate the header.
+ */
+static SigV4Status_t copyTrimmedHeaderStringToCanonicalBuffer( const char * pData,
+                                                               size_t dataLen,
+                                                               char separator,
+                                                               CanonicalContext_t * pCanonicalRequest );
+
 /**
  * @brief Helper function to determine whether a header string character represents a space
  * that can be trimmed when creating "Canonical Headers".
@@ -304,20 +921,67 @@ static SigV4Status_t generateAuthorizationValuePrefix( const SigV4Parameters_t *
                                                        size_t * pAuthPrefixLen );
 
 /**
- * @brief Write a line in the canonical request.
- * @note Used whenever there are components of the request that
- * are already canonicalized.
+ * @brief Add a line to the canonical request that is hashed directly from
+ * application memory, followed by a newline character, when the canonical
+ * request is hashed.
+ * @note Used for the HTTP method, for the components of the request that
+ * are already canonicalized, and for the components held by an application
+ * cache, so that they are not copied into the processing buffer.
  *
- * @param[in] pLine The line to write to the canonical request.
+ * @param[in] pLine The line to add to the canonical request. It must remain
+ * valid until the canonical request is hashed.
  * @param[in] lineLen The length of @p pLine
- * @param[in,out] pCanonicalContext The canonical context where
- * the line should be written.
- * @return SigV4InsufficientMemory if the length of the canonical request
- * buffer cannot write the desired line, #SigV4Success otherwise.
+ * @param[in,out] pCanonicalContext The canonical context to which the line
+ * is added at its current cursor.
+ */
+static void referenceLineInCanonicalRequest( const char * pLine,
+                                             size_t lineLen,
+                                             CanonicalContext_t * pCanonicalContext );
+
+/**
+ * @brief Add a line that wraps around the end of a ring buffer to the
+ * canonical request, to be hashed from the application's memory.
+ *
+ * @param[in] pLine The start of the line. It must remain valid until the
+ * canonical request is hashed.
+ * @param[in] lineLen The length of @p pLine
+ * @param[in] pWrap The rest of the line, or NULL. It must remain valid until
+ * the canonical request is hashed.
+ * @param[in] wrapLen The length of @p pWrap
+ * @param[in,out] pCanonicalContext The canonical context to which the line
+ * is added at its current cursor.
+ */
+static void referenceWrappedLineInCanonicalRequest( const char * pLine,
+                                                    size_t lineLen,
+                                                    const char * pWrap,
+                                                    size_t wrapLen,
+                                                    CanonicalContext_t * pCanonicalContext );
+
+/**
+ * @brief Get the length of the part of an input that wraps around the end of
+ * a ring buffer.
+ *
+ * @param[in] pWrap The wrapped part of the input, or NULL.
+ * @param[in] wrapLen The length of @p pWrap.
+ *
+ * @return @p wrapLen, or 0 if @p pWrap is NULL.
  */
-static SigV4Status_t writeLineToCanonicalRequest( const char * pLine,
-                                                  size_t lineLen,
-                                                  CanonicalContext_t * pCanonicalContext );
+static size_t wrappedLength( const char * pWrap,
+                             size_t wrapLen );
+
+/**
+ * @brief Make the wrapped part of an input the whole input when the ring
+ * buffer wrapped right at its start, so that the first part is never empty.
+ *
+ * @param[in,out] ppData The first part of the input, or NULL.
+ * @param[in,out] pDataLen The length of @p ppData.
+ * @param[in,out] ppWrap The wrapped part of the input, or NULL.
+ * @param[in,out] pWrapLen The length of @p ppWrap.
+ */
+static void skipEmptyWrappedHead( const char ** ppData,
+                                  size_t * pDataLen,
+                                  const char ** ppWrap,
+                                  size_t * pWrapLen );
 
 /**
  * @brief Set a query parameter key in the canonical request.
@@ -455,22 +1119,83 @@ static int32_t completeHmac( HmacContext_t * pHmacContext,
                              size_t outputLen );
 
 /**
- * @brief Generates the complete hash of an input string, then write
- * the digest in the provided output buffer.
- * @note Unlike #completeHashAndHexEncode, this function will not
- * encode the hash and will simply output the bytes written by the
- * hash function.
+ * @brief Checks whether the crypto interface provides its own HMAC
+ * implementation.
  *
- * @param[in] pInput The data passed as input to the hash function.
- * @param[in] inputLen The length of @p pInput.
- * @param[out] pOutput The buffer onto which to write the hash.
- * @param[out] outputLen The length of @p pOutput and must be greater
- * than pCryptoInterface->hashDigestLen for this function to succeed.
  * @param[in] pCryptoInterface The interface used to call hash functions.
- * @return Zero on success, all other return values are failures.
+ * @return True if hmacInit, hmacUpdate, and hmacFinal are all set.
  */
-static int32_t completeHash( const uint8_t * pInput,
+static bool hasNativeHmac( const SigV4CryptoInterface_t * pCryptoInterface );
+
+/**
+ * @brief Generates the complete HMAC digest through the HMAC interfaces of the
+ * crypto interface instead of the built-in HMAC implementation.
+ *
+ * @param[in] pHmacContext The context used for the current HMAC calculation.
+ * It may already hold a prefix of the key.
+ * @param[in] pKey The rest of the key passed as input to the HMAC function.
+ * @param[in] keyLen The length of @p pKey.
+ * @param[in] pData The data passed as input to the HMAC function.
+ * @param[in] dataLen The length of @p pData.
+ * @param[out] pOutput The buffer onto which to write the HMAC digest.
+ * @param[out] outputLen The length of @p pOutput.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t completeNativeHmac( HmacContext_t * pHmacContext,
+                                   const char * pKey,
+                                   size_t keyLen,
+                                   const char * pData,
+                                   size_t dataLen,
+                                   char * pOutput,
+                                   size_t outputLen );
+
+/**
+ * @brief Hashes several segments in a row, through the vectored hash update
+ * if the crypto interface provides it.
+ *
+ * @param[in] pCryptoInterface The interface used to call hash functions.
+ * @param[in] pSegments The segments to hash, in order.
+ * @param[in] segmentCount The number of entries of @p pSegments.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t hashUpdateSegments( const SigV4CryptoInterface_t * pCryptoInterface,
+                                   const SigV4IoVec_t * pSegments,
+                                   size_t segmentCount );
+
+/**
+ * @brief Appends a segment to a list of segments to hash.
+ *
+ * @param[in, out] pSegments The list of segments.
+ * @param[in, out] pSegmentCount The number of segments in @p pSegments.
+ * @param[in] pData Start of the segment.
+ * @param[in] dataLen Length of the segment.
+ */
+static void appendSegment( SigV4IoVec_t * pSegments,
+                           size_t * pSegmentCount,
+                           const void * pData,
+                           size_t dataLen );
+
+/**
+ * @brief Generates the complete hash of an input string, then write
+ * the digest in the provided output buffer.
+ * @note Unlike #completeHashAndHexEncode, this function will not
+ * encode the hash and will simply output the bytes written by the
+ * hash function.
+ *
+ * @param[in] pInput The data passed as input to the hash function.
+ * @param[in] inputLen The length of @p pInput.
+ * @param[in] pWrap The rest of the input, hashed after @p pInput, or NULL.
+ * @param[in] wrapLen The length of @p pWrap.
+ * @param[out] pOutput The buffer onto which to write the hash.
+ * @param[out] outputLen The length of @p pOutput and must be greater
+ * than pCryptoInterface->hashDigestLen for this function to succeed.
+ * @param[in] pCryptoInterface The interface used to call hash functions.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t completeHash( const uint8_t * pInput,
                              size_t inputLen,
+                             const uint8_t * pWrap,
+                             size_t wrapLen,
                              uint8_t * pOutput,
                              size_t outputLen,
                              const SigV4CryptoInterface_t * pCryptoInterface );
@@ -482,6 +1207,8 @@ static int32_t completeHash( const uint8_t * pInput,
  *
  * @param[in] pInput The data passed as input to the hash function.
  * @param[in] inputLen The length of @p pInput.
+ * @param[in] pWrap The rest of the input, hashed after @p pInput, or NULL.
+ * @param[in] wrapLen The length of @p pWrap.
  * @param[out] pOutput The buffer onto which to write the hex-encoded hash.
  * @param[out] pOutputLen The length of @p pOutput and must be greater
  * than pCryptoInterface->hashDigestLen * 2 for this function to succeed.
@@ -490,10 +1217,44 @@ static int32_t completeHash( const uint8_t * pInput,
  */
 static SigV4Status_t completeHashAndHexEncode( const char * pInput,
                                                size_t inputLen,
+                                               const char * pWrap,
+                                               size_t wrapLen,
                                                char * pOutput,
                                                size_t * pOutputLen,
                                                const SigV4CryptoInterface_t * pCryptoInterface );
 
+/**
+ * @brief Hash the canonical request, made up of the processing buffer with
+ * the referenced lines of @p pCanonicalContext in their places.
+ *
+ * @param[in] pCanonicalContext The context of the canonical request.
+ * @param[out] pOutput The buffer onto which to write the hash.
+ * @param[in] outputLen The length of @p pOutput.
+ * @param[in] pCryptoInterface The interface used to call hash functions.
+ * @return Zero on success, all other return values are failures.
+ */
+static int32_t hashCanonicalRequest( const CanonicalContext_t * pCanonicalContext,
+                                     uint8_t * pOutput,
+                                     size_t outputLen,
+                                     const SigV4CryptoInterface_t * pCryptoInterface );
+
+/**
+ * @brief Hash the canonical request, made up of the processing buffer with
+ * the referenced lines of @p pCanonicalContext in their places, then
+ * hex-encode the hash.
+ *
+ * @param[in] pCanonicalContext The context of the canonical request.
+ * @param[out] pOutput The buffer onto which to write the hex-encoded hash.
+ * @param[out] pOutputLen The length of @p pOutput and must be greater
+ * than pCryptoInterface->hashDigestLen * 2 for this function to succeed.
+ * @param[in] pCryptoInterface The interface used to call hash functions.
+ * @return Zero on success, all other return values are failures.
+ */
+static SigV4Status_t hashCanonicalRequestAndHexEncode( const CanonicalContext_t * pCanonicalContext,
+                                                       char * pOutput,
+                                                       size_t * pOutputLen,
+                                                       const SigV4CryptoInterface_t * pCryptoInterface );
+
 /**
  * @brief Generate the prefix of the string to sign containing the
  * algorithm and date then write it onto @p pBufStart.
@@ -528,6 +1289,39 @@ static SigV4Status_t writeStringToSign( const SigV4Parameters_t * pParams,
                                         size_t algorithmLen,
                                         CanonicalContext_t * pCanonicalContext );
 
+/**
+ * @brief Write the credential scope identity that a signing key is bound to,
+ * "<access key ID>/<YYYYMMDD>/<region>/<service>", to @p pScopeId.
+ *
+ * @param[in] pSigV4Params The application-defined parameters used to
+ * generate the signing key.
+ * @param[out] pScopeId Buffer of #SIGV4_SIGNING_KEY_CACHE_ID_LENGTH bytes to
+ * write the identity to.
+ * @param[out] pScopeIdLen The length of the identity written to @p pScopeId.
+ * @return true if the identity fits in @p pScopeId, false otherwise.
+ */
+static bool writeSigningKeyScopeId( const SigV4Parameters_t * pSigV4Params,
+                                    char * pScopeId,
+                                    size_t * pScopeIdLen );
+
+/**
+ * @brief Retrieve the signing key from the application-supplied
+ * #SigV4SigningKeyCache_t if it was derived for the same credential scope and
+ * secret access key, otherwise generate it and store it in the cache.
+ *
+ * @param[in] pSigV4Params The application-defined parameters used to
+ * generate the signing key.
+ * @param[in] pHmacContext The context used for the current HMAC calculation.
+ * @param[out] pSigningKey The #SigV4String_t onto which the signing key will be written.
+ * @param[in,out] pBytesRemaining The number of bytes remaining in the canonical buffer.
+ * @return SigV4InsufficientMemory if the canonical buffer cannot fit the signing key
+ * or the signature, #SigV4HashError if a hash operation failed, #SigV4Success otherwise.
+ */
+static SigV4Status_t retrieveSigningKey( const SigV4Parameters_t * pSigV4Params,
+                                         HmacContext_t * pHmacContext,
+                                         SigV4String_t * pSigningKey,
+                                         size_t * pBytesRemaining );
+
 /**
  * @brief Generate the signing key and write it onto a #SigV4String_t.
  *
@@ -647,6 +1441,352 @@ static SigV4Status_t verifyParamsToGenerateAuthHeaderApi( const SigV4Parameters_
                                                           char * const * pSignature,
                                                           const size_t * signatureLen );
 
+/**
+ * @brief Verify the SigV4 parameters passed to the APIs that generate the
+ * HTTP Authorization header value.
+ *
+ * @param[in] pParams Complete SigV4 configurations passed by application.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter otherwise.
+ */
+static SigV4Status_t verifySigV4Parameters( const SigV4Parameters_t * pParams );
+
+/**
+ * @brief Generate the canonical request, up to and including the hashed
+ * payload, in the processing buffer.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[out] pCanonicalContext The canonical context of the request.
+ * @param[out] pSignedHeaders The location of the signed headers list.
+ * @param[out] pSignedHeadersLen The length of the signed headers list.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+static SigV4Status_t generateCanonicalRequest( const SigV4Parameters_t * pParams,
+                                               CanonicalContext_t * pCanonicalContext,
+                                               char ** pSignedHeaders,
+                                               size_t * pSignedHeadersLen );
+
+/**
+ * @brief Sign the canonical request held by @p pCanonicalContext with
+ * HMAC-SHA256, and write the hex-encoded signature to @p pSignature.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pAlgorithm The algorithm used for generating the SigV4 signature.
+ * @param[in] algorithmLen The length of @p pAlgorithm.
+ * @param[in,out] pCanonicalContext The canonical context of the request, whose
+ * processing buffer is reused to compute the signature.
+ * @param[out] pSignature Buffer of at least twice the digest length to write
+ * the hex-encoded signature to.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+static SigV4Status_t generateHmacSignature( const SigV4Parameters_t * pParams,
+                                            const char * pAlgorithm,
+                                            size_t algorithmLen,
+                                            CanonicalContext_t * pCanonicalContext,
+                                            char * pSignature );
+
+/**
+ * @brief Sign the string to sign held by @p pCanonicalContext with HMAC-SHA256,
+ * and write the hex-encoded signature to @p pSignature. The string to sign is
+ * left intact, so it can be signed again with other credentials.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in,out] pCanonicalContext The canonical context holding the string to
+ * sign, whose processing buffer past the string is used to compute the
+ * signature.
+ * @param[out] pSignature Buffer of at least twice the digest length to write
+ * the hex-encoded signature to.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+static SigV4Status_t signStringToSign( const SigV4Parameters_t * pParams,
+                                       CanonicalContext_t * pCanonicalContext,
+                                       char * pSignature );
+
+/**
+ * @brief Sign the canonical request held by @p pCanonicalContext, and write
+ * the hex-encoded signature to @p pSignature.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pAlgorithm The algorithm used for generating the SigV4 signature.
+ * @param[in] algorithmLen The length of @p pAlgorithm.
+ * @param[in,out] pCanonicalContext The canonical context of the request, whose
+ * processing buffer is reused to compute the signature.
+ * @param[out] pSignature Buffer of at least the length returned by
+ * maxEncodedSignatureLength() to write the hex-encoded signature to.
+ * @param[out] pSignatureLen The length of the hex-encoded signature.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+static SigV4Status_t generateSignature( const SigV4Parameters_t * pParams,
+                                        const char * pAlgorithm,
+                                        size_t algorithmLen,
+                                        CanonicalContext_t * pCanonicalContext,
+                                        char * pSignature,
+                                        size_t * pSignatureLen );
+
+/**
+ * @brief Check whether the request is signed with SigV4A.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ *
+ * @return true if the algorithm is #SIGV4_AWS4_ECDSA_P256_SHA256, false
+ * otherwise.
+ */
+static bool isSigV4A( const SigV4Parameters_t * pParams );
+
+/**
+ * @brief Get the largest length of the hex-encoded signature of a request.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ *
+ * @return Twice the digest length, or twice the largest DER-encoded ECDSA
+ * signature with SigV4A.
+ */
+static size_t maxEncodedSignatureLength( const SigV4Parameters_t * pParams );
+
+/**
+ * @brief Check whether a candidate SigV4A private key is at most n - 2, where
+ * n is the order of the P-256 curve.
+ *
+ * @param[in] pKey The big-endian candidate of #SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH
+ * bytes.
+ *
+ * @return true if the candidate is in range, false otherwise.
+ */
+static bool isEcdsaKeyCandidateInRange( const uint8_t * pKey );
+
+/**
+ * @brief Derive the SigV4A private key from the credentials, and import it in
+ * the ECDSA interface.
+ *
+ * The key is HMAC-SHA256("AWS4A" + SecretKey, FixedInput) + 1, where the fixed
+ * input holds the algorithm, the access key ID and a counter that is
+ * incremented until the HMAC is at most n - 2.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pHmacContext The context used for the HMAC calculations.
+ * @param[in] pBuffer Scratch space for the fixed input and the key, which is
+ * cleared before returning.
+ * @param[in] bufferLen The length of @p pBuffer.
+ *
+ * @return #SigV4InsufficientMemory if @p pBuffer is too small,
+ * #SigV4HashError if an HMAC or the import failed, #SigV4Success otherwise.
+ */
+static SigV4Status_t deriveEcdsaKey( const SigV4Parameters_t * pParams,
+                                     HmacContext_t * pHmacContext,
+                                     uint8_t * pBuffer,
+                                     size_t bufferLen );
+
+/**
+ * @brief Make sure that the ECDSA interface holds the SigV4A private key of
+ * the credentials, deriving and importing it unless the application-supplied
+ * #SigV4EcdsaKeyCache_t records that it already does.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pHmacContext The context used for the HMAC calculations.
+ * @param[in] pBuffer Scratch space for the key derivation.
+ * @param[in] bufferLen The length of @p pBuffer.
+ *
+ * @return #SigV4Success if successful, #SigV4HashError if the secret access
+ * key cannot be hashed for the cache, error code of deriveEcdsaKey()
+ * otherwise.
+ */
+static SigV4Status_t retrieveEcdsaKey( const SigV4Parameters_t * pParams,
+                                       HmacContext_t * pHmacContext,
+                                       uint8_t * pBuffer,
+                                       size_t bufferLen );
+
+/**
+ * @brief Sign the canonical request held by @p pCanonicalContext with SigV4A,
+ * and write the hex-encoded DER signature to @p pSignature.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pAlgorithm The algorithm used for generating the signature.
+ * @param[in] algorithmLen The length of @p pAlgorithm.
+ * @param[in,out] pCanonicalContext The canonical context of the request, whose
+ * processing buffer is reused to compute the signature.
+ * @param[out] pSignature Buffer of at least twice
+ * #SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH to write the hex-encoded signature to.
+ * @param[out] pSignatureLen The length of the hex-encoded signature.
+ *
+ * @return #SigV4Success if successful, error code otherwise.
+ */
+static SigV4Status_t generateEcdsaSignature( const SigV4Parameters_t * pParams,
+                                             const char * pAlgorithm,
+                                             size_t algorithmLen,
+                                             CanonicalContext_t * pCanonicalContext,
+                                             char * pSignature,
+                                             size_t * pSignatureLen );
+
+/**
+ * @brief Fill @p pIov with the #SIGV4_AUTHORIZATION_IOVEC_COUNT segments of
+ * the Authorization header value.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[in] pAlgorithm The algorithm used for generating the SigV4 signature.
+ * @param[in] algorithmLen The length of @p pAlgorithm.
+ * @param[in] pBuf The buffer holding the signed headers list followed by the
+ * hex-encoded signature.
+ * @param[in] signedHeadersLen The length of the signed headers list.
+ * @param[in] signatureLen The length of the hex-encoded signature.
+ * @param[out] pIov The segments to fill.
+ */
+static void fillAuthorizationIov( const SigV4Parameters_t * pParams,
+                                  const char * pAlgorithm,
+                                  size_t algorithmLen,
+                                  const char * pBuf,
+                                  size_t signedHeadersLen,
+                                  size_t signatureLen,
+                                  SigV4IoVec_t * pIov );
+
+/**
+ * @brief Split the request target of an HTTP request line into its path and
+ * query. The scheme and authority of an absolute-form target, as sent to
+ * proxies, are skipped.
+ *
+ * @param[in] pTarget The request target.
+ * @param[in] targetLen The length of @p pTarget.
+ * @param[out] pHttpParams The HTTP parameters whose path and query are set.
+ */
+static void parseRequestTarget( const char * pTarget,
+                                size_t targetLen,
+                                SigV4HttpParameters_t * pHttpParams );
+
+/**
+ * @brief Parse the request line of a raw HTTP/1.1 request, i.e.
+ * "<method> <request target> HTTP/<version>\r\n".
+ *
+ * @param[in] pRequest The raw HTTP request.
+ * @param[in] requestLen The length of @p pRequest.
+ * @param[out] pHttpParams The HTTP parameters whose method, path and query
+ * are set.
+ * @param[out] pLineLen The length of the request line, including its line
+ * ending.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidParameter if the request
+ * line is malformed.
+ */
+static SigV4Status_t parseRequestLine( const char * pRequest,
+                                       size_t requestLen,
+                                       SigV4HttpParameters_t * pHttpParams,
+                                       size_t * pLineLen );
+
+/**
+ * @brief Find the length of the header block of a raw HTTP/1.1 request,
+ * including the empty line that ends it.
+ *
+ * @param[in] pHeaders The start of the header block.
+ * @param[in] headersLen The number of bytes from @p pHeaders to the end of the
+ * request.
+ * @param[out] pBlockLen The length of the header block.
+ *
+ * @return #SigV4Success if successful, #SigV4InvalidHttpHeaders if the header
+ * block is empty or not terminated by an empty line.
+ */
+static SigV4Status_t findHeaderBlockEnd( const char * pHeaders,
+                                         size_t headersLen,
+                                         size_t * pBlockLen );
+
+/**
+ * @brief Parse a string of decimal digits.
+ *
+ * @param[in] pDigits The digits.
+ * @param[in] digitsLen The length of @p pDigits, at most #MAX_DECIMAL_DIGITS.
+ * @param[out] pValue The parsed value.
+ *
+ * @return true if @p pDigits is a decimal number that fits, false otherwise.
+ */
+static bool parseDecimal( const char * pDigits,
+                          size_t digitsLen,
+                          uint32_t * pValue );
+
+/**
+ * @brief Convert an ISO 8601 date of the "YYYYMMDD'T'HHMMSS'Z'" form to seconds
+ * since the Unix epoch.
+ *
+ * @param[in] pDate The date, of #SIGV4_ISO_STRING_LEN characters.
+ * @param[out] pSeconds The seconds since the Unix epoch.
+ *
+ * @return true if the date is valid and in the range of 32-bit seconds, false
+ * otherwise.
+ */
+static bool iso8601ToEpochSeconds( const char * pDate,
+                                   uint32_t * pSeconds );
+
+/**
+ * @brief Find a parameter in a query string by its case-sensitive name.
+ *
+ * @param[in] pQuery The query string.
+ * @param[in] queryLen The length of @p pQuery.
+ * @param[in] pName The name of the parameter.
+ * @param[in] nameLen The length of @p pName.
+ * @param[out] pStart The index in @p pQuery at which "<name>=<value>" starts.
+ * @param[out] pEnd The index in @p pQuery at which "<name>=<value>" ends.
+ *
+ * @return true if the parameter was found, false otherwise.
+ */
+static bool findQueryParameter( const char * pQuery,
+                                size_t queryLen,
+                                const char * pName,
+                                size_t nameLen,
+                                size_t * pStart,
+                                size_t * pEnd );
+
+/**
+ * @brief Compute what a presigned URL signature is looked up by: the signing
+ * time, the X-Amz-Expires value, and a digest of everything else that is
+ * signed except X-Amz-Date.
+ *
+ * @param[in] pParams The application-defined parameters of the request.
+ * @param[out] pKey The key to compute.
+ * @param[out] pCacheable Whether the request can be cached, which needs an
+ * unwrapped query holding X-Amz-Date and a decimal X-Amz-Expires, unwrapped
+ * headers, and a valid #SigV4Parameters_t.pDateIso8601.
+ *
+ * @return #SigV4Success if successful or if the request cannot be cached,
+ * #SigV4HashError if the digest could not be computed.
+ */
+static SigV4Status_t computePresignCacheKey( const SigV4Parameters_t * pParams,
+                                             PresignCacheKey_t * pKey,
+                                             bool * pCacheable );
+
+/**
+ * @brief Find a signature that can be reused for a presigned URL in a
+ * presigned URL cache.
+ *
+ * @param[in] pPresignCache The presigned URL cache.
+ * @param[in] pKey The key of the request.
+ * @param[in] digestLen The length of the request digest in @p pKey.
+ *
+ * @return The entry holding the signature, or NULL if the request is not
+ * cached, its signature was generated in another time bucket, or too little of
+ * its validity remains.
+ */
+static SigV4PresignCacheEntry_t * findPresignCacheEntry( SigV4PresignCache_t * pPresignCache,
+                                                         const PresignCacheKey_t * pKey,
+                                                         size_t digestLen );
+
+/**
+ * @brief Store a presigned URL signature in a presigned URL cache, replacing
+ * the least recently used entry.
+ *
+ * @param[in, out] pPresignCache The presigned URL cache.
+ * @param[in] pKey The key of the request.
+ * @param[in] digestLen The length of the request digest in @p pKey.
+ * @param[in] pSigningDate The ISO 8601 date the signature was generated for.
+ * @param[in] pSignature The hex-encoded signature.
+ * @param[in] signatureLen The length of @p pSignature.
+ */
+static void storePresignCacheEntry( SigV4PresignCache_t * pPresignCache,
+                                    const PresignCacheKey_t * pKey,
+                                    size_t digestLen,
+                                    const char * pSigningDate,
+                                    const char * pSignature,
+                                    size_t signatureLen );
+
 /**
  * @brief Assign default arguments based on parameters set in @p pParams.
  *
@@ -1058,11 +2198,30 @@ static SigV4Status_t lowercaseHexEncode( const SigV4String_t * pInputStr,
 
 static size_t sizeNeededForCredentialScope( const SigV4Parameters_t * pSigV4Params )
 {
+    /* The SigV4A credential scope leaves out the region. */
+    size_t regionScopeLen = 0U;
+
+    size_t scopeLen = 0U;
+
     assert( pSigV4Params != NULL );
-    return ISO_DATE_SCOPE_LEN +                                        \
-           CREDENTIAL_SCOPE_SEPARATOR_LEN + pSigV4Params->regionLen +  \
-           CREDENTIAL_SCOPE_SEPARATOR_LEN + pSigV4Params->serviceLen + \
-           CREDENTIAL_SCOPE_SEPARATOR_LEN + CREDENTIAL_SCOPE_TERMINATOR_LEN;
+
+    if( pSigV4Params->pPrecomputedScope != NULL )
+    {
+        scopeLen = ISO_DATE_SCOPE_LEN + pSigV4Params->pPrecomputedScope->scopeSuffixLen;
+    }
+    else
+    {
+        if( !isSigV4A( pSigV4Params ) )
+        {
+            regionScopeLen = CREDENTIAL_SCOPE_SEPARATOR_LEN + pSigV4Params->regionLen;
+        }
+
+        scopeLen = ISO_DATE_SCOPE_LEN + regionScopeLen +                       \
+                   CREDENTIAL_SCOPE_SEPARATOR_LEN + pSigV4Params->serviceLen + \
+                   CREDENTIAL_SCOPE_SEPARATOR_LEN + CREDENTIAL_SCOPE_TERMINATOR_LEN;
+    }
+
+    return scopeLen;
 }
 
 /*-----------------------------------------------------------*/
@@ -1086,7 +2245,6 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
 
     assert( pSigV4Params != NULL );
     assert( pSigV4Params->pCredentials != NULL );
-    assert( pSigV4Params->pRegion != NULL );
     assert( pSigV4Params->pService != NULL );
     assert( pCredScope != NULL );
     assert( pCredScope->pData != NULL );
@@ -1099,26 +2257,42 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
     ( void ) memcpy( pBufWrite, pSigV4Params->pDateIso8601, ISO_DATE_SCOPE_LEN );
     pBufWrite = &( pBufWrite[ ISO_DATE_SCOPE_LEN ] );
 
-    *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
-    pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
+    if( pSigV4Params->pPrecomputedScope != NULL )
+    {
+        /* Concatenate the rest of the scope, which starts with its separator. */
+        copyStringResult = copyString( pBufWrite,
+                                       pSigV4Params->pPrecomputedScope->pScopeSuffix,
+                                       pSigV4Params->pPrecomputedScope->scopeSuffixLen );
+        pBufWrite = &( pBufWrite[ copyStringResult ] );
+    }
+    else
+    {
+        *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+        pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
+
+        /* Concatenate AWS region, unless signing with SigV4A. */
+        if( !isSigV4A( pSigV4Params ) )
+        {
+            assert( pSigV4Params->pRegion != NULL );
 
-    /* Concatenate AWS region. */
-    ( void ) memcpy( pBufWrite, pSigV4Params->pRegion, pSigV4Params->regionLen );
-    pBufWrite = &( pBufWrite[ pSigV4Params->regionLen ] );
+            ( void ) memcpy( pBufWrite, pSigV4Params->pRegion, pSigV4Params->regionLen );
+            pBufWrite = &( pBufWrite[ pSigV4Params->regionLen ] );
 
-    *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
-    pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
+            *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+            pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
+        }
 
-    /* Concatenate AWS service. */
-    ( void ) memcpy( pBufWrite, pSigV4Params->pService, pSigV4Params->serviceLen );
-    pBufWrite = &( pBufWrite[ pSigV4Params->serviceLen ] );
+        /* Concatenate AWS service. */
+        ( void ) memcpy( pBufWrite, pSigV4Params->pService, pSigV4Params->serviceLen );
+        pBufWrite = &( pBufWrite[ pSigV4Params->serviceLen ] );
 
-    *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
-    pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
+        *pBufWrite = CREDENTIAL_SCOPE_SEPARATOR;
+        pBufWrite = &( pBufWrite[ CREDENTIAL_SCOPE_SEPARATOR_LEN ] );
 
-    /* Concatenate terminator. */
-    copyStringResult = copyString( pBufWrite, CREDENTIAL_SCOPE_TERMINATOR, CREDENTIAL_SCOPE_TERMINATOR_LEN );
-    pBufWrite = &( pBufWrite[ copyStringResult ] );
+        /* Concatenate terminator. */
+        copyStringResult = copyString( pBufWrite, CREDENTIAL_SCOPE_TERMINATOR, CREDENTIAL_SCOPE_TERMINATOR_LEN );
+        pBufWrite = &( pBufWrite[ copyStringResult ] );
+    }
 
     /* Verify that the number of bytes written match the sizeNeededForCredentialScope()
      * utility function for calculating size of credential scope. */
@@ -1135,7 +2309,8 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                                    const void * pSecondVal )
     {
         const SigV4KeyValuePair_t * pFirst, * pSecond = NULL;
-        size_t lenSmall = 0U;
+        size_t lenSmall = 0U, index;
+        int32_t compResult = 0;
 
         assert( pFirstVal != NULL );
         assert( pSecondVal != NULL );
@@ -1146,18 +2321,37 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         assert( ( pFirst->key.pData != NULL ) && ( pFirst->key.dataLen != 0U ) );
         assert( ( pSecond->key.pData != NULL ) && ( pSecond->key.dataLen != 0U ) );
 
-        if( pFirst->key.dataLen <= pSecond->key.dataLen )
+        if( ( pFirst->keyRank != 0U ) && ( pSecond->keyRank != 0U ) )
         {
-            lenSmall = pFirst->key.dataLen;
+            /* Well-known header names are ranked in canonical order. */
+            compResult = ( int32_t ) pFirst->keyRank - ( int32_t ) pSecond->keyRank;
         }
         else
         {
-            lenSmall = pSecond->key.dataLen;
+            if( pFirst->key.dataLen <= pSecond->key.dataLen )
+            {
+                lenSmall = pFirst->key.dataLen;
+            }
+            else
+            {
+                lenSmall = pSecond->key.dataLen;
+            }
+
+            /* Header names are sorted by their lowercase form. */
+            for( index = 0U; ( compResult == 0 ) && ( index < lenSmall ); index++ )
+            {
+                compResult = ( int32_t ) lowercaseCharacter( pFirst->key.pData[ index ] ) -
+                             ( int32_t ) lowercaseCharacter( pSecond->key.pData[ index ] );
+            }
+
+            if( ( compResult == 0 ) && ( pFirst->key.dataLen != pSecond->key.dataLen ) )
+            {
+                /* Names share a common prefix, so the shorter one should come first. */
+                compResult = ( pFirst->key.dataLen < pSecond->key.dataLen ) ? -1 : 1;
+            }
         }
 
-        return strncmp( pFirst->key.pData,
-                        pSecond->key.pData,
-                        lenSmall );
+        return compResult;
     }
 
 /*-----------------------------------------------------------*/
@@ -1434,6 +2628,59 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                                                             CanonicalContext_t * pCanonicalRequest )
     {
         SigV4Status_t status = SigV4Success;
+
+        if( FLAG_IS_SET( flags, SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG ) )
+        {
+            /* There is nothing to trim or lowercase, so skip the per-character checks. */
+            status = copyTrimmedHeaderStringToCanonicalBuffer( pData, dataLen, separator, pCanonicalRequest );
+        }
+        else
+        {
+            status = trimHeaderStringToCanonicalBuffer( pData, dataLen, flags, separator, pCanonicalRequest );
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t copyTrimmedHeaderStringToCanonicalBuffer( const char * pData,
+                                                                   size_t dataLen,
+                                                                   char separator,
+                                                                   CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t status = SigV4Success;
+        char * pBuf;
+
+        assert( ( pData != NULL ) && ( dataLen > 0U ) );
+        assert( pCanonicalRequest != NULL );
+
+        /* Remaining buffer space should accommodate the data and the trailing separator character. */
+        if( pCanonicalRequest->bufRemaining <= dataLen )
+        {
+            status = SigV4InsufficientMemory;
+        }
+        else
+        {
+            pBuf = ( char * ) &( pCanonicalRequest->pBufProcessing[ pCanonicalRequest->uxCursorIndex ] );
+            ( void ) memcpy( pBuf, pData, dataLen );
+            pBuf[ dataLen ] = separator;
+            pCanonicalRequest->uxCursorIndex += dataLen + 1U;
+            pCanonicalRequest->bufRemaining -= dataLen + 1U;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t trimHeaderStringToCanonicalBuffer( const char * pData,
+                                                            size_t dataLen,
+                                                            uint32_t flags,
+                                                            char separator,
+                                                            CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t status = SigV4Success;
         size_t index = 0;
         size_t numOfBytesCopied = 0;
         size_t buffRemaining;
@@ -1508,9 +2755,8 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                                               char ** pSignedHeaders,
                                               size_t * pSignedHeadersLen )
     {
-        size_t headerIndex = 0, keyLen = 0;
+        size_t headerIndex = 0;
         SigV4Status_t sigV4Status = SigV4Success;
-        const char * headerKey;
         size_t uxSignedHeaderIndex;
 
         assert( pCanonicalRequest != NULL );
@@ -1523,12 +2769,9 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         for( headerIndex = 0; headerIndex < headerCount; headerIndex++ )
         {
             assert( ( pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData ) != NULL );
-            keyLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.dataLen;
-
-            headerKey = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData;
 
             /* ';' is used to separate signed multiple headers in the canonical request. */
-            sigV4Status = copyHeaderStringToCanonicalBuffer( headerKey, keyLen, flags, ';', pCanonicalRequest );
+            sigV4Status = copyHeaderKeyToCanonicalBuffer( &( pCanonicalRequest->pHeadersLoc[ headerIndex ] ), flags, ';', pCanonicalRequest );
 
             if( sigV4Status != SigV4Success )
             {
@@ -1551,43 +2794,128 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
 
 /*-----------------------------------------------------------*/
     static void storeHashedPayloadLocation( size_t headerIndex,
-                                            const char * pAmzSHA256Header,
-                                            size_t amzSHA256HeaderLen,
                                             CanonicalContext_t * pCanonicalRequest )
     {
         assert( pCanonicalRequest != NULL );
 
-        const uint8_t * pHeaderData = ( const uint8_t * ) pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData;
-        size_t headerLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.dataLen;
-        const uint8_t * pHeaderLiteral = ( const uint8_t * ) pAmzSHA256Header;
-
-        if( ( headerLen == amzSHA256HeaderLen ) && ( memcmp( pHeaderData, pHeaderLiteral, headerLen ) == 0 ) )
+        /* The header name was ranked when it was parsed. */
+        if( pCanonicalRequest->pHeadersLoc[ headerIndex ].keyRank == WELL_KNOWN_HEADER_RANK_CONTENT_SHA256 )
         {
             pCanonicalRequest->pHashPayloadLoc = pCanonicalRequest->pHeadersLoc[ headerIndex ].value.pData;
             pCanonicalRequest->hashPayloadLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].value.dataLen;
         }
     }
 
+/*-----------------------------------------------------------*/
+
+    static const SigV4ConstString_t * getWellKnownHeaderName( uint8_t rank )
+    {
+        /* The well-known header names, in canonical order. */
+        static const SigV4ConstString_t wellKnownHeaders[ WELL_KNOWN_HEADER_COUNT ] =
+        {
+            { "content-length",                       sizeof( "content-length" ) - 1U                 },
+            { "content-type",                         sizeof( "content-type" ) - 1U                   },
+            { "host",                                 sizeof( "host" ) - 1U                           },
+            { SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER, SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER_LENGTH   },
+            { SIGV4_HTTP_X_AMZ_DATE_HEADER,           sizeof( SIGV4_HTTP_X_AMZ_DATE_HEADER ) - 1U     },
+            { SIGV4_HTTP_X_AMZ_SECURITY_TOKEN_HEADER, sizeof( SIGV4_HTTP_X_AMZ_SECURITY_TOKEN_HEADER ) - 1U },
+            { SIGV4_HTTP_X_AMZ_STORAGE_CLASS_HEADER,  sizeof( SIGV4_HTTP_X_AMZ_STORAGE_CLASS_HEADER ) - 1U }
+        };
+
+        assert( ( rank > 0U ) && ( rank <= WELL_KNOWN_HEADER_COUNT ) );
+
+        return &( wellKnownHeaders[ rank - 1U ] );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint8_t rankWellKnownHeader( const char * pKey,
+                                        size_t keyLen )
+    {
+        /* The rank of the well-known header name in each slot, indexed by
+         * ( 4 * length + lowercase last character ) modulo 16, which does not
+         * collide for any two well-known header names. */
+        static const uint8_t slotRanks[ WELL_KNOWN_HEADER_SLOT_COUNT ] =
+        {
+            1U, 0U, 0U, 0U, 3U, 2U, 4U, 0U, 0U, 0U, 0U, 0U, 0U, 5U, 6U, 7U
+        };
+        const SigV4ConstString_t * pName;
+        uint8_t rank = 0U;
+        size_t index;
+
+        assert( ( pKey != NULL ) && ( keyLen > 0U ) );
+
+        rank = slotRanks[ ( ( keyLen << 2 ) + ( size_t ) ( uint8_t ) lowercaseCharacter( pKey[ keyLen - 1U ] ) ) %
+                          WELL_KNOWN_HEADER_SLOT_COUNT ];
+
+        if( rank != 0U )
+        {
+            /* Verify the name, as any other name may fall into the same slot. */
+            pName = getWellKnownHeaderName( rank );
+
+            if( keyLen != pName->dataLen )
+            {
+                rank = 0U;
+            }
+
+            for( index = 0U; ( rank != 0U ) && ( index < keyLen ); index++ )
+            {
+                if( lowercaseCharacter( pKey[ index ] ) != pName->pData[ index ] )
+                {
+                    rank = 0U;
+                }
+            }
+        }
+
+        return rank;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t copyHeaderKeyToCanonicalBuffer( const SigV4KeyValuePair_t * pHeader,
+                                                         uint32_t flags,
+                                                         char separator,
+                                                         CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t status = SigV4Success;
+        const SigV4ConstString_t * pName;
+
+        assert( pHeader != NULL );
+
+        if( pHeader->keyRank != 0U )
+        {
+            /* The lowercase form of a well-known header name is known already. */
+            pName = getWellKnownHeaderName( pHeader->keyRank );
+            status = copyTrimmedHeaderStringToCanonicalBuffer( pName->pData, pName->dataLen, separator, pCanonicalRequest );
+        }
+        else
+        {
+            status = copyHeaderStringToCanonicalBuffer( pHeader->key.pData, pHeader->key.dataLen, flags, separator, pCanonicalRequest );
+        }
+
+        return status;
+    }
+
     static SigV4Status_t appendCanonicalizedHeaders( size_t headerCount,
                                                      uint32_t flags,
+                                                     const size_t * pSortedOrder,
                                                      CanonicalContext_t * pCanonicalRequest )
     {
-        size_t headerIndex = 0, keyLen = 0, valLen = 0;
+        size_t sortedIndex = 0, headerIndex = 0, valLen = 0;
         const char * value;
-        const char * headerKey;
         SigV4Status_t sigV4Status = SigV4Success;
 
         assert( pCanonicalRequest != NULL );
         assert( headerCount > 0 );
 
-        for( headerIndex = 0; headerIndex < headerCount; headerIndex++ )
+        for( sortedIndex = 0; sortedIndex < headerCount; sortedIndex++ )
         {
+            headerIndex = ( pSortedOrder != NULL ) ? pSortedOrder[ sortedIndex ] : sortedIndex;
+            assert( headerIndex < headerCount );
             assert( pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData != NULL );
-            keyLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.dataLen;
             valLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].value.dataLen;
-            headerKey = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData;
             /* ':' is used to separate header key and header value in the canonical request. */
-            sigV4Status = copyHeaderStringToCanonicalBuffer( headerKey, keyLen, flags, ':', pCanonicalRequest );
+            sigV4Status = copyHeaderKeyToCanonicalBuffer( &( pCanonicalRequest->pHeadersLoc[ headerIndex ] ), flags, ':', pCanonicalRequest );
 
             if( sigV4Status == SigV4Success )
             {
@@ -1636,12 +2964,21 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                 sigV4Status = SigV4MaxHeaderPairCountExceeded;
                 break;
             }
+            /* A header field entry must have a non-empty key. */
+            else if( ( keyFlag ) && ( pHeaders[ index ] == ':' ) && ( pCurrLoc == pKeyOrValStartLoc ) )
+            {
+                LogError( ( "Failed to parse HTTP headers: Found a header without a name." ) );
+                sigV4Status = SigV4InvalidHttpHeaders;
+                break;
+            }
             /* Look for key part of an header field entry. */
             else if( ( keyFlag ) && ( pHeaders[ index ] == ':' ) )
             {
                 dataLen = pCurrLoc - pKeyOrValStartLoc;
                 pCanonicalRequest->pHeadersLoc[ noOfHeaders ].key.pData = pKeyOrValStartLoc;
                 pCanonicalRequest->pHeadersLoc[ noOfHeaders ].key.dataLen = ( size_t ) dataLen;
+                pCanonicalRequest->pHeadersLoc[ noOfHeaders ].keyRank = rankWellKnownHeader( pKeyOrValStartLoc, ( size_t ) dataLen );
+                pCanonicalRequest->pHeadersLoc[ noOfHeaders ].parseIndex = noOfHeaders;
                 pKeyOrValStartLoc = &( pCurrLoc[ 1 ] );
                 keyFlag = false;
             }
@@ -1655,7 +2992,7 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                 pCanonicalRequest->pHeadersLoc[ noOfHeaders ].value.dataLen = ( size_t ) dataLen;
 
                 /* Storing location of hashed request payload */
-                storeHashedPayloadLocation( noOfHeaders, SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER, SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER_LENGTH, pCanonicalRequest );
+                storeHashedPayloadLocation( noOfHeaders, pCanonicalRequest );
 
                 /* Set starting location of the next header key string after the "\r\n". */
                 pKeyOrValStartLoc = &( pCurrLoc[ 2 ] );
@@ -1670,7 +3007,7 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
                 pCanonicalRequest->pHeadersLoc[ noOfHeaders ].value.dataLen = ( size_t ) dataLen;
 
                 /* Storing location of hashed request payload */
-                storeHashedPayloadLocation( noOfHeaders, SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER, SIGV4_HTTP_X_AMZ_CONTENT_SHA256_HEADER_LENGTH, pCanonicalRequest );
+                storeHashedPayloadLocation( noOfHeaders, pCanonicalRequest );
 
                 /* Set starting location of the next header key string after the "\n". */
                 pKeyOrValStartLoc = &( pCurrLoc[ 1 ] );
@@ -1702,17 +3039,172 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         return sigV4Status;
     }
 
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t parseWrappedHeaderKeyValueEntries( const char * pHeaders,
+                                                            size_t headersDataLen,
+                                                            const char * pHeadersWrap,
+                                                            size_t headersWrapLen,
+                                                            uint32_t flags,
+                                                            size_t * headerCount,
+                                                            CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t sigV4Status = SigV4Success;
+        SigV4WrappedInput_t wrappedInput;
+        size_t i = 0U;
+
+        if( wrappedLength( pHeadersWrap, headersWrapLen ) == 0U )
+        {
+            sigV4Status = parseHeaderKeyValueEntries( pHeaders, headersDataLen, flags, headerCount, pCanonicalRequest );
+        }
+        else
+        {
+            /* Both forms of headers end each line with '\n', which is kept so
+             * that every piece holds whole header lines. */
+            sigV4Status = splitWrappedInput( pHeaders, headersDataLen, pHeadersWrap, headersWrapLen,
+                                             LINEFEED_CHAR, true, pCanonicalRequest, &wrappedInput );
+
+            for( i = 0U; ( sigV4Status == SigV4Success ) && ( i < WRAPPED_INPUT_PIECE_COUNT ); i++ )
+            {
+                if( wrappedInput.pieces[ i ].dataLen > 0U )
+                {
+                    sigV4Status = parseHeaderKeyValueEntries( wrappedInput.pieces[ i ].pData,
+                                                              wrappedInput.pieces[ i ].dataLen,
+                                                              flags,
+                                                              headerCount,
+                                                              pCanonicalRequest );
+                }
+            }
+        }
+
+        return sigV4Status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t splitWrappedInput( const char * pData,
+                                            size_t dataLen,
+                                            const char * pWrap,
+                                            size_t wrapLen,
+                                            char separator,
+                                            bool keepSeparator,
+                                            CanonicalContext_t * pCanonicalRequest,
+                                            SigV4WrappedInput_t * pWrappedInput )
+    {
+        size_t headLen = dataLen, wrapHeadLen = wrapLen, separatorLen = 1U;
+        const char * pSeparator = NULL;
+
+        assert( pData != NULL );
+        assert( pWrap != NULL );
+        assert( wrapLen > 0U );
+        assert( pWrappedInput != NULL );
+
+        if( keepSeparator )
+        {
+            separatorLen = 0U;
+        }
+
+        /* The straddling entry starts after the last separator before the end
+         * of the ring buffer... */
+        while( ( headLen > 0U ) && ( pData[ headLen - 1U ] != separator ) )
+        {
+            headLen--;
+        }
+
+        pWrappedInput->pieces[ 0 ].pData = pData;
+        pWrappedInput->pieces[ 0 ].dataLen = ( headLen > 0U ) ? ( headLen - separatorLen ) : 0U;
+
+        /* ...and ends at the first separator after it. */
+        pSeparator = memchr( pWrap, ( int ) separator, wrapLen );
+
+        if( pSeparator != NULL )
+        {
+            wrapHeadLen = ( size_t ) ( pSeparator - pWrap ) + 1U;
+        }
+
+        pWrappedInput->pieces[ 2 ].pData = &( pWrap[ wrapHeadLen ] );
+        pWrappedInput->pieces[ 2 ].dataLen = wrapLen - wrapHeadLen;
+
+        if( pSeparator != NULL )
+        {
+            wrapHeadLen -= separatorLen;
+        }
+
+        return stageWrappedSeam( &( pData[ headLen ] ), dataLen - headLen,
+                                 pWrap, wrapHeadLen,
+                                 pCanonicalRequest, pWrappedInput );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t stageWrappedSeam( const char * pDataTail,
+                                           size_t dataTailLen,
+                                           const char * pWrapHead,
+                                           size_t wrapHeadLen,
+                                           CanonicalContext_t * pCanonicalRequest,
+                                           SigV4WrappedInput_t * pWrappedInput )
+    {
+        SigV4Status_t sigV4Status = SigV4Success;
+        size_t stagedLen = dataTailLen + wrapHeadLen;
+        char * pStaged = NULL;
+
+        assert( pCanonicalRequest != NULL );
+        assert( pWrappedInput != NULL );
+
+        pWrappedInput->stagedLen = 0U;
+
+        if( dataTailLen == 0U )
+        {
+            /* The ring buffer wrapped between two entries. */
+            pWrappedInput->pieces[ 1 ].pData = pWrapHead;
+            pWrappedInput->pieces[ 1 ].dataLen = wrapHeadLen;
+        }
+        else if( wrapHeadLen == 0U )
+        {
+            pWrappedInput->pieces[ 1 ].pData = pDataTail;
+            pWrappedInput->pieces[ 1 ].dataLen = dataTailLen;
+        }
+        else if( pCanonicalRequest->bufRemaining < stagedLen )
+        {
+            sigV4Status = SigV4InsufficientMemory;
+            LOG_INSUFFICIENT_MEMORY_ERROR( "copy the entry that wraps around the ring buffer",
+                                           stagedLen - pCanonicalRequest->bufRemaining );
+        }
+        else
+        {
+            /* The entry is put at the end of the processing buffer, which is
+             * taken out of the space left for the canonical request. */
+            pCanonicalRequest->bufRemaining -= stagedLen;
+            pStaged = ( char * ) &( pCanonicalRequest->pBufProcessing[ pCanonicalRequest->uxCursorIndex +
+                                                                      pCanonicalRequest->bufRemaining ] );
+            ( void ) memcpy( pStaged, pDataTail, dataTailLen );
+            ( void ) memcpy( &( pStaged[ dataTailLen ] ), pWrapHead, wrapHeadLen );
+
+            pWrappedInput->pieces[ 1 ].pData = pStaged;
+            pWrappedInput->pieces[ 1 ].dataLen = stagedLen;
+            pWrappedInput->stagedLen = stagedLen;
+        }
+
+        return sigV4Status;
+    }
+
 /*-----------------------------------------------------------*/
 
     static SigV4Status_t generateCanonicalAndSignedHeaders( const char * pHeaders,
                                                             size_t headersLen,
+                                                            const char * pHeadersWrap,
+                                                            size_t headersWrapLen,
                                                             uint32_t flags,
+                                                            SigV4SignedHeadersCache_t * pSignedHeadersCache,
                                                             CanonicalContext_t * canonicalRequest,
                                                             char ** pSignedHeaders,
                                                             size_t * pSignedHeadersLen )
     {
         size_t noOfHeaders = 0;
         SigV4Status_t sigV4Status = SigV4Success;
+        SigV4SignedHeadersCache_t * pCache = NULL;
+        const size_t * pSortedOrder = NULL;
+        uint32_t fingerprint = 0U;
 
         assert( pHeaders != NULL );
         assert( canonicalRequest != NULL );
@@ -1720,29 +3212,34 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         assert( pSignedHeadersLen != NULL );
 
         /* Parsing header string to extract key and value. */
-        sigV4Status = parseHeaderKeyValueEntries( pHeaders,
-                                                  headersLen,
-                                                  flags,
-                                                  &noOfHeaders,
-                                                  canonicalRequest );
+        sigV4Status = parseWrappedHeaderKeyValueEntries( pHeaders,
+                                                         headersLen,
+                                                         pHeadersWrap,
+                                                         headersWrapLen,
+                                                         flags,
+                                                         &noOfHeaders,
+                                                         canonicalRequest );
 
         if( sigV4Status == SigV4Success )
         {
             if( FLAG_IS_SET( flags, SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG ) )
             {
-                /* Headers are already canonicalized, so just write it to the buffer as is. */
-                sigV4Status = writeLineToCanonicalRequest( pHeaders,
-                                                           headersLen,
-                                                           canonicalRequest );
+                /* Headers are already canonicalized, so they are hashed as is without being copied. */
+                referenceWrappedLineInCanonicalRequest( pHeaders,
+                                                        headersLen,
+                                                        pHeadersWrap,
+                                                        headersWrapLen,
+                                                        canonicalRequest );
             }
             else
             {
-                /* Sorting headers based on keys. */
-                quickSort( canonicalRequest->pHeadersLoc, noOfHeaders, sizeof( SigV4KeyValuePair_t ), cmpHeaderField );
+                /* Sorting headers based on keys, unless the cache holds their order. */
+                pCache = pSignedHeadersCache;
+                pSortedOrder = sortHeaders( pCache, noOfHeaders, canonicalRequest, &fingerprint );
 
                 /* If the headers are canonicalized, we will copy them directly into the buffer as they do not
                  * need processing, else we need to call the following function. */
-                sigV4Status = appendCanonicalizedHeaders( noOfHeaders, flags, canonicalRequest );
+                sigV4Status = appendCanonicalizedHeaders( noOfHeaders, flags, pSortedOrder, canonicalRequest );
             }
         }
 
@@ -1764,16 +3261,197 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
 
         if( sigV4Status == SigV4Success )
         {
-            sigV4Status = appendSignedHeaders( noOfHeaders,
+            sigV4Status = writeSignedHeaders( pCache,
+                                              pSortedOrder,
+                                              fingerprint,
+                                              noOfHeaders,
+                                              flags,
+                                              canonicalRequest,
+                                              pSignedHeaders,
+                                              pSignedHeadersLen );
+        }
+
+        return sigV4Status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static const size_t * sortHeaders( const SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                       size_t headerCount,
+                                       CanonicalContext_t * pCanonicalRequest,
+                                       uint32_t * pFingerprint )
+    {
+        const size_t * pSortedOrder = NULL;
+
+        assert( pCanonicalRequest != NULL );
+        assert( pFingerprint != NULL );
+
+        if( pSignedHeadersCache != NULL )
+        {
+            *pFingerprint = fingerprintHeaderNames( headerCount, pCanonicalRequest );
+
+            if( matchSignedHeadersCache( pSignedHeadersCache, *pFingerprint, headerCount, pCanonicalRequest ) )
+            {
+                pSortedOrder = pSignedHeadersCache->pSortedOrder;
+            }
+        }
+
+        if( pSortedOrder == NULL )
+        {
+            quickSort( pCanonicalRequest->pHeadersLoc, headerCount, sizeof( SigV4KeyValuePair_t ), cmpHeaderField );
+        }
+
+        return pSortedOrder;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t writeSignedHeaders( SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                             const size_t * pSortedOrder,
+                                             uint32_t fingerprint,
+                                             size_t headerCount,
+                                             uint32_t flags,
+                                             CanonicalContext_t * pCanonicalRequest,
+                                             char ** pSignedHeaders,
+                                             size_t * pSignedHeadersLen )
+    {
+        SigV4Status_t sigV4Status = SigV4Success;
+
+        assert( pCanonicalRequest != NULL );
+        assert( pSignedHeaders != NULL );
+        assert( pSignedHeadersLen != NULL );
+
+        if( pSortedOrder != NULL )
+        {
+            /* The cache holds the signed headers list of these header names. */
+            assert( pSignedHeadersCache != NULL );
+            *pSignedHeaders = pSignedHeadersCache->pSignedHeaders;
+            *pSignedHeadersLen = pSignedHeadersCache->signedHeadersLen;
+            referenceLineInCanonicalRequest( pSignedHeadersCache->pSignedHeaders,
+                                             pSignedHeadersCache->signedHeadersLen,
+                                             pCanonicalRequest );
+        }
+        else
+        {
+            sigV4Status = appendSignedHeaders( headerCount,
                                                flags,
-                                               canonicalRequest,
+                                               pCanonicalRequest,
                                                pSignedHeaders,
                                                pSignedHeadersLen );
+
+            if( ( sigV4Status == SigV4Success ) && ( pSignedHeadersCache != NULL ) )
+            {
+                storeSignedHeadersCache( pSignedHeadersCache, fingerprint, headerCount,
+                                         pCanonicalRequest, *pSignedHeaders, *pSignedHeadersLen );
+            }
         }
 
         return sigV4Status;
     }
 
+/*-----------------------------------------------------------*/
+
+    static uint32_t fingerprintHeaderNames( size_t headerCount,
+                                            const CanonicalContext_t * pCanonicalRequest )
+    {
+        uint32_t fingerprint = FNV1A_32_OFFSET_BASIS;
+        size_t headerIndex;
+
+        assert( pCanonicalRequest != NULL );
+
+        for( headerIndex = 0U; headerIndex < headerCount; headerIndex++ )
+        {
+            fingerprint = updateFnv1aHash( fingerprint,
+                                           pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData,
+                                           pCanonicalRequest->pHeadersLoc[ headerIndex ].key.dataLen );
+            fingerprint = updateFnv1aHash( fingerprint, ":", 1U );
+        }
+
+        return fingerprint;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool matchSignedHeadersCache( const SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                         uint32_t fingerprint,
+                                         size_t headerCount,
+                                         const CanonicalContext_t * pCanonicalRequest )
+    {
+        bool isMatch = false;
+        size_t sortedIndex, headerIndex, keyLen, offset = 0U;
+
+        assert( pSignedHeadersCache != NULL );
+        assert( pCanonicalRequest != NULL );
+
+        isMatch = ( pSignedHeadersCache->signedHeadersLen != 0U ) &&
+                  ( pSignedHeadersCache->fingerprint == fingerprint ) &&
+                  ( pSignedHeadersCache->headerCount == headerCount );
+
+        /* Compare the names, so that a fingerprint collision is not taken for a hit. */
+        for( sortedIndex = 0U; isMatch && ( sortedIndex < headerCount ); sortedIndex++ )
+        {
+            headerIndex = pSignedHeadersCache->pSortedOrder[ sortedIndex ];
+            assert( headerIndex < headerCount );
+            keyLen = pCanonicalRequest->pHeadersLoc[ headerIndex ].key.dataLen;
+
+            isMatch = ( ( pSignedHeadersCache->headerNamesLen - offset ) > keyLen ) &&
+                      ( memcmp( &( pSignedHeadersCache->pHeaderNames[ offset ] ),
+                                pCanonicalRequest->pHeadersLoc[ headerIndex ].key.pData,
+                                keyLen ) == 0 ) &&
+                      ( pSignedHeadersCache->pHeaderNames[ offset + keyLen ] == ':' );
+            offset += keyLen + 1U;
+        }
+
+        return isMatch && ( offset == pSignedHeadersCache->headerNamesLen );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void storeSignedHeadersCache( SigV4SignedHeadersCache_t * pSignedHeadersCache,
+                                         uint32_t fingerprint,
+                                         size_t headerCount,
+                                         const CanonicalContext_t * pCanonicalRequest,
+                                         const char * pSignedHeaders,
+                                         size_t signedHeadersLen )
+    {
+        size_t sortedIndex, keyLen, headerNamesLen = 0U;
+
+        assert( pSignedHeadersCache != NULL );
+        assert( pCanonicalRequest != NULL );
+
+        for( sortedIndex = 0U; sortedIndex < headerCount; sortedIndex++ )
+        {
+            headerNamesLen += pCanonicalRequest->pHeadersLoc[ sortedIndex ].key.dataLen + 1U;
+        }
+
+        /* The signed headers list has the names separated by ';', so it is
+         * shorter than the names each followed by ':'. */
+        assert( signedHeadersLen < headerNamesLen );
+
+        if( headerNamesLen <= SIGV4_SIGNED_HEADERS_CACHE_LENGTH )
+        {
+            headerNamesLen = 0U;
+
+            for( sortedIndex = 0U; sortedIndex < headerCount; sortedIndex++ )
+            {
+                keyLen = pCanonicalRequest->pHeadersLoc[ sortedIndex ].key.dataLen;
+                ( void ) memcpy( &( pSignedHeadersCache->pHeaderNames[ headerNamesLen ] ),
+                                 pCanonicalRequest->pHeadersLoc[ sortedIndex ].key.pData,
+                                 keyLen );
+                headerNamesLen += keyLen;
+                pSignedHeadersCache->pHeaderNames[ headerNamesLen ] = ':';
+                headerNamesLen++;
+                pSignedHeadersCache->pSortedOrder[ sortedIndex ] = pCanonicalRequest->pHeadersLoc[ sortedIndex ].parseIndex;
+            }
+
+            pSignedHeadersCache->fingerprint = fingerprint;
+            pSignedHeadersCache->headerNamesLen = headerNamesLen;
+            pSignedHeadersCache->headerCount = headerCount;
+            ( void ) memcpy( pSignedHeadersCache->pSignedHeaders, pSignedHeaders, signedHeadersLen );
+            pSignedHeadersCache->signedHeadersLen = signedHeadersLen;
+        }
+    }
+
 /*-----------------------------------------------------------*/
 
     static void setQueryParameterKey( size_t currentParameter,
@@ -1891,6 +3569,9 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         assert( pCanonicalRequest != NULL );
         assert( pCanonicalRequest->pQueryLoc != NULL );
 
+        /* Parameters are added after those already parsed. */
+        currentParameter = *pNumberOfParameters;
+
         /* Note: Constness of the query string is casted out here, taking care not to modify
          * its contents in any way. */
 
@@ -1946,6 +3627,50 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         return returnStatus;
     }
 
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t parseWrappedQueryString( const char * pQuery,
+                                                  size_t queryLen,
+                                                  const char * pQueryWrap,
+                                                  size_t queryWrapLen,
+                                                  size_t * pNumberOfParameters,
+                                                  size_t * pStagedLen,
+                                                  CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        SigV4WrappedInput_t wrappedInput;
+        size_t i = 0U;
+
+        assert( pStagedLen != NULL );
+
+        if( wrappedLength( pQueryWrap, queryWrapLen ) == 0U )
+        {
+            returnStatus = parseQueryString( pQuery, queryLen, pNumberOfParameters, pCanonicalRequest );
+        }
+        else
+        {
+            /* The '&' separators are dropped, as the end of each piece
+             * terminates its last parameter. */
+            returnStatus = splitWrappedInput( pQuery, queryLen, pQueryWrap, queryWrapLen,
+                                              '&', false, pCanonicalRequest, &wrappedInput );
+
+            for( i = 0U; ( returnStatus == SigV4Success ) && ( i < WRAPPED_INPUT_PIECE_COUNT ); i++ )
+            {
+                if( wrappedInput.pieces[ i ].dataLen > 0U )
+                {
+                    returnStatus = parseQueryString( wrappedInput.pieces[ i ].pData,
+                                                     wrappedInput.pieces[ i ].dataLen,
+                                                     pNumberOfParameters,
+                                                     pCanonicalRequest );
+                }
+            }
+
+            *pStagedLen = wrappedInput.stagedLen;
+        }
+
+        return returnStatus;
+    }
+
 /*-----------------------------------------------------------*/
 
     static SigV4Status_t writeValueInCanonicalizedQueryString( char * pBufCur,
@@ -1996,114 +3721,209 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
 
 /*-----------------------------------------------------------*/
 
-    static SigV4Status_t writeCanonicalQueryParameters( CanonicalContext_t * pCanonicalRequest,
-                                                        size_t numberOfParameters,
-                                                        const bool doubleEncodeEqualsInParmsValues )
+    static SigV4Status_t encodeQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                                size_t numberOfParameters,
+                                                const bool doubleEncodeEqualsInParmsValues,
+                                                size_t * pEncodedQueryLen )
     {
         SigV4Status_t returnStatus = SigV4Success;
         size_t uxBufIndex;
         size_t encodedLen = 0U, remainingLen = 0U, paramsIndex = 0U;
+        char * pBuf;
+        SigV4KeyValuePair_t * pParam;
 
         assert( pCanonicalRequest != NULL );
-        assert( pCanonicalRequest->pQueryLoc != NULL );
+        assert( pEncodedQueryLen != NULL );
 
+        pBuf = ( char * ) pCanonicalRequest->pBufProcessing;
         uxBufIndex = pCanonicalRequest->uxCursorIndex;
         remainingLen = pCanonicalRequest->bufRemaining;
 
-        for( paramsIndex = 0U; paramsIndex < numberOfParameters; paramsIndex++ )
+        for( paramsIndex = 0U; ( returnStatus == SigV4Success ) && ( paramsIndex < numberOfParameters ); paramsIndex++ )
         {
-            assert( pCanonicalRequest->pQueryLoc[ paramsIndex ].key.pData != NULL );
-            assert( pCanonicalRequest->pQueryLoc[ paramsIndex ].key.dataLen > 0U );
+            pParam = &( pCanonicalRequest->pQueryLoc[ paramsIndex ] );
+            assert( pParam->key.pData != NULL );
+            assert( pParam->key.dataLen > 0U );
 
             encodedLen = remainingLen;
-            returnStatus = SigV4_EncodeURI( pCanonicalRequest->pQueryLoc[ paramsIndex ].key.pData,
-                                            pCanonicalRequest->pQueryLoc[ paramsIndex ].key.dataLen,
-                                            ( char * ) &( pCanonicalRequest->pBufProcessing[ uxBufIndex ] ),
+            returnStatus = SigV4_EncodeURI( pParam->key.pData,
+                                            pParam->key.dataLen,
+                                            &( pBuf[ uxBufIndex ] ),
                                             &encodedLen,
                                             true /* Encode slash (/) */,
                                             false /* Do not double encode '='. */ );
 
             if( returnStatus == SigV4Success )
             {
-                uxBufIndex = uxBufIndex + encodedLen;
+                /* From here on, the parameter refers to its encoded form. */
+                pParam->key.pData = &( pBuf[ uxBufIndex ] );
+                pParam->key.dataLen = encodedLen;
+                uxBufIndex += encodedLen;
                 remainingLen -= encodedLen;
 
-                assert( pCanonicalRequest->pQueryLoc[ paramsIndex ].value.pData != NULL );
-                returnStatus = writeValueInCanonicalizedQueryString( ( char * ) &( pCanonicalRequest->pBufProcessing[ uxBufIndex ] ),
+                returnStatus = writeValueInCanonicalizedQueryString( &( pBuf[ uxBufIndex ] ),
                                                                      remainingLen,
-                                                                     pCanonicalRequest->pQueryLoc[ paramsIndex ].value.pData,
-                                                                     pCanonicalRequest->pQueryLoc[ paramsIndex ].value.dataLen,
+                                                                     pParam->value.pData,
+                                                                     pParam->value.dataLen,
                                                                      &encodedLen,
                                                                      doubleEncodeEqualsInParmsValues );
-                uxBufIndex = uxBufIndex + encodedLen;
-                remainingLen -= encodedLen;
             }
 
-            /* If there is a succeeding query parameter, add the '&' separator in the canonical query. */
-            if( ( returnStatus == SigV4Success ) && ( ( paramsIndex + 1U ) != numberOfParameters ) )
+            if( returnStatus == SigV4Success )
             {
-                /* Before adding the '&' for the next query parameter, check that there is
-                 * space in the buffer. */
+                pParam->value.pData = &( pBuf[ uxBufIndex + 1U ] );
+                pParam->value.dataLen = encodedLen - 1U;
+                uxBufIndex += encodedLen;
+                remainingLen -= encodedLen;
+
+                /* Every parameter is followed by '&', which becomes the linefeed
+                 * after the last parameter once the parameters are sorted. */
                 if( remainingLen > 0U )
                 {
-                    ( ( char * ) ( pCanonicalRequest->pBufProcessing ) )[ uxBufIndex ] = '&';
+                    pBuf[ uxBufIndex ] = '&';
                     uxBufIndex++;
                     remainingLen--;
                 }
-
-                /* There is at least another query parameter entry to encode
-                 * but no space in the buffer. */
                 else
                 {
                     returnStatus = SigV4InsufficientMemory;
                     LOG_INSUFFICIENT_MEMORY_ERROR( "write query parameter separator, '&'", 1U );
-                    break;
                 }
             }
         }
 
-        /* Update the context state if canonical query generation was successful. */
-        if( returnStatus == SigV4Success )
-        {
-            pCanonicalRequest->uxCursorIndex = uxBufIndex;
-            pCanonicalRequest->bufRemaining = remainingLen;
-        }
+        *pEncodedQueryLen = uxBufIndex - pCanonicalRequest->uxCursorIndex;
 
         return returnStatus;
     }
 
 /*-----------------------------------------------------------*/
 
-    static SigV4Status_t generateCanonicalQuery( const char * pQuery,
-                                                 size_t queryLen,
-                                                 const bool doubleEncodeEqualsInParmsValues,
-                                                 CanonicalContext_t * pCanonicalContext )
+    static void copySortedQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                           size_t numberOfParameters,
+                                           size_t encodedQueryLen )
     {
-        SigV4Status_t returnStatus = SigV4Success;
-        size_t numberOfParameters = 0U;
+        size_t paramsIndex, paramLen, offset = 0U;
+        char * pQuery;
+        char * pScratch;
 
-        assert( pCanonicalContext != NULL );
+        assert( pCanonicalRequest != NULL );
+        assert( pCanonicalRequest->bufRemaining >= ( 2U * encodedQueryLen ) );
 
-        if( pQuery != NULL )
+        pQuery = ( char * ) &( pCanonicalRequest->pBufProcessing[ pCanonicalRequest->uxCursorIndex ] );
+        pScratch = &( pQuery[ encodedQueryLen ] );
+
+        for( paramsIndex = 0U; paramsIndex < numberOfParameters; paramsIndex++ )
         {
-            returnStatus = parseQueryString( pQuery, queryLen, &numberOfParameters, pCanonicalContext );
+            /* The encoded key, '=', the encoded value and '&'. */
+            paramLen = pCanonicalRequest->pQueryLoc[ paramsIndex ].key.dataLen +
+                       pCanonicalRequest->pQueryLoc[ paramsIndex ].value.dataLen + 2U;
+            ( void ) memcpy( &( pScratch[ offset ] ), pCanonicalRequest->pQueryLoc[ paramsIndex ].key.pData, paramLen );
+            offset += paramLen;
         }
 
-        if( ( returnStatus == SigV4Success ) && ( numberOfParameters > 0U ) )
-        {
-            /* Sort the parameter names by character code point in ascending order.
-             * Parameters with duplicate names should be sorted by value. */
-            quickSort( pCanonicalContext->pQueryLoc, numberOfParameters, sizeof( SigV4KeyValuePair_t ), cmpQueryFieldValue );
+        ( void ) memcpy( pQuery, pScratch, encodedQueryLen );
+    }
 
-            /* URI-encode each parameter name and value according to the following rules specified for SigV4:
-             *  - Do not URI-encode any of the unreserved characters that RFC 3986 defines:
-             *      A-Z, a-z, 0-9, hyphen ( - ), underscore ( _ ), period ( . ), and tilde ( ~ ).
-             *  - Percent-encode all other characters with %XY, where X and Y are hexadecimal characters (0-9 and uppercase A-F).
-             */
-            returnStatus = writeCanonicalQueryParameters( pCanonicalContext, numberOfParameters, doubleEncodeEqualsInParmsValues );
-        }
+/*-----------------------------------------------------------*/
 
-        if( returnStatus == SigV4Success )
+    static void rotateSortedQueryParameters( CanonicalContext_t * pCanonicalRequest,
+                                             size_t numberOfParameters )
+    {
+        size_t paramsIndex, otherIndex, paramLen, shiftedLen;
+        char * pDest;
+        const char * pParam;
+
+        assert( pCanonicalRequest != NULL );
+
+        pDest = ( char * ) &( pCanonicalRequest->pBufProcessing[ pCanonicalRequest->uxCursorIndex ] );
+
+        for( paramsIndex = 0U; paramsIndex < numberOfParameters; paramsIndex++ )
+        {
+            pParam = pCanonicalRequest->pQueryLoc[ paramsIndex ].key.pData;
+            paramLen = pCanonicalRequest->pQueryLoc[ paramsIndex ].key.dataLen +
+                       pCanonicalRequest->pQueryLoc[ paramsIndex ].value.dataLen + 2U;
+            assert( pParam >= pDest );
+            shiftedLen = ( size_t ) ( pParam - pDest );
+
+            if( shiftedLen > 0U )
+            {
+                /* Rotate the parameter in front of the parameters stored before it. */
+                reverseCharacters( pDest, shiftedLen );
+                reverseCharacters( &( pDest[ shiftedLen ] ), paramLen );
+                reverseCharacters( pDest, shiftedLen + paramLen );
+
+                for( otherIndex = paramsIndex + 1U; otherIndex < numberOfParameters; otherIndex++ )
+                {
+                    if( pCanonicalRequest->pQueryLoc[ otherIndex ].key.pData < pParam )
+                    {
+                        pCanonicalRequest->pQueryLoc[ otherIndex ].key.pData = &( pCanonicalRequest->pQueryLoc[ otherIndex ].key.pData[ paramLen ] );
+                        pCanonicalRequest->pQueryLoc[ otherIndex ].value.pData = &( pCanonicalRequest->pQueryLoc[ otherIndex ].value.pData[ paramLen ] );
+                    }
+                }
+            }
+
+            pDest = &( pDest[ paramLen ] );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t generateCanonicalQuery( const char * pQuery,
+                                                 size_t queryLen,
+                                                 const char * pQueryWrap,
+                                                 size_t queryWrapLen,
+                                                 const bool doubleEncodeEqualsInParmsValues,
+                                                 CanonicalContext_t * pCanonicalContext )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        size_t numberOfParameters = 0U, encodedQueryLen = 0U, stagedLen = 0U;
+
+        assert( pCanonicalContext != NULL );
+
+        if( pQuery != NULL )
+        {
+            returnStatus = parseWrappedQueryString( pQuery, queryLen, pQueryWrap, queryWrapLen,
+                                                    &numberOfParameters, &stagedLen, pCanonicalContext );
+        }
+
+        if( ( returnStatus == SigV4Success ) && ( numberOfParameters > 0U ) )
+        {
+            /* URI-encode each parameter name and value according to the following rules specified for SigV4:
+             *  - Do not URI-encode any of the unreserved characters that RFC 3986 defines:
+             *      A-Z, a-z, 0-9, hyphen ( - ), underscore ( _ ), period ( . ), and tilde ( ~ ).
+             *  - Percent-encode all other characters with %XY, where X and Y are hexadecimal characters (0-9 and uppercase A-F).
+             */
+            returnStatus = encodeQueryParameters( pCanonicalContext, numberOfParameters, doubleEncodeEqualsInParmsValues, &encodedQueryLen );
+        }
+
+        if( ( returnStatus == SigV4Success ) && ( numberOfParameters > 0U ) )
+        {
+            /* Sort the encoded parameter names by character code point in ascending order.
+             * Parameters with duplicate names should be sorted by value. */
+            quickSort( pCanonicalContext->pQueryLoc, numberOfParameters, sizeof( SigV4KeyValuePair_t ), cmpQueryFieldValue );
+
+            /* Put the encoded parameters in sorted order, through the free space
+             * after them if there is enough of it. */
+            if( ( pCanonicalContext->bufRemaining - encodedQueryLen ) >= encodedQueryLen )
+            {
+                copySortedQueryParameters( pCanonicalContext, numberOfParameters, encodedQueryLen );
+            }
+            else
+            {
+                rotateSortedQueryParameters( pCanonicalContext, numberOfParameters );
+            }
+
+            /* Keep the last '&' as space for the linefeed. */
+            pCanonicalContext->uxCursorIndex += encodedQueryLen - 1U;
+            pCanonicalContext->bufRemaining -= encodedQueryLen - 1U;
+        }
+
+        /* The parameters now refer to their encoded form, so the query
+         * parameter copied across the end of a ring buffer is released. */
+        pCanonicalContext->bufRemaining += stagedLen;
+
+        if( returnStatus == SigV4Success )
         {
             if( pCanonicalContext->bufRemaining > 0U )
             {
@@ -2122,6 +3942,374 @@ static void generateCredentialScope( const SigV4Parameters_t * pSigV4Params,
         return returnStatus;
     }
 
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t verifyQueryBuilderParams( const SigV4QueryBuilder_t * pBuilder,
+                                                   const char * pKey,
+                                                   size_t keyLen,
+                                                   const char * pValue,
+                                                   size_t valueLen )
+    {
+        SigV4Status_t returnStatus = SigV4InvalidParameter;
+
+        if( ( pBuilder == NULL ) || ( pBuilder->pQuery == NULL ) ||
+            ( pBuilder->queryLen >= pBuilder->bufferLen ) )
+        {
+            LogError( ( "Parameter check failed: pBuilder is NULL or was not initialized with SigV4_InitQueryBuilder." ) );
+        }
+        else if( ( pKey == NULL ) || ( keyLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: Query parameter name is empty." ) );
+        }
+        else if( ( pValue == NULL ) && ( valueLen != 0U ) )
+        {
+            LogError( ( "Parameter check failed: pValue is NULL, but valueLen is not zero." ) );
+        }
+        else
+        {
+            returnStatus = SigV4Success;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t queryBuilderStoredLength( const SigV4QueryBuilder_t * pBuilder )
+    {
+        assert( pBuilder != NULL );
+
+        return ( pBuilder->queryLen > 0U ) ? ( pBuilder->queryLen + 1U ) : 0U;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t encodeQueryBuilderEntry( const SigV4QueryBuilder_t * pBuilder,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen,
+                                                  size_t * pEncodedKeyLen,
+                                                  size_t * pEntryLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        size_t storedLen = queryBuilderStoredLength( pBuilder );
+        char * pEntry = &( pBuilder->pQuery[ storedLen ] );
+        size_t remainingLen = pBuilder->bufferLen - storedLen;
+        size_t encodedLen = remainingLen;
+
+        assert( pEncodedKeyLen != NULL );
+        assert( pEntryLen != NULL );
+
+        returnStatus = SigV4_EncodeURI( pKey, keyLen, pEntry, &encodedLen,
+                                        true /* Encode slash (/) */,
+                                        false /* Do not double encode '='. */ );
+
+        if( returnStatus == SigV4Success )
+        {
+            *pEncodedKeyLen = encodedLen;
+            remainingLen -= encodedLen;
+            returnStatus = writeValueInCanonicalizedQueryString( &( pEntry[ encodedLen ] ),
+                                                                 remainingLen,
+                                                                 ( valueLen > 0U ) ? pValue : NULL,
+                                                                 valueLen,
+                                                                 &encodedLen,
+                                                                 pBuilder->doubleEncodeEquals );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            remainingLen -= encodedLen;
+
+            if( remainingLen < 1U )
+            {
+                returnStatus = SigV4InsufficientMemory;
+                LogError( ( "Failed to encode query parameter: The query builder buffer is full." ) );
+            }
+            else
+            {
+                *pEntryLen = *pEncodedKeyLen + encodedLen + 1U;
+                pEntry[ *pEntryLen - 1U ] = '&';
+            }
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static int32_t cmpEncodedQueryKey( const char * pFirstKey,
+                                       size_t firstKeyLen,
+                                       const char * pSecondKey,
+                                       size_t secondKeyLen )
+    {
+        size_t lenSmall = ( firstKeyLen < secondKeyLen ) ? firstKeyLen : secondKeyLen;
+        int32_t compResult = ( int32_t ) memcmp( pFirstKey, pSecondKey, lenSmall );
+
+        if( ( compResult == 0 ) && ( firstKeyLen != secondKeyLen ) )
+        {
+            /* Names share a common prefix, so the shorter one should come first. */
+            compResult = ( firstKeyLen < secondKeyLen ) ? -1 : 1;
+        }
+
+        return compResult;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t findQueryBuilderEntry( const char * pQuery,
+                                         size_t storedLen,
+                                         const char * pKey,
+                                         size_t keyLen,
+                                         size_t * pFoundLen )
+    {
+        size_t offset = 0U, entryKeyLen = 0U, entryLen = 0U;
+        int32_t compResult = -1;
+
+        assert( pQuery != NULL );
+        assert( pFoundLen != NULL );
+
+        *pFoundLen = 0U;
+
+        /* Stored parameters are sorted by name, and every one of them is
+         * written as "name=value&", so scan until a name that is not smaller. */
+        while( ( offset < storedLen ) && ( compResult < 0 ) )
+        {
+            entryKeyLen = 0U;
+
+            while( pQuery[ offset + entryKeyLen ] != '=' )
+            {
+                entryKeyLen++;
+            }
+
+            entryLen = entryKeyLen;
+
+            while( pQuery[ offset + entryLen ] != '&' )
+            {
+                entryLen++;
+            }
+
+            entryLen++;
+            compResult = cmpEncodedQueryKey( &( pQuery[ offset ] ), entryKeyLen, pKey, keyLen );
+
+            if( compResult < 0 )
+            {
+                offset += entryLen;
+            }
+        }
+
+        if( compResult == 0 )
+        {
+            *pFoundLen = entryLen;
+        }
+
+        return offset;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t skipRepeatedQueryBuilderEntries( const char * pQuery,
+                                                   size_t storedLen,
+                                                   size_t offset,
+                                                   const char * pEntry,
+                                                   size_t keyLen,
+                                                   size_t entryLen )
+    {
+        size_t insertOffset = offset, storedKeyLen = 0U, storedEntryLen = 0U;
+        bool isSkipped = true;
+
+        assert( pQuery != NULL );
+        assert( pEntry != NULL );
+
+        while( ( insertOffset < storedLen ) && isSkipped )
+        {
+            storedKeyLen = 0U;
+
+            while( pQuery[ insertOffset + storedKeyLen ] != '=' )
+            {
+                storedKeyLen++;
+            }
+
+            storedEntryLen = storedKeyLen;
+
+            while( pQuery[ insertOffset + storedEntryLen ] != '&' )
+            {
+                storedEntryLen++;
+            }
+
+            storedEntryLen++;
+
+            /* The values start after the '=' and end before the '&'. */
+            isSkipped = ( cmpEncodedQueryKey( &( pQuery[ insertOffset ] ), storedKeyLen, pEntry, keyLen ) == 0 ) &&
+                        ( cmpEncodedQueryKey( &( pQuery[ insertOffset + storedKeyLen + 1U ] ), storedEntryLen - storedKeyLen - 2U,
+                                              &( pEntry[ keyLen + 1U ] ), entryLen - keyLen - 2U ) <= 0 );
+
+            if( isSkipped )
+            {
+                insertOffset += storedEntryLen;
+            }
+        }
+
+        return insertOffset;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void reverseCharacters( char * pData,
+                                   size_t dataLen )
+    {
+        size_t low = 0U, high = dataLen;
+        char swap = '\0';
+
+        while( ( high - low ) > 1U )
+        {
+            high--;
+            swap = pData[ low ];
+            pData[ low ] = pData[ high ];
+            pData[ high ] = swap;
+            low++;
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint32_t updateFnv1aHash( uint32_t hash,
+                                     const char * pData,
+                                     size_t dataLen )
+    {
+        uint32_t updatedHash = hash;
+        size_t i;
+
+        assert( pData != NULL );
+
+        for( i = 0U; i < dataLen; i++ )
+        {
+            updatedHash ^= ( uint32_t ) ( uint8_t ) pData[ i ];
+            updatedHash *= FNV1A_32_PRIME;
+        }
+
+        return updatedHash;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4PathCacheEntry_t * findPathCacheEntry( SigV4PathCache_t * pPathCache,
+                                                       uint32_t pathHash,
+                                                       const char * pPath,
+                                                       size_t pathLen,
+                                                       bool encodeTwice )
+    {
+        SigV4PathCacheEntry_t * pFound = NULL;
+        SigV4PathCacheEntry_t * pEntry = NULL;
+        size_t i;
+
+        assert( pPathCache != NULL );
+
+        for( i = 0U; ( i < SIGV4_PATH_CACHE_ENTRY_COUNT ) && ( pFound == NULL ); i++ )
+        {
+            pEntry = &( pPathCache->entries[ i ] );
+
+            /* The hash rules out most entries before the paths are compared. */
+            if( ( pEntry->canonicalPathLen != 0U ) &&
+                ( pEntry->pathHash == pathHash ) &&
+                ( pEntry->pathLen == pathLen ) &&
+                ( pEntry->encodedTwice == encodeTwice ) &&
+                ( memcmp( pEntry->pPath, pPath, pathLen ) == 0 ) )
+            {
+                pFound = pEntry;
+            }
+        }
+
+        return pFound;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void storePathCacheEntry( SigV4PathCache_t * pPathCache,
+                                     uint32_t pathHash,
+                                     const char * pPath,
+                                     size_t pathLen,
+                                     bool encodeTwice,
+                                     const char * pCanonicalPath,
+                                     size_t canonicalPathLen )
+    {
+        SigV4PathCacheEntry_t * pVictim = NULL;
+        size_t i;
+
+        assert( pPathCache != NULL );
+
+        pVictim = &( pPathCache->entries[ 0 ] );
+
+        if( ( pathLen <= SIGV4_PATH_CACHE_PATH_LENGTH ) &&
+            ( canonicalPathLen <= SIGV4_PATH_CACHE_PATH_LENGTH ) )
+        {
+            /* Empty entries have never been used, so they are replaced first. */
+            for( i = 1U; i < SIGV4_PATH_CACHE_ENTRY_COUNT; i++ )
+            {
+                if( pPathCache->entries[ i ].lastUsed < pVictim->lastUsed )
+                {
+                    pVictim = &( pPathCache->entries[ i ] );
+                }
+            }
+
+            pPathCache->useCounter++;
+            pVictim->pathHash = pathHash;
+            pVictim->lastUsed = pPathCache->useCounter;
+            pVictim->encodedTwice = encodeTwice;
+            ( void ) memcpy( pVictim->pPath, pPath, pathLen );
+            pVictim->pathLen = pathLen;
+            ( void ) memcpy( pVictim->pCanonicalPath, pCanonicalPath, canonicalPathLen );
+            pVictim->canonicalPathLen = canonicalPathLen;
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t writeCanonicalURI( SigV4PathCache_t * pPathCache,
+                                            const char * pUri,
+                                            size_t uriLen,
+                                            bool encodeTwice,
+                                            CanonicalContext_t * pCanonicalRequest )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        SigV4PathCacheEntry_t * pEntry = NULL;
+        uint32_t pathHash = 0U;
+        size_t uxStartIndex = pCanonicalRequest->uxCursorIndex;
+
+        if( pPathCache == NULL )
+        {
+            returnStatus = generateCanonicalURI( pUri, uriLen, encodeTwice, pCanonicalRequest );
+        }
+        else
+        {
+            pathHash = updateFnv1aHash( FNV1A_32_OFFSET_BASIS, pUri, uriLen );
+            pEntry = findPathCacheEntry( pPathCache, pathHash, pUri, uriLen, encodeTwice );
+
+            if( pEntry != NULL )
+            {
+                pPathCache->useCounter++;
+                pEntry->lastUsed = pPathCache->useCounter;
+                referenceLineInCanonicalRequest( pEntry->pCanonicalPath,
+                                                 pEntry->canonicalPathLen,
+                                                 pCanonicalRequest );
+            }
+            else
+            {
+                returnStatus = generateCanonicalURI( pUri, uriLen, encodeTwice, pCanonicalRequest );
+
+                if( returnStatus == SigV4Success )
+                {
+                    /* The canonical URI is followed by a newline character. */
+                    storePathCacheEntry( pPathCache, pathHash, pUri, uriLen, encodeTwice,
+                                         ( const char * ) &( pCanonicalRequest->pBufProcessing[ uxStartIndex ] ),
+                                         ( pCanonicalRequest->uxCursorIndex - uxStartIndex ) - 1U );
+                }
+            }
+        }
+
+        return returnStatus;
+    }
+
 #endif /* #if ( SIGV4_USE_CANONICAL_SUPPORT == 1 ) */
 
 /*-----------------------------------------------------------*/
@@ -2142,7 +4330,23 @@ static SigV4Status_t verifyParamsToGenerateAuthHeaderApi( const SigV4Parameters_
                     "Input parameters cannot be NULL" ) );
         returnStatus = SigV4InvalidParameter;
     }
-    else if( pParams->pCredentials == NULL )
+    else
+    {
+        returnStatus = verifySigV4Parameters( pParams );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t verifySigV4Parameters( const SigV4Parameters_t * pParams )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+
+    assert( pParams != NULL );
+
+    if( pParams->pCredentials == NULL )
     {
         LogError( ( "Parameter check failed: pParams->pCredentials is NULL." ) );
         returnStatus = SigV4InvalidParameter;
@@ -2162,7 +4366,7 @@ static SigV4Status_t verifyParamsToGenerateAuthHeaderApi( const SigV4Parameters_
         LogError( ( "Parameter check failed: pParams->DateIso8601 data is NULL." ) );
         returnStatus = SigV4InvalidParameter;
     }
-    else if( ( pParams->pRegion == NULL ) || ( pParams->regionLen == 0U ) )
+    else if( !isSigV4A( pParams ) && ( ( pParams->pRegion == NULL ) || ( pParams->regionLen == 0U ) ) )
     {
         LogError( ( "Parameter check failed: Region data is empty." ) );
         returnStatus = SigV4InvalidParameter;
@@ -2210,9 +4414,39 @@ static SigV4Status_t verifyParamsToGenerateAuthHeaderApi( const SigV4Parameters_
         LogError( ( "Parameter check failed: HTTP Method data is either NULL or zero bytes in length." ) );
         returnStatus = SigV4InvalidParameter;
     }
-    else if( ( pParams->pHttpParameters->pHeaders == NULL ) || ( pParams->pHttpParameters->headersLen == 0U ) )
+    else if( ( ( pParams->pHttpParameters->pHeaders == NULL ) && ( pParams->pHttpParameters->headersLen != 0U ) ) ||
+             ( ( pParams->pHttpParameters->headersLen +
+                 wrappedLength( pParams->pHttpParameters->pHeadersWrap, pParams->pHttpParameters->headersWrapLen ) ) == 0U ) )
+    {
+        LogError( ( "Parameter check failed: HTTP headers are either NULL or zero bytes in length." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PAYLOAD_IS_DIGEST ) &&
+             ( ( pParams->pHttpParameters->pPayload == NULL ) ||
+               ( ( pParams->pHttpParameters->payloadLen +
+                   wrappedLength( pParams->pHttpParameters->pPayloadWrap, pParams->pHttpParameters->payloadWrapLen ) ) !=
+                 ( pParams->pCryptoInterface->hashDigestLen * 2U ) ) ) )
+    {
+        LogError( ( "Parameter check failed: SIGV4_HTTP_PAYLOAD_IS_DIGEST is set, but the payload is not a hex-encoded digest." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( isSigV4A( pParams ) &&
+             ( ( pParams->pEcdsaInterface == NULL ) || ( pParams->pEcdsaInterface->loadKey == NULL ) ||
+               ( pParams->pEcdsaInterface->sign == NULL ) ) )
+    {
+        LogError( ( "Parameter check failed: SigV4A requires pParams->pEcdsaInterface with loadKey and sign function pointer members." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( isSigV4A( pParams ) && ( pParams->pCryptoInterface->hashDigestLen != SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ) )
+    {
+        LogError( ( "Parameter check failed: SigV4A requires a SHA-256 crypto interface." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( ( pParams->pPrecomputedScope != NULL ) &&
+             ( ( pParams->pPrecomputedScope->pScopeSuffix == NULL ) || ( pParams->pPrecomputedScope->scopeSuffixLen == 0U ) ||
+               ( pParams->pPrecomputedScope->pAuthPrefix == NULL ) || ( pParams->pPrecomputedScope->authPrefixLen == 0U ) ) )
     {
-        LogError( ( "Parameter check failed: HTTP URI path information is either NULL or zero bytes in length." ) );
+        LogError( ( "Parameter check failed: pParams->pPrecomputedScope has an empty scope suffix or Authorization prefix." ) );
         returnStatus = SigV4InvalidParameter;
     }
     else
@@ -2246,11 +4480,15 @@ static void assignDefaultArguments( const SigV4Parameters_t * pParams,
 
 static int32_t completeHash( const uint8_t * pInput,
                              size_t inputLen,
+                             const uint8_t * pWrap,
+                             size_t wrapLen,
                              uint8_t * pOutput,
                              size_t outputLen,
                              const SigV4CryptoInterface_t * pCryptoInterface )
 {
     int32_t hashStatus = -1;
+    SigV4IoVec_t segments[ 2 ];
+    size_t segmentCount = 0U;
 
     assert( pOutput != NULL );
     assert( outputLen > 0 );
@@ -2259,12 +4497,18 @@ static int32_t completeHash( const uint8_t * pInput,
     assert( pCryptoInterface->hashUpdate != NULL );
     assert( pCryptoInterface->hashFinal != NULL );
 
+    appendSegment( segments, &segmentCount, pInput, inputLen );
+
+    if( wrapLen > 0U )
+    {
+        appendSegment( segments, &segmentCount, pWrap, wrapLen );
+    }
+
     hashStatus = pCryptoInterface->hashInit( pCryptoInterface->pHashContext );
 
     if( hashStatus == 0 )
     {
-        hashStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                   pInput, inputLen );
+        hashStatus = hashUpdateSegments( pCryptoInterface, segments, segmentCount );
     }
 
     if( hashStatus == 0 )
@@ -2280,6 +4524,8 @@ static int32_t completeHash( const uint8_t * pInput,
 
 static SigV4Status_t completeHashAndHexEncode( const char * pInput,
                                                size_t inputLen,
+                                               const char * pWrap,
+                                               size_t wrapLen,
                                                char * pOutput,
                                                size_t * pOutputLen,
                                                const SigV4CryptoInterface_t * pCryptoInterface )
@@ -2304,6 +4550,8 @@ static SigV4Status_t completeHashAndHexEncode( const char * pInput,
 
     if( completeHash( ( const uint8_t * ) pInput,
                       inputLen,
+                      ( const uint8_t * ) pWrap,
+                      wrappedLength( pWrap, wrapLen ),
                       hashBuffer,
                       pCryptoInterface->hashDigestLen,
                       pCryptoInterface ) != 0 )
@@ -2329,6 +4577,156 @@ static SigV4Status_t completeHashAndHexEncode( const char * pInput,
 
 /*-----------------------------------------------------------*/
 
+static int32_t hashCanonicalRequest( const CanonicalContext_t * pCanonicalContext,
+                                     uint8_t * pOutput,
+                                     size_t outputLen,
+                                     const SigV4CryptoInterface_t * pCryptoInterface )
+{
+    int32_t hashStatus = -1;
+    size_t uxHashedIndex = 0U, i = 0U;
+    const SigV4ReferencedLine_t * pLine = NULL;
+    SigV4IoVec_t segments[ MAX_CANONICAL_REQUEST_SEGMENTS ];
+    size_t segmentCount = 0U;
+
+    assert( pCanonicalContext != NULL );
+    assert( pCanonicalContext->referencedLineCount <= MAX_REFERENCED_CANONICAL_LINES );
+
+    /* Each referenced line is hashed after the buffered bytes that precede it. */
+    for( i = 0U; i < pCanonicalContext->referencedLineCount; i++ )
+    {
+        pLine = &( pCanonicalContext->referencedLines[ i ] );
+
+        if( pLine->uxInsertIndex > uxHashedIndex )
+        {
+            appendSegment( segments, &segmentCount,
+                           &( pCanonicalContext->pBufProcessing[ uxHashedIndex ] ),
+                           pLine->uxInsertIndex - uxHashedIndex );
+            uxHashedIndex = pLine->uxInsertIndex;
+        }
+
+        appendSegment( segments, &segmentCount, pLine->line.pData, pLine->line.dataLen );
+
+        if( pLine->wrap.dataLen > 0U )
+        {
+            appendSegment( segments, &segmentCount, pLine->wrap.pData, pLine->wrap.dataLen );
+        }
+
+        appendSegment( segments, &segmentCount, "\n", 1U );
+    }
+
+    appendSegment( segments, &segmentCount,
+                   &( pCanonicalContext->pBufProcessing[ uxHashedIndex ] ),
+                   pCanonicalContext->uxCursorIndex - uxHashedIndex );
+
+    hashStatus = pCryptoInterface->hashInit( pCryptoInterface->pHashContext );
+
+    if( hashStatus == 0 )
+    {
+        hashStatus = hashUpdateSegments( pCryptoInterface, segments, segmentCount );
+    }
+
+    if( hashStatus == 0 )
+    {
+        hashStatus = pCryptoInterface->hashFinal( pCryptoInterface->pHashContext,
+                                                  pOutput, outputLen );
+    }
+
+    return hashStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t hashUpdateSegments( const SigV4CryptoInterface_t * pCryptoInterface,
+                                   const SigV4IoVec_t * pSegments,
+                                   size_t segmentCount )
+{
+    int32_t hashStatus = 0;
+    size_t i = 0U;
+
+    assert( pCryptoInterface != NULL );
+    assert( pSegments != NULL );
+
+    if( pCryptoInterface->hashUpdateV != NULL )
+    {
+        hashStatus = pCryptoInterface->hashUpdateV( pCryptoInterface->pHashContext,
+                                                    pSegments,
+                                                    segmentCount );
+    }
+    else
+    {
+        for( i = 0U; ( hashStatus == 0 ) && ( i < segmentCount ); i++ )
+        {
+            hashStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
+                                                       ( const uint8_t * ) pSegments[ i ].pData,
+                                                       pSegments[ i ].dataLen );
+        }
+    }
+
+    return hashStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void appendSegment( SigV4IoVec_t * pSegments,
+                           size_t * pSegmentCount,
+                           const void * pData,
+                           size_t dataLen )
+{
+    assert( pSegments != NULL );
+    assert( pSegmentCount != NULL );
+
+    pSegments[ *pSegmentCount ].pData = ( const char * ) pData;
+    pSegments[ *pSegmentCount ].dataLen = dataLen;
+    ( *pSegmentCount )++;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t hashCanonicalRequestAndHexEncode( const CanonicalContext_t * pCanonicalContext,
+                                                       char * pOutput,
+                                                       size_t * pOutputLen,
+                                                       const SigV4CryptoInterface_t * pCryptoInterface )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    /* Used to store the hash of the canonical request. */
+    uint8_t hashBuffer[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+    SigV4String_t originalHash;
+    SigV4String_t hexEncodedHash;
+
+    assert( pOutput != NULL );
+    assert( pOutputLen != NULL );
+    assert( pCryptoInterface != NULL );
+
+    originalHash.pData = ( char * ) hashBuffer;
+    originalHash.dataLen = pCryptoInterface->hashDigestLen;
+    hexEncodedHash.pData = pOutput;
+    hexEncodedHash.dataLen = *pOutputLen;
+
+    if( hashCanonicalRequest( pCanonicalContext,
+                              hashBuffer,
+                              pCryptoInterface->hashDigestLen,
+                              pCryptoInterface ) != 0 )
+    {
+        returnStatus = SigV4HashError;
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = lowercaseHexEncode( &originalHash,
+                                           &hexEncodedHash );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        assert( hexEncodedHash.dataLen == pCryptoInterface->hashDigestLen * 2U );
+        *pOutputLen = hexEncodedHash.dataLen;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 static int32_t hmacAddKey( HmacContext_t * pHmacContext,
                            const char * pKey,
                            size_t keyLen,
@@ -2337,6 +4735,8 @@ static int32_t hmacAddKey( HmacContext_t * pHmacContext,
     int32_t returnStatus = 0;
     const SigV4CryptoInterface_t * pCryptoInterface = NULL;
     const uint8_t * pUnsignedKey = ( const uint8_t * ) pKey;
+    SigV4IoVec_t segments[ 2 ];
+    size_t segmentCount = 0U;
 
     assert( pHmacContext != NULL );
     assert( pHmacContext->key != NULL );
@@ -2357,22 +4757,17 @@ static int32_t hmacAddKey( HmacContext_t * pHmacContext,
     }
     else
     {
-        returnStatus = pCryptoInterface->hashInit( pCryptoInterface->pHashContext );
+        /* Hash the part of the key that is cached in the HMAC context, then
+         * hash down the remaining part of the key in order to create a
+         * block-sized derived key. */
+        appendSegment( segments, &segmentCount, pHmacContext->key, pHmacContext->keyLen );
+        appendSegment( segments, &segmentCount, pUnsignedKey, keyLen );
 
-        /* Hash part of the key that is cached in the HMAC context. */
-        if( returnStatus == 0 )
-        {
-            returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                         pHmacContext->key,
-                                                         pHmacContext->keyLen );
-        }
+        returnStatus = pCryptoInterface->hashInit( pCryptoInterface->pHashContext );
 
-        /* Hash down the remaining part of the key in order to create a block-sized derived key. */
         if( returnStatus == 0 )
         {
-            returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                         pUnsignedKey,
-                                                         keyLen );
+            returnStatus = hashUpdateSegments( pCryptoInterface, segments, segmentCount );
         }
 
         if( returnStatus == 0 )
@@ -2409,6 +4804,8 @@ static int32_t hmacIntermediate( HmacContext_t * pHmacContext,
     int32_t returnStatus = 0;
     size_t i = 0U;
     const SigV4CryptoInterface_t * pCryptoInterface = pHmacContext->pCryptoInterface;
+    SigV4IoVec_t segments[ 2 ];
+    size_t segmentCount = 0U;
 
     assert( pHmacContext != NULL );
     assert( dataLen > 0U );
@@ -2432,18 +4829,10 @@ static int32_t hmacIntermediate( HmacContext_t * pHmacContext,
 
     if( returnStatus == 0 )
     {
-        /* Hash the inner-padded block-sized key. */
-        returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                     pHmacContext->key,
-                                                     pCryptoInterface->hashBlockLen );
-    }
-
-    if( returnStatus == 0 )
-    {
-        /* Hash the data. */
-        returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                     ( const uint8_t * ) pData,
-                                                     dataLen );
+        /* Hash the inner-padded block-sized key, then the data. */
+        appendSegment( segments, &segmentCount, pHmacContext->key, pCryptoInterface->hashBlockLen );
+        appendSegment( segments, &segmentCount, pData, dataLen );
+        returnStatus = hashUpdateSegments( pCryptoInterface, segments, segmentCount );
     }
 
     return returnStatus;
@@ -2458,6 +4847,8 @@ static int32_t hmacFinal( HmacContext_t * pHmacContext,
     int32_t returnStatus = -1;
     uint8_t innerHashDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
     size_t i = 0U;
+    SigV4IoVec_t segments[ 2 ];
+    size_t segmentCount = 0U;
     const SigV4CryptoInterface_t * pCryptoInterface = NULL;
 
     assert( pHmacContext != NULL );
@@ -2491,18 +4882,10 @@ static int32_t hmacFinal( HmacContext_t * pHmacContext,
 
     if( returnStatus == 0 )
     {
-        /* Update hash using the outer-padded key. */
-        returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                     pHmacContext->key,
-                                                     pCryptoInterface->hashBlockLen );
-    }
-
-    if( returnStatus == 0 )
-    {
-        /* Update hash using the inner digest. */
-        returnStatus = pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
-                                                     innerHashDigest,
-                                                     pCryptoInterface->hashDigestLen );
+        /* Update hash using the outer-padded key, then the inner digest. */
+        appendSegment( segments, &segmentCount, pHmacContext->key, pCryptoInterface->hashBlockLen );
+        appendSegment( segments, &segmentCount, innerHashDigest, pCryptoInterface->hashDigestLen );
+        returnStatus = hashUpdateSegments( pCryptoInterface, segments, segmentCount );
     }
 
     if( returnStatus == 0 )
@@ -2521,34 +4904,70 @@ static int32_t hmacFinal( HmacContext_t * pHmacContext,
 
 /*-----------------------------------------------------------*/
 
-static SigV4Status_t writeLineToCanonicalRequest( const char * pLine,
-                                                  size_t lineLen,
-                                                  CanonicalContext_t * pCanonicalContext )
+static void referenceLineInCanonicalRequest( const char * pLine,
+                                             size_t lineLen,
+                                             CanonicalContext_t * pCanonicalContext )
 {
-    SigV4Status_t returnStatus = SigV4Success;
+    SigV4ReferencedLine_t * pReferencedLine = NULL;
 
     assert( pLine != NULL );
     assert( pCanonicalContext != NULL );
+    assert( pCanonicalContext->referencedLineCount < MAX_REFERENCED_CANONICAL_LINES );
+
+    pReferencedLine = &( pCanonicalContext->referencedLines[ pCanonicalContext->referencedLineCount ] );
+    pReferencedLine->line.pData = pLine;
+    pReferencedLine->line.dataLen = lineLen;
+    pReferencedLine->wrap.pData = NULL;
+    pReferencedLine->wrap.dataLen = 0U;
+    pReferencedLine->uxInsertIndex = pCanonicalContext->uxCursorIndex;
+    pCanonicalContext->referencedLineCount++;
+}
 
-    /* Make sure that there is space for the Method and the newline character.*/
-    if( pCanonicalContext->bufRemaining < ( lineLen + 1U ) )
-    {
-        returnStatus = SigV4InsufficientMemory;
-    }
-    else
-    {
-        ( void ) memcpy( ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ),
-                         pLine,
-                         lineLen );
-        pCanonicalContext->uxCursorIndex += lineLen;
+/*-----------------------------------------------------------*/
 
-        ( ( char * ) ( pCanonicalContext->pBufProcessing ) )[ pCanonicalContext->uxCursorIndex ] = LINEFEED_CHAR;
-        pCanonicalContext->uxCursorIndex++;
+static void referenceWrappedLineInCanonicalRequest( const char * pLine,
+                                                    size_t lineLen,
+                                                    const char * pWrap,
+                                                    size_t wrapLen,
+                                                    CanonicalContext_t * pCanonicalContext )
+{
+    SigV4ReferencedLine_t * pReferencedLine = NULL;
 
-        pCanonicalContext->bufRemaining -= ( lineLen + 1U );
-    }
+    referenceLineInCanonicalRequest( pLine, lineLen, pCanonicalContext );
 
-    return returnStatus;
+    /* The rest of the line is hashed right after its start. */
+    pReferencedLine = &( pCanonicalContext->referencedLines[ pCanonicalContext->referencedLineCount - 1U ] );
+    pReferencedLine->wrap.pData = pWrap;
+    pReferencedLine->wrap.dataLen = wrappedLength( pWrap, wrapLen );
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t wrappedLength( const char * pWrap,
+                             size_t wrapLen )
+{
+    return ( pWrap == NULL ) ? 0U : wrapLen;
+}
+
+/*-----------------------------------------------------------*/
+
+static void skipEmptyWrappedHead( const char ** ppData,
+                                  size_t * pDataLen,
+                                  const char ** ppWrap,
+                                  size_t * pWrapLen )
+{
+    assert( ppData != NULL );
+    assert( pDataLen != NULL );
+    assert( ppWrap != NULL );
+    assert( pWrapLen != NULL );
+
+    if( ( ( *ppData == NULL ) || ( *pDataLen == 0U ) ) && ( wrappedLength( *ppWrap, *pWrapLen ) > 0U ) )
+    {
+        *ppData = *ppWrap;
+        *pDataLen = *pWrapLen;
+        *ppWrap = NULL;
+        *pWrapLen = 0U;
+    }
 }
 
 /*-----------------------------------------------------------*/
@@ -2571,21 +4990,99 @@ static int32_t completeHmac( HmacContext_t * pHmacContext,
     assert( pOutput != NULL );
     assert( outputLen >= pHmacContext->pCryptoInterface->hashDigestLen );
 
+    if( hasNativeHmac( pHmacContext->pCryptoInterface ) )
+    {
+        returnStatus = completeNativeHmac( pHmacContext,
+                                           pKey,
+                                           keyLen,
+                                           pData,
+                                           dataLen,
+                                           pOutput,
+                                           outputLen );
+    }
+    else
+    {
+        returnStatus = hmacAddKey( pHmacContext,
+                                   pKey,
+                                   keyLen,
+                                   false /* Not a key prefix. */ );
+
+        if( returnStatus == 0 )
+        {
+            returnStatus = hmacIntermediate( pHmacContext, pData, dataLen );
+        }
+
+        if( returnStatus == 0 )
+        {
+            returnStatus = hmacFinal( pHmacContext, pOutput, outputLen );
+        }
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool hasNativeHmac( const SigV4CryptoInterface_t * pCryptoInterface )
+{
+    assert( pCryptoInterface != NULL );
+
+    return ( pCryptoInterface->hmacInit != NULL ) &&
+           ( pCryptoInterface->hmacUpdate != NULL ) &&
+           ( pCryptoInterface->hmacFinal != NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t completeNativeHmac( HmacContext_t * pHmacContext,
+                                   const char * pKey,
+                                   size_t keyLen,
+                                   const char * pData,
+                                   size_t dataLen,
+                                   char * pOutput,
+                                   size_t outputLen )
+{
+    int32_t returnStatus = 0;
+    const SigV4CryptoInterface_t * pCryptoInterface = NULL;
+
+    assert( pHmacContext != NULL );
+    assert( pHmacContext->pCryptoInterface != NULL );
+
+    pCryptoInterface = pHmacContext->pCryptoInterface;
+
+    /* Gather the key in the HMAC context, which joins it to a cached prefix
+     * such as "AWS4". The key is neither padded nor XORed with the pads, as
+     * that is left to the native implementation; only a key longer than a
+     * block is hashed down, which yields the same HMAC. */
     returnStatus = hmacAddKey( pHmacContext,
                                pKey,
                                keyLen,
-                               false /* Not a key prefix. */ );
+                               true /* Leave the key unpadded. */ );
+
+    if( returnStatus == 0 )
+    {
+        returnStatus = pCryptoInterface->hmacInit( pCryptoInterface->pHmacContext,
+                                                   pHmacContext->key,
+                                                   pHmacContext->keyLen );
+    }
 
     if( returnStatus == 0 )
     {
-        returnStatus = hmacIntermediate( pHmacContext, pData, dataLen );
+        returnStatus = pCryptoInterface->hmacUpdate( pCryptoInterface->pHmacContext,
+                                                     ( const uint8_t * ) pData,
+                                                     dataLen );
     }
 
     if( returnStatus == 0 )
     {
-        returnStatus = hmacFinal( pHmacContext, pOutput, outputLen );
+        returnStatus = pCryptoInterface->hmacFinal( pCryptoInterface->pHmacContext,
+                                                    ( uint8_t * ) pOutput,
+                                                    outputLen );
     }
 
+    /* Reset the HMAC context. */
+    pHmacContext->keyLen = 0U;
+
     return returnStatus;
 }
 
@@ -2629,7 +5126,6 @@ static SigV4Status_t writeStringToSign( const SigV4Parameters_t * pParams,
 {
     SigV4Status_t returnStatus = SigV4Success;
     char * pBufStart = ( char * ) pCanonicalContext->pBufProcessing;
-    size_t uxBufferLen = pCanonicalContext->uxCursorIndex;
     /* An overestimate but sufficient memory is checked before proceeding. */
     size_t encodedLen = SIGV4_PROCESSING_BUFFER_LENGTH;
 
@@ -2661,11 +5157,10 @@ static SigV4Status_t writeStringToSign( const SigV4Parameters_t * pParams,
     else
     {
         /* Hash the canonical request to its precalculated location in the string to sign. */
-        returnStatus = completeHashAndHexEncode( pBufStart,
-                                                 uxBufferLen,
-                                                 &( pBufStart[ sizeNeededBeforeHash ] ),
-                                                 &encodedLen,
-                                                 pParams->pCryptoInterface );
+        returnStatus = hashCanonicalRequestAndHexEncode( pCanonicalContext,
+                                                         &( pBufStart[ sizeNeededBeforeHash ] ),
+                                                         &encodedLen,
+                                                         pParams->pCryptoInterface );
     }
 
     if( returnStatus == SigV4Success )
@@ -2710,6 +5205,14 @@ static SigV4Status_t generateCanonicalRequestUntilHeaders( const SigV4Parameters
     SigV4Status_t returnStatus = SigV4Success;
     const char * pPath = NULL;
     size_t pathLen = 0U;
+    const char * pQuery = pParams->pHttpParameters->pQuery;
+    size_t queryLen = pParams->pHttpParameters->queryLen;
+    const char * pQueryWrap = pParams->pHttpParameters->pQueryWrap;
+    size_t queryWrapLen = pParams->pHttpParameters->queryWrapLen;
+    const char * pHeaders = pParams->pHttpParameters->pHeaders;
+    size_t headersLen = pParams->pHttpParameters->headersLen;
+    const char * pHeadersWrap = pParams->pHttpParameters->pHeadersWrap;
+    size_t headersWrapLen = pParams->pHttpParameters->headersWrapLen;
     bool doubleEncodeEqualsInParmsValues = true;
 
     /* In presigned URL we do not want to double-encode any equals ( = ) characters in parameter values */
@@ -2732,55 +5235,54 @@ static SigV4Status_t generateCanonicalRequestUntilHeaders( const SigV4Parameters
         pathLen = pParams->pHttpParameters->pathLen;
     }
 
+    /* A ring buffer may wrap right at the start of the query or headers. */
+    skipEmptyWrappedHead( &pQuery, &queryLen, &pQueryWrap, &queryWrapLen );
+    skipEmptyWrappedHead( &pHeaders, &headersLen, &pHeadersWrap, &headersWrapLen );
+
     pCanonicalContext->uxCursorIndex = 0;
     pCanonicalContext->bufRemaining = SIGV4_PROCESSING_BUFFER_LENGTH;
+    pCanonicalContext->referencedLineCount = 0U;
 
-    /* Write the HTTP Request Method to the canonical request. */
-    returnStatus = writeLineToCanonicalRequest( pParams->pHttpParameters->pHttpMethod,
-                                                pParams->pHttpParameters->httpMethodLen,
-                                                pCanonicalContext );
+    /* The HTTP Request Method is hashed from the application's memory. */
+    referenceLineInCanonicalRequest( pParams->pHttpParameters->pHttpMethod,
+                                     pParams->pHttpParameters->httpMethodLen,
+                                     pCanonicalContext );
 
-    if( returnStatus == SigV4Success )
+    /* Write the URI to the canonical request. */
+    if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PATH_IS_CANONICAL_FLAG ) )
     {
-        /* Write the URI to the canonical request. */
-        if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PATH_IS_CANONICAL_FLAG ) )
-        {
-            /* URI is already canonicalized, so just write it to the buffer as is. */
-            returnStatus = writeLineToCanonicalRequest( pPath,
-                                                        pathLen,
-                                                        pCanonicalContext );
-        }
-        else if( ( pParams->serviceLen == S3_SERVICE_NAME_LEN ) &&
-                 ( strncmp( pParams->pService, S3_SERVICE_NAME, S3_SERVICE_NAME_LEN ) == 0 ) )
-        {
-            /* S3 is the only service in which the URI must only be encoded once. */
-            returnStatus = generateCanonicalURI( pPath, pathLen,
-                                                 false /* Do not encode twice. */,
-                                                 pCanonicalContext );
-        }
-        else
-        {
-            returnStatus = generateCanonicalURI( pPath, pathLen,
-                                                 true /* Encode twice */,
-                                                 pCanonicalContext );
-        }
+        /* URI is already canonicalized, so it is hashed as is without being copied. */
+        referenceLineInCanonicalRequest( pPath,
+                                         pathLen,
+                                         pCanonicalContext );
+    }
+    else
+    {
+        /* S3 is the only service in which the URI must only be encoded once. */
+        returnStatus = writeCanonicalURI( pParams->pPathCache, pPath, pathLen,
+                                          !isS3Service( pParams ),
+                                          pCanonicalContext );
     }
 
     if( returnStatus == SigV4Success )
     {
         /* Write the query to the canonical request. */
         if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG ) &&
-            ( pParams->pHttpParameters->pQuery != NULL ) )
+            ( pQuery != NULL ) )
         {
-            /* HTTP query is already canonicalized, so just write it to the buffer as is. */
-            returnStatus = writeLineToCanonicalRequest( pParams->pHttpParameters->pQuery,
-                                                        pParams->pHttpParameters->queryLen,
-                                                        pCanonicalContext );
+            /* HTTP query is already canonicalized, so it is hashed as is without being copied. */
+            referenceWrappedLineInCanonicalRequest( pQuery,
+                                                    queryLen,
+                                                    pQueryWrap,
+                                                    queryWrapLen,
+                                                    pCanonicalContext );
         }
         else
         {
-            returnStatus = generateCanonicalQuery( pParams->pHttpParameters->pQuery,
-                                                   pParams->pHttpParameters->queryLen,
+            returnStatus = generateCanonicalQuery( pQuery,
+                                                   queryLen,
+                                                   pQueryWrap,
+                                                   queryWrapLen,
                                                    doubleEncodeEqualsInParmsValues,
                                                    pCanonicalContext );
         }
@@ -2789,9 +5291,12 @@ static SigV4Status_t generateCanonicalRequestUntilHeaders( const SigV4Parameters
     if( returnStatus == SigV4Success )
     {
         /* Canonicalize original HTTP headers before writing to buffer. */
-        returnStatus = generateCanonicalAndSignedHeaders( pParams->pHttpParameters->pHeaders,
-                                                          pParams->pHttpParameters->headersLen,
+        returnStatus = generateCanonicalAndSignedHeaders( pHeaders,
+                                                          headersLen,
+                                                          pHeadersWrap,
+                                                          headersWrapLen,
                                                           pParams->pHttpParameters->flags,
+                                                          pParams->pSignedHeadersCache,
                                                           pCanonicalContext,
                                                           pSignedHeaders,
                                                           pSignedHeadersLen );
@@ -2812,8 +5317,9 @@ static SigV4Status_t generateAuthorizationValuePrefix( const SigV4Parameters_t *
 {
     SigV4Status_t returnStatus = SigV4Success;
     SigV4String_t credentialScope;
-    size_t authPrefixLen = 0U;
+    size_t authPrefixLen = 0U, credentialPrefixLen = 0U;
     size_t numOfBytesWritten = 0U;
+    size_t encodedSignatureLen = 0U;
 
     assert( pParams != NULL );
     assert( pAlgorithm != NULL );
@@ -2823,14 +5329,20 @@ static SigV4Status_t generateAuthorizationValuePrefix( const SigV4Parameters_t *
     assert( pAuthBuf != NULL );
     assert( pAuthPrefixLen != NULL );
 
-    /* Since the signed headers are required to be a part of final Authorization header value,
-     * we copy the signed headers onto the auth buffer before continuing to generate the signature
-     * in order to prevent an additional copy and/or usage of extra space. */
-    size_t encodedSignatureLen = ( pParams->pCryptoInterface->hashDigestLen * 2U );
+    encodedSignatureLen = maxEncodedSignatureLength( pParams );
+
+    /* "<algorithm> Credential=" is copied as is when it was computed ahead of signing. */
+    if( pParams->pPrecomputedScope != NULL )
+    {
+        credentialPrefixLen = pParams->pPrecomputedScope->authPrefixLen;
+    }
+    else
+    {
+        credentialPrefixLen = algorithmLen + SPACE_CHAR_LEN + AUTH_CREDENTIAL_PREFIX_LEN;
+    }
 
     /* Check if the authorization buffer has enough space to hold the final SigV4 Authorization header value. */
-    authPrefixLen = algorithmLen + SPACE_CHAR_LEN +                                            \
-                    AUTH_CREDENTIAL_PREFIX_LEN + pParams->pCredentials->accessKeyIdLen +       \
+    authPrefixLen = credentialPrefixLen + pParams->pCredentials->accessKeyIdLen +              \
                     CREDENTIAL_SCOPE_SEPARATOR_LEN + sizeNeededForCredentialScope( pParams ) + \
                     AUTH_SEPARATOR_LEN + AUTH_SIGNED_HEADERS_PREFIX_LEN + signedHeadersLen +   \
                     AUTH_SEPARATOR_LEN + AUTH_SIGNATURE_PREFIX_LEN;
@@ -2844,16 +5356,26 @@ static SigV4Status_t generateAuthorizationValuePrefix( const SigV4Parameters_t *
     else
     {
         /* START:  Writing of authorization value prefix. */
-        /******************* Write <algorithm> *******************************************/
-        ( void ) memcpy( pAuthBuf, pAlgorithm, algorithmLen );
-        numOfBytesWritten += algorithmLen;
+        if( pParams->pPrecomputedScope != NULL )
+        {
+            /******************* Write "<algorithm> Credential=" *****************************/
+            numOfBytesWritten += copyString( pAuthBuf, pParams->pPrecomputedScope->pAuthPrefix, credentialPrefixLen );
+        }
+        else
+        {
+            /******************* Write <algorithm> *******************************************/
+            ( void ) memcpy( pAuthBuf, pAlgorithm, algorithmLen );
+            numOfBytesWritten += algorithmLen;
+
+            /* Add space separator. */
+            pAuthBuf[ numOfBytesWritten ] = SPACE_CHAR;
+            numOfBytesWritten += SPACE_CHAR_LEN;
 
-        /* Add space separator. */
-        pAuthBuf[ numOfBytesWritten ] = SPACE_CHAR;
-        numOfBytesWritten += SPACE_CHAR_LEN;
+            /**************** Write "Credential=" ********************************************/
+            numOfBytesWritten += copyString( &( pAuthBuf[ numOfBytesWritten ] ), AUTH_CREDENTIAL_PREFIX, AUTH_CREDENTIAL_PREFIX_LEN );
+        }
 
-        /**************** Write "Credential=<access key ID>/<credential scope>, " ****************/
-        numOfBytesWritten += copyString( &( pAuthBuf[ numOfBytesWritten ] ), AUTH_CREDENTIAL_PREFIX, AUTH_CREDENTIAL_PREFIX_LEN );
+        /**************** Write "<access key ID>/<credential scope>, " ***************************/
         ( void ) memcpy( &( pAuthBuf[ numOfBytesWritten ] ),
                          pParams->pCredentials->pAccessKeyId,
                          pParams->pCredentials->accessKeyIdLen );
@@ -2872,6 +5394,10 @@ static SigV4Status_t generateAuthorizationValuePrefix( const SigV4Parameters_t *
 
 
         /************************ Write "SignedHeaders=<signedHeaders>, " *******************************/
+
+        /* Since the signed headers are required to be a part of final Authorization header value,
+         * we copy the signed headers onto the auth buffer before continuing to generate the signature
+         * in order to prevent an additional copy and/or usage of extra space. */
         numOfBytesWritten += copyString( &( pAuthBuf[ numOfBytesWritten ] ), AUTH_SIGNED_HEADERS_PREFIX, AUTH_SIGNED_HEADERS_PREFIX_LEN );
         ( void ) memcpy( &( pAuthBuf[ numOfBytesWritten ] ), pSignedHeaders, signedHeadersLen );
         numOfBytesWritten += signedHeadersLen;
@@ -2997,57 +5523,217 @@ static SigV4Status_t generateSigningKey( const SigV4Parameters_t * pSigV4Params,
 
 /*-----------------------------------------------------------*/
 
-static SigV4Status_t writePayloadHashToCanonicalRequest( const SigV4Parameters_t * pParams,
-                                                         CanonicalContext_t * pCanonicalContext )
+static bool writeSigningKeyScopeId( const SigV4Parameters_t * pSigV4Params,
+                                    char * pScopeId,
+                                    size_t * pScopeIdLen )
 {
-    size_t encodedLen = 0U;
-    SigV4Status_t returnStatus = SigV4Success;
+    bool fits = false;
+    size_t scopeIdLen = 0U;
 
-    assert( pParams != NULL );
-    assert( pCanonicalContext != NULL );
+    assert( pSigV4Params != NULL );
+    assert( pScopeId != NULL );
+    assert( pScopeIdLen != NULL );
 
-    if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PAYLOAD_IS_HASH ) )
-    {
-        /* Copy the hashed payload data supplied by the user in the headers data list. */
-        returnStatus = copyHeaderStringToCanonicalBuffer( pCanonicalContext->pHashPayloadLoc, pCanonicalContext->hashPayloadLen, pParams->pHttpParameters->flags, '\n', pCanonicalContext );
-        /* Remove new line at the end of the payload. */
-        pCanonicalContext->uxCursorIndex--;
-    }
-    else if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_IS_PRESIGNED_URL ) )
-    {
-        /* Copy the UNSIGNED-PAYLOAD data in the headers data list. */
-        returnStatus = copyHeaderStringToCanonicalBuffer( "UNSIGNED-PAYLOAD", strlen( "UNSIGNED-PAYLOAD" ), pParams->pHttpParameters->flags, '\n', pCanonicalContext );
-        /* Remove new line at the end of the payload. */
-        pCanonicalContext->uxCursorIndex--;
-    }
-    else
+    /* The identity consists of four fields separated by three '/' characters. */
+    scopeIdLen = pSigV4Params->pCredentials->accessKeyIdLen + ISO_DATE_SCOPE_LEN +
+                 pSigV4Params->regionLen + pSigV4Params->serviceLen + 3U;
+
+    if( scopeIdLen <= SIGV4_SIGNING_KEY_CACHE_ID_LENGTH )
     {
-        encodedLen = pCanonicalContext->bufRemaining;
-        /* Calculate hash of the request payload. */
-        returnStatus = completeHashAndHexEncode( pParams->pHttpParameters->pPayload,
-                                                 pParams->pHttpParameters->payloadLen,
-                                                 ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ),
-                                                 &encodedLen,
-                                                 pParams->pCryptoInterface );
-        pCanonicalContext->uxCursorIndex += encodedLen;
-        pCanonicalContext->bufRemaining -= encodedLen;
+        fits = true;
+        scopeIdLen = 0U;
+
+        ( void ) memcpy( pScopeId, pSigV4Params->pCredentials->pAccessKeyId, pSigV4Params->pCredentials->accessKeyIdLen );
+        scopeIdLen += pSigV4Params->pCredentials->accessKeyIdLen;
+        pScopeId[ scopeIdLen ] = '/';
+        scopeIdLen++;
+
+        ( void ) memcpy( &pScopeId[ scopeIdLen ], pSigV4Params->pDateIso8601, ISO_DATE_SCOPE_LEN );
+        scopeIdLen += ISO_DATE_SCOPE_LEN;
+        pScopeId[ scopeIdLen ] = '/';
+        scopeIdLen++;
+
+        ( void ) memcpy( &pScopeId[ scopeIdLen ], pSigV4Params->pRegion, pSigV4Params->regionLen );
+        scopeIdLen += pSigV4Params->regionLen;
+        pScopeId[ scopeIdLen ] = '/';
+        scopeIdLen++;
+
+        ( void ) memcpy( &pScopeId[ scopeIdLen ], pSigV4Params->pService, pSigV4Params->serviceLen );
+        scopeIdLen += pSigV4Params->serviceLen;
+
+        *pScopeIdLen = scopeIdLen;
     }
 
-    return returnStatus;
+    return fits;
 }
 
 /*-----------------------------------------------------------*/
 
-SigV4Status_t SigV4_AwsIotDateToIso8601( const char * pDate,
-                                         size_t dateLen,
-                                         char * pDateISO8601,
-                                         size_t dateISO8601Len )
+static SigV4Status_t retrieveSigningKey( const SigV4Parameters_t * pSigV4Params,
+                                         HmacContext_t * pHmacContext,
+                                         SigV4String_t * pSigningKey,
+                                         size_t * pBytesRemaining )
 {
-    SigV4Status_t returnStatus = SigV4InvalidParameter;
-    SigV4DateTime_t date = { 0 };
-    char * pWriteLoc = pDateISO8601;
-    const char * pFormatStr = NULL;
-    size_t formatLen = 0U;
+    SigV4Status_t returnStatus = SigV4Success;
+    SigV4SigningKeyCache_t * pCache = NULL;
+    char pScopeId[ SIGV4_SIGNING_KEY_CACHE_ID_LENGTH ];
+    uint8_t pSecretDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+    size_t scopeIdLen = 0U;
+    size_t digestLen = 0U;
+    bool cacheable = false;
+
+    assert( pSigV4Params != NULL );
+    assert( pSigningKey != NULL );
+    assert( pBytesRemaining != NULL );
+
+    pCache = pSigV4Params->pSigningKeyCache;
+    digestLen = pSigV4Params->pCryptoInterface->hashDigestLen;
+
+    if( pCache != NULL )
+    {
+        cacheable = writeSigningKeyScopeId( pSigV4Params, pScopeId, &scopeIdLen );
+    }
+
+    /* The secret access key may be rotated under the same access key ID, so
+     * the cached key is also bound to a digest of the secret. */
+    if( cacheable &&
+        ( completeHash( ( const uint8_t * ) pSigV4Params->pCredentials->pSecretAccessKey,
+                        pSigV4Params->pCredentials->secretAccessKeyLen,
+                        NULL,
+                        0U,
+                        pSecretDigest,
+                        sizeof( pSecretDigest ),
+                        pSigV4Params->pCryptoInterface ) != 0 ) )
+    {
+        LogError( ( "Failed to hash the secret access key for the signing key cache." ) );
+        returnStatus = SigV4HashError;
+    }
+    else if( cacheable &&
+             ( pCache->signingKeyLen == digestLen ) &&
+             ( pCache->scopeIdLen == scopeIdLen ) &&
+             ( memcmp( pCache->pScopeId, pScopeId, scopeIdLen ) == 0 ) &&
+             ( pCache->secretAccessKeyLen == pSigV4Params->pCredentials->secretAccessKeyLen ) &&
+             ( memcmp( pCache->pSecretDigest, pSecretDigest, digestLen ) == 0 ) )
+    {
+        /* The signature is still computed in the canonical buffer, so it must
+         * be able to hold one digest. */
+        if( *pBytesRemaining < digestLen )
+        {
+            returnStatus = SigV4InsufficientMemory;
+            LOG_INSUFFICIENT_MEMORY_ERROR( "compute signature", digestLen - *pBytesRemaining );
+        }
+        else
+        {
+            pSigningKey->pData = ( char * ) pCache->pSigningKey;
+            pSigningKey->dataLen = digestLen;
+        }
+    }
+    else
+    {
+        returnStatus = generateSigningKey( pSigV4Params,
+                                           pHmacContext,
+                                           pSigningKey,
+                                           pBytesRemaining );
+
+        if( cacheable && ( returnStatus == SigV4Success ) )
+        {
+            ( void ) memcpy( pCache->pScopeId, pScopeId, scopeIdLen );
+            pCache->scopeIdLen = scopeIdLen;
+            ( void ) memcpy( pCache->pSecretDigest, pSecretDigest, digestLen );
+            pCache->secretAccessKeyLen = pSigV4Params->pCredentials->secretAccessKeyLen;
+            ( void ) memcpy( pCache->pSigningKey, pSigningKey->pData, digestLen );
+            pCache->signingKeyLen = digestLen;
+        }
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t writePayloadHashToCanonicalRequest( const SigV4Parameters_t * pParams,
+                                                         CanonicalContext_t * pCanonicalContext )
+{
+    size_t encodedLen = 0U, wrapLen = 0U;
+    SigV4Status_t returnStatus = SigV4Success;
+
+    assert( pParams != NULL );
+    assert( pCanonicalContext != NULL );
+
+    if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PAYLOAD_IS_DIGEST ) )
+    {
+        /* The application hashed the payload ahead of signing, so its digest
+         * is copied as-is. */
+        wrapLen = wrappedLength( pParams->pHttpParameters->pPayloadWrap, pParams->pHttpParameters->payloadWrapLen );
+        encodedLen = pParams->pHttpParameters->payloadLen + wrapLen;
+
+        if( pCanonicalContext->bufRemaining < encodedLen )
+        {
+            returnStatus = SigV4InsufficientMemory;
+            LOG_INSUFFICIENT_MEMORY_ERROR( "write the payload digest",
+                                           encodedLen - pCanonicalContext->bufRemaining );
+        }
+        else
+        {
+            ( void ) memcpy( &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ),
+                             pParams->pHttpParameters->pPayload,
+                             pParams->pHttpParameters->payloadLen );
+
+            if( wrapLen > 0U )
+            {
+                ( void ) memcpy( &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex + pParams->pHttpParameters->payloadLen ] ),
+                                 pParams->pHttpParameters->pPayloadWrap,
+                                 wrapLen );
+            }
+
+            pCanonicalContext->uxCursorIndex += encodedLen;
+            pCanonicalContext->bufRemaining -= encodedLen;
+        }
+    }
+    else if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_PAYLOAD_IS_HASH ) )
+    {
+        /* Copy the hashed payload data supplied by the user in the headers data list. */
+        returnStatus = copyHeaderStringToCanonicalBuffer( pCanonicalContext->pHashPayloadLoc, pCanonicalContext->hashPayloadLen, pParams->pHttpParameters->flags, '\n', pCanonicalContext );
+        /* Remove new line at the end of the payload. */
+        pCanonicalContext->uxCursorIndex--;
+    }
+    else if( FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_IS_PRESIGNED_URL ) )
+    {
+        /* Copy the UNSIGNED-PAYLOAD data in the headers data list. */
+        returnStatus = copyHeaderStringToCanonicalBuffer( "UNSIGNED-PAYLOAD", strlen( "UNSIGNED-PAYLOAD" ), pParams->pHttpParameters->flags, '\n', pCanonicalContext );
+        /* Remove new line at the end of the payload. */
+        pCanonicalContext->uxCursorIndex--;
+    }
+    else
+    {
+        encodedLen = pCanonicalContext->bufRemaining;
+        /* Calculate hash of the request payload. */
+        returnStatus = completeHashAndHexEncode( pParams->pHttpParameters->pPayload,
+                                                 pParams->pHttpParameters->payloadLen,
+                                                 pParams->pHttpParameters->pPayloadWrap,
+                                                 pParams->pHttpParameters->payloadWrapLen,
+                                                 ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ),
+                                                 &encodedLen,
+                                                 pParams->pCryptoInterface );
+        pCanonicalContext->uxCursorIndex += encodedLen;
+        pCanonicalContext->bufRemaining -= encodedLen;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_AwsIotDateToIso8601( const char * pDate,
+                                         size_t dateLen,
+                                         char * pDateISO8601,
+                                         size_t dateISO8601Len )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+    SigV4DateTime_t date = { 0 };
+    char * pWriteLoc = pDateISO8601;
+    const char * pFormatStr = NULL;
+    size_t formatLen = 0U;
 
     /* Check for NULL parameters. */
     if( pDate == NULL )
@@ -3116,110 +5802,183 @@ SigV4Status_t SigV4_AwsIotDateToIso8601( const char * pDate,
 
 /*-----------------------------------------------------------*/
 
-SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams,
-                                               char * pAuthBuf,
-                                               size_t * authBufLen,
-                                               char ** pSignature,
-                                               size_t * signatureLen )
+static SigV4Status_t generateCanonicalRequest( const SigV4Parameters_t * pParams,
+                                               CanonicalContext_t * pCanonicalContext,
+                                               char ** pSignedHeaders,
+                                               size_t * pSignedHeadersLen )
 {
     SigV4Status_t returnStatus = SigV4Success;
-    CanonicalContext_t canonicalContext;
-    const char * pAlgorithm = NULL;
-    char * pSignedHeaders = NULL;
-    size_t algorithmLen = 0U, signedHeadersLen = 0U, authPrefixLen = 0U;
-    HmacContext_t hmacContext = { 0 };
-
-    SigV4String_t signingKey;
-    size_t uxBufferLen;
 
-    returnStatus = verifyParamsToGenerateAuthHeaderApi( pParams,
-                                                        pAuthBuf, authBufLen,
-                                                        pSignature, signatureLen );
+    returnStatus = generateCanonicalRequestUntilHeaders( pParams, pCanonicalContext,
+                                                         pSignedHeaders,
+                                                         pSignedHeadersLen );
 
     if( returnStatus == SigV4Success )
     {
-        assignDefaultArguments( pParams, &pAlgorithm, &algorithmLen );
+        /* Write HTTP request payload hash to the canonical request. */
+        returnStatus = writePayloadHashToCanonicalRequest( pParams, pCanonicalContext );
     }
 
     if( returnStatus == SigV4Success )
     {
-        returnStatus = generateCanonicalRequestUntilHeaders( pParams, &canonicalContext,
-                                                             &pSignedHeaders,
-                                                             &signedHeadersLen );
+        LogDebug( ( "Generated Canonical Request, without the lines hashed in place: %.*s",
+                    ( unsigned int ) ( pCanonicalContext->uxCursorIndex ),
+                    pCanonicalContext->pBufProcessing ) );
     }
 
-    /* Hash and hex-encode the canonical request to the buffer. */
-    if( returnStatus == SigV4Success )
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isSigV4A( const SigV4Parameters_t * pParams )
+{
+    assert( pParams != NULL );
+
+    return ( pParams->pAlgorithm != NULL ) &&
+           ( pParams->algorithmLen == SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH ) &&
+           ( strncmp( pParams->pAlgorithm, SIGV4_AWS4_ECDSA_P256_SHA256, SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH ) == 0 );
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t maxEncodedSignatureLength( const SigV4Parameters_t * pParams )
+{
+    size_t signatureLen = pParams->pCryptoInterface->hashDigestLen;
+
+    if( isSigV4A( pParams ) )
     {
-        /* Write HTTP request payload hash to the canonical request. */
-        returnStatus = writePayloadHashToCanonicalRequest( pParams, &canonicalContext );
+        signatureLen = SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH;
     }
 
-    /* Write the prefix of the Authorization header value. */
-    if( returnStatus == SigV4Success )
+    return signatureLen * 2U;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isEcdsaKeyCandidateInRange( const uint8_t * pKey )
+{
+    /* n - 2, where n is the order of the P-256 curve. */
+    static const uint8_t orderMinusTwo[ SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ] =
     {
-        LogDebug( ( "Generated Canonical Request: %.*s",
-                    ( unsigned int ) ( canonicalContext.uxCursorIndex ),
-                    canonicalContext.pBufProcessing ) );
+        0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x00U, 0x00U, 0x00U, 0x00U,
+        0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+        0xBCU, 0xE6U, 0xFAU, 0xADU, 0xA7U, 0x17U, 0x9EU, 0x84U,
+        0xF3U, 0xB9U, 0xCAU, 0xC2U, 0xFCU, 0x63U, 0x25U, 0x4FU
+    };
 
-        authPrefixLen = *authBufLen;
-        returnStatus = generateAuthorizationValuePrefix( pParams,
-                                                         pAlgorithm, algorithmLen,
-                                                         pSignedHeaders, signedHeadersLen,
-                                                         pAuthBuf, &authPrefixLen );
+    assert( pKey != NULL );
+
+    /* Both numbers are big-endian and of the same length. */
+    return memcmp( pKey, orderMinusTwo, SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ) <= 0;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t deriveEcdsaKey( const SigV4Parameters_t * pParams,
+                                     HmacContext_t * pHmacContext,
+                                     uint8_t * pBuffer,
+                                     size_t bufferLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    int32_t hmacStatus = 0;
+    size_t inputLen = 0U, counterIndex = 0U, i = 0U;
+    uint8_t * pKey = NULL;
+    uint32_t counter = 1U;
+    bool derived = false;
+
+    assert( pParams != NULL );
+    assert( pHmacContext != NULL );
+    assert( pBuffer != NULL );
+
+    inputLen = SIGV4A_KDF_FIXED_INPUT_LEN + pParams->pCredentials->accessKeyIdLen;
+
+    if( bufferLen < ( inputLen + SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ) )
+    {
+        returnStatus = SigV4InsufficientMemory;
+        LOG_INSUFFICIENT_MEMORY_ERROR( "derive SigV4A key",
+                                       inputLen + SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH - bufferLen );
+    }
+    else
+    {
+        /* The fixed input is, with + meaning concatenation:
+         * 0x00000001 + "AWS4-ECDSA-P256-SHA256" + 0x00 + AccessKeyId +
+         * Counter + 0x00000100 (the length of the key in bits). */
+        ( void ) memset( pBuffer, 0, inputLen );
+        pBuffer[ 3 ] = 1U;
+        i = 4U;
+        ( void ) memcpy( &pBuffer[ i ], SIGV4_AWS4_ECDSA_P256_SHA256, SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH );
+        i += SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH + 1U;
+        ( void ) memcpy( &pBuffer[ i ], pParams->pCredentials->pAccessKeyId, pParams->pCredentials->accessKeyIdLen );
+        counterIndex = i + pParams->pCredentials->accessKeyIdLen;
+        pBuffer[ counterIndex + 3U ] = 1U;
+        pKey = &pBuffer[ inputLen ];
     }
 
-    /* Write string to sign. */
-    if( returnStatus == SigV4Success )
+    while( ( returnStatus == SigV4Success ) && !derived && ( counter <= SIGV4A_KDF_MAX_COUNTER ) )
     {
-        returnStatus = writeStringToSign( pParams, pAlgorithm, algorithmLen, &canonicalContext );
+        pBuffer[ counterIndex ] = ( uint8_t ) counter;
+
+        /* The "AWS4A" prefix is part of the key:
+         * HMAC("AWS4A" + SecretKey, FixedInput) */
+        hmacStatus = hmacAddKey( pHmacContext,
+                                 SIGV4A_HMAC_KEY_PREFIX,
+                                 SIGV4A_HMAC_KEY_PREFIX_LEN,
+                                 true /* Is key prefix. */ );
+
+        /* The above call should always succeed as it only populates the HMAC key cache. */
+        assert( hmacStatus == 0 );
+
+        hmacStatus = completeHmac( pHmacContext,
+                                   pParams->pCredentials->pSecretAccessKey,
+                                   pParams->pCredentials->secretAccessKeyLen,
+                                   ( const char * ) pBuffer,
+                                   inputLen,
+                                   ( char * ) pKey,
+                                   SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH );
+
+        if( hmacStatus != 0 )
+        {
+            returnStatus = SigV4HashError;
+        }
+        else
+        {
+            derived = isEcdsaKeyCandidateInRange( pKey );
+            counter++;
+        }
     }
 
-    /* Write the signing key. The is done by computing the following function
-     * where the + operator means concatenation:
-     * HMAC(HMAC(HMAC(HMAC("AWS4" + kSecret,pDate),pRegion),pService),"aws4_request") */
-    if( returnStatus == SigV4Success )
+    if( ( returnStatus == SigV4Success ) && !derived )
     {
-        hmacContext.pCryptoInterface = pParams->pCryptoInterface;
-        signingKey.pData = ( char * ) &( canonicalContext.pBufProcessing[ canonicalContext.uxCursorIndex ] );
-        signingKey.dataLen = canonicalContext.bufRemaining;
-        returnStatus = generateSigningKey( pParams,
-                                           &hmacContext,
-                                           &signingKey,
-                                           &canonicalContext.bufRemaining );
+        LogError( ( "Failed to derive the SigV4A key: No candidate is in range." ) );
+        returnStatus = SigV4HashError;
     }
 
-    /* Use the SigningKey and StringToSign to produce the final signature.
-     * Note that the StringToSign starts from the beginning of the processing buffer. */
     if( returnStatus == SigV4Success )
     {
-        uxBufferLen = canonicalContext.uxCursorIndex;
-        returnStatus = ( completeHmac( &hmacContext,
-                                       signingKey.pData,
-                                       signingKey.dataLen,
-                                       ( char * ) canonicalContext.pBufProcessing,
-                                       uxBufferLen,
-                                       ( char * ) &( canonicalContext.pBufProcessing[ canonicalContext.uxCursorIndex ] ),
-                                       pParams->pCryptoInterface->hashDigestLen ) != 0 )
-                       ? SigV4HashError : SigV4Success;
+        /* Add one to the big-endian candidate, which is at most n - 2, so the
+         * key is in [1, n - 1]. As the candidate is not all 0xFF bytes, the
+         * carry stops at its first byte at the latest. */
+        i = SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH;
+
+        do
+        {
+            i--;
+            pKey[ i ]++;
+        } while( pKey[ i ] == 0U );
+
+        if( pParams->pEcdsaInterface->loadKey( pParams->pEcdsaInterface->pEcdsaContext,
+                                               pKey,
+                                               SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ) != 0 )
+        {
+            returnStatus = SigV4HashError;
+        }
     }
 
-    /* Hex-encode the final signature beforehand to its precalculated
-     * location in the buffer provided for the Authorization header value. */
-    if( returnStatus == SigV4Success )
+    /* Do not leave the key in the processing buffer. */
+    if( pKey != NULL )
     {
-        SigV4String_t originalHmac;
-        SigV4String_t hexEncodedHmac;
-        originalHmac.pData = ( char * ) &( canonicalContext.pBufProcessing[ canonicalContext.uxCursorIndex ] );
-        originalHmac.dataLen = pParams->pCryptoInterface->hashDigestLen;
-        hexEncodedHmac.pData = &( pAuthBuf[ authPrefixLen ] );
-        /* #authBufLen is an overestimate but the validation was already done earlier. */
-        hexEncodedHmac.dataLen = *authBufLen;
-        returnStatus = lowercaseHexEncode( &originalHmac,
-                                           &hexEncodedHmac );
-        *pSignature = hexEncodedHmac.pData;
-        *signatureLen = hexEncodedHmac.dataLen;
-        *authBufLen = authPrefixLen + ( pParams->pCryptoInterface->hashDigestLen << 1U );
+        ( void ) memset( pKey, 0, SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH );
     }
 
     return returnStatus;
@@ -3227,42 +5986,1318 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
 
 /*-----------------------------------------------------------*/
 
-#if ( SIGV4_USE_CANONICAL_SUPPORT == 1 )
+static SigV4Status_t retrieveEcdsaKey( const SigV4Parameters_t * pParams,
+                                       HmacContext_t * pHmacContext,
+                                       uint8_t * pBuffer,
+                                       size_t bufferLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    SigV4EcdsaKeyCache_t * pCache = NULL;
+    const SigV4Credentials_t * pCredentials = NULL;
+    uint8_t pSecretDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+    size_t digestLen = 0U;
 
-    SigV4Status_t SigV4_EncodeURI( const char * pUri,
-                                   size_t uriLen,
-                                   char * pCanonicalURI,
-                                   size_t * canonicalURILen,
-                                   bool encodeSlash,
-                                   bool doubleEncodeEquals )
+    assert( pParams != NULL );
+
+    pCache = pParams->pEcdsaKeyCache;
+    pCredentials = pParams->pCredentials;
+    digestLen = pParams->pCryptoInterface->hashDigestLen;
+
+    /* The imported key is bound to the ECDSA context it was imported into and
+     * to a digest of the secret, which may be rotated under the same access
+     * key ID. */
+    if( ( pCache != NULL ) &&
+        ( completeHash( ( const uint8_t * ) pCredentials->pSecretAccessKey,
+                        pCredentials->secretAccessKeyLen,
+                        NULL,
+                        0U,
+                        pSecretDigest,
+                        sizeof( pSecretDigest ),
+                        pParams->pCryptoInterface ) != 0 ) )
     {
-        size_t uriIndex = 0U, bytesConsumed = 0U;
-        size_t bufferLen = 0U;
-        SigV4Status_t returnStatus = SigV4Success;
+        LogError( ( "Failed to hash the secret access key for the SigV4A key cache." ) );
+        returnStatus = SigV4HashError;
+    }
+    else if( ( pCache != NULL ) &&
+             ( pCache->pEcdsaContext == pParams->pEcdsaInterface->pEcdsaContext ) &&
+             ( pCache->accessKeyIdLen == pCredentials->accessKeyIdLen ) &&
+             ( memcmp( pCache->pAccessKeyId, pCredentials->pAccessKeyId, pCredentials->accessKeyIdLen ) == 0 ) &&
+             ( pCache->secretAccessKeyLen == pCredentials->secretAccessKeyLen ) &&
+             ( memcmp( pCache->pSecretDigest, pSecretDigest, digestLen ) == 0 ) )
+    {
+        LogDebug( ( "The SigV4A key of the access key ID is already imported." ) );
+    }
+    else
+    {
+        /* The imported key changes even if the derivation fails, so the cache
+         * is emptied first. */
+        if( pCache != NULL )
+        {
+            pCache->accessKeyIdLen = 0U;
+        }
 
-        assert( pUri != NULL );
-        assert( pCanonicalURI != NULL );
-        assert( canonicalURILen != NULL );
+        returnStatus = deriveEcdsaKey( pParams, pHmacContext, pBuffer, bufferLen );
 
-        bufferLen = *canonicalURILen;
+        if( ( pCache != NULL ) && ( returnStatus == SigV4Success ) &&
+            ( pCredentials->accessKeyIdLen <= SIGV4_SIGNING_KEY_CACHE_ID_LENGTH ) )
+        {
+            ( void ) memcpy( pCache->pAccessKeyId, pCredentials->pAccessKeyId, pCredentials->accessKeyIdLen );
+            pCache->accessKeyIdLen = pCredentials->accessKeyIdLen;
+            ( void ) memcpy( pCache->pSecretDigest, pSecretDigest, digestLen );
+            pCache->secretAccessKeyLen = pCredentials->secretAccessKeyLen;
+            pCache->pEcdsaContext = pParams->pEcdsaInterface->pEcdsaContext;
+        }
+    }
 
-        while( ( uriIndex < uriLen ) && ( returnStatus == SigV4Success ) )
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t generateEcdsaSignature( const SigV4Parameters_t * pParams,
+                                             const char * pAlgorithm,
+                                             size_t algorithmLen,
+                                             CanonicalContext_t * pCanonicalContext,
+                                             char * pSignature,
+                                             size_t * pSignatureLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    HmacContext_t hmacContext = { 0 };
+    uint8_t * pDigest = NULL;
+    uint8_t * pScratch = NULL;
+    size_t scratchLen = 0U;
+    size_t derSignatureLen = SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH;
+    SigV4String_t derSignature;
+    SigV4String_t hexEncodedSignature;
+
+    /* Write string to sign. */
+    returnStatus = writeStringToSign( pParams, pAlgorithm, algorithmLen, pCanonicalContext );
+
+    /* The digest of the string to sign is written after it, followed by the
+     * scratch space of the key derivation, which then holds the signature. */
+    if( returnStatus == SigV4Success )
+    {
+        if( pCanonicalContext->bufRemaining < ( SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH + SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH ) )
         {
-            if( doubleEncodeEquals && ( pUri[ uriIndex ] == '=' ) )
-            {
-                if( ( bufferLen - bytesConsumed ) < URI_DOUBLE_ENCODED_EQUALS_CHAR_SIZE )
-                {
-                    returnStatus = SigV4InsufficientMemory;
-                    LOG_INSUFFICIENT_MEMORY_ERROR( "double encode '=' character in canonical query",
-                                                   ( bytesConsumed + URI_DOUBLE_ENCODED_EQUALS_CHAR_SIZE - bufferLen ) );
-                }
-                else
-                {
-                    bytesConsumed += writeDoubleEncodedEquals( &( pCanonicalURI[ bytesConsumed ] ), bufferLen - bytesConsumed );
-                }
-            }
-            else if( isAllowedChar( pUri[ uriIndex ], encodeSlash ) )
-            {
+            returnStatus = SigV4InsufficientMemory;
+            LOG_INSUFFICIENT_MEMORY_ERROR( "compute SigV4A signature",
+                                           SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH + SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH -
+                                           pCanonicalContext->bufRemaining );
+        }
+        else
+        {
+            pDigest = &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] );
+            pScratch = &( pDigest[ SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ] );
+            scratchLen = pCanonicalContext->bufRemaining - SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH;
+        }
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = ( completeHash( pCanonicalContext->pBufProcessing,
+                                       pCanonicalContext->uxCursorIndex,
+                                       NULL,
+                                       0U,
+                                       pDigest,
+                                       SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH,
+                                       pParams->pCryptoInterface ) != 0 )
+                       ? SigV4HashError : SigV4Success;
+    }
+
+    /* The key derivation is skipped if the application cache records that the
+     * key of the access key ID is already imported. */
+    if( returnStatus == SigV4Success )
+    {
+        hmacContext.pCryptoInterface = pParams->pCryptoInterface;
+        returnStatus = retrieveEcdsaKey( pParams, &hmacContext, pScratch, scratchLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        if( ( pParams->pEcdsaInterface->sign( pParams->pEcdsaInterface->pEcdsaContext,
+                                              pDigest,
+                                              SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH,
+                                              pScratch,
+                                              &derSignatureLen ) != 0 ) ||
+            ( derSignatureLen == 0U ) ||
+            ( derSignatureLen > SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH ) )
+        {
+            LogError( ( "Failed to sign the string to sign with the ECDSA interface." ) );
+            returnStatus = SigV4HashError;
+        }
+    }
+
+    /* Hex-encode the DER signature to its precalculated location. */
+    if( returnStatus == SigV4Success )
+    {
+        derSignature.pData = ( char * ) pScratch;
+        derSignature.dataLen = derSignatureLen;
+        hexEncodedSignature.pData = pSignature;
+        /* The space for the signature was validated by the caller. */
+        hexEncodedSignature.dataLen = SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH * 2U;
+        returnStatus = lowercaseHexEncode( &derSignature, &hexEncodedSignature );
+        *pSignatureLen = hexEncodedSignature.dataLen;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t signStringToSign( const SigV4Parameters_t * pParams,
+                                       CanonicalContext_t * pCanonicalContext,
+                                       char * pSignature )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    HmacContext_t hmacContext = { 0 };
+    SigV4String_t signingKey;
+    SigV4String_t originalHmac;
+    SigV4String_t hexEncodedHmac;
+    size_t bytesRemaining = pCanonicalContext->bufRemaining;
+
+    /* Write the signing key. The is done by computing the following function
+     * where the + operator means concatenation:
+     * HMAC(HMAC(HMAC(HMAC("AWS4" + kSecret,pDate),pRegion),pService),"aws4_request")
+     * The computation is skipped if the application cache holds the key for
+     * the same credential scope. */
+    hmacContext.pCryptoInterface = pParams->pCryptoInterface;
+    signingKey.pData = ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] );
+    signingKey.dataLen = bytesRemaining;
+    returnStatus = retrieveSigningKey( pParams,
+                                       &hmacContext,
+                                       &signingKey,
+                                       &bytesRemaining );
+
+    /* Use the SigningKey and StringToSign to produce the final signature.
+     * Note that the StringToSign starts from the beginning of the processing buffer. */
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = ( completeHmac( &hmacContext,
+                                       signingKey.pData,
+                                       signingKey.dataLen,
+                                       ( char * ) pCanonicalContext->pBufProcessing,
+                                       pCanonicalContext->uxCursorIndex,
+                                       ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ),
+                                       pParams->pCryptoInterface->hashDigestLen ) != 0 )
+                       ? SigV4HashError : SigV4Success;
+    }
+
+    /* Hex-encode the final signature to its precalculated location. */
+    if( returnStatus == SigV4Success )
+    {
+        originalHmac.pData = ( char * ) &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] );
+        originalHmac.dataLen = pParams->pCryptoInterface->hashDigestLen;
+        hexEncodedHmac.pData = pSignature;
+        /* The space for the signature was validated by the caller. */
+        hexEncodedHmac.dataLen = pParams->pCryptoInterface->hashDigestLen * 2U;
+        returnStatus = lowercaseHexEncode( &originalHmac,
+                                           &hexEncodedHmac );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t generateHmacSignature( const SigV4Parameters_t * pParams,
+                                            const char * pAlgorithm,
+                                            size_t algorithmLen,
+                                            CanonicalContext_t * pCanonicalContext,
+                                            char * pSignature )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+
+    /* Write string to sign. */
+    returnStatus = writeStringToSign( pParams, pAlgorithm, algorithmLen, pCanonicalContext );
+
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = signStringToSign( pParams, pCanonicalContext, pSignature );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t generateSignature( const SigV4Parameters_t * pParams,
+                                        const char * pAlgorithm,
+                                        size_t algorithmLen,
+                                        CanonicalContext_t * pCanonicalContext,
+                                        char * pSignature,
+                                        size_t * pSignatureLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+
+    if( isSigV4A( pParams ) )
+    {
+        returnStatus = generateEcdsaSignature( pParams, pAlgorithm, algorithmLen,
+                                               pCanonicalContext, pSignature, pSignatureLen );
+    }
+    else
+    {
+        returnStatus = generateHmacSignature( pParams, pAlgorithm, algorithmLen,
+                                              pCanonicalContext, pSignature );
+        *pSignatureLen = pParams->pCryptoInterface->hashDigestLen * 2U;
+    }
+
+    return returnStatus;
+}
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams,
+                                               char * pAuthBuf,
+                                               size_t * authBufLen,
+                                               char ** pSignature,
+                                               size_t * signatureLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    CanonicalContext_t canonicalContext;
+    const char * pAlgorithm = NULL;
+    char * pSignedHeaders = NULL;
+    size_t algorithmLen = 0U, signedHeadersLen = 0U, authPrefixLen = 0U;
+
+    returnStatus = verifyParamsToGenerateAuthHeaderApi( pParams,
+                                                        pAuthBuf, authBufLen,
+                                                        pSignature, signatureLen );
+
+    if( returnStatus == SigV4Success )
+    {
+        assignDefaultArguments( pParams, &pAlgorithm, &algorithmLen );
+        returnStatus = generateCanonicalRequest( pParams, &canonicalContext,
+                                                 &pSignedHeaders,
+                                                 &signedHeadersLen );
+    }
+
+    /* Write the prefix of the Authorization header value. */
+    if( returnStatus == SigV4Success )
+    {
+        authPrefixLen = *authBufLen;
+        returnStatus = generateAuthorizationValuePrefix( pParams,
+                                                         pAlgorithm, algorithmLen,
+                                                         pSignedHeaders, signedHeadersLen,
+                                                         pAuthBuf, &authPrefixLen );
+    }
+
+    /* Write the signature to its precalculated location in the buffer
+     * provided for the Authorization header value. */
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = generateSignature( pParams, pAlgorithm, algorithmLen,
+                                          &canonicalContext, &( pAuthBuf[ authPrefixLen ] ),
+                                          signatureLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        *pSignature = &( pAuthBuf[ authPrefixLen ] );
+        *authBufLen = authPrefixLen + *signatureLen;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_GenerateHTTPAuthorizations( const SigV4Parameters_t * pParams,
+                                                SigV4Authorization_t * pAuthorizations,
+                                                size_t authorizationCount )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    SigV4Parameters_t params;
+    CanonicalContext_t canonicalContext;
+    const char * pAlgorithm = NULL;
+    char * pSignedHeaders = NULL;
+    size_t algorithmLen = 0U, signedHeadersLen = 0U, i;
+
+    if( ( pParams == NULL ) || ( pAuthorizations == NULL ) || ( authorizationCount == 0U ) )
+    {
+        LogError( ( "Parameter check failed: pParams and pAuthorizations cannot be NULL, "
+                    "and authorizationCount cannot be zero." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else
+    {
+        params = *pParams;
+
+        /* Every set of credentials is checked before any work is done. */
+        for( i = 0U; ( returnStatus == SigV4Success ) && ( i < authorizationCount ); i++ )
+        {
+            if( pAuthorizations[ i ].pAuthBuf == NULL )
+            {
+                LogError( ( "Parameter check failed: pAuthorizations[ %lu ].pAuthBuf is NULL.", ( unsigned long ) i ) );
+                returnStatus = SigV4InvalidParameter;
+            }
+            else
+            {
+                params.pCredentials = pAuthorizations[ i ].pCredentials;
+                returnStatus = verifySigV4Parameters( &params );
+            }
+        }
+    }
+
+    if( ( returnStatus == SigV4Success ) && isSigV4A( &params ) )
+    {
+        LogError( ( "Parameter check failed: SigV4A requests cannot be signed for several credentials at once." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( ( returnStatus == SigV4Success ) && FLAG_IS_SET( params.pHttpParameters->flags, SIGV4_HTTP_IS_PRESIGNED_URL ) )
+    {
+        /* The X-Amz-Credential query parameter of a presigned URL names a
+         * single access key ID, so its canonical request cannot be shared. */
+        LogError( ( "Parameter check failed: Presigned URLs cannot be signed for several credentials at once." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else
+    {
+        /* Empty else block for MISRA C:2012 compliance. */
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        assignDefaultArguments( &params, &pAlgorithm, &algorithmLen );
+        returnStatus = generateCanonicalRequest( &params, &canonicalContext,
+                                                 &pSignedHeaders,
+                                                 &signedHeadersLen );
+    }
+
+    /* The signed headers list is in the processing buffer, which the string to
+     * sign overwrites, so every prefix is written first. */
+    for( i = 0U; ( returnStatus == SigV4Success ) && ( i < authorizationCount ); i++ )
+    {
+        params.pCredentials = pAuthorizations[ i ].pCredentials;
+        returnStatus = generateAuthorizationValuePrefix( &params,
+                                                         pAlgorithm, algorithmLen,
+                                                         pSignedHeaders, signedHeadersLen,
+                                                         pAuthorizations[ i ].pAuthBuf,
+                                                         &( pAuthorizations[ i ].authBufLen ) );
+    }
+
+    /* The credential scope does not name the access key ID, so the string to
+     * sign is shared by all credentials. */
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = writeStringToSign( &params, pAlgorithm, algorithmLen, &canonicalContext );
+    }
+
+    for( i = 0U; ( returnStatus == SigV4Success ) && ( i < authorizationCount ); i++ )
+    {
+        params.pCredentials = pAuthorizations[ i ].pCredentials;
+        params.pSigningKeyCache = pAuthorizations[ i ].pSigningKeyCache;
+        pAuthorizations[ i ].pSignature = &( pAuthorizations[ i ].pAuthBuf[ pAuthorizations[ i ].authBufLen ] );
+        returnStatus = signStringToSign( &params, &canonicalContext, pAuthorizations[ i ].pSignature );
+
+        if( returnStatus == SigV4Success )
+        {
+            pAuthorizations[ i ].signatureLen = params.pCryptoInterface->hashDigestLen * 2U;
+            pAuthorizations[ i ].authBufLen += pAuthorizations[ i ].signatureLen;
+        }
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void fillAuthorizationIov( const SigV4Parameters_t * pParams,
+                                  const char * pAlgorithm,
+                                  size_t algorithmLen,
+                                  const char * pBuf,
+                                  size_t signedHeadersLen,
+                                  size_t signatureLen,
+                                  SigV4IoVec_t * pIov )
+{
+    const SigV4PrecomputedScope_t * pScope = pParams->pPrecomputedScope;
+
+    /* "<algorithm> Credential=<access key ID>/" */
+    pIov[ 0 ].pData = pAlgorithm;
+    pIov[ 0 ].dataLen = algorithmLen;
+    pIov[ 1 ].pData = AUTH_CREDENTIAL_SEGMENT;
+    pIov[ 1 ].dataLen = AUTH_CREDENTIAL_SEGMENT_LEN;
+    pIov[ 2 ].pData = pParams->pCredentials->pAccessKeyId;
+    pIov[ 2 ].dataLen = pParams->pCredentials->accessKeyIdLen;
+    pIov[ 3 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+    pIov[ 3 ].dataLen = AUTH_SCOPE_SEPARATOR_SEGMENT_LEN;
+
+    /* "<YYYYMMDD>/<region>/<service>", where SigV4A leaves out "<region>/". */
+    pIov[ 4 ].pData = pParams->pDateIso8601;
+    pIov[ 4 ].dataLen = ISO_DATE_SCOPE_LEN;
+    pIov[ 5 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+    pIov[ 5 ].dataLen = AUTH_SCOPE_SEPARATOR_SEGMENT_LEN;
+
+    if( pScope != NULL )
+    {
+        /* The precomputed prefix holds "<algorithm> Credential=", and the
+         * suffix the rest of the credential scope after the date. */
+        pIov[ 0 ].pData = pScope->pAuthPrefix;
+        pIov[ 0 ].dataLen = pScope->authPrefixLen;
+        pIov[ 1 ].dataLen = 0U;
+        pIov[ 5 ].pData = pScope->pScopeSuffix;
+        pIov[ 5 ].dataLen = pScope->scopeSuffixLen;
+        pIov[ 6 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 6 ].dataLen = 0U;
+        pIov[ 7 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 7 ].dataLen = 0U;
+    }
+    else if( isSigV4A( pParams ) )
+    {
+        pIov[ 6 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 6 ].dataLen = 0U;
+        pIov[ 7 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 7 ].dataLen = 0U;
+    }
+    else
+    {
+        pIov[ 6 ].pData = pParams->pRegion;
+        pIov[ 6 ].dataLen = pParams->regionLen;
+        pIov[ 7 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 7 ].dataLen = AUTH_SCOPE_SEPARATOR_SEGMENT_LEN;
+    }
+
+    /* "/aws4_request, SignedHeaders=<signed headers>, Signature=<signature>" */
+    if( pScope != NULL )
+    {
+        pIov[ 8 ].pData = AUTH_SCOPE_SEPARATOR_SEGMENT;
+        pIov[ 8 ].dataLen = 0U;
+        pIov[ 9 ].pData = AUTH_SCOPE_SIGNED_HEADERS_SEGMENT;
+        pIov[ 9 ].dataLen = AUTH_SCOPE_SIGNED_HEADERS_SEGMENT_LEN;
+    }
+    else
+    {
+        pIov[ 8 ].pData = pParams->pService;
+        pIov[ 8 ].dataLen = pParams->serviceLen;
+        pIov[ 9 ].pData = AUTH_SIGNED_HEADERS_SEGMENT;
+        pIov[ 9 ].dataLen = AUTH_SIGNED_HEADERS_SEGMENT_LEN;
+    }
+
+    pIov[ 10 ].pData = pBuf;
+    pIov[ 10 ].dataLen = signedHeadersLen;
+    pIov[ 11 ].pData = AUTH_SIGNATURE_SEGMENT;
+    pIov[ 11 ].dataLen = AUTH_SIGNATURE_SEGMENT_LEN;
+    pIov[ 12 ].pData = &( pBuf[ signedHeadersLen ] );
+    pIov[ 12 ].dataLen = signatureLen;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_GenerateHTTPAuthorizationIov( const SigV4Parameters_t * pParams,
+                                                  SigV4IoVec_t * pIov,
+                                                  size_t * pIovCount,
+                                                  char * pBuf,
+                                                  size_t bufLen )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    CanonicalContext_t canonicalContext;
+    const char * pAlgorithm = NULL;
+    char * pSignedHeaders = NULL;
+    size_t algorithmLen = 0U, signedHeadersLen = 0U, signatureLen = 0U;
+
+    if( ( pParams == NULL ) || ( pIov == NULL ) || ( pIovCount == NULL ) || ( pBuf == NULL ) )
+    {
+        LogError( ( "Parameter check failed: At least one of the input parameters is NULL. "
+                    "Input parameters cannot be NULL" ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else if( *pIovCount < SIGV4_AUTHORIZATION_IOVEC_COUNT )
+    {
+        LogError( ( "Parameter check failed: *pIovCount must be at least SIGV4_AUTHORIZATION_IOVEC_COUNT." ) );
+        returnStatus = SigV4InsufficientMemory;
+    }
+    else
+    {
+        returnStatus = verifySigV4Parameters( pParams );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        assignDefaultArguments( pParams, &pAlgorithm, &algorithmLen );
+        returnStatus = generateCanonicalRequest( pParams, &canonicalContext,
+                                                 &pSignedHeaders,
+                                                 &signedHeadersLen );
+    }
+
+    /* The signed headers list is copied out of the processing buffer, which
+     * is reused to compute the signature. */
+    if( returnStatus == SigV4Success )
+    {
+        if( bufLen < ( signedHeadersLen + maxEncodedSignatureLength( pParams ) ) )
+        {
+            LogError( ( "Insufficient memory provided to write the signed headers and signature, bytesExceeded=%lu",
+                        ( unsigned long ) ( signedHeadersLen + maxEncodedSignatureLength( pParams ) - bufLen ) ) );
+            returnStatus = SigV4InsufficientMemory;
+        }
+        else
+        {
+            ( void ) memcpy( pBuf, pSignedHeaders, signedHeadersLen );
+        }
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = generateSignature( pParams, pAlgorithm, algorithmLen,
+                                          &canonicalContext, &( pBuf[ signedHeadersLen ] ),
+                                          &signatureLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        fillAuthorizationIov( pParams, pAlgorithm, algorithmLen, pBuf, signedHeadersLen, signatureLen, pIov );
+        *pIovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void parseRequestTarget( const char * pTarget,
+                                size_t targetLen,
+                                SigV4HttpParameters_t * pHttpParams )
+{
+    const char * pPath = pTarget;
+    size_t pathLen = targetLen;
+    const char * pSchemeEnd = NULL;
+    const char * pQueryStart = NULL;
+    size_t authorityIndex = 0U;
+
+    /* An absolute-form target, "<scheme>://<authority><path>", is signed by
+     * its path. */
+    if( ( targetLen > 0U ) && ( pTarget[ 0 ] != '/' ) )
+    {
+        pSchemeEnd = ( const char * ) memchr( pTarget, ( int ) ':', targetLen );
+    }
+
+    if( pSchemeEnd != NULL )
+    {
+        authorityIndex = ( size_t ) ( pSchemeEnd - pTarget ) + HTTP_SCHEME_SEPARATOR_LEN;
+    }
+
+    if( ( authorityIndex > 0U ) && ( authorityIndex <= targetLen ) &&
+        ( strncmp( pSchemeEnd, HTTP_SCHEME_SEPARATOR, HTTP_SCHEME_SEPARATOR_LEN ) == 0 ) )
+    {
+        /* The path starts at the first '/' after the authority, if any. */
+        pPath = ( const char * ) memchr( &( pTarget[ authorityIndex ] ), ( int ) '/', targetLen - authorityIndex );
+        pathLen = ( pPath != NULL ) ? ( targetLen - ( size_t ) ( pPath - pTarget ) ) : 0U;
+    }
+
+    if( pathLen > 0U )
+    {
+        pQueryStart = ( const char * ) memchr( pPath, ( int ) '?', pathLen );
+    }
+
+    if( pQueryStart != NULL )
+    {
+        pHttpParams->pQuery = &( pQueryStart[ 1 ] );
+        pHttpParams->queryLen = pathLen - ( size_t ) ( pQueryStart - pPath ) - 1U;
+        pathLen = ( size_t ) ( pQueryStart - pPath );
+    }
+
+    pHttpParams->pPath = pPath;
+    pHttpParams->pathLen = pathLen;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t parseRequestLine( const char * pRequest,
+                                       size_t requestLen,
+                                       SigV4HttpParameters_t * pHttpParams,
+                                       size_t * pLineLen )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+    const char * pLineEnd = NULL;
+    const char * pMethodEnd = NULL;
+    const char * pTargetEnd = NULL;
+    size_t lineLen = 0U;
+
+    pLineEnd = ( const char * ) memchr( pRequest, ( int ) '\n', requestLen );
+
+    if( pLineEnd != NULL )
+    {
+        lineLen = ( size_t ) ( pLineEnd - pRequest );
+    }
+
+    if( ( lineLen > 0U ) && ( pRequest[ lineLen - 1U ] == '\r' ) )
+    {
+        /* The request line without its line ending. */
+        lineLen--;
+        pMethodEnd = ( const char * ) memchr( pRequest, ( int ) ' ', lineLen );
+    }
+
+    if( ( pMethodEnd != NULL ) && ( pMethodEnd != pRequest ) )
+    {
+        pTargetEnd = ( const char * ) memchr( &( pMethodEnd[ 1 ] ), ( int ) ' ',
+                                              lineLen - ( size_t ) ( pMethodEnd - pRequest ) - 1U );
+    }
+
+    if( ( pTargetEnd != NULL ) &&
+        ( ( lineLen - ( size_t ) ( pTargetEnd - pRequest ) - 1U ) > HTTP_VERSION_PREFIX_LEN ) &&
+        ( strncmp( &( pTargetEnd[ 1 ] ), HTTP_VERSION_PREFIX, HTTP_VERSION_PREFIX_LEN ) == 0 ) )
+    {
+        pHttpParams->pHttpMethod = pRequest;
+        pHttpParams->httpMethodLen = ( size_t ) ( pMethodEnd - pRequest );
+        parseRequestTarget( &( pMethodEnd[ 1 ] ),
+                            ( size_t ) ( pTargetEnd - pMethodEnd ) - 1U,
+                            pHttpParams );
+        *pLineLen = lineLen + HTTP_REQUEST_LINE_ENDING_LEN;
+        returnStatus = SigV4Success;
+    }
+    else
+    {
+        LogError( ( "Parameter check failed: The request does not start with an HTTP/1.1 request line." ) );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t findHeaderBlockEnd( const char * pHeaders,
+                                         size_t headersLen,
+                                         size_t * pBlockLen )
+{
+    SigV4Status_t returnStatus = SigV4InvalidHttpHeaders;
+    const char * pLineFeed = NULL;
+    size_t index = 0U;
+    bool searching = true;
+
+    /* The header block must hold at least one header, so it cannot start with
+     * the empty line. Each line feed is then found with memchr(), and the
+     * block ends at the first one followed by an empty line. */
+    if( ( headersLen >= HTTP_REQUEST_LINE_ENDING_LEN ) &&
+        ( strncmp( pHeaders, HTTP_REQUEST_LINE_ENDING, HTTP_REQUEST_LINE_ENDING_LEN ) == 0 ) )
+    {
+        searching = false;
+    }
+
+    while( searching )
+    {
+        pLineFeed = ( const char * ) memchr( &( pHeaders[ index ] ), ( int ) '\n', headersLen - index );
+
+        if( pLineFeed == NULL )
+        {
+            searching = false;
+        }
+        else
+        {
+            index = ( size_t ) ( pLineFeed - pHeaders ) + 1U;
+
+            if( ( ( headersLen - index ) >= HTTP_REQUEST_LINE_ENDING_LEN ) &&
+                ( strncmp( &( pHeaders[ index ] ), HTTP_REQUEST_LINE_ENDING, HTTP_REQUEST_LINE_ENDING_LEN ) == 0 ) )
+            {
+                *pBlockLen = index + HTTP_REQUEST_LINE_ENDING_LEN;
+                returnStatus = SigV4Success;
+                searching = false;
+            }
+        }
+    }
+
+    if( returnStatus != SigV4Success )
+    {
+        LogError( ( "Failed to find the end of the HTTP headers in the request." ) );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_SignRawHttpRequest( const SigV4Parameters_t * pParams,
+                                        const char * pRequest,
+                                        size_t requestLen,
+                                        char * pAuthBuf,
+                                        size_t * authBufLen,
+                                        size_t * pAuthInsertIndex )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    SigV4Parameters_t rawParams;
+    SigV4HttpParameters_t httpParams = { 0 };
+    size_t lineLen = 0U, blockLen = 0U, signatureLen = 0U;
+    char * pSignature = NULL;
+
+    if( ( pParams == NULL ) || ( pRequest == NULL ) || ( requestLen == 0U ) || ( pAuthInsertIndex == NULL ) )
+    {
+        LogError( ( "Parameter check failed: At least one of the input parameters is NULL or empty." ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else
+    {
+        returnStatus = parseRequestLine( pRequest, requestLen, &httpParams, &lineLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        returnStatus = findHeaderBlockEnd( &( pRequest[ lineLen ] ), requestLen - lineLen, &blockLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        /* The request is signed in place: every part of the HTTP parameters
+         * points into the request. */
+        httpParams.pHeaders = &( pRequest[ lineLen ] );
+        httpParams.headersLen = blockLen;
+        httpParams.pPayload = &( pRequest[ lineLen + blockLen ] );
+        httpParams.payloadLen = requestLen - lineLen - blockLen;
+
+        if( pParams->pHttpParameters != NULL )
+        {
+            httpParams.flags = pParams->pHttpParameters->flags;
+        }
+
+        rawParams = *pParams;
+        rawParams.pHttpParameters = &httpParams;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &rawParams, pAuthBuf, authBufLen,
+                                                        &pSignature, &signatureLen );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        /* The Authorization header goes before the empty line that ends the
+         * header block. */
+        *pAuthInsertIndex = lineLen + blockLen - HTTP_REQUEST_LINE_ENDING_LEN;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool parseDecimal( const char * pDigits,
+                          size_t digitsLen,
+                          uint32_t * pValue )
+{
+    bool isValid = ( digitsLen > 0U ) && ( digitsLen <= MAX_DECIMAL_DIGITS );
+    uint32_t value = 0U;
+    size_t i;
+
+    for( i = 0U; isValid && ( i < digitsLen ); i++ )
+    {
+        if( ( pDigits[ i ] >= '0' ) && ( pDigits[ i ] <= '9' ) )
+        {
+            value = ( value * 10U ) + ( uint32_t ) ( ( uint8_t ) pDigits[ i ] - ( uint8_t ) '0' );
+        }
+        else
+        {
+            isValid = false;
+        }
+    }
+
+    *pValue = value;
+
+    return isValid;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool iso8601ToEpochSeconds( const char * pDate,
+                                   uint32_t * pSeconds )
+{
+    const uint32_t monthDays[ 12 ] = MONTH_DAYS;
+    uint32_t year = 0U, month = 0U, day = 0U, hour = 0U, minute = 0U, second = 0U;
+    uint32_t days = 0U, i;
+    bool isValid = false, isLeapYear = false;
+
+    /* "YYYYMMDD'T'HHMMSS'Z'" */
+    isValid = ( pDate[ ISO_DATE_SCOPE_LEN ] == 'T' ) &&
+              ( pDate[ SIGV4_ISO_STRING_LEN - 1U ] == 'Z' ) &&
+              parseDecimal( pDate, ISO_YEAR_LEN, &year ) &&
+              parseDecimal( &pDate[ 4 ], ISO_NON_YEAR_LEN, &month ) &&
+              parseDecimal( &pDate[ 6 ], ISO_NON_YEAR_LEN, &day ) &&
+              parseDecimal( &pDate[ 9 ], ISO_NON_YEAR_LEN, &hour ) &&
+              parseDecimal( &pDate[ 11 ], ISO_NON_YEAR_LEN, &minute ) &&
+              parseDecimal( &pDate[ 13 ], ISO_NON_YEAR_LEN, &second );
+    isLeapYear = ( ( ( year % 4U ) == 0U ) && ( ( year % 100U ) != 0U ) ) || ( ( year % 400U ) == 0U );
+
+    /* The month is checked before it picks the number of days in it. */
+    isValid = isValid &&
+              ( year >= EPOCH_YEAR ) && ( year <= MAX_EPOCH_YEAR ) &&
+              ( month >= 1U ) && ( month <= 12U ) &&
+              ( day >= 1U ) &&
+              ( day <= ( monthDays[ month - 1U ] + ( ( ( month == 2U ) && isLeapYear ) ? 1U : 0U ) ) ) &&
+              ( hour < 24U ) && ( minute < 60U ) && ( second < 60U );
+
+    if( isValid )
+    {
+        /* Days of the whole years, with a leap day for every leap year
+         * between the epoch and the start of the year. */
+        days = ( 365U * ( year - EPOCH_YEAR ) ) +
+               ( ( ( year - 1U ) / 4U ) - ( ( year - 1U ) / 100U ) + ( ( year - 1U ) / 400U ) ) -
+               ( ( ( EPOCH_YEAR - 1U ) / 4U ) - ( ( EPOCH_YEAR - 1U ) / 100U ) + ( ( EPOCH_YEAR - 1U ) / 400U ) );
+
+        for( i = 1U; i < month; i++ )
+        {
+            days += monthDays[ i - 1U ];
+        }
+
+        if( ( month > 2U ) && isLeapYear )
+        {
+            days++;
+        }
+
+        days += day - 1U;
+        *pSeconds = ( days * SECONDS_PER_DAY ) + ( hour * 3600U ) + ( minute * 60U ) + second;
+    }
+
+    return isValid;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool findQueryParameter( const char * pQuery,
+                                size_t queryLen,
+                                const char * pName,
+                                size_t nameLen,
+                                size_t * pStart,
+                                size_t * pEnd )
+{
+    bool isFound = false;
+    size_t start = 0U, end = 0U;
+
+    while( ( !isFound ) && ( start < queryLen ) )
+    {
+        end = start;
+
+        while( ( end < queryLen ) && ( pQuery[ end ] != '&' ) )
+        {
+            end++;
+        }
+
+        if( ( ( end - start ) > nameLen ) &&
+            ( pQuery[ start + nameLen ] == '=' ) &&
+            ( memcmp( &( pQuery[ start ] ), pName, nameLen ) == 0 ) )
+        {
+            isFound = true;
+            *pStart = start;
+            *pEnd = end;
+        }
+        else
+        {
+            start = end + 1U;
+        }
+    }
+
+    return isFound;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4Status_t computePresignCacheKey( const SigV4Parameters_t * pParams,
+                                             PresignCacheKey_t * pKey,
+                                             bool * pCacheable )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    const SigV4HttpParameters_t * pHttpParams = pParams->pHttpParameters;
+    const SigV4CryptoInterface_t * pCryptoInterface = pParams->pCryptoInterface;
+    const char * pAlgorithm = NULL;
+    const char * pRegion = "";
+    const char * pPath = "";
+    const char * pPayload = "";
+    const char * pPayloadWrap = "";
+    size_t regionLen = 0U, pathLen = 0U, payloadLen = 0U, payloadWrapLen = 0U;
+    size_t algorithmLen = 0U, dateStart = 0U, dateEnd = 0U, expiresStart = 0U, expiresEnd = 0U;
+    size_t pFieldLengths[ PRESIGN_CACHE_KEY_FIELD_COUNT ];
+    SigV4IoVec_t pSegments[ PRESIGN_CACHE_KEY_SEGMENT_COUNT ];
+    size_t segmentCount = 0U, i;
+    int32_t hashStatus = 0;
+
+    *pCacheable = ( pHttpParams->pQueryWrap == NULL ) &&
+                  ( pHttpParams->pHeadersWrap == NULL ) &&
+                  iso8601ToEpochSeconds( pParams->pDateIso8601, &( pKey->signingTime ) ) &&
+                  findQueryParameter( pHttpParams->pQuery, pHttpParams->queryLen,
+                                      PRESIGN_DATE_PARAMETER, PRESIGN_DATE_PARAMETER_LEN,
+                                      &dateStart, &dateEnd ) &&
+                  findQueryParameter( pHttpParams->pQuery, pHttpParams->queryLen,
+                                      PRESIGN_EXPIRES_PARAMETER, PRESIGN_EXPIRES_PARAMETER_LEN,
+                                      &expiresStart, &expiresEnd ) &&
+                  parseDecimal( &( pHttpParams->pQuery[ expiresStart + PRESIGN_EXPIRES_PARAMETER_LEN + 1U ] ),
+                                expiresEnd - expiresStart - PRESIGN_EXPIRES_PARAMETER_LEN - 1U,
+                                &( pKey->expires ) );
+
+    if( *pCacheable )
+    {
+        assignDefaultArguments( pParams, &pAlgorithm, &algorithmLen );
+
+        /* The region, which SigV4A leaves out, and the path may be NULL
+         * whatever their lengths, and are then hashed as empty. */
+        if( pParams->pRegion != NULL )
+        {
+            pRegion = pParams->pRegion;
+            regionLen = pParams->regionLen;
+        }
+
+        if( pHttpParams->pPath != NULL )
+        {
+            pPath = pHttpParams->pPath;
+            pathLen = pHttpParams->pathLen;
+        }
+
+        /* A payload digest is signed in place of UNSIGNED-PAYLOAD, so it
+         * tells apart requests that are otherwise the same. */
+        if( FLAG_IS_SET( pHttpParams->flags, SIGV4_HTTP_PAYLOAD_IS_DIGEST ) )
+        {
+            pPayload = pHttpParams->pPayload;
+            payloadLen = pHttpParams->payloadLen;
+            payloadWrapLen = wrappedLength( pHttpParams->pPayloadWrap, pHttpParams->payloadWrapLen );
+
+            if( payloadWrapLen > 0U )
+            {
+                pPayloadWrap = pHttpParams->pPayloadWrap;
+            }
+        }
+
+        /* Every field is hashed along with its length, so that the fields of
+         * two requests cannot be shifted into each other. The query is hashed
+         * around X-Amz-Date, which is the only part that changes between
+         * requests for the same URL. */
+        appendSegment( pSegments, &segmentCount, pFieldLengths, sizeof( pFieldLengths ) );
+        appendSegment( pSegments, &segmentCount, &( pHttpParams->flags ), sizeof( pHttpParams->flags ) );
+        appendSegment( pSegments, &segmentCount, pParams->pDateIso8601, ISO_DATE_SCOPE_LEN );
+        appendSegment( pSegments, &segmentCount, pHttpParams->pHttpMethod, pHttpParams->httpMethodLen );
+        appendSegment( pSegments, &segmentCount, pPath, pathLen );
+        appendSegment( pSegments, &segmentCount, pHttpParams->pQuery, dateStart );
+        appendSegment( pSegments, &segmentCount, &( pHttpParams->pQuery[ dateEnd ] ), pHttpParams->queryLen - dateEnd );
+        appendSegment( pSegments, &segmentCount, pHttpParams->pHeaders, pHttpParams->headersLen );
+        appendSegment( pSegments, &segmentCount, pPayload, payloadLen );
+        appendSegment( pSegments, &segmentCount, pPayloadWrap, payloadWrapLen );
+        appendSegment( pSegments, &segmentCount, pParams->pCredentials->pAccessKeyId, pParams->pCredentials->accessKeyIdLen );
+        appendSegment( pSegments, &segmentCount, pRegion, regionLen );
+        appendSegment( pSegments, &segmentCount, pParams->pService, pParams->serviceLen );
+        appendSegment( pSegments, &segmentCount, pAlgorithm, algorithmLen );
+
+        for( i = 0U; i < PRESIGN_CACHE_KEY_FIELD_COUNT; i++ )
+        {
+            pFieldLengths[ i ] = pSegments[ segmentCount - PRESIGN_CACHE_KEY_FIELD_COUNT + i ].dataLen;
+        }
+
+        hashStatus = pCryptoInterface->hashInit( pCryptoInterface->pHashContext );
+
+        if( hashStatus == 0 )
+        {
+            hashStatus = hashUpdateSegments( pCryptoInterface, pSegments, segmentCount );
+        }
+
+        if( hashStatus == 0 )
+        {
+            hashStatus = pCryptoInterface->hashFinal( pCryptoInterface->pHashContext,
+                                                      pKey->pRequestDigest,
+                                                      pCryptoInterface->hashDigestLen );
+        }
+
+        if( hashStatus != 0 )
+        {
+            LogError( ( "Failed to hash the presigned URL request for the presigned URL cache." ) );
+            returnStatus = SigV4HashError;
+        }
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static SigV4PresignCacheEntry_t * findPresignCacheEntry( SigV4PresignCache_t * pPresignCache,
+                                                         const PresignCacheKey_t * pKey,
+                                                         size_t digestLen )
+{
+    SigV4PresignCacheEntry_t * pFound = NULL;
+    SigV4PresignCacheEntry_t * pEntry = NULL;
+    uint32_t elapsed = 0U;
+    size_t i;
+
+    assert( pPresignCache != NULL );
+    assert( pPresignCache->bucketSeconds != 0U );
+
+    for( i = 0U; ( i < SIGV4_PRESIGN_CACHE_ENTRY_COUNT ) && ( pFound == NULL ); i++ )
+    {
+        pEntry = &( pPresignCache->entries[ i ] );
+        elapsed = pKey->signingTime - pEntry->signingTime;
+
+        /* The signature must have been generated earlier in the same time
+         * bucket, and must stay valid for long enough. */
+        if( ( pEntry->signatureLen != 0U ) &&
+            ( pKey->signingTime >= pEntry->signingTime ) &&
+            ( ( pKey->signingTime / pPresignCache->bucketSeconds ) == ( pEntry->signingTime / pPresignCache->bucketSeconds ) ) &&
+            ( elapsed <= pEntry->expires ) &&
+            ( ( pEntry->expires - elapsed ) >= pPresignCache->minRemainingSeconds ) &&
+            ( memcmp( pEntry->pRequestDigest, pKey->pRequestDigest, digestLen ) == 0 ) )
+        {
+            pFound = pEntry;
+        }
+    }
+
+    return pFound;
+}
+
+/*-----------------------------------------------------------*/
+
+static void storePresignCacheEntry( SigV4PresignCache_t * pPresignCache,
+                                    const PresignCacheKey_t * pKey,
+                                    size_t digestLen,
+                                    const char * pSigningDate,
+                                    const char * pSignature,
+                                    size_t signatureLen )
+{
+    SigV4PresignCacheEntry_t * pVictim = NULL;
+    size_t i;
+
+    assert( pPresignCache != NULL );
+    assert( signatureLen <= SIGV4_MAX_ENCODED_SIGNATURE_LENGTH );
+
+    pVictim = &( pPresignCache->entries[ 0 ] );
+
+    /* Empty entries have never been used, so they are replaced first. */
+    for( i = 1U; i < SIGV4_PRESIGN_CACHE_ENTRY_COUNT; i++ )
+    {
+        if( pPresignCache->entries[ i ].lastUsed < pVictim->lastUsed )
+        {
+            pVictim = &( pPresignCache->entries[ i ] );
+        }
+    }
+
+    pPresignCache->useCounter++;
+    pVictim->lastUsed = pPresignCache->useCounter;
+    ( void ) memcpy( pVictim->pRequestDigest, pKey->pRequestDigest, digestLen );
+    pVictim->signingTime = pKey->signingTime;
+    pVictim->expires = pKey->expires;
+    ( void ) memcpy( pVictim->pSigningDate, pSigningDate, SIGV4_ISO_STRING_LEN );
+    ( void ) memcpy( pVictim->pSignature, pSignature, signatureLen );
+    pVictim->signatureLen = signatureLen;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_GeneratePresignedSignature( const SigV4Parameters_t * pParams,
+                                                SigV4PresignCache_t * pPresignCache,
+                                                char * pSignature,
+                                                size_t * pSignatureLen,
+                                                char * pSigningDate )
+{
+    SigV4Status_t returnStatus = SigV4Success;
+    CanonicalContext_t canonicalContext;
+    PresignCacheKey_t key;
+    SigV4PresignCacheEntry_t * pEntry = NULL;
+    const char * pAlgorithm = NULL;
+    char * pSignedHeaders = NULL;
+    size_t algorithmLen = 0U, signedHeadersLen = 0U;
+    bool isCacheable = false;
+
+    if( ( pParams == NULL ) || ( pSignature == NULL ) || ( pSignatureLen == NULL ) || ( pSigningDate == NULL ) )
+    {
+        LogError( ( "Parameter check failed: At least one of the input parameters is NULL. "
+                    "Input parameters cannot be NULL" ) );
+        returnStatus = SigV4InvalidParameter;
+    }
+    else
+    {
+        returnStatus = verifySigV4Parameters( pParams );
+    }
+
+    if( returnStatus == SigV4Success )
+    {
+        if( !FLAG_IS_SET( pParams->pHttpParameters->flags, SIGV4_HTTP_IS_PRESIGNED_URL ) )
+        {
+            LogError( ( "Parameter check failed: SIGV4_HTTP_IS_PRESIGNED_URL must be set in pParams->pHttpParameters->flags." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( *pSignatureLen < maxEncodedSignatureLength( pParams ) )
+        {
+            LogError( ( "Insufficient memory provided to write the signature, bytesExceeded=%lu",
+                        ( unsigned long ) ( maxEncodedSignatureLength( pParams ) - *pSignatureLen ) ) );
+            returnStatus = SigV4InsufficientMemory;
+        }
+        else
+        {
+            /* Empty else. */
+        }
+    }
+
+    if( ( returnStatus == SigV4Success ) && ( pPresignCache != NULL ) && ( pPresignCache->bucketSeconds != 0U ) )
+    {
+        returnStatus = computePresignCacheKey( pParams, &key, &isCacheable );
+
+        if( isCacheable && ( returnStatus == SigV4Success ) )
+        {
+            pEntry = findPresignCacheEntry( pPresignCache, &key, pParams->pCryptoInterface->hashDigestLen );
+        }
+    }
+
+    if( ( returnStatus == SigV4Success ) && ( pEntry != NULL ) )
+    {
+        pPresignCache->useCounter++;
+        pEntry->lastUsed = pPresignCache->useCounter;
+        ( void ) memcpy( pSignature, pEntry->pSignature, pEntry->signatureLen );
+        *pSignatureLen = pEntry->signatureLen;
+        ( void ) memcpy( pSigningDate, pEntry->pSigningDate, SIGV4_ISO_STRING_LEN );
+    }
+    else if( returnStatus == SigV4Success )
+    {
+        assignDefaultArguments( pParams, &pAlgorithm, &algorithmLen );
+        returnStatus = generateCanonicalRequest( pParams, &canonicalContext,
+                                                 &pSignedHeaders,
+                                                 &signedHeadersLen );
+
+        if( returnStatus == SigV4Success )
+        {
+            returnStatus = generateSignature( pParams, pAlgorithm, algorithmLen,
+                                              &canonicalContext, pSignature,
+                                              pSignatureLen );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            ( void ) memcpy( pSigningDate, pParams->pDateIso8601, SIGV4_ISO_STRING_LEN );
+
+            if( isCacheable )
+            {
+                storePresignCacheEntry( pPresignCache, &key, pParams->pCryptoInterface->hashDigestLen,
+                                        pSigningDate, pSignature, *pSignatureLen );
+            }
+        }
+    }
+    else
+    {
+        /* Empty else. */
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_HashPayload( const SigV4CryptoInterface_t * pCryptoInterface,
+                                 const char * pPayload,
+                                 size_t payloadLen,
+                                 char * pHexDigest,
+                                 size_t * pHexDigestLen )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+
+    if( ( pCryptoInterface == NULL ) || ( pHexDigest == NULL ) || ( pHexDigestLen == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface, pHexDigest and pHexDigestLen must not be NULL." ) );
+    }
+    else if( ( pCryptoInterface->hashInit == NULL ) || ( pCryptoInterface->hashUpdate == NULL ) ||
+             ( pCryptoInterface->hashFinal == NULL ) )
+    {
+        LogError( ( "Parameter check failed: At least one of hashInit, hashUpdate, hashFinal function pointer members is NULL." ) );
+    }
+    else if( pCryptoInterface->hashDigestLen > SIGV4_HASH_MAX_DIGEST_LENGTH )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface->hashDigestLen is greater than `SIGV4_HASH_MAX_DIGEST_LENGTH`, "
+                    "which can be configured in sigv4_config.h." ) );
+    }
+    else if( ( pPayload == NULL ) && ( payloadLen != 0U ) )
+    {
+        LogError( ( "Parameter check failed: pPayload is NULL, but payloadLen is not zero." ) );
+    }
+    else if( *pHexDigestLen < ( pCryptoInterface->hashDigestLen * 2U ) )
+    {
+        returnStatus = SigV4InsufficientMemory;
+        LogError( ( "Parameter check failed: pHexDigestLen must be at least %lu.",
+                    ( unsigned long ) ( pCryptoInterface->hashDigestLen * 2U ) ) );
+    }
+    else
+    {
+        returnStatus = completeHashAndHexEncode( pPayload,
+                                                 payloadLen,
+                                                 NULL,
+                                                 0U,
+                                                 pHexDigest,
+                                                 pHexDigestLen,
+                                                 pCryptoInterface );
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+SigV4Status_t SigV4_FinishPayloadHash( const SigV4CryptoInterface_t * pCryptoInterface,
+                                       char * pHexDigest,
+                                       size_t * pHexDigestLen )
+{
+    SigV4Status_t returnStatus = SigV4InvalidParameter;
+    uint8_t hashBuffer[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+    SigV4String_t originalHash;
+    SigV4String_t hexEncodedHash;
+
+    if( ( pCryptoInterface == NULL ) || ( pHexDigest == NULL ) || ( pHexDigestLen == NULL ) )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface, pHexDigest and pHexDigestLen must not be NULL." ) );
+    }
+    else if( pCryptoInterface->hashFinal == NULL )
+    {
+        LogError( ( "Parameter check failed: hashFinal function pointer member is NULL." ) );
+    }
+    else if( pCryptoInterface->hashDigestLen > SIGV4_HASH_MAX_DIGEST_LENGTH )
+    {
+        LogError( ( "Parameter check failed: pCryptoInterface->hashDigestLen is greater than `SIGV4_HASH_MAX_DIGEST_LENGTH`, "
+                    "which can be configured in sigv4_config.h." ) );
+    }
+    else if( *pHexDigestLen < ( pCryptoInterface->hashDigestLen * 2U ) )
+    {
+        returnStatus = SigV4InsufficientMemory;
+        LogError( ( "Parameter check failed: pHexDigestLen must be at least %lu.",
+                    ( unsigned long ) ( pCryptoInterface->hashDigestLen * 2U ) ) );
+    }
+    else if( pCryptoInterface->hashFinal( pCryptoInterface->pHashContext,
+                                          hashBuffer,
+                                          pCryptoInterface->hashDigestLen ) != 0 )
+    {
+        returnStatus = SigV4HashError;
+    }
+    else
+    {
+        originalHash.pData = ( char * ) hashBuffer;
+        originalHash.dataLen = pCryptoInterface->hashDigestLen;
+        hexEncodedHash.pData = pHexDigest;
+        hexEncodedHash.dataLen = *pHexDigestLen;
+
+        /* The space for the digest was validated above. */
+        returnStatus = lowercaseHexEncode( &originalHash, &hexEncodedHash );
+        *pHexDigestLen = hexEncodedHash.dataLen;
+    }
+
+    return returnStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( SIGV4_USE_CANONICAL_SUPPORT == 1 )
+
+    SigV4Status_t SigV4_EncodeURI( const char * pUri,
+                                   size_t uriLen,
+                                   char * pCanonicalURI,
+                                   size_t * canonicalURILen,
+                                   bool encodeSlash,
+                                   bool doubleEncodeEquals )
+    {
+        size_t uriIndex = 0U, bytesConsumed = 0U;
+        size_t bufferLen = 0U;
+        SigV4Status_t returnStatus = SigV4Success;
+
+        assert( pUri != NULL );
+        assert( pCanonicalURI != NULL );
+        assert( canonicalURILen != NULL );
+
+        bufferLen = *canonicalURILen;
+
+        while( ( uriIndex < uriLen ) && ( returnStatus == SigV4Success ) )
+        {
+            if( doubleEncodeEquals && ( pUri[ uriIndex ] == '=' ) )
+            {
+                if( ( bufferLen - bytesConsumed ) < URI_DOUBLE_ENCODED_EQUALS_CHAR_SIZE )
+                {
+                    returnStatus = SigV4InsufficientMemory;
+                    LOG_INSUFFICIENT_MEMORY_ERROR( "double encode '=' character in canonical query",
+                                                   ( bytesConsumed + URI_DOUBLE_ENCODED_EQUALS_CHAR_SIZE - bufferLen ) );
+                }
+                else
+                {
+                    bytesConsumed += writeDoubleEncodedEquals( &( pCanonicalURI[ bytesConsumed ] ), bufferLen - bytesConsumed );
+                }
+            }
+            else if( isAllowedChar( pUri[ uriIndex ], encodeSlash ) )
+            {
                 /* If the output buffer has space, add the character as-is in URI encoding as it
                  * is neither a special character nor an '=' character requiring double encoding. */
                 if( bytesConsumed < bufferLen )
@@ -3276,33 +7311,598 @@ SigV4Status_t SigV4_GenerateHTTPAuthorization( const SigV4Parameters_t * pParams
                     LogError( ( "Failed to encode URI in buffer due to insufficient memory" ) );
                 }
             }
-            else if( pUri[ uriIndex ] == '\0' )
+            else if( pUri[ uriIndex ] == '\0' )
+            {
+                /* The URI path beyond the NULL terminator is not encoded. */
+                uriIndex = uriLen;
+            }
+            else
+            {
+                if( ( bufferLen - bytesConsumed ) < URI_ENCODED_SPECIAL_CHAR_SIZE )
+                {
+                    returnStatus = SigV4InsufficientMemory;
+                    LOG_INSUFFICIENT_MEMORY_ERROR( "encode special character in canonical URI",
+                                                   ( bytesConsumed + URI_ENCODED_SPECIAL_CHAR_SIZE - bufferLen ) );
+                }
+                else
+                {
+                    bytesConsumed += writeHexCodeOfChar( &( pCanonicalURI[ bytesConsumed ] ), bufferLen - bytesConsumed, pUri[ uriIndex ] );
+                }
+            }
+
+            uriIndex++;
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            /* Set the output parameter of the number of URI encoded bytes written
+             * to the buffer. */
+            *canonicalURILen = bytesConsumed;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_InitQueryBuilder( SigV4QueryBuilder_t * pBuilder,
+                                          char * pBuffer,
+                                          size_t bufferLen,
+                                          bool doubleEncodeEquals )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+
+        if( ( pBuilder == NULL ) || ( pBuffer == NULL ) || ( bufferLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: pBuilder and pBuffer must not be NULL, and bufferLen must not be zero." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            pBuilder->pQuery = pBuffer;
+            pBuilder->queryLen = 0U;
+            pBuilder->bufferLen = bufferLen;
+            pBuilder->doubleEncodeEquals = doubleEncodeEquals;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t insertQueryBuilderEntry( SigV4QueryBuilder_t * pBuilder,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen,
+                                                  bool replaceKey )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        size_t storedLen = 0U, encodedKeyLen = 0U, entryLen = 0U;
+        size_t offset = 0U, foundLen = 0U;
+
+        returnStatus = verifyQueryBuilderParams( pBuilder, pKey, keyLen, pValue, valueLen );
+
+        if( returnStatus == SigV4Success )
+        {
+            /* Only the new parameter is encoded, after the stored ones. */
+            returnStatus = encodeQueryBuilderEntry( pBuilder, pKey, keyLen, pValue, valueLen,
+                                                    &encodedKeyLen, &entryLen );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            storedLen = queryBuilderStoredLength( pBuilder );
+            offset = findQueryBuilderEntry( pBuilder->pQuery, storedLen,
+                                            &( pBuilder->pQuery[ storedLen ] ), encodedKeyLen,
+                                            &foundLen );
+
+            if( !replaceKey )
+            {
+                offset = skipRepeatedQueryBuilderEntries( pBuilder->pQuery, storedLen, offset,
+                                                          &( pBuilder->pQuery[ storedLen ] ), encodedKeyLen, entryLen );
+                foundLen = 0U;
+            }
+
+            /* Drop the previous value of the parameter, if any, which moves the
+             * new entry down along with the parameters that sort after it. */
+            ( void ) memmove( &( pBuilder->pQuery[ offset ] ),
+                              &( pBuilder->pQuery[ offset + foundLen ] ),
+                              ( storedLen + entryLen ) - ( offset + foundLen ) );
+            storedLen -= foundLen;
+
+            /* Rotate the new entry in front of the parameters that sort after it. */
+            reverseCharacters( &( pBuilder->pQuery[ offset ] ), storedLen - offset );
+            reverseCharacters( &( pBuilder->pQuery[ storedLen ] ), entryLen );
+            reverseCharacters( &( pBuilder->pQuery[ offset ] ), ( storedLen - offset ) + entryLen );
+
+            /* The '&' following the last parameter is not part of the query. */
+            pBuilder->queryLen = ( storedLen + entryLen ) - 1U;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SetQueryParameter( SigV4QueryBuilder_t * pBuilder,
+                                           const char * pKey,
+                                           size_t keyLen,
+                                           const char * pValue,
+                                           size_t valueLen )
+    {
+        return insertQueryBuilderEntry( pBuilder, pKey, keyLen, pValue, valueLen, true );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_RemoveQueryParameter( SigV4QueryBuilder_t * pBuilder,
+                                              const char * pKey,
+                                              size_t keyLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        size_t storedLen = 0U, encodedKeyLen = 0U, entryLen = 0U;
+        size_t offset = 0U, foundLen = 0U;
+
+        returnStatus = verifyQueryBuilderParams( pBuilder, pKey, keyLen, NULL, 0U );
+
+        if( returnStatus == SigV4Success )
+        {
+            returnStatus = encodeQueryBuilderEntry( pBuilder, pKey, keyLen, NULL, 0U,
+                                                    &encodedKeyLen, &entryLen );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            storedLen = queryBuilderStoredLength( pBuilder );
+            offset = findQueryBuilderEntry( pBuilder->pQuery, storedLen,
+                                            &( pBuilder->pQuery[ storedLen ] ), encodedKeyLen,
+                                            &foundLen );
+
+            ( void ) memmove( &( pBuilder->pQuery[ offset ] ),
+                              &( pBuilder->pQuery[ offset + foundLen ] ),
+                              storedLen - ( offset + foundLen ) );
+            storedLen -= foundLen;
+            pBuilder->queryLen = ( storedLen > 0U ) ? ( storedLen - 1U ) : 0U;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool isS3Service( const SigV4Parameters_t * pParams )
+    {
+        bool isS3 = false;
+
+        if( pParams->pPrecomputedScope != NULL )
+        {
+            isS3 = pParams->pPrecomputedScope->encodePathOnce;
+        }
+        else
+        {
+            isS3 = ( pParams->serviceLen == S3_SERVICE_NAME_LEN ) &&
+                   ( strncmp( pParams->pService, S3_SERVICE_NAME, S3_SERVICE_NAME_LEN ) == 0 );
+        }
+
+        return isS3;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint32_t signerHttpFlags( const SigV4Signer_t * pSigner )
+    {
+        uint32_t flags = 0U;
+
+        if( pSigner->pParams->pHttpParameters != NULL )
+        {
+            flags = pSigner->pParams->pHttpParameters->flags;
+        }
+
+        return flags;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t enterNextSignerState( SigV4Signer_t * pSigner )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        const SigV4CryptoInterface_t * pCryptoInterface = pSigner->pParams->pCryptoInterface;
+
+        if( pSigner->state == SIGNER_STATE_PATH )
+        {
+            /* The path is closed, and the query is built in the rest of the buffer. */
+            if( pSigner->bufferUsed == pSigner->bufferLen )
+            {
+                returnStatus = SigV4InsufficientMemory;
+                LogError( ( "Failed to start the query: The signer buffer is full." ) );
+            }
+            else
             {
-                /* The URI path beyond the NULL terminator is not encoded. */
-                uriIndex = uriLen;
+                ( void ) SigV4_InitQueryBuilder( &( pSigner->query ),
+                                                 &( pSigner->pBuffer[ pSigner->bufferUsed ] ),
+                                                 pSigner->bufferLen - pSigner->bufferUsed,
+                                                 !FLAG_IS_SET( signerHttpFlags( pSigner ), SIGV4_HTTP_IS_PRESIGNED_URL ) );
+            }
+        }
+        else if( pSigner->state == SIGNER_STATE_QUERY )
+        {
+            /* The headers follow the canonical query. */
+            pSigner->bufferUsed += pSigner->query.queryLen;
+        }
+        else if( pSigner->state == SIGNER_STATE_HEADERS )
+        {
+            if( pCryptoInterface->hashInit( pCryptoInterface->pHashContext ) != 0 )
+            {
+                returnStatus = SigV4HashError;
+            }
+        }
+        else if( pSigner->state == SIGNER_STATE_PAYLOAD )
+        {
+            returnStatus = finalizeSignerPayloadDigest( pSigner );
+        }
+        else
+        {
+            /* Nothing to close before the path. */
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            pSigner->state++;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t advanceSigner( SigV4Signer_t * pSigner,
+                                        uint8_t state )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+
+        if( ( pSigner == NULL ) || ( pSigner->pParams == NULL ) )
+        {
+            LogError( ( "Parameter check failed: pSigner is NULL or not initialized." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( pSigner->state == SIGNER_STATE_FAILED )
+        {
+            LogError( ( "The signer failed earlier, and lost a part of the request." ) );
+            returnStatus = pSigner->status;
+        }
+        else if( pSigner->state > state )
+        {
+            LogError( ( "Parameter check failed: A later part of the request was already pushed to the signer." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( ( state > SIGNER_STATE_METHOD ) && ( pSigner->methodLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: The method must be pushed to the signer first." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            while( ( returnStatus == SigV4Success ) && ( pSigner->state < state ) )
+            {
+                returnStatus = enterNextSignerState( pSigner );
+            }
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t finalizeSignerPayloadDigest( SigV4Signer_t * pSigner )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        const SigV4CryptoInterface_t * pCryptoInterface = pSigner->pParams->pCryptoInterface;
+        uint8_t hashBuffer[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+        SigV4String_t originalHash;
+        SigV4String_t hexEncodedHash;
+
+        originalHash.pData = ( char * ) hashBuffer;
+        originalHash.dataLen = pCryptoInterface->hashDigestLen;
+        hexEncodedHash.pData = pSigner->pPayloadDigest;
+        hexEncodedHash.dataLen = sizeof( pSigner->pPayloadDigest );
+
+        if( pCryptoInterface->hashFinal( pCryptoInterface->pHashContext,
+                                         hashBuffer,
+                                         pCryptoInterface->hashDigestLen ) != 0 )
+        {
+            returnStatus = SigV4HashError;
+        }
+        else
+        {
+            returnStatus = lowercaseHexEncode( &originalHash, &hexEncodedHash );
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static SigV4Status_t failSignerOnError( SigV4Signer_t * pSigner,
+                                            SigV4Status_t status )
+    {
+        if( ( status != SigV4Success ) && ( status != SigV4InvalidParameter ) )
+        {
+            /* Later parts would be signed without this one, so the signer
+             * keeps reporting the error instead. */
+            pSigner->state = SIGNER_STATE_FAILED;
+            pSigner->status = status;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_InitSigner( SigV4Signer_t * pSigner,
+                                    const SigV4Parameters_t * pParams,
+                                    char * pBuffer,
+                                    size_t bufferLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+
+        if( ( pSigner == NULL ) || ( pParams == NULL ) || ( pBuffer == NULL ) || ( bufferLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: pSigner, pParams and pBuffer must not be NULL, and bufferLen must not be zero." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else if( ( pParams->pService == NULL ) || ( pParams->pCryptoInterface == NULL ) ||
+                 ( pParams->pCryptoInterface->hashInit == NULL ) || ( pParams->pCryptoInterface->hashUpdate == NULL ) ||
+                 ( pParams->pCryptoInterface->hashFinal == NULL ) ||
+                 ( pParams->pCryptoInterface->hashDigestLen > SIGV4_HASH_MAX_DIGEST_LENGTH ) )
+        {
+            LogError( ( "Parameter check failed: The service and the hash functions of the crypto interface must be set." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            ( void ) memset( pSigner, 0, sizeof( SigV4Signer_t ) );
+            pSigner->pParams = pParams;
+            pSigner->pBuffer = pBuffer;
+            pSigner->bufferLen = bufferLen;
+            pSigner->state = SIGNER_STATE_METHOD;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerPushMethod( SigV4Signer_t * pSigner,
+                                          const char * pMethod,
+                                          size_t methodLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+
+        if( ( pMethod == NULL ) || ( methodLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: pMethod must not be NULL or empty." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            returnStatus = advanceSigner( pSigner, SIGNER_STATE_METHOD );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            if( methodLen > ( pSigner->bufferLen - pSigner->bufferUsed ) )
+            {
+                returnStatus = SigV4InsufficientMemory;
+                LogError( ( "Failed to push the method: The signer buffer is full." ) );
             }
             else
             {
-                if( ( bufferLen - bytesConsumed ) < URI_ENCODED_SPECIAL_CHAR_SIZE )
-                {
-                    returnStatus = SigV4InsufficientMemory;
-                    LOG_INSUFFICIENT_MEMORY_ERROR( "encode special character in canonical URI",
-                                                   ( bytesConsumed + URI_ENCODED_SPECIAL_CHAR_SIZE - bufferLen ) );
-                }
-                else
-                {
-                    bytesConsumed += writeHexCodeOfChar( &( pCanonicalURI[ bytesConsumed ] ), bufferLen - bytesConsumed, pUri[ uriIndex ] );
-                }
+                ( void ) memcpy( &( pSigner->pBuffer[ pSigner->bufferUsed ] ), pMethod, methodLen );
+                pSigner->bufferUsed += methodLen;
+                pSigner->methodLen += methodLen;
             }
+        }
 
-            uriIndex++;
+        return failSignerOnError( pSigner, returnStatus );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerPushPath( SigV4Signer_t * pSigner,
+                                        const char * pPath,
+                                        size_t pathLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        size_t encodedLen = 0U, doubleEncodedLen = 0U;
+        char * pEncoded = NULL;
+
+        if( ( pPath == NULL ) && ( pathLen > 0U ) )
+        {
+            LogError( ( "Parameter check failed: pPath is NULL." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            returnStatus = advanceSigner( pSigner, SIGNER_STATE_PATH );
+        }
+
+        if( ( returnStatus == SigV4Success ) && ( pathLen > 0U ) )
+        {
+            /* URI-encoding works one character at a time, so each part of the
+             * path is encoded on its own. */
+            pEncoded = &( pSigner->pBuffer[ pSigner->bufferUsed ] );
+            encodedLen = pSigner->bufferLen - pSigner->bufferUsed;
+            returnStatus = SigV4_EncodeURI( pPath, pathLen, pEncoded, &encodedLen, false, false );
+        }
+
+        if( ( returnStatus == SigV4Success ) && ( encodedLen > 0U ) && !isS3Service( pSigner->pParams ) )
+        {
+            doubleEncodedLen = pSigner->bufferLen - pSigner->bufferUsed - encodedLen;
+            returnStatus = SigV4_EncodeURI( pEncoded, encodedLen, &( pEncoded[ encodedLen ] ), &doubleEncodedLen, false, false );
+
+            if( returnStatus == SigV4Success )
+            {
+                ( void ) memmove( pEncoded, &( pEncoded[ encodedLen ] ), doubleEncodedLen );
+                encodedLen = doubleEncodedLen;
+            }
         }
 
         if( returnStatus == SigV4Success )
         {
-            /* Set the output parameter of the number of URI encoded bytes written
-             * to the buffer. */
-            *canonicalURILen = bytesConsumed;
+            pSigner->bufferUsed += encodedLen;
+            pSigner->pathLen += encodedLen;
+        }
+
+        return failSignerOnError( pSigner, returnStatus );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerPushQueryParameter( SigV4Signer_t * pSigner,
+                                                  const char * pKey,
+                                                  size_t keyLen,
+                                                  const char * pValue,
+                                                  size_t valueLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+
+        returnStatus = advanceSigner( pSigner, SIGNER_STATE_QUERY );
+
+        if( returnStatus == SigV4Success )
+        {
+            /* Unlike the query builder, the signer keeps every value of a
+             * repeated parameter, as they are all sent with the request. */
+            returnStatus = insertQueryBuilderEntry( &( pSigner->query ), pKey, keyLen, pValue, valueLen, false );
+        }
+
+        return failSignerOnError( pSigner, returnStatus );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerPushHeader( SigV4Signer_t * pSigner,
+                                          const char * pName,
+                                          size_t nameLen,
+                                          const char * pValue,
+                                          size_t valueLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        char * pHeader = NULL;
+
+        if( ( pName == NULL ) || ( nameLen == 0U ) || ( pValue == NULL ) || ( valueLen == 0U ) )
+        {
+            LogError( ( "Parameter check failed: The header name and value must not be NULL or empty." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            returnStatus = advanceSigner( pSigner, SIGNER_STATE_HEADERS );
+        }
+
+        if( returnStatus == SigV4Success )
+        {
+            /* The header is stored as "name:value\r\n", to be canonicalized
+             * with the other headers once they are all known. */
+            if( ( nameLen + valueLen + 3U ) > ( pSigner->bufferLen - pSigner->bufferUsed ) )
+            {
+                returnStatus = SigV4InsufficientMemory;
+                LogError( ( "Failed to push the header: The signer buffer is full." ) );
+            }
+            else
+            {
+                pHeader = &( pSigner->pBuffer[ pSigner->bufferUsed ] );
+                ( void ) memcpy( pHeader, pName, nameLen );
+                pHeader[ nameLen ] = ':';
+                ( void ) memcpy( &( pHeader[ nameLen + 1U ] ), pValue, valueLen );
+                ( void ) memcpy( &( pHeader[ nameLen + 1U + valueLen ] ), HTTP_REQUEST_LINE_ENDING, HTTP_REQUEST_LINE_ENDING_LEN );
+                pSigner->bufferUsed += nameLen + valueLen + 3U;
+            }
+        }
+
+        return failSignerOnError( pSigner, returnStatus );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerPushPayload( SigV4Signer_t * pSigner,
+                                           const char * pPayload,
+                                           size_t payloadLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        const SigV4CryptoInterface_t * pCryptoInterface = NULL;
+
+        if( ( pPayload == NULL ) && ( payloadLen > 0U ) )
+        {
+            LogError( ( "Parameter check failed: pPayload is NULL." ) );
+            returnStatus = SigV4InvalidParameter;
+        }
+        else
+        {
+            returnStatus = advanceSigner( pSigner, SIGNER_STATE_PAYLOAD );
+        }
+
+        if( ( returnStatus == SigV4Success ) && ( payloadLen > 0U ) )
+        {
+            pCryptoInterface = pSigner->pParams->pCryptoInterface;
+
+            if( pCryptoInterface->hashUpdate( pCryptoInterface->pHashContext,
+                                              ( const uint8_t * ) pPayload,
+                                              payloadLen ) != 0 )
+            {
+                returnStatus = SigV4HashError;
+            }
+        }
+
+        return failSignerOnError( pSigner, returnStatus );
+    }
+
+/*-----------------------------------------------------------*/
+
+    SigV4Status_t SigV4_SignerFinish( SigV4Signer_t * pSigner,
+                                      char * pAuthBuf,
+                                      size_t * authBufLen,
+                                      char ** pSignature,
+                                      size_t * signatureLen )
+    {
+        SigV4Status_t returnStatus = SigV4Success;
+        SigV4Parameters_t signerParams;
+        SigV4HttpParameters_t httpParams = { 0 };
+        size_t queryIndex = 0U, headersIndex = 0U;
+
+        /* Every part of the request is closed, which finalizes the payload digest. */
+        returnStatus = failSignerOnError( pSigner, advanceSigner( pSigner, SIGNER_STATE_FINISHED ) );
+
+        if( returnStatus == SigV4Success )
+        {
+            queryIndex = pSigner->methodLen + pSigner->pathLen;
+            headersIndex = queryIndex + pSigner->query.queryLen;
+
+            /* The path and query are canonicalized, and the payload is hashed,
+             * so only the headers are canonicalized here. */
+            httpParams.flags = signerHttpFlags( pSigner ) &
+                               ( SIGV4_HTTP_PAYLOAD_IS_HASH | SIGV4_HTTP_IS_PRESIGNED_URL | SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG );
+            httpParams.flags |= SIGV4_HTTP_PATH_IS_CANONICAL_FLAG | SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+            httpParams.pHttpMethod = pSigner->pBuffer;
+            httpParams.httpMethodLen = pSigner->methodLen;
+            httpParams.pPath = &( pSigner->pBuffer[ pSigner->methodLen ] );
+            httpParams.pathLen = pSigner->pathLen;
+            httpParams.pQuery = &( pSigner->pBuffer[ queryIndex ] );
+            httpParams.queryLen = pSigner->query.queryLen;
+            httpParams.pHeaders = &( pSigner->pBuffer[ headersIndex ] );
+            httpParams.headersLen = pSigner->bufferUsed - headersIndex;
+            httpParams.pPayload = pSigner->pPayloadDigest;
+            httpParams.payloadLen = pSigner->pParams->pCryptoInterface->hashDigestLen * 2U;
+
+            if( !FLAG_IS_SET( httpParams.flags, SIGV4_HTTP_PAYLOAD_IS_HASH ) &&
+                !FLAG_IS_SET( httpParams.flags, SIGV4_HTTP_IS_PRESIGNED_URL ) )
+            {
+                httpParams.flags |= SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+            }
+
+            signerParams = *( pSigner->pParams );
+            signerParams.pHttpParameters = &httpParams;
+            returnStatus = SigV4_GenerateHTTPAuthorization( &signerParams, pAuthBuf, authBufLen, pSignature, signatureLen );
         }
 
         return returnStatus;
@@ -25,6 +25,10 @@
 /**
  * @file sigv4_quicksort.c
  * @brief Implements an Iterative Quicksort Algorithm for the SigV4 Library.
+ *
+ * Subarrays that are still unsorted after a logarithmic number of partitions
+ * are sorted with heapsort instead, as in introsort, so that sorting takes
+ * O(n log n) comparisons even for adversarial orderings.
  */
 
 #include "sigv4_quicksort.h"
@@ -50,6 +54,16 @@
         ( valueToPop ) = ( stack )[ ( index ) ]; \
     }
 
+/**
+ * @brief Push a subarray and the number of partitions above it to the stack.
+ */
+#define PUSH_SEGMENT( lowIndex, highIndex, segmentDepth, stack, depthStack, index ) \
+    {                                                                               \
+        ( depthStack )[ ( index ) / 2U ] = ( segmentDepth );                        \
+        PUSH_STACK( lowIndex, stack, index );                                       \
+        PUSH_STACK( highIndex, stack, index );                                      \
+    }
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -79,6 +93,37 @@ static void quickSortHelper( void * pArray,
                              size_t itemSize,
                              ComparisonFunc_t comparator );
 
+/**
+ * @brief A helper function to perform heapsort on a subarray.
+ *
+ * @param[in] pArray The array to be sorted.
+ * @param[in] low The low index of the array.
+ * @param[in] high The high index of the array.
+ * @param[in] itemSize The amount of memory per entry in the array.
+ * @param[out] comparator The comparison function to determine if one item is less than another.
+ */
+static void heapSort( void * pArray,
+                      size_t low,
+                      size_t high,
+                      size_t itemSize,
+                      ComparisonFunc_t comparator );
+
+/**
+ * @brief A helper function to move an item down a max-heap until it is not
+ * less than its children.
+ *
+ * @param[in] pHeap The array holding the heap.
+ * @param[in] root The index of the item to move down.
+ * @param[in] numItems The number of items in the heap.
+ * @param[in] itemSize The amount of memory per entry in the array.
+ * @param[out] comparator The comparison function to determine if one item is less than another.
+ */
+static void siftDown( uint8_t * pHeap,
+                      size_t root,
+                      size_t numItems,
+                      size_t itemSize,
+                      ComparisonFunc_t comparator );
+
 /**
  * @brief A helper function to partition a subarray using the last element
  * of the array as the pivot. All items smaller than the pivot end up
@@ -130,12 +175,22 @@ static void quickSortHelper( void * pArray,
 {
     size_t stack[ SIGV4_WORST_CASE_SORT_STACK_SIZE ];
 
+    /* The number of partitions above each subarray on the stack. */
+    size_t depthStack[ SIGV4_WORST_CASE_SORT_STACK_SIZE / 2U ];
+
     /* Low and high are first two items on the stack. Note
      * that we use an intermediary variable for MISRA compliance. */
     size_t top = 0U, lo = low, hi = high;
+    size_t depth = 0U, maxDepth = 0U, count;
 
-    PUSH_STACK( lo, stack, top );
-    PUSH_STACK( hi, stack, top );
+    /* Allow up to 2 * floor(log2(n)) partitions above a subarray, after which
+     * quicksort is taken to be degenerating on this input. */
+    for( count = high - low + 1U; count > 1U; count >>= 1 )
+    {
+        maxDepth += 2U;
+    }
+
+    PUSH_SEGMENT( lo, hi, depth, stack, depthStack, top );
 
     while( top > 0U )
     {
@@ -143,60 +198,124 @@ static void quickSortHelper( void * pArray,
         size_t len1, len2;
         POP_STACK( hi, stack, top );
         POP_STACK( lo, stack, top );
+        depth = depthStack[ top / 2U ];
 
-        partitionIndex = partition( pArray, lo, hi, itemSize, comparator );
-
-        /* Calculate length of the left partition containing items smaller
-         * than the pivot element.
-         * The length is zero if either:
-         * 1. The pivoted item is the smallest in the the array before partitioning.
-         *              OR
-         * 2. The left partition is only of single length which can be treated as
-         * sorted, and thus, of zero length for avoided adding to the stack. */
-        len1 = ( ( partitionIndex != 0U ) && ( ( partitionIndex - 1U ) > lo ) ) ? ( partitionIndex - lo ) : 0U;
-
-        /* Calculate length of the right partition containing items greater than
-         * or equal to the pivot item.
-         * The calculated length is zero if either:
-         * 1. The pivoted item is the greatest in the the array before partitioning.
-         *              OR
-         * 2. The right partition contains only a single length which can be treated as
-         * sorted, and thereby, of zero length to avoid adding to the stack. */
-        len2 = ( ( partitionIndex + 1U ) < hi ) ? ( hi - partitionIndex ) : 0U;
-
-        /* Push the information of the left and right partitions to the stack.
-         * Note: For stack space optimization, the larger of the partitions is pushed
-         * first and the smaller is pushed later so that the smaller part of the tree
-         * is completed first without increasing stack space usage before coming back
-         * to the larger partition. */
-        if( len1 > len2 )
+        if( depth >= maxDepth )
         {
-            PUSH_STACK( lo, stack, top );
-            PUSH_STACK( partitionIndex - 1U, stack, top );
-
-            if( len2 > 0U )
-            {
-                PUSH_STACK( partitionIndex + 1U, stack, top );
-                PUSH_STACK( hi, stack, top );
-            }
+            /* Sort the subarray in O(n log n) comparisons whatever its order. */
+            heapSort( pArray, lo, hi, itemSize, comparator );
         }
         else
         {
-            if( len2 > 0U )
+            partitionIndex = partition( pArray, lo, hi, itemSize, comparator );
+
+            /* Calculate length of the left partition containing items smaller
+             * than the pivot element.
+             * The length is zero if either:
+             * 1. The pivoted item is the smallest in the the array before partitioning.
+             *              OR
+             * 2. The left partition is only of single length which can be treated as
+             * sorted, and thus, of zero length for avoided adding to the stack. */
+            len1 = ( ( partitionIndex != 0U ) && ( ( partitionIndex - 1U ) > lo ) ) ? ( partitionIndex - lo ) : 0U;
+
+            /* Calculate length of the right partition containing items greater than
+             * or equal to the pivot item.
+             * The calculated length is zero if either:
+             * 1. The pivoted item is the greatest in the the array before partitioning.
+             *              OR
+             * 2. The right partition contains only a single length which can be treated as
+             * sorted, and thereby, of zero length to avoid adding to the stack. */
+            len2 = ( ( partitionIndex + 1U ) < hi ) ? ( hi - partitionIndex ) : 0U;
+
+            /* Push the information of the left and right partitions to the stack.
+             * Note: For stack space optimization, the larger of the partitions is pushed
+             * first and the smaller is pushed later so that the smaller part of the tree
+             * is completed first without increasing stack space usage before coming back
+             * to the larger partition. */
+            if( len1 > len2 )
             {
-                PUSH_STACK( partitionIndex + 1U, stack, top );
-                PUSH_STACK( hi, stack, top );
-            }
+                PUSH_SEGMENT( lo, partitionIndex - 1U, depth + 1U, stack, depthStack, top );
 
-            if( len1 > 0U )
+                if( len2 > 0U )
+                {
+                    PUSH_SEGMENT( partitionIndex + 1U, hi, depth + 1U, stack, depthStack, top );
+                }
+            }
+            else
             {
-                PUSH_STACK( lo, stack, top );
-                PUSH_STACK( partitionIndex - 1U, stack, top );
+                if( len2 > 0U )
+                {
+                    PUSH_SEGMENT( partitionIndex + 1U, hi, depth + 1U, stack, depthStack, top );
+                }
+
+                if( len1 > 0U )
+                {
+                    PUSH_SEGMENT( lo, partitionIndex - 1U, depth + 1U, stack, depthStack, top );
+                }
             }
         }
     }
 }
 
+static void heapSort( void * pArray,
+                      size_t low,
+                      size_t high,
+                      size_t itemSize,
+                      ComparisonFunc_t comparator )
+{
+    uint8_t * pHeap;
+    size_t numItems = high - low + 1U, i;
+
+    assert( pArray != NULL );
+    assert( comparator != NULL );
+
+    pHeap = &( ( ( uint8_t * ) pArray )[ low * itemSize ] );
+
+    /* Arrange the subarray into a max-heap. */
+    for( i = numItems / 2U; i > 0U; i-- )
+    {
+        siftDown( pHeap, i - 1U, numItems, itemSize, comparator );
+    }
+
+    /* Repeatedly move the largest item of the heap past its end. */
+    for( i = numItems - 1U; i > 0U; i-- )
+    {
+        swap( pHeap, &( pHeap[ i * itemSize ] ), itemSize );
+        siftDown( pHeap, 0U, i, itemSize, comparator );
+    }
+}
+
+static void siftDown( uint8_t * pHeap,
+                      size_t root,
+                      size_t numItems,
+                      size_t itemSize,
+                      ComparisonFunc_t comparator )
+{
+    size_t parent = root, child = ( 2U * root ) + 1U;
+
+    while( child < numItems )
+    {
+        /* Pick the larger of the two children. */
+        if( ( ( child + 1U ) < numItems ) &&
+            ( comparator( &( pHeap[ child * itemSize ] ), &( pHeap[ ( child + 1U ) * itemSize ] ) ) < 0 ) )
+        {
+            ++child;
+        }
+
+        if( comparator( &( pHeap[ parent * itemSize ] ), &( pHeap[ child * itemSize ] ) ) < 0 )
+        {
+            swap( &( pHeap[ parent * itemSize ] ), &( pHeap[ child * itemSize ] ), itemSize );
+            parent = child;
+            child = ( 2U * parent ) + 1U;
+        }
+        else
+        {
+            /* The heap property holds. */
+            child = numItems;
+        }
+    }
+}
+
 static size_t partition( void * pArray,
                          size_t low,
                          size_t high,
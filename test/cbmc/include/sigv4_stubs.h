@@ -46,10 +46,6 @@ SigV4Status_t scanValue( const char * pDate,
                          size_t lenToRead,
                          SigV4DateTime_t * pDateElements );
 
-SigV4Status_t writeLineToCanonicalRequest( const char * pLine,
-                                           size_t lineLen,
-                                           CanonicalContext_t * pCanonicalContext );
-
 SigV4Status_t SigV4_EncodeURI( const char * pUri,
                                size_t uriLen,
                                char * pCanonicalURI,
@@ -59,11 +55,15 @@ SigV4Status_t SigV4_EncodeURI( const char * pUri,
 
 SigV4Status_t generateCanonicalQuery( const char * pQuery,
                                       size_t queryLen,
+                                      const char * pQueryWrap,
+                                      size_t queryWrapLen,
                                       const bool doubleEncodeEqualsInParmsValues,
                                       CanonicalContext_t * pCanonicalContext );
 
 SigV4Status_t generateCanonicalAndSignedHeaders( const char * pHeaders,
                                                  size_t headersLen,
+                                                 const char * pHeadersWrap,
+                                                 size_t headersWrapLen,
                                                  uint32_t flags,
                                                  CanonicalContext_t * canonicalRequest,
                                                  char ** pSignedHeaders,
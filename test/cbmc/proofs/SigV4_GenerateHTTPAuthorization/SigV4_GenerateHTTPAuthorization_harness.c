@@ -59,6 +59,12 @@ void harness()
         pCryptoInterface->hashInit = nondet_bool() ? NULL : HashInitStub;
         pCryptoInterface->hashUpdate = nondet_bool() ? NULL : HashUpdateStub;
         pCryptoInterface->hashFinal = nondet_bool() ? NULL : HashFinalStub;
+        /* The optional HMAC and vectored hash interfaces are exercised by
+         * the unit tests. */
+        pCryptoInterface->hmacInit = NULL;
+        pCryptoInterface->hmacUpdate = NULL;
+        pCryptoInterface->hmacFinal = NULL;
+        pCryptoInterface->hashUpdateV = NULL;
     }
 
     if( pCredentials != NULL )
@@ -102,6 +108,21 @@ void harness()
         pSigV4Params->pCredentials = pCredentials;
         pSigV4Params->pCryptoInterface = pCryptoInterface;
         pSigV4Params->pHttpParameters = pHttpParams;
+
+        /* The optional caches do not change the canonical request and are
+         * exercised by the unit tests. */
+        pSigV4Params->pSigningKeyCache = NULL;
+        pSigV4Params->pPathCache = NULL;
+        pSigV4Params->pSignedHeadersCache = NULL;
+
+        /* SigV4A requests are rejected without an ECDSA interface; SigV4A
+         * signing is exercised by the unit tests. */
+        pSigV4Params->pEcdsaInterface = NULL;
+        pSigV4Params->pEcdsaKeyCache = NULL;
+
+        /* A precomputed scope only replaces the scope built from the region,
+         * service and algorithm, and is exercised by the unit tests. */
+        pSigV4Params->pPrecomputedScope = NULL;
     }
 
     authBufLen = malloc( sizeof( size_t ) );
@@ -130,23 +130,6 @@ void addToDate( const char formatChar,
     }
 }
 
-SigV4Status_t writeLineToCanonicalRequest( const char * pLine,
-                                           size_t lineLen,
-                                           CanonicalContext_t * pCanonicalContext )
-{
-    SigV4Status_t ret = SigV4InsufficientMemory;
-
-    assert( pCanonicalContext != NULL );
-
-    if( pCanonicalContext->bufRemaining >= ( lineLen + 1U ) )
-    {
-        assert( __CPROVER_w_ok( &( pCanonicalContext->pBufProcessing[ pCanonicalContext->uxCursorIndex ] ), ( lineLen + 1U ) ) );
-        ret = SigV4Success;
-    }
-
-    return ret;
-}
-
 SigV4Status_t SigV4_EncodeURI( const char * pUri,
                                size_t uriLen,
                                char * pCanonicalURI,
@@ -174,6 +157,8 @@ SigV4Status_t SigV4_EncodeURI( const char * pUri,
 
 SigV4Status_t generateCanonicalQuery( const char * pQuery,
                                       size_t queryLen,
+                                      const char * pQueryWrap,
+                                      size_t queryWrapLen,
                                       const bool doubleEncodeEqualsInParmsValues,
                                       CanonicalContext_t * pCanonicalContext )
 {
@@ -196,6 +181,8 @@ SigV4Status_t generateCanonicalQuery( const char * pQuery,
 
 SigV4Status_t generateCanonicalAndSignedHeaders( const char * pHeaders,
                                                  size_t headersLen,
+                                                 const char * pHeadersWrap,
+                                                 size_t headersWrapLen,
                                                  uint32_t flags,
                                                  CanonicalContext_t * pCanonicalContext,
                                                  char ** pSignedHeaders,
@@ -0,0 +1,247 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <functional>
+#include <future>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "unity.h"
+
+/* Include the C++ interface. */
+#include "sigv4_async.hpp"
+#include "sigv4_crypto_sha256.h"
+
+#define PAYLOAD    "Action=ListUsers&Version=2010-05-08"
+
+static SigV4Sha256Context_t sha256Context;
+static SigV4CryptoInterface_t cryptoInterface;
+static sigv4::PayloadDigest expectedDigest;
+
+/*============================ Test Helpers ========================== */
+
+/**
+ * @brief Executor running each job on a new thread, which it joins when
+ * destroyed.
+ */
+class ThreadExecutor
+{
+public:
+    ~ThreadExecutor()
+    {
+        if( thread_.joinable() )
+        {
+            thread_.join();
+        }
+    }
+
+    void operator()( std::function< void() > job )
+    {
+        thread_ = std::thread( std::move( job ) );
+    }
+
+private:
+    std::thread thread_;
+};
+
+/**
+ * @brief Executor running each job inline, and counting the jobs after they
+ * returned, so that it touches its own state after running a job.
+ */
+struct InlineExecutor
+{
+    int * pJobCount;
+
+    void operator()( std::function< void() > job )
+    {
+        job();
+        ( *pJobCount )++;
+    }
+};
+
+static bool digestsEqual( const sigv4::PayloadDigest & digest )
+{
+    return ( digest.status == SigV4Success ) && ( digest.view() == expectedDigest.view() );
+}
+
+#if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine )
+
+/**
+ * @brief Coroutine type that starts eagerly and destroys its frame when done.
+ */
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+        }
+    };
+};
+
+template< typename Submit >
+static DetachedTask awaitDigest( Submit submit,
+                                 std::promise< sigv4::PayloadDigest > * pResult )
+{
+    pResult->set_value( co_await sigv4::HashPayloadAwaitable< Submit >( cryptoInterface, PAYLOAD, std::move( submit ) ) );
+}
+
+#endif /* if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine ) */
+
+/* ============================ UNITY FIXTURES ============================== */
+
+/* Called before each test method. */
+void setUp()
+{
+    SigV4Sha256Context_t context;
+    SigV4CryptoInterface_t referenceInterface;
+
+    ( void ) SigV4_Sha256CryptoInit( &referenceInterface, &context );
+    expectedDigest = sigv4::hashPayload( referenceInterface, PAYLOAD );
+    ( void ) SigV4_Sha256CryptoInit( &cryptoInterface, &sha256Context );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* ======================== Testing hashPayloadAsync ======================== */
+
+/**
+ * @brief Test that a payload hashed on a new thread has the digest of
+ * hashPayload().
+ */
+void test_HashPayloadAsync_Future()
+{
+    std::future< sigv4::PayloadDigest > digest = sigv4::hashPayloadAsync( cryptoInterface, PAYLOAD );
+
+    TEST_ASSERT_TRUE( digestsEqual( digest.get() ) );
+}
+
+/**
+ * @brief Test that the completion callback receives the digest, whether the
+ * executor runs the job on another thread or inline.
+ */
+void test_HashPayloadAsync_Callback()
+{
+    sigv4::PayloadDigest threadDigest;
+    sigv4::PayloadDigest inlineDigest;
+    int jobCount = 0;
+
+    {
+        ThreadExecutor executor;
+
+        sigv4::hashPayloadAsync( cryptoInterface, PAYLOAD, std::ref( executor ),
+                                 [ &threadDigest ]( const sigv4::PayloadDigest & digest )
+                                 {
+                                     threadDigest = digest;
+                                 } );
+    }
+
+    sigv4::hashPayloadAsync( cryptoInterface, PAYLOAD, InlineExecutor { &jobCount },
+                             [ &inlineDigest ]( const sigv4::PayloadDigest & digest )
+                             {
+                                 inlineDigest = digest;
+                             } );
+
+    TEST_ASSERT_TRUE( digestsEqual( threadDigest ) );
+    TEST_ASSERT_TRUE( digestsEqual( inlineDigest ) );
+    TEST_ASSERT_EQUAL( 1, jobCount );
+}
+
+/* ====================== Testing HashPayloadAwaitable ====================== */
+
+#if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine )
+
+/**
+ * @brief Test that an awaiting coroutine is resumed with the digest when the
+ * job runs on another thread.
+ */
+void test_HashPayloadAwaitable_Thread()
+{
+    std::promise< sigv4::PayloadDigest > result;
+    std::future< sigv4::PayloadDigest > digest = result.get_future();
+    ThreadExecutor executor;
+
+    awaitDigest( std::ref( executor ), &result );
+
+    TEST_ASSERT_TRUE( digestsEqual( digest.get() ) );
+}
+
+/**
+ * @brief Test that a job run inline does not resume the coroutine while the
+ * executor is still running, as the coroutine would destroy the awaitable
+ * holding the executor.
+ */
+void test_HashPayloadAwaitable_Inline()
+{
+    std::promise< sigv4::PayloadDigest > result;
+    std::future< sigv4::PayloadDigest > digest = result.get_future();
+    int jobCount = 0;
+
+    awaitDigest( InlineExecutor { &jobCount }, &result );
+
+    TEST_ASSERT_EQUAL( 1, jobCount );
+    TEST_ASSERT_TRUE( digestsEqual( digest.get() ) );
+}
+
+#endif /* if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine ) */
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    UNITY_BEGIN();
+
+    RUN_TEST( test_HashPayloadAsync_Future );
+    RUN_TEST( test_HashPayloadAsync_Callback );
+    #if defined( __cpp_impl_coroutine ) && defined( __cpp_lib_coroutine )
+        RUN_TEST( test_HashPayloadAwaitable_Thread );
+        RUN_TEST( test_HashPayloadAwaitable_Inline );
+    #endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,297 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "unity.h"
+
+/* Include the C++ interface. */
+#include "sigv4_replay.hpp"
+
+#define DATE                "20210811T001558Z"
+#define DATE_SECONDS        1628640958U
+
+#define SIGNATURE           "20fdb62349e7104f9ce4184a444fedfbd19e40a5e31d57d433689c5a5138fa99"
+#define OTHER_SIGNATURE     "5ed87bc35ab9711c8d1784eec57bd8dd531520d367c57c2cbd425e6059a4aaf1"
+
+#define WINDOW_SECONDS      60U
+#define THREAD_COUNT        4U
+#define SIGNATURE_COUNT     256U
+
+/*============================ Test Helpers ========================== */
+
+/* The x-amz-date of @p seconds since the Unix epoch. */
+static std::string isoDate( std::time_t seconds )
+{
+    char date[ SIGV4_ISO_STRING_LEN + 1U ] = {};
+
+    TEST_ASSERT_EQUAL( SIGV4_ISO_STRING_LEN, std::strftime( date, sizeof( date ), "%Y%m%dT%H%M%SZ", std::gmtime( &seconds ) ) );
+
+    return std::string( date );
+}
+
+static std::string signatureOf( std::size_t index )
+{
+    return "signature-" + std::to_string( index );
+}
+
+static void assertEpochSeconds( std::string_view date,
+                                std::uint64_t expected )
+{
+    std::uint64_t seconds = 0U;
+
+    TEST_ASSERT_TRUE( sigv4::detail::iso8601ToEpochSeconds( date, &seconds ) );
+    TEST_ASSERT_EQUAL_UINT64( expected, seconds );
+}
+
+static void assertInvalidDate( std::string_view date )
+{
+    std::uint64_t seconds = 0U;
+
+    TEST_ASSERT_FALSE( sigv4::detail::iso8601ToEpochSeconds( date, &seconds ) );
+}
+
+/* ============================ UNITY FIXTURES ============================== */
+
+/* Called before each test method. */
+void setUp()
+{
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* ===================== Testing iso8601ToEpochSeconds ====================== */
+
+/**
+ * @brief Test the conversion of dates, including leap days, and the rejection
+ * of malformed dates and of dates that do not exist.
+ */
+void test_Iso8601ToEpochSeconds()
+{
+    assertEpochSeconds( "19700101T000000Z", 0U );
+    assertEpochSeconds( DATE, DATE_SECONDS );
+    assertEpochSeconds( "20000229T000000Z", 951782400U );
+    assertEpochSeconds( "20240229T235959Z", 1709251199U );
+    assertEpochSeconds( "21000301T000000Z", 4107542400U );
+
+    /* Leap days only exist in leap years. */
+    assertInvalidDate( "20230229T000000Z" );
+    assertInvalidDate( "21000229T000000Z" );
+    assertInvalidDate( "20240230T000000Z" );
+    assertInvalidDate( "20230431T000000Z" );
+    assertInvalidDate( "20230132T000000Z" );
+    assertInvalidDate( "20230100T000000Z" );
+    assertInvalidDate( "20231301T000000Z" );
+    assertInvalidDate( "20230001T000000Z" );
+    assertInvalidDate( "20230101T240000Z" );
+    assertInvalidDate( "20230101T006000Z" );
+    assertInvalidDate( "20230101T000060Z" );
+    assertInvalidDate( "19691231T235959Z" );
+
+    /* Malformed dates. */
+    assertInvalidDate( "" );
+    assertInvalidDate( "20210811T001558" );
+    assertInvalidDate( "20210811T001558ZZ" );
+    assertInvalidDate( "20210811 001558Z" );
+    assertInvalidDate( "20210811T001558z" );
+    assertInvalidDate( "2021O811T001558Z" );
+    assertInvalidDate( "20210811T00155-Z" );
+}
+
+/* ========================== Testing ReplayIndex =========================== */
+
+/**
+ * @brief Test that a signature is fresh the first time it is recorded for a
+ * date, and replayed afterwards.
+ */
+void test_ReplayIndex_Fresh_Then_Replayed()
+{
+    sigv4::ReplayIndex index( WINDOW_SECONDS, 64U );
+    const std::string nextDate = isoDate( DATE_SECONDS + 1U );
+
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, DATE, DATE_SECONDS ) );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    TEST_ASSERT_TRUE( index.contains( SIGNATURE, DATE, DATE_SECONDS ) );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Replayed );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS + 30U ) == sigv4::ReplayStatus::Replayed );
+
+    /* Other signatures, and other dates, are recorded apart. */
+    TEST_ASSERT_FALSE( index.contains( OTHER_SIGNATURE, DATE, DATE_SECONDS ) );
+    TEST_ASSERT_TRUE( index.insert( OTHER_SIGNATURE, DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, nextDate, DATE_SECONDS ) );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, nextDate, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, nextDate, DATE_SECONDS ) == sigv4::ReplayStatus::Replayed );
+}
+
+/**
+ * @brief Test that dates further than the window from now, on either side,
+ * and malformed dates are neither recorded nor found.
+ */
+void test_ReplayIndex_Outside_Window()
+{
+    sigv4::ReplayIndex index( WINDOW_SECONDS, 64U );
+
+    /* The bounds of the window are inside it. */
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS - WINDOW_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS + WINDOW_SECONDS ) == sigv4::ReplayStatus::Replayed );
+
+    /* The date is too far in the future, then too far in the past. */
+    TEST_ASSERT_TRUE( index.insert( OTHER_SIGNATURE, DATE, DATE_SECONDS - WINDOW_SECONDS - 1U ) == sigv4::ReplayStatus::OutsideWindow );
+    TEST_ASSERT_TRUE( index.insert( OTHER_SIGNATURE, DATE, DATE_SECONDS + WINDOW_SECONDS + 1U ) == sigv4::ReplayStatus::OutsideWindow );
+    TEST_ASSERT_FALSE( index.contains( OTHER_SIGNATURE, DATE, DATE_SECONDS ) );
+
+    /* A recorded signature is not found once its date left the window. */
+    TEST_ASSERT_TRUE( index.contains( SIGNATURE, DATE, DATE_SECONDS + WINDOW_SECONDS ) );
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, DATE, DATE_SECONDS + WINDOW_SECONDS + 1U ) );
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, DATE, DATE_SECONDS - WINDOW_SECONDS - 1U ) );
+
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, "20210811T001558", DATE_SECONDS ) == sigv4::ReplayStatus::OutsideWindow );
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, "20210230T001558Z", DATE_SECONDS ) == sigv4::ReplayStatus::OutsideWindow );
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, "20210811T001558", DATE_SECONDS ) );
+}
+
+/**
+ * @brief Test that a second is full once the probed slots are taken, while
+ * its recorded signatures are still found and other seconds still accept
+ * signatures.
+ */
+void test_ReplayIndex_Full()
+{
+    sigv4::ReplayIndex index( WINDOW_SECONDS, sigv4::ReplayIndex::kMaxProbes );
+    const std::string nextDate = isoDate( DATE_SECONDS + 1U );
+
+    for( std::size_t i = 0U; i < sigv4::ReplayIndex::kMaxProbes; i++ )
+    {
+        TEST_ASSERT_TRUE( index.insert( signatureOf( i ), DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    }
+
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Full );
+    TEST_ASSERT_FALSE( index.contains( SIGNATURE, DATE, DATE_SECONDS ) );
+
+    for( std::size_t i = 0U; i < sigv4::ReplayIndex::kMaxProbes; i++ )
+    {
+        TEST_ASSERT_TRUE( index.contains( signatureOf( i ), DATE, DATE_SECONDS ) );
+        TEST_ASSERT_TRUE( index.insert( signatureOf( i ), DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Replayed );
+    }
+
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, nextDate, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+}
+
+/**
+ * @brief Test that the bucket of a second is reused by the second one lap of
+ * the wheel later, without being cleared.
+ */
+void test_ReplayIndex_Bucket_Reused_Next_Lap()
+{
+    /* A window of 1 second takes a wheel of 4 seconds. */
+    sigv4::ReplayIndex index( 1U, sigv4::ReplayIndex::kMaxProbes );
+    const std::string nextLapDate = isoDate( DATE_SECONDS + 4U );
+
+    for( std::size_t i = 0U; i < sigv4::ReplayIndex::kMaxProbes; i++ )
+    {
+        TEST_ASSERT_TRUE( index.insert( signatureOf( i ), DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh );
+    }
+
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Full );
+
+    /* The slots of the earlier lap are free for the seconds of the next. */
+    for( std::size_t i = 0U; i < sigv4::ReplayIndex::kMaxProbes; i++ )
+    {
+        TEST_ASSERT_FALSE( index.contains( signatureOf( i ), nextLapDate, DATE_SECONDS + 4U ) );
+        TEST_ASSERT_TRUE( index.insert( signatureOf( i ), nextLapDate, DATE_SECONDS + 4U ) == sigv4::ReplayStatus::Fresh );
+    }
+
+    TEST_ASSERT_TRUE( index.insert( SIGNATURE, nextLapDate, DATE_SECONDS + 4U ) == sigv4::ReplayStatus::Full );
+    TEST_ASSERT_TRUE( index.insert( signatureOf( 0U ), nextLapDate, DATE_SECONDS + 4U ) == sigv4::ReplayStatus::Replayed );
+}
+
+/**
+ * @brief Test that when threads record the same signatures concurrently,
+ * exactly one insert of each signature is fresh.
+ */
+void test_ReplayIndex_Concurrent_Inserts()
+{
+    sigv4::ReplayIndex index( WINDOW_SECONDS, 1024U );
+    std::array< std::atomic< std::size_t >, SIGNATURE_COUNT > freshCounts {};
+    std::atomic< bool > isStarted { false };
+    std::vector< std::thread > threads;
+
+    for( std::size_t t = 0U; t < THREAD_COUNT; t++ )
+    {
+        threads.emplace_back( [ &index, &freshCounts, &isStarted ]()
+                              {
+                                  while( !isStarted.load( std::memory_order_acquire ) )
+                                  {
+                                      std::this_thread::yield();
+                                  }
+
+                                  for( std::size_t i = 0U; i < SIGNATURE_COUNT; i++ )
+                                  {
+                                      if( index.insert( signatureOf( i ), DATE, DATE_SECONDS ) == sigv4::ReplayStatus::Fresh )
+                                      {
+                                          freshCounts[ i ].fetch_add( 1U, std::memory_order_relaxed );
+                                      }
+                                  }
+                              } );
+    }
+
+    isStarted.store( true, std::memory_order_release );
+
+    for( std::thread & thread : threads )
+    {
+        thread.join();
+    }
+
+    for( std::size_t i = 0U; i < SIGNATURE_COUNT; i++ )
+    {
+        TEST_ASSERT_EQUAL( 1U, freshCounts[ i ].load() );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    UNITY_BEGIN();
+
+    RUN_TEST( test_Iso8601ToEpochSeconds );
+    RUN_TEST( test_ReplayIndex_Fresh_Then_Replayed );
+    RUN_TEST( test_ReplayIndex_Outside_Window );
+    RUN_TEST( test_ReplayIndex_Full );
+    RUN_TEST( test_ReplayIndex_Bucket_Reused_Next_Lap );
+    RUN_TEST( test_ReplayIndex_Concurrent_Inserts );
+
+    return UNITY_END();
+}
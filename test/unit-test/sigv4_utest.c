@@ -25,6 +25,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <openssl/sha.h>
+#include <openssl/evp.h>
+#include <openssl/core_names.h>
 
 #include "unity.h"
 
@@ -32,6 +34,9 @@
 #include "sigv4.h"
 /* We include the internal SigV4 macros so that they don't have to be redefined for these tests. */
 #include "sigv4_internal.h"
+#include "sigv4_quicksort.h"
+#include "sigv4_crypto_sha256.h"
+#include "sigv4_crypto_openssl.h"
 
 #define STR_LIT_LEN( LIT )    ( sizeof( LIT ) - 1U )
 
@@ -80,9 +85,18 @@
 #define HEADERS                                               "Host: iam.amazonaws.com\r\nContent-Type: application/x-www-form-urlencoded; charset=utf-8\r\nX-Amz-Date: "DATE "\r\n\r\n"
 #define HEADERS_LENGTH                                        ( sizeof( HEADERS ) - 1U )
 #define PRECANON_HEADER                                       "content-type:application/json;\nhost:iam.amazonaws.com\n"
+#define UPPERCASE_HEADERS                                     "HOST: iam.amazonaws.com\r\nCONTENT-TYPE: application/x-www-form-urlencoded; charset=utf-8\r\nX-AMZ-DATE: "DATE "\r\n\r\n"
+#define HEADERS_WITH_UNKNOWN_NAMES                            "Host: iam.amazonaws.com\r\nPost: a\r\nContent-Type: application/json\r\nAccept: b\r\nX-Amz-Date: "DATE "\r\n\r\n"
+#define HEADERS_WITH_PREFIX_NAMES                             "X-Amz-Date: "DATE "\r\nX-Ab: a\r\nHost: iam.amazonaws.com\r\nX-A: b\r\n\r\n"
+#define HEADERS_WITH_PREFIX_NAMES_REVERSED                    "X-A: b\r\nHost: iam.amazonaws.com\r\nX-Ab: a\r\nX-Amz-Date: "DATE "\r\n\r\n"
+#define TRIMMED_HEADERS                                       "host:iam.amazonaws.com\r\ncontent-type:application/x-www-form-urlencoded; charset=utf-8\r\nx-amz-date:"DATE "\r\n\r\n"
+#define CANONICAL_HEADERS                                     "content-type:application/x-www-form-urlencoded; charset=utf-8\nhost:iam.amazonaws.com\nx-amz-date:"DATE "\n"
 #define HEADERS_WITH_X_AMZ_CONTENT_SHA256                     "Host: iam.amazonaws.com\r\nContent-Type: application/x-www-form-urlencoded; charset=utf-8\r\nx-amz-content-sha256: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\r\nX-Amz-Date: "DATE "\r\n\r\n"
 #define HEADERS_WITHOUT_X_AMZ_CONTENT_SHA256                  "Host: iam.amazonaws.com\r\nContent-Type: application/x-www-form-urlencoded; charset=utf-8\r\nx-amz-content-sha512: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\r\nX-Amz-Date: "DATE "\r\n\r\n"
 
+/* The hex-encoded SHA-256 digest of an empty payload. */
+#define EMPTY_PAYLOAD_DIGEST                                  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+
 /* Header data containing leading, trailing and sequential trimmable spaces. */
 #define HEADERS_WITH_TRIMMABLE_SPACES                         "  Header-1 :  Value \t - \t 1  \r\n"
 
@@ -114,23 +128,23 @@
 /* Insufficient memory parameters for SIGV4_PROCESSING_BUFFER_LENGTH=350. In the comments below,
  * + means concatenation, OOM means "Out of Memory", LF means newline character */
 
-/* HTTP method + URI-encoded variant of this string must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
+/* URI-encoded variant of this string must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
 #define PATH_FIRST_ENCODE_OOM                                                           \
     "/path-to-victory-will-soon-come-to-a-close-and-then-we-can-finally-eat-our-errors" \
     "-even-though-this-is-not-a-good-practice-at-all-so-obviously-this-is-just-a-joke-" \
     "so-why-are-you-still-reading-this-i-mean-im-crazy-enough-to-type-this-very-"       \
     "long-string-instead-of-using-a-lorem-ipsum-website-maybe-i-should-be-a-comedian-"  \
     "instead-be-a-programmer-really"
-/* HTTP method + URI-encoded variant of this string + \n must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
+/* URI-encoded variant of this string + \n must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
 #define PATH_FIRST_ENCODE_AND_LF_OOM                                                    \
     "/path-to-victory-will-soon-come-to-a-close-and-then-we-can-finally-eat-our-errors" \
     "-even-though-this-is-not-a-good-practice-at-all-so-obviously-this-is-just-a-joke-" \
     "so-why-are-you-still-reading-this-i-mean-im-crazy-enough-to-type-this-very-xchjsd" \
     "chjdsvchjdvhjcdhjsckhdsvchdks-sfdghfdfahgsdhfgjsgfjkgfsdgkdgfdjkgdggdjfsjkgjksgkj" \
     "sdgfdfgdshfgsjdhfdhfkhdkfhjdgfgdfgdfg-sdvfdvfhdvfhvdhfvdsfdsgfgdsjfgjdsfqwertyuio" \
-    "pasdfghwsshasdfghjk"
+    "pasdfghwsshasdfghjklzxc"
 
-/* HTTP method + this URI-encoded variant of this string + double-encoded variant must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
+/* This URI-encoded variant of this string + double-encoded variant must be greater than SIGV4_PROCESSING_BUFFER_LENGTH. */
 #define PATH_SECOND_ENCODE_OOM    "/path-to-victory-will-soon-come-to-a-close-and-then-we-can-finally-eat-our-errors-even-though-this-is-not-a-good-practice-at-all-so-obviously-this-is-just-a-joke-so-why-are-you-still-reading-this-i-mean-im-crazy-enough-to-type-this-very-long-string-instead-of-using-a-lorem-ipsum-website-maybe-i-should-be-a-comedian-instead"
 
 /* Encoding query string field in canonicalized query string causes OOM. */
@@ -189,6 +203,36 @@ static size_t signatureLen;
 
 /* ============================ HELPER FUNCTIONS ============================ */
 
+/**
+ * @brief Compare two integers, for testing quickSort().
+ */
+/* Number of comparisons made by cmpInteger(), to bound the work of quickSort(). */
+static size_t cmpIntegerCount = 0U;
+
+static int32_t cmpInteger( const void * pFirstVal,
+                           const void * pSecondVal )
+{
+    cmpIntegerCount++;
+
+    return *( ( const int32_t * ) pFirstVal ) - *( ( const int32_t * ) pSecondVal );
+}
+
+/**
+ * @brief Sort an array with quickSort(), and verify that it is sorted.
+ */
+static void sortAndVerify( int32_t * pArray,
+                           size_t numItems )
+{
+    size_t i;
+
+    quickSort( pArray, numItems, sizeof( int32_t ), cmpInteger );
+
+    for( i = 1U; i < numItems; i++ )
+    {
+        TEST_ASSERT_TRUE( pArray[ i - 1U ] <= pArray[ i ] );
+    }
+}
+
 /**
  * @brief Format a date input with SigV4_AwsIotDateToIso8601(), and verify the
  * output against the expected result, if no errors occurred.
@@ -313,6 +357,166 @@ static int32_t hash_final_failable( void * pHashContext,
     return ret;
 }
 
+/*==================== Native HMAC Implementation of Crypto Interface ===================== */
+
+/* The OpenSSL adapter, whose HMAC the failable native HMAC functions call. */
+static SigV4CryptoInterface_t opensslHmac;
+static SigV4OpenSSLContext_t opensslHmacContext;
+
+static size_t hmacInitCalledCount = 0U, hmacInitCallToFail = SIZE_MAX;
+static size_t hmacUpdateCalledCount = 0U, hmacUpdateCallToFail = SIZE_MAX;
+static size_t hmacFinalCalledCount = 0U, hmacFinalCallToFail = SIZE_MAX;
+
+static int32_t hmac_init_failable( void * pHmacContext,
+                                   const uint8_t * pKey,
+                                   size_t keyLen )
+{
+    int32_t ret = 1;
+
+    if( ( hmacInitCalledCount++ != hmacInitCallToFail ) &&
+        ( opensslHmac.hmacInit( pHmacContext, pKey, keyLen ) == 0 ) )
+    {
+        ret = 0;
+    }
+
+    return ret;
+}
+
+static int32_t hmac_update_failable( void * pHmacContext,
+                                     const uint8_t * pInput,
+                                     size_t inputLen )
+{
+    int32_t ret = 1;
+
+    if( ( hmacUpdateCalledCount++ != hmacUpdateCallToFail ) &&
+        ( opensslHmac.hmacUpdate( pHmacContext, pInput, inputLen ) == 0 ) )
+    {
+        ret = 0;
+    }
+
+    return ret;
+}
+
+static int32_t hmac_final_failable( void * pHmacContext,
+                                    uint8_t * pOutput,
+                                    size_t outputLen )
+{
+    int32_t ret = 1;
+
+    if( ( hmacFinalCalledCount++ != hmacFinalCallToFail ) &&
+        ( opensslHmac.hmacFinal( pHmacContext, pOutput, outputLen ) == 0 ) )
+    {
+        ret = 0;
+    }
+
+    return ret;
+}
+
+/*==================== OpenSSL Based implementation of ECDSA Interface ===================== */
+
+static SigV4OpenSSLEcdsaContext_t opensslEcdsaContext;
+static SigV4EcdsaInterface_t opensslEcdsa;
+static uint8_t ecdsaSignedDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+static uint8_t ecdsaLoadedKey[ SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ];
+static size_t ecdsaLoadKeyCalledCount = 0U, ecdsaLoadKeyCallToFail = SIZE_MAX;
+static size_t ecdsaSignCalledCount = 0U, ecdsaSignCallToFail = SIZE_MAX;
+
+/* Length reported for the signatures, unless SIZE_MAX. */
+static size_t ecdsaSignatureLen = SIZE_MAX;
+
+static int32_t ecdsa_load_key_failable( void * pEcdsaContext,
+                                        const uint8_t * pPrivateKey,
+                                        size_t privateKeyLen )
+{
+    int32_t ret = 1;
+
+    memcpy( ecdsaLoadedKey, pPrivateKey, privateKeyLen );
+
+    if( ecdsaLoadKeyCalledCount++ != ecdsaLoadKeyCallToFail )
+    {
+        ret = opensslEcdsa.loadKey( pEcdsaContext, pPrivateKey, privateKeyLen );
+    }
+
+    return ret;
+}
+
+static int32_t ecdsa_sign_failable( void * pEcdsaContext,
+                                    const uint8_t * pDigest,
+                                    size_t digestLen,
+                                    uint8_t * pSignature,
+                                    size_t * pSignatureLen )
+{
+    int32_t ret = 1;
+
+    memcpy( ecdsaSignedDigest, pDigest, digestLen );
+
+    if( ecdsaSignCalledCount++ != ecdsaSignCallToFail )
+    {
+        ret = opensslEcdsa.sign( pEcdsaContext, pDigest, digestLen, pSignature, pSignatureLen );
+    }
+
+    if( ecdsaSignatureLen != SIZE_MAX )
+    {
+        *pSignatureLen = ecdsaSignatureLen;
+    }
+
+    return ret;
+}
+
+/* Number of HMACs whose output is replaced with one above the P-256 order. */
+static size_t hmacOutOfRangeCount = 0U;
+
+static int32_t hmac_final_out_of_range( void * pHmacContext,
+                                        uint8_t * pOutput,
+                                        size_t outputLen )
+{
+    int32_t ret = hmac_final_failable( pHmacContext, pOutput, outputLen );
+
+    if( hmacFinalCalledCount <= hmacOutOfRangeCount )
+    {
+        memset( pOutput, 0xFF, outputLen );
+    }
+
+    return ret;
+}
+
+/* Replaces the HMAC output with a candidate whose low bytes are all 0xFF. */
+static int32_t hmac_final_carry( void * pHmacContext,
+                                 uint8_t * pOutput,
+                                 size_t outputLen )
+{
+    int32_t ret = hmac_final_failable( pHmacContext, pOutput, outputLen );
+
+    memset( pOutput, 0xFF, outputLen );
+    pOutput[ 0 ] = 0U;
+
+    return ret;
+}
+
+/*==================== Vectored Implementation of Crypto Interface ===================== */
+
+static size_t hashUpdateVCalledCount = 0U, hashUpdateVCallToFail = SIZE_MAX;
+
+static int32_t sha256_update_v_failable( void * pHashContext,
+                                         const SigV4IoVec_t * pSegments,
+                                         size_t segmentCount )
+{
+    int32_t ret = 0;
+    size_t i;
+
+    if( hashUpdateVCalledCount++ == hashUpdateVCallToFail )
+    {
+        ret = 1;
+    }
+
+    for( i = 0U; ( ret == 0 ) && ( i < segmentCount ); i++ )
+    {
+        ret = valid_sha256_update( pHashContext, ( const uint8_t * ) pSegments[ i ].pData, pSegments[ i ].dataLen );
+    }
+
+    return ret;
+}
+
 /*============================ Test Helpers ========================== */
 
 static void resetFailableHashParams()
@@ -735,136 +939,1307 @@ void test_SigV4_GenerateHTTPAuthorization_Happy_Paths()
     TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
 }
 
-/* Test the API for handling corner cases of sorting the Query Parameters (when generating Canonical Query) */
-void test_SigV4_GenerateHTTPAuthorization_Sorting_Query_Params_Corner_Cases()
+/**
+ * @brief Test that a signing key cache supplied by the application is populated
+ * on the first call and reused while the credential scope is unchanged.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Signing_Key_Cache()
 {
     SigV4Status_t returnStatus;
+    SigV4SigningKeyCache_t signingKeyCache;
+    const char * pExpectedSignature = "20fdb62349e7104f9ce4184a444fedfbd19e40a5e31d57d433689c5a5138fa99";
+    char longAccessKeyId[ SIGV4_SIGNING_KEY_CACHE_ID_LENGTH ];
+    char rotatedSecretKey[ SECRET_KEY_LEN ];
+    char rotatedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+
+    memset( &signingKeyCache, 0, sizeof( signingKeyCache ) );
+    params.pSigningKeyCache = &signingKeyCache;
 
-    /* Test when the query string contains query parameters with exactly matching names. */
-    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS;
-    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS );
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH, signingKeyCache.signingKeyLen );
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( ACCESS_KEY_ID "/20210811/" REGION "/" SERVICE ), signingKeyCache.scopeIdLen );
+    TEST_ASSERT_EQUAL_MEMORY( ACCESS_KEY_ID "/20210811/" REGION "/" SERVICE, signingKeyCache.pScopeId, signingKeyCache.scopeIdLen );
 
-    /* Test when the query string contains query parameters which do not match in name length but match in
-     * the name data for the common length between 2 parameters. */
-    params.pHttpParameters->pQuery = QUERY_WITH_MATCHING_PARAM_PREFIX;
-    params.pHttpParameters->queryLen = strlen( QUERY_WITH_MATCHING_PARAM_PREFIX );
+    /* A cache hit is observable through a signature computed with the cached
+     * key, once that key is altered. */
+    signingKeyCache.pSigningKey[ 0 ] ^= 1U;
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
-
-    /* Test when the query string contains query parameters with exactly matching parameter names as well
-     * as matching values for those parameters. The query values of matching parameters differ in length though. */
-    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_1;
-    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_1 );
+    TEST_ASSERT_FALSE( memcmp( pExpectedSignature, signature, signatureLen ) == 0 );
+    signingKeyCache.pSigningKey[ 0 ] ^= 1U;
+
+    /* A secret rotated under the same access key ID misses the cache, whether
+     * its length differs or not. */
+    memcpy( rotatedSecretKey, SECRET_KEY, SECRET_KEY_LEN );
+    rotatedSecretKey[ 0 ] = 'x';
+    creds.pSecretAccessKey = rotatedSecretKey;
+    params.pSigningKeyCache = NULL;
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
-    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_2;
-    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_2 );
+    memcpy( rotatedSignature, signature, sizeof( rotatedSignature ) );
+    params.pSigningKeyCache = &signingKeyCache;
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( rotatedSignature, signature, sizeof( rotatedSignature ) );
 
-    /* Test when the query string contains query parameters with exactly matching parameter names as well
-     * as matching values for those parameters. The query values of matching parameters differ in length though. */
-    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_VALUES;
-    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_VALUES );
+    creds.pSecretAccessKey = SECRET_KEY_LONGER_THAN_HASH_BLOCK;
+    creds.secretAccessKeyLen = SECRET_KEY_LONGER_THAN_HASH_BLOCK_LEN;
+    pExpectedSignature = "842f14580889c0d25727eee03310b17dcb3811a2e915172ba2f0db42a6c5b0e8";
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
-}
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+    TEST_ASSERT_EQUAL( SECRET_KEY_LONGER_THAN_HASH_BLOCK_LEN, signingKeyCache.secretAccessKeyLen );
 
-/* Test that the library can handle HTTP headers data containing trimmable spaces. */
-void test_SigV4_GenerateAuthorization_Headers_With_Trimmable_Spaces()
-{
-    params.pHttpParameters->pHeaders = HEADERS_WITH_TRIMMABLE_SPACES;
-    params.pHttpParameters->headersLen = strlen( HEADERS_WITH_TRIMMABLE_SPACES );
+    /* The secret is hashed right after the payload and the canonical request,
+     * and a failure to hash it leaves the cache untouched. */
+    resetFailableHashParams();
+    finalHashCallToFail = 2U;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4HashError, returnStatus );
+    TEST_ASSERT_EQUAL( SECRET_KEY_LONGER_THAN_HASH_BLOCK_LEN, signingKeyCache.secretAccessKeyLen );
+    finalHashCallToFail = SIZE_MAX;
 
-    const char * pExpectedSignature = "41dfba73a35f6cff18fc02e991f6499d4e0fb1209a4d42e9155a623ae0f36831";
+    /* A different credential scope misses the cache and replaces its entry. */
+    params.pService = S3_SERVICE_NAME;
+    params.serviceLen = S3_SERVICE_NAME_LEN;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( ACCESS_KEY_ID "/20210811/" REGION "/" S3_SERVICE_NAME, signingKeyCache.pScopeId, signingKeyCache.scopeIdLen );
 
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
-    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
-    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+    /* So does a credential scope of the same length. */
+    params.pRegion = "us-west-1";
+    params.regionLen = STR_LIT_LEN( "us-west-1" );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( ACCESS_KEY_ID "/20210811/us-west-1/" S3_SERVICE_NAME, signingKeyCache.pScopeId, signingKeyCache.scopeIdLen );
+
+    /* A credential scope that does not fit in the cache bypasses it. */
+    memset( &signingKeyCache, 0, sizeof( signingKeyCache ) );
+    memset( longAccessKeyId, ( int ) 'A', sizeof( longAccessKeyId ) );
+    creds.pAccessKeyId = longAccessKeyId;
+    creds.accessKeyIdLen = sizeof( longAccessKeyId );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, signingKeyCache.signingKeyLen );
 }
 
-/* Test that the library can handle query string that contains empty values for its parameters. */
-void test_SigV4_GenerateAuthorization_Query_Strings_Special_Cases()
+/**
+ * @brief Test that a path cache supplied by the application yields the same
+ * signatures as encoding the path on every call, and evicts the least
+ * recently used path when full.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Path_Cache()
 {
-    params.pHttpParameters->pQuery = QUERY_STRING_NO_PARAM_VALUE;
-    params.pHttpParameters->queryLen = strlen( QUERY_STRING_NO_PARAM_VALUE );
-
-    const char * pExpectedSignature = "9eed8862e36ac9861f0ea0be863ef6d825de854c8eb9da072637dcc64e5ef919";
-
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
-    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
-    printf( "%.*s\n", ( int ) ( authBufLen ), authBuf );
-    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+    SigV4Status_t returnStatus;
+    SigV4PathCache_t pathCache;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char shortPath[ 2 ] = { '/', 'a' };
+    char longPath[ SIGV4_PATH_CACHE_PATH_LENGTH + 1U ];
+    size_t i;
 
-    params.pHttpParameters->pQuery = QUERY_STRING_WITH_TRAILING_N_LEADING_AMPERSAND;
-    params.pHttpParameters->queryLen = strlen( QUERY_STRING_WITH_TRAILING_N_LEADING_AMPERSAND );
+    params.pHttpParameters->pPath = PRECANON_PATH;
+    params.pHttpParameters->pathLen = STR_LIT_LEN( PRECANON_PATH );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
 
-    pExpectedSignature = "576a0348d54591e15bed920586936f9263656470197adf7ce79c5fc8ef44d825";
+    memset( &pathCache, 0, sizeof( pathCache ) );
+    params.pPathCache = &pathCache;
 
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
-    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
-    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+    /* The first call populates the cache, and the second one hits it. */
+    for( i = 1U; i <= 2U; i++ )
+    {
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+        TEST_ASSERT_EQUAL( i, pathCache.useCounter );
+        TEST_ASSERT_EQUAL( i, pathCache.entries[ 0 ].lastUsed );
+    }
 
-    params.pHttpParameters->pQuery = QUERY_STRING_WITH_REPEATED_AMPERSAND;
-    params.pHttpParameters->queryLen = strlen( QUERY_STRING_WITH_REPEATED_AMPERSAND );
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( "/path-%252520" ), pathCache.entries[ 0 ].canonicalPathLen );
+    TEST_ASSERT_EQUAL_MEMORY( "/path-%252520", pathCache.entries[ 0 ].pCanonicalPath, pathCache.entries[ 0 ].canonicalPathLen );
 
-    pExpectedSignature = "4fcf6c89d5ddb944c0e386817d52835f578769e100d7e92d433bf4a946b7e6c3";
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
-    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
-    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
-}
+    /* S3 encodes the path only once, so it does not share the entry. */
+    params.pService = S3_SERVICE_NAME;
+    params.serviceLen = S3_SERVICE_NAME_LEN;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( "/path-%2520", pathCache.entries[ 1 ].pCanonicalPath, pathCache.entries[ 1 ].canonicalPathLen );
 
-/* Test that the library can handle an empty query string. */
-void test_SigV4_GenerateAuthorization_Empty_Query()
-{
-    /* Happy path when both query and length are NULL and 0 respectively. */
-    params.pHttpParameters->pQuery = NULL;
-    params.pHttpParameters->queryLen = 0U;
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    /* Entries whose path differs from the request are not taken for a hit,
+     * even with the same hash, so the path is cached again. */
+    pathCache.entries[ 1 ].pathLen--;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( "/path-%2520", pathCache.entries[ 2 ].pCanonicalPath, pathCache.entries[ 2 ].canonicalPathLen );
+    pathCache.entries[ 2 ].pPath[ 1 ] = 'P';
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( "/path-%2520", pathCache.entries[ 3 ].pCanonicalPath, pathCache.entries[ 3 ].canonicalPathLen );
 
-    /* The query is NULL, length is greater than 0, and the query is precanonicalized. */
-    params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
-    params.pHttpParameters->pQuery = NULL;
-    params.pHttpParameters->queryLen = 3U;
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    /* Once the cache is full, the least recently used paths are replaced. */
+    params.pHttpParameters->pPath = shortPath;
+    params.pHttpParameters->pathLen = sizeof( shortPath );
 
-    /* The query is non-NULL but length is 0. */
-    params.pHttpParameters->pQuery = QUERY;
-    params.pHttpParameters->queryLen = 0U;
-    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
-                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
-}
+    for( i = 0U; i < SIGV4_PATH_CACHE_ENTRY_COUNT; i++ )
+    {
+        shortPath[ 1 ] = ( char ) ( 'a' + i );
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    }
 
-void test_SigV4_GenerateHTTPAuthorization_Default_Arguments()
-{
-    SigV4Status_t returnStatus;
+    for( i = 0U; i < SIGV4_PATH_CACHE_ENTRY_COUNT; i++ )
+    {
+        TEST_ASSERT_EQUAL( sizeof( shortPath ), pathCache.entries[ i ].pathLen );
+    }
 
-    /* Default algorithm is the macro defined by SIGV4_AWS4_HMAC_SHA256. */
-    params.pAlgorithm = NULL;
+    /* Paths whose raw or canonical form does not fit in an entry are not cached. */
+    memset( &pathCache, 0, sizeof( pathCache ) );
+    memset( longPath, ( int ) 'a', sizeof( longPath ) );
+    params.pHttpParameters->pPath = longPath;
+    params.pHttpParameters->pathLen = sizeof( longPath );
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
-    /* Default path is "/". */
-    params.pHttpParameters->pPath = NULL;
+    TEST_ASSERT_EQUAL( 0U, pathCache.entries[ 0 ].canonicalPathLen );
+
+    memset( longPath, ( int ) ' ', sizeof( longPath ) );
+    params.pHttpParameters->pathLen = ( SIGV4_PATH_CACHE_PATH_LENGTH / URI_ENCODED_SPECIAL_CHAR_SIZE ) + 1U;
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
-    params.pHttpParameters->pPath = "/";
-    params.pHttpParameters->pathLen = 0;
+    TEST_ASSERT_EQUAL( 0U, pathCache.entries[ 0 ].canonicalPathLen );
+
+    /* Paths that do not fit in the processing buffer once encoded twice are
+     * not signed. */
+    params.pService = SERVICE;
+    params.serviceLen = STR_LIT_LEN( SERVICE );
+    params.pHttpParameters->pathLen = sizeof( longPath );
+    authBufLen = AUTH_BUF_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
-    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, pathCache.entries[ 0 ].canonicalPathLen );
 }
 
 /**
- * @brief Test the case when some input parameters are precanonicalized.
+ * @brief Test that a signed headers cache reuses the sort order and signed
+ * headers list of a request with the same header names, and that it does not
+ * change the signature.
  */
-void test_SigV4_GenerateHTTPAuthorization_Precanonicalized()
+void test_SigV4_GenerateHTTPAuthorization_Signed_Headers_Cache()
+{
+    SigV4Status_t returnStatus;
+    SigV4SignedHeadersCache_t signedHeadersCache;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char longHeader[ SIGV4_SIGNED_HEADERS_CACHE_LENGTH + 8U ];
+    char ringHeaders[ HEADERS_LENGTH ];
+    size_t headLen = STR_LIT_LEN( "Host: iam.amazonaws.com\r\n" );
+    size_t i;
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    memset( &signedHeadersCache, 0, sizeof( signedHeadersCache ) );
+    params.pSignedHeadersCache = &signedHeadersCache;
+
+    /* The first call populates the cache, and the second one hits it. */
+    for( i = 0U; i < 2U; i++ )
+    {
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+        TEST_ASSERT_EQUAL( STR_LIT_LEN( "content-type;host;x-amz-date" ), signedHeadersCache.signedHeadersLen );
+        TEST_ASSERT_EQUAL_MEMORY( "content-type;host;x-amz-date", signedHeadersCache.pSignedHeaders, signedHeadersCache.signedHeadersLen );
+        TEST_ASSERT_EQUAL( 1U, signedHeadersCache.pSortedOrder[ 0 ] );
+        TEST_ASSERT_EQUAL( 0U, signedHeadersCache.pSortedOrder[ 1 ] );
+        TEST_ASSERT_EQUAL( 2U, signedHeadersCache.pSortedOrder[ 2 ] );
+    }
+
+    /* Headers that wrap around a ring buffer start at a higher address than
+     * their wrapped part, but keep their sort order by position in the request. */
+    memset( &signedHeadersCache, 0, sizeof( signedHeadersCache ) );
+    memcpy( ringHeaders, &( HEADERS[ headLen ] ), HEADERS_LENGTH - headLen );
+    memcpy( &( ringHeaders[ HEADERS_LENGTH - headLen ] ), HEADERS, headLen );
+    params.pHttpParameters->pHeaders = &( ringHeaders[ HEADERS_LENGTH - headLen ] );
+    params.pHttpParameters->headersLen = headLen;
+    params.pHttpParameters->pHeadersWrap = ringHeaders;
+    params.pHttpParameters->headersWrapLen = HEADERS_LENGTH - headLen;
+
+    for( i = 0U; i < 2U; i++ )
+    {
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+        TEST_ASSERT_EQUAL( 1U, signedHeadersCache.pSortedOrder[ 0 ] );
+        TEST_ASSERT_EQUAL( 0U, signedHeadersCache.pSortedOrder[ 1 ] );
+        TEST_ASSERT_EQUAL( 2U, signedHeadersCache.pSortedOrder[ 2 ] );
+    }
+
+    params.pHttpParameters->pHeaders = HEADERS;
+    params.pHttpParameters->headersLen = HEADERS_LENGTH;
+    params.pHttpParameters->pHeadersWrap = NULL;
+    params.pHttpParameters->headersWrapLen = 0U;
+
+    /* Cached names that differ from the request are not taken for a hit,
+     * even when the fingerprint matches. */
+    signedHeadersCache.pHeaderNames[ 0 ] = 'Z';
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    TEST_ASSERT_EQUAL( 'C', signedHeadersCache.pHeaderNames[ 0 ] );
+
+    signedHeadersCache.headerNamesLen--;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( "content-type:host:x-amz-date:" ), signedHeadersCache.headerNamesLen );
+
+    /* So are cached names with another count, with a name that runs on where
+     * the request one ends, or followed by more names. */
+    signedHeadersCache.headerCount++;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    TEST_ASSERT_EQUAL( 3U, signedHeadersCache.headerCount );
+
+    signedHeadersCache.pHeaderNames[ STR_LIT_LEN( "content-type" ) ] = 's';
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    TEST_ASSERT_EQUAL( ':', signedHeadersCache.pHeaderNames[ STR_LIT_LEN( "content-type" ) ] );
+
+    signedHeadersCache.pHeaderNames[ signedHeadersCache.headerNamesLen ] = 'a';
+    signedHeadersCache.pHeaderNames[ signedHeadersCache.headerNamesLen + 1U ] = ':';
+    signedHeadersCache.headerNamesLen += 2U;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( "content-type:host:x-amz-date:" ), signedHeadersCache.headerNamesLen );
+
+    /* Other header names replace the cached ones. */
+    params.pHttpParameters->pHeaders = HEADERS_SORTED_COVERAGE_1;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( HEADERS_SORTED_COVERAGE_1 );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( 6U, signedHeadersCache.headerCount );
+    TEST_ASSERT_EQUAL_MEMORY( "a;b;c;d;e;f", signedHeadersCache.pSignedHeaders, signedHeadersCache.signedHeadersLen );
+
+    /* Header names that do not fit in the cache are not cached. */
+    memset( &signedHeadersCache, 0, sizeof( signedHeadersCache ) );
+    memset( longHeader, ( int ) 'a', sizeof( longHeader ) );
+    memcpy( &longHeader[ sizeof( longHeader ) - 6U ], ":v\r\n\r\n", 6U );
+    params.pHttpParameters->pHeaders = longHeader;
+    params.pHttpParameters->headersLen = sizeof( longHeader );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, signedHeadersCache.signedHeadersLen );
+}
+
+/**
+ * @brief Test that a payload hashed ahead of signing with SigV4_HashPayload()
+ * produces the same signature as a payload hashed while signing.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Payload_Is_Digest()
+{
+    SigV4Status_t returnStatus;
+    const char * pExpectedSignature = "20fdb62349e7104f9ce4184a444fedfbd19e40a5e31d57d433689c5a5138fa99";
+    char payloadDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t payloadDigestLen = sizeof( payloadDigest );
+
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( EMPTY_PAYLOAD_DIGEST ), payloadDigestLen );
+    TEST_ASSERT_EQUAL_MEMORY( EMPTY_PAYLOAD_DIGEST, payloadDigest, payloadDigestLen );
+
+    httpParams.pPayload = payloadDigest;
+    httpParams.payloadLen = payloadDigestLen;
+    httpParams.flags = SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+
+    /* The digest must have the hex-encoded length of the configured hash. */
+    httpParams.payloadLen = payloadDigestLen - 1U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    httpParams.pPayload = NULL;
+    httpParams.payloadLen = payloadDigestLen;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+}
+
+/**
+ * @brief Test the parameter validation and error paths of SigV4_HashPayload().
+ */
+void test_SigV4_HashPayload_Errors()
+{
+    SigV4Status_t returnStatus;
+    char payloadDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t payloadDigestLen = sizeof( payloadDigest );
+
+    returnStatus = SigV4_HashPayload( NULL, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, NULL, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, NULL );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 1U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH + 1U;
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH;
+
+    cryptoInterface.hashInit = NULL;
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashInit = valid_sha256_init;
+    cryptoInterface.hashUpdate = NULL;
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashUpdate = valid_sha256_update;
+    cryptoInterface.hashFinal = NULL;
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashFinal = valid_sha256_final;
+
+    payloadDigestLen = sizeof( payloadDigest ) - 1U;
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    resetFailableHashParams();
+    finalHashCallToFail = 0U;
+    payloadDigestLen = sizeof( payloadDigest );
+    returnStatus = SigV4_HashPayload( &cryptoInterface, NULL, 0U, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4HashError, returnStatus );
+}
+
+/**
+ * @brief Test that SigV4_FinishPayloadHash() completes a payload hash fed in
+ * parts to the same digest as SigV4_HashPayload(), and its error paths.
+ */
+void test_SigV4_FinishPayloadHash()
+{
+    SigV4Status_t returnStatus;
+    const char * pPayload = "Action=ListUsers&Version=2010-05-08";
+    char expectedDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t expectedDigestLen = sizeof( expectedDigest );
+    char payloadDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t payloadDigestLen = sizeof( payloadDigest );
+
+    returnStatus = SigV4_HashPayload( &cryptoInterface, pPayload, strlen( pPayload ),
+                                      expectedDigest, &expectedDigestLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    TEST_ASSERT_EQUAL( 0, cryptoInterface.hashInit( cryptoInterface.pHashContext ) );
+    TEST_ASSERT_EQUAL( 0, cryptoInterface.hashUpdate( cryptoInterface.pHashContext,
+                                                      ( const uint8_t * ) pPayload, 7U ) );
+    TEST_ASSERT_EQUAL( 0, cryptoInterface.hashUpdate( cryptoInterface.pHashContext,
+                                                      ( const uint8_t * ) &pPayload[ 7U ], strlen( pPayload ) - 7U ) );
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( expectedDigestLen, payloadDigestLen );
+    TEST_ASSERT_EQUAL_MEMORY( expectedDigest, payloadDigest, payloadDigestLen );
+
+    returnStatus = SigV4_FinishPayloadHash( NULL, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, NULL, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, NULL );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH + 1U;
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH;
+
+    cryptoInterface.hashFinal = NULL;
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    cryptoInterface.hashFinal = valid_sha256_final;
+
+    payloadDigestLen = sizeof( payloadDigest ) - 1U;
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    resetFailableHashParams();
+    finalHashCallToFail = 0U;
+    payloadDigestLen = sizeof( payloadDigest );
+    returnStatus = SigV4_FinishPayloadHash( &cryptoInterface, payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4HashError, returnStatus );
+}
+
+/**
+ * @brief Test that the segments written by SigV4_GenerateHTTPAuthorizationIov()
+ * make up the Authorization header value written by
+ * SigV4_GenerateHTTPAuthorization(), and the error paths of the former.
+ */
+void test_SigV4_GenerateHTTPAuthorizationIov()
+{
+    SigV4Status_t returnStatus;
+    SigV4IoVec_t iov[ SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+    size_t iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    char buf[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U + STR_LIT_LEN( "content-type;host;x-amz-date" ) ];
+    char gathered[ AUTH_BUF_LENGTH ];
+    size_t gatheredLen = 0U, i;
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SIGV4_AUTHORIZATION_IOVEC_COUNT, iovCount );
+
+    for( i = 0U; i < iovCount; i++ )
+    {
+        TEST_ASSERT_TRUE( ( gatheredLen + iov[ i ].dataLen ) <= sizeof( gathered ) );
+        memcpy( &gathered[ gatheredLen ], iov[ i ].pData, iov[ i ].dataLen );
+        gatheredLen += iov[ i ].dataLen;
+    }
+
+    TEST_ASSERT_EQUAL( authBufLen, gatheredLen );
+    TEST_ASSERT_EQUAL_MEMORY( authBuf, gathered, authBufLen );
+    TEST_ASSERT_EQUAL_MEMORY( signature, iov[ iovCount - 1U ].pData, signatureLen );
+
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( NULL, iov, &iovCount, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, NULL, &iovCount, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, NULL, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, NULL, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT - 1U;
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, buf, sizeof( buf ) - 1U );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    params.pCredentials = NULL;
+    returnStatus = SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, buf, sizeof( buf ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+}
+
+/**
+ * @brief Test that SigV4_GenerateHTTPAuthorizations() writes the same
+ * Authorization header values as SigV4_GenerateHTTPAuthorization() does for
+ * each set of credentials.
+ */
+void test_SigV4_GenerateHTTPAuthorizations()
+{
+    SigV4Status_t returnStatus;
+    SigV4Credentials_t tenantCreds[ 3 ];
+    SigV4SigningKeyCache_t signingKeyCache;
+    SigV4Authorization_t authorizations[ 3 ];
+    char authBufs[ 3 ][ AUTH_BUF_LENGTH ];
+    size_t i, j;
+
+    memset( &signingKeyCache, 0, sizeof( signingKeyCache ) );
+    memset( authorizations, 0, sizeof( authorizations ) );
+    tenantCreds[ 0 ] = creds;
+    tenantCreds[ 1 ].pAccessKeyId = "AKIDEXAMPLE";
+    tenantCreds[ 1 ].accessKeyIdLen = STR_LIT_LEN( "AKIDEXAMPLE" );
+    tenantCreds[ 1 ].pSecretAccessKey = SECRET_KEY_LONGER_THAN_HASH_BLOCK;
+    tenantCreds[ 1 ].secretAccessKeyLen = SECRET_KEY_LONGER_THAN_HASH_BLOCK_LEN;
+    tenantCreds[ 2 ] = creds;
+    tenantCreds[ 2 ].pSecretAccessKey = "tenant3/SecretAccessKey";
+    tenantCreds[ 2 ].secretAccessKeyLen = STR_LIT_LEN( "tenant3/SecretAccessKey" );
+
+    /* The signing key of the last credentials is cached, so the second call
+     * reuses it. */
+    for( j = 0U; j < 2U; j++ )
+    {
+        for( i = 0U; i < 3U; i++ )
+        {
+            authorizations[ i ].pCredentials = &tenantCreds[ i ];
+            authorizations[ i ].pAuthBuf = authBufs[ i ];
+            authorizations[ i ].authBufLen = AUTH_BUF_LENGTH;
+        }
+
+        authorizations[ 2 ].pSigningKeyCache = &signingKeyCache;
+        returnStatus = SigV4_GenerateHTTPAuthorizations( &params, authorizations, 3U );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH, signingKeyCache.signingKeyLen );
+
+        for( i = 0U; i < 3U; i++ )
+        {
+            params.pCredentials = &tenantCreds[ i ];
+            authBufLen = AUTH_BUF_LENGTH;
+            returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+            TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+            TEST_ASSERT_EQUAL( authBufLen, authorizations[ i ].authBufLen );
+            TEST_ASSERT_EQUAL_MEMORY( authBuf, authorizations[ i ].pAuthBuf, authBufLen );
+            TEST_ASSERT_EQUAL( signatureLen, authorizations[ i ].signatureLen );
+            TEST_ASSERT_EQUAL_MEMORY( signature, authorizations[ i ].pSignature, signatureLen );
+        }
+
+        params.pCredentials = &creds;
+    }
+
+    TEST_ASSERT_FALSE( memcmp( authorizations[ 0 ].pSignature, authorizations[ 2 ].pSignature, authorizations[ 0 ].signatureLen ) == 0 );
+}
+
+/**
+ * @brief Test the error paths of SigV4_GenerateHTTPAuthorizations().
+ */
+void test_SigV4_GenerateHTTPAuthorizations_Errors()
+{
+    SigV4Authorization_t authorizations[ 2 ];
+    SigV4EcdsaInterface_t ecdsaInterface = { 0 };
+    char authBufs[ 2 ][ AUTH_BUF_LENGTH ];
+    size_t i;
+
+    memset( authorizations, 0, sizeof( authorizations ) );
+
+    for( i = 0U; i < 2U; i++ )
+    {
+        authorizations[ i ].pCredentials = &creds;
+        authorizations[ i ].pAuthBuf = authBufs[ i ];
+        authorizations[ i ].authBufLen = AUTH_BUF_LENGTH;
+    }
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( NULL, authorizations, 2U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, NULL, 2U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 0U ) );
+
+    /* Every entry is checked before any is written. */
+    authorizations[ 1 ].pAuthBuf = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+    authorizations[ 1 ].pAuthBuf = authBufs[ 1 ];
+    authorizations[ 1 ].pCredentials = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+    authorizations[ 1 ].pCredentials = &creds;
+    TEST_ASSERT_EQUAL( AUTH_BUF_LENGTH, authorizations[ 0 ].authBufLen );
+
+    ecdsaInterface.loadKey = ecdsa_load_key_failable;
+    ecdsaInterface.sign = ecdsa_sign_failable;
+    params.pEcdsaInterface = &ecdsaInterface;
+    params.pAlgorithm = SIGV4_AWS4_ECDSA_P256_SHA256;
+    params.algorithmLen = SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+    params.pAlgorithm = SIGV4_AWS4_HMAC_SHA256;
+    params.algorithmLen = SIGV4_AWS4_HMAC_SHA256_LENGTH;
+
+    /* The X-Amz-Credential of a presigned URL names one access key ID. */
+    httpParams.flags = SIGV4_HTTP_IS_PRESIGNED_URL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+    TEST_ASSERT_EQUAL( AUTH_BUF_LENGTH, authorizations[ 0 ].authBufLen );
+    httpParams.flags = 0U;
+
+    authorizations[ 1 ].authBufLen = 10U;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+
+    /* Hash failures are reported whether they happen while hashing the
+     * canonical request or while signing for either set of credentials. */
+    for( i = 0U; i < 12U; i++ )
+    {
+        authorizations[ 0 ].authBufLen = AUTH_BUF_LENGTH;
+        authorizations[ 1 ].authBufLen = AUTH_BUF_LENGTH;
+        resetFailableHashParams();
+        finalHashCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorizations( &params, authorizations, 2U ) );
+    }
+}
+
+/**
+ * @brief Test that a raw HTTP request is signed the same as its parts, and the
+ * error paths of SigV4_SignRawHttpRequest().
+ */
+void test_SigV4_SignRawHttpRequest()
+{
+    SigV4Status_t returnStatus;
+    char expectedAuth[ AUTH_BUF_LENGTH ];
+    size_t expectedAuthLen = 0U, insertIndex = 0U;
+    const char * pRequest = "GET /?" QUERY " HTTP/1.1\r\n" HEADERS;
+    const char * pAbsoluteRequest = "GET https://iam.amazonaws.com/?" QUERY " HTTP/1.1\r\n" HEADERS;
+    const char * pNoPathRequest = "GET https://iam.amazonaws.com HTTP/1.1\r\n" HEADERS;
+    const char * pEmptyQueryRequest = "GET /? HTTP/1.1\r\n" HEADERS;
+    const char * pNoSchemeRequest = "GET iam.amazonaws.com:443 HTTP/1.1\r\n" HEADERS;
+    const char * pEmptyTargetRequest = "GET  HTTP/1.1\r\n" HEADERS;
+    const char * pSchemeOnlyRequest = "GET http: HTTP/1.1\r\n" HEADERS;
+    const char * pInvalidRequests[] =
+    {
+        "GET / HTTP/1.1\n" HEADERS,
+        "\r\n" HEADERS,
+        " / HTTP/1.1\r\n" HEADERS,
+        "GET\r\n" HEADERS,
+        "GET /\r\n" HEADERS,
+        "GET / HTTP\r\n" HEADERS,
+        "GET / FTP/1.1\r\n" HEADERS,
+        "GET / HTTP/1.1"
+    };
+    size_t i;
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedAuth, authBuf, authBufLen );
+    expectedAuthLen = authBufLen;
+
+    /* Only the flags of the HTTP parameters are used. */
+    params.pHttpParameters->pHttpMethod = "PUT";
+    params.pHttpParameters->httpMethodLen = STR_LIT_LEN( "PUT" );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pRequest, strlen( pRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( expectedAuthLen, authBufLen );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, authBuf, authBufLen );
+    TEST_ASSERT_EQUAL( strlen( pRequest ) - STR_LIT_LEN( "\r\n" ), insertIndex );
+
+    params.pHttpParameters = NULL;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pAbsoluteRequest, strlen( pAbsoluteRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, authBuf, authBufLen );
+
+    /* Without a query, the absolute-form and origin-form targets sign the same. */
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pEmptyQueryRequest, strlen( pEmptyQueryRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedAuth, authBuf, authBufLen );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pNoPathRequest, strlen( pNoPathRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, authBuf, authBufLen );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pNoSchemeRequest, strlen( pNoSchemeRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    /* An empty target is signed as the root path, and a target that ends
+     * within its scheme separator as a path. */
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pEmptyTargetRequest, strlen( pEmptyTargetRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, authBuf, authBufLen );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignRawHttpRequest( &params, pSchemeOnlyRequest, strlen( pSchemeOnlyRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_FALSE( memcmp( expectedAuth, authBuf, authBufLen ) == 0 );
+
+    for( i = 0U; i < ( sizeof( pInvalidRequests ) / sizeof( pInvalidRequests[ 0 ] ) ); i++ )
+    {
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_SignRawHttpRequest( &params, pInvalidRequests[ i ], strlen( pInvalidRequests[ i ] ), authBuf, &authBufLen, &insertIndex );
+        TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    }
+
+    returnStatus = SigV4_SignRawHttpRequest( &params, "GET / HTTP/1.1\r\n\r\n", STR_LIT_LEN( "GET / HTTP/1.1\r\n\r\n" ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, "GET / HTTP/1.1\r\nHost: a\r\n\r", STR_LIT_LEN( "GET / HTTP/1.1\r\nHost: a\r\n\r" ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, "GET / HTTP/1.1\r\nH", STR_LIT_LEN( "GET / HTTP/1.1\r\nH" ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
+
+    returnStatus = SigV4_SignRawHttpRequest( NULL, pRequest, strlen( pRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, NULL, strlen( pRequest ), authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, pRequest, 0U, authBuf, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, pRequest, strlen( pRequest ), authBuf, &authBufLen, NULL );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    returnStatus = SigV4_SignRawHttpRequest( &params, pRequest, strlen( pRequest ), NULL, &authBufLen, &insertIndex );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+}
+
+/**
+ * @brief Test that the query builder keeps the canonical query sorted while
+ * parameters are set, replaced and removed.
+ */
+void test_SigV4_QueryBuilder_Happy_Path()
+{
+    SigV4Status_t returnStatus;
+    SigV4QueryBuilder_t queryBuilder;
+    char queryBuffer[ 128 ];
+    const char * pExpectedSignature = "20fdb62349e7104f9ce4184a444fedfbd19e40a5e31d57d433689c5a5138fa99";
+
+    returnStatus = SigV4_InitQueryBuilder( &queryBuilder, queryBuffer, sizeof( queryBuffer ), true );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, queryBuilder.queryLen );
+
+    /* Removing a parameter from an empty query leaves it empty. */
+    returnStatus = SigV4_RemoveQueryParameter( &queryBuilder, "Marker", 6U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, queryBuilder.queryLen );
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Version", 7U, "2010-05-08", 10U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Marker", 6U, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Action", 6U, "ListUsers", 9U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Action/", 7U, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Marker", 6U, "b=c", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "Actio", 5U, "n", 1U ) );
+    TEST_ASSERT_EQUAL_MEMORY( "Actio=n&Action=ListUsers&Action%2F=&Marker=b%253Dc&Version=2010-05-08",
+                              queryBuilder.pQuery,
+                              queryBuilder.queryLen );
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Marker", 6U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Action/", 7U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Actio", 5U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Zzz", 3U ) );
+    TEST_ASSERT_EQUAL_MEMORY( QUERY, queryBuilder.pQuery, queryBuilder.queryLen );
+    TEST_ASSERT_EQUAL( QUERY_LENGTH, queryBuilder.queryLen );
+
+    /* The built query signs the same as the query it was built from. */
+    params.pHttpParameters->pQuery = queryBuilder.pQuery;
+    params.pHttpParameters->queryLen = queryBuilder.queryLen;
+    params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Version", 7U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_RemoveQueryParameter( &queryBuilder, "Action", 6U ) );
+    TEST_ASSERT_EQUAL( 0U, queryBuilder.queryLen );
+}
+
+/**
+ * @brief Test the query builder with invalid parameters and a full buffer.
+ */
+void test_SigV4_QueryBuilder_Errors()
+{
+    SigV4QueryBuilder_t queryBuilder;
+    char queryBuffer[ 16 ];
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitQueryBuilder( NULL, queryBuffer, sizeof( queryBuffer ), true ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitQueryBuilder( &queryBuilder, NULL, sizeof( queryBuffer ), true ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitQueryBuilder( &queryBuilder, queryBuffer, 0U, true ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_InitQueryBuilder( &queryBuilder, queryBuffer, sizeof( queryBuffer ), false ) );
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( NULL, "a", 1U, "b", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( &queryBuilder, NULL, 1U, "b", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( &queryBuilder, "a", 0U, "b", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_RemoveQueryParameter( NULL, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_RemoveQueryParameter( &queryBuilder, NULL, 0U ) );
+
+    /* The encoded name, value, and trailing separator each do not fit. */
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SetQueryParameter( &queryBuilder, "////////", 8U, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, "/////", 5U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, "bcdefghijklmno", 14U ) );
+    TEST_ASSERT_EQUAL( 0U, queryBuilder.queryLen );
+
+    /* Once the buffer is full, the builder rejects further parameters. */
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, "bcdefghijklm", 12U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_RemoveQueryParameter( &queryBuilder, "a", 1U ) );
+    TEST_ASSERT_EQUAL_MEMORY( "a=bcdefghijklm", queryBuilder.pQuery, queryBuilder.queryLen );
+
+    queryBuilder.queryLen = queryBuilder.bufferLen;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, "b", 1U ) );
+    queryBuilder.pQuery = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SetQueryParameter( &queryBuilder, "a", 1U, "b", 1U ) );
+}
+
+/**
+ * @brief Push a request to a signer, in parts split the way they could arrive.
+ */
+static SigV4Status_t pushSignerRequest( SigV4Signer_t * pSigner,
+                                        const char * pPayload )
+{
+    SigV4Status_t returnStatus;
+
+    returnStatus = SigV4_SignerPushMethod( pSigner, "G", 1U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushMethod( pSigner, "ET", 2U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushPath( pSigner, "/my pa", 6U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushPath( pSigner, NULL, 0U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushPath( pSigner, "th/", 3U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushQueryParameter( pSigner, "Version", 7U, "2010-05-08", 10U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushQueryParameter( pSigner, "Action", 6U, "ListUsers", 9U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushHeader( pSigner, "Host", 4U, "iam.amazonaws.com", 17U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushHeader( pSigner, "x-amz-content-sha256", 20U, "UNSIGNED-PAYLOAD", 16U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushHeader( pSigner, "X-Amz-Date", 10U, DATE, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushPayload( pSigner, pPayload, 10U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = SigV4_SignerPushPayload( pSigner, NULL, 0U );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    return SigV4_SignerPushPayload( pSigner, &( pPayload[ 10 ] ), strlen( pPayload ) - 10U );
+}
+
+/**
+ * @brief Test that a request pushed to a signer in parts signs the same as the
+ * whole request.
+ */
+void test_SigV4_Signer_Happy_Path()
+{
+    SigV4Status_t returnStatus;
+    SigV4Signer_t signer;
+    char signerBuffer[ 256 ];
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    const char * pHeaders = "Host:iam.amazonaws.com\r\nx-amz-content-sha256:UNSIGNED-PAYLOAD\r\nX-Amz-Date:" DATE "\r\n";
+    const char * pPayload = "Action=ListUsers&Version=2010-05-08";
+    const char * pServices[] = { SERVICE, "s3", SERVICE };
+    const uint32_t flags[] = { 0U, SIGV4_HTTP_PAYLOAD_IS_HASH, SIGV4_HTTP_IS_PRESIGNED_URL };
+    size_t i;
+
+    params.pHttpParameters->pPath = "/my path/";
+    params.pHttpParameters->pathLen = STR_LIT_LEN( "/my path/" );
+    params.pHttpParameters->pHeaders = pHeaders;
+    params.pHttpParameters->headersLen = strlen( pHeaders );
+    params.pHttpParameters->pPayload = pPayload;
+    params.pHttpParameters->payloadLen = strlen( pPayload );
+
+    for( i = 0U; i < ( sizeof( flags ) / sizeof( flags[ 0 ] ) ); i++ )
+    {
+        params.pService = pServices[ i ];
+        params.serviceLen = strlen( pServices[ i ] );
+        params.pHttpParameters->flags = flags[ i ];
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+        returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        returnStatus = pushSignerRequest( &signer, pPayload );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+        /* A finished signer can sign again, but takes no more parts. */
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+        returnStatus = SigV4_SignerPushPayload( &signer, pPayload, 1U );
+        TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+    }
+
+    /* Without HTTP parameters, the headers are signed without flags. */
+    params.pService = SERVICE;
+    params.serviceLen = STR_LIT_LEN( SERVICE );
+    params.pHttpParameters->flags = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+    params.pHttpParameters = NULL;
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    returnStatus = pushSignerRequest( &signer, pPayload );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+}
+
+/**
+ * @brief Test that the signer signs every value of a repeated query parameter,
+ * sorted by name and then by value, like a whole request with those values.
+ */
+void test_SigV4_Signer_Repeated_Query_Parameters()
+{
+    SigV4Status_t returnStatus;
+    SigV4Signer_t signer;
+    char signerBuffer[ 256 ];
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    const char * pHeaders = "Host:iam.amazonaws.com\r\nX-Amz-Date:" DATE "\r\n";
+    const char * pValues[] = { "2", "1", "10", "2" };
+    size_t i;
+
+    params.pHttpParameters->pPath = "/";
+    params.pHttpParameters->pathLen = 1U;
+    params.pHttpParameters->pQuery = "a=2&b=1&a=1&a=10&a=2";
+    params.pHttpParameters->queryLen = STR_LIT_LEN( "a=2&b=1&a=1&a=10&a=2" );
+    params.pHttpParameters->pHeaders = pHeaders;
+    params.pHttpParameters->headersLen = strlen( pHeaders );
+    params.pHttpParameters->pPayload = NULL;
+    params.pHttpParameters->payloadLen = 0U;
+    params.pHttpParameters->flags = 0U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushPath( &signer, "/", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushQueryParameter( &signer, "b", 1U, "1", 1U ) );
+
+    for( i = 0U; i < ( sizeof( pValues ) / sizeof( pValues[ 0 ] ) ); i++ )
+    {
+        returnStatus = SigV4_SignerPushQueryParameter( &signer, "a", 1U, pValues[ i ], strlen( pValues[ i ] ) );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    }
+
+    TEST_ASSERT_EQUAL_STRING_LEN( "a=1&a=10&a=2&a=2&b=1", signer.query.pQuery, signer.query.queryLen );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushHeader( &signer, "Host", 4U, "iam.amazonaws.com", 17U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushHeader( &signer, "X-Amz-Date", 10U, DATE, SIGV4_ISO_STRING_LEN ) );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+}
+
+/**
+ * @brief Test the error paths of the signer.
+ */
+void test_SigV4_Signer_Errors()
+{
+    SigV4Status_t returnStatus;
+    SigV4Signer_t signer;
+    char signerBuffer[ 16 ];
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( NULL, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, NULL, signerBuffer, sizeof( signerBuffer ) ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, NULL, sizeof( signerBuffer ) ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, 0U ) );
+    params.pCryptoInterface->hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH + 1U;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pCryptoInterface->hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH;
+    params.pCryptoInterface->hashFinal = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pCryptoInterface->hashFinal = valid_sha256_final;
+    params.pCryptoInterface->hashUpdate = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pCryptoInterface->hashUpdate = valid_sha256_update;
+    params.pCryptoInterface->hashInit = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pCryptoInterface->hashInit = valid_sha256_init;
+    params.pCryptoInterface = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pCryptoInterface = &cryptoInterface;
+    params.pService = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) ) );
+    params.pService = SERVICE;
+
+    /* Parts must be pushed in order, starting with the method. */
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushMethod( NULL, "GET", 3U ) );
+    memset( &signer, 0, sizeof( signer ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushMethod( &signer, NULL, 3U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushMethod( &signer, "GET", 0U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushPath( &signer, "/", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushPath( &signer, NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushHeader( &signer, NULL, 1U, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushHeader( &signer, "a", 0U, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushHeader( &signer, "a", 1U, NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushHeader( &signer, "a", 1U, "a", 0U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushPayload( &signer, NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushHeader( &signer, "a", 1U, "b", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_SignerPushQueryParameter( &signer, "a", 1U, "b", 1U ) );
+
+    /* Each part must fit in the signer buffer: 16 bytes. A part that does not
+     * fit fails the signer, which then returns the error for every call. */
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushMethod( &signer, "GETGETGETGETGETGET", 18U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushPath( &signer, "/", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+
+    /* " " is encoded to "%20" and then to "%2520", so four spaces only fit
+     * once encoded, and five do not fit at all. */
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushPath( &signer, "    ", 4U ) );
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushPath( &signer, "     ", 5U ) );
+
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushPath( &signer, "/", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushHeader( &signer, "host", 4U, "localhost", 9U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushHeader( &signer, "host", 4U, "local", 5U ) );
+
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushPath( &signer, "/", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushHeader( &signer, "host", 4U, "local", 5U ) );
+    /* The authorization buffer is not part of the request, so signing can be retried. */
+    authBufLen = 1U;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GETGETGETGETGETG", 16U ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_SignerPushQueryParameter( &signer, "a", 1U, "b", 1U ) );
+
+    /* A hash error fails the signer, so the payload hash is neither used again
+     * nor finished once a fragment was lost. */
+    resetFailableHashParams();
+    hashInitCallToFail = 0U;
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerPushPayload( &signer, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerPushPayload( &signer, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 1U, hashInitCalledCount );
+    TEST_ASSERT_EQUAL( 0U, updateHashCalledCount );
+    TEST_ASSERT_EQUAL( 0U, finalHashCalledCount );
+
+    resetFailableHashParams();
+    updateHashCallToFail = 0U;
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerPushPayload( &signer, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerPushHeader( &signer, "a", 1U, "b", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 1U, updateHashCalledCount );
+    TEST_ASSERT_EQUAL( 0U, finalHashCalledCount );
+
+    resetFailableHashParams();
+    finalHashCallToFail = 0U;
+    returnStatus = SigV4_InitSigner( &signer, &params, signerBuffer, sizeof( signerBuffer ) );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushMethod( &signer, "GET", 3U ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_SignerPushPayload( &signer, "a", 1U ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_SignerFinish( &signer, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 1U, finalHashCalledCount );
+}
+
+/* Test the API for handling corner cases of sorting the Query Parameters (when generating Canonical Query) */
+void test_SigV4_GenerateHTTPAuthorization_Sorting_Query_Params_Corner_Cases()
+{
+    SigV4Status_t returnStatus;
+
+    /* Test when the query string contains query parameters with exactly matching names. */
+    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS;
+    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    /* Test when the query string contains query parameters which do not match in name length but match in
+     * the name data for the common length between 2 parameters. */
+    params.pHttpParameters->pQuery = QUERY_WITH_MATCHING_PARAM_PREFIX;
+    params.pHttpParameters->queryLen = strlen( QUERY_WITH_MATCHING_PARAM_PREFIX );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    /* Test when the query string contains query parameters with exactly matching parameter names as well
+     * as matching values for those parameters. The query values of matching parameters differ in length though. */
+    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_1;
+    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_1 );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_2;
+    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_MATCHING_VALUES_PREFIX_2 );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+
+    /* Test when the query string contains query parameters with exactly matching parameter names as well
+     * as matching values for those parameters. The query values of matching parameters differ in length though. */
+    params.pHttpParameters->pQuery = QUERY_MATCHING_PARAMS_AND_VALUES;
+    params.pHttpParameters->queryLen = strlen( QUERY_MATCHING_PARAMS_AND_VALUES );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+}
+
+/* Test that the library can handle HTTP headers data containing trimmable spaces. */
+void test_SigV4_GenerateAuthorization_Headers_With_Trimmable_Spaces()
+{
+    params.pHttpParameters->pHeaders = HEADERS_WITH_TRIMMABLE_SPACES;
+    params.pHttpParameters->headersLen = strlen( HEADERS_WITH_TRIMMABLE_SPACES );
+
+    const char * pExpectedSignature = "41dfba73a35f6cff18fc02e991f6499d4e0fb1209a4d42e9155a623ae0f36831";
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+}
+
+/* Test that the library can handle query string that contains empty values for its parameters. */
+void test_SigV4_GenerateAuthorization_Query_Strings_Special_Cases()
+{
+    params.pHttpParameters->pQuery = QUERY_STRING_NO_PARAM_VALUE;
+    params.pHttpParameters->queryLen = strlen( QUERY_STRING_NO_PARAM_VALUE );
+
+    const char * pExpectedSignature = "9eed8862e36ac9861f0ea0be863ef6d825de854c8eb9da072637dcc64e5ef919";
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
+    printf( "%.*s\n", ( int ) ( authBufLen ), authBuf );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+
+    params.pHttpParameters->pQuery = QUERY_STRING_WITH_TRAILING_N_LEADING_AMPERSAND;
+    params.pHttpParameters->queryLen = strlen( QUERY_STRING_WITH_TRAILING_N_LEADING_AMPERSAND );
+
+    pExpectedSignature = "576a0348d54591e15bed920586936f9263656470197adf7ce79c5fc8ef44d825";
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+
+    params.pHttpParameters->pQuery = QUERY_STRING_WITH_REPEATED_AMPERSAND;
+    params.pHttpParameters->queryLen = strlen( QUERY_STRING_WITH_REPEATED_AMPERSAND );
+
+    pExpectedSignature = "4fcf6c89d5ddb944c0e386817d52835f578769e100d7e92d433bf4a946b7e6c3";
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U, signatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( pExpectedSignature, signature, signatureLen );
+}
+
+/* Test that the library can handle an empty query string. */
+void test_SigV4_GenerateAuthorization_Empty_Query()
+{
+    /* Happy path when both query and length are NULL and 0 respectively. */
+    params.pHttpParameters->pQuery = NULL;
+    params.pHttpParameters->queryLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+
+    /* The query is NULL, length is greater than 0, and the query is precanonicalized. */
+    params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+    params.pHttpParameters->pQuery = NULL;
+    params.pHttpParameters->queryLen = 3U;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+
+    /* The query is non-NULL but length is 0. */
+    params.pHttpParameters->pQuery = QUERY;
+    params.pHttpParameters->queryLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization(
+                           &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+}
+
+void test_SigV4_GenerateHTTPAuthorization_Default_Arguments()
+{
+    SigV4Status_t returnStatus;
+
+    /* Default algorithm is the macro defined by SIGV4_AWS4_HMAC_SHA256. */
+    params.pAlgorithm = NULL;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    /* Default path is "/". */
+    params.pHttpParameters->pPath = NULL;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    params.pHttpParameters->pPath = "/";
+    params.pHttpParameters->pathLen = 0;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+}
+
+/**
+ * @brief Test that a precomputed credential scope signs as the scope built from
+ * the region, service and algorithm, and that its S3 decision is followed.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Precomputed_Scope()
+{
+    SigV4PrecomputedScope_t precomputedScope =
+    {
+        "/" REGION "/" SERVICE "/aws4_request", STR_LIT_LEN( "/" REGION "/" SERVICE "/aws4_request" ),
+        SIGV4_AWS4_HMAC_SHA256 " Credential=",  STR_LIT_LEN( SIGV4_AWS4_HMAC_SHA256 " Credential=" ),
+        false
+    };
+    char expectedAuth[ AUTH_BUF_LENGTH ];
+    size_t expectedAuthLen;
+    char expectedSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ];
+    SigV4IoVec_t iov[ SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+    size_t iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    char iovBuf[ 200 ];
+    char iovAuth[ AUTH_BUF_LENGTH ];
+    size_t iovAuthLen = 0U, i;
+
+    httpParams.pPath = "/path-%20";
+    httpParams.pathLen = STR_LIT_LEN( "/path-%20" );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    memcpy( expectedAuth, authBuf, authBufLen );
+    expectedAuthLen = authBufLen;
+
+    params.pPrecomputedScope = &precomputedScope;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( expectedAuthLen, authBufLen );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, authBuf, expectedAuthLen );
+    memcpy( expectedSignature, signature, signatureLen );
+
+    /* The segments make up the same value out of the precomputed parts. */
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, iovBuf, sizeof( iovBuf ) ) );
+    TEST_ASSERT_EQUAL_PTR( precomputedScope.pAuthPrefix, iov[ 0 ].pData );
+    TEST_ASSERT_EQUAL_PTR( precomputedScope.pScopeSuffix, iov[ 5 ].pData );
+
+    for( i = 0U; i < iovCount; i++ )
+    {
+        memcpy( &iovAuth[ iovAuthLen ], iov[ i ].pData, iov[ i ].dataLen );
+        iovAuthLen += iov[ i ].dataLen;
+    }
+
+    TEST_ASSERT_EQUAL( expectedAuthLen, iovAuthLen );
+    TEST_ASSERT_EQUAL_MEMORY( expectedAuth, iovAuth, expectedAuthLen );
+
+    /* The service is not compared against S3 when the scope says the path is
+     * encoded once, so "%20" is encoded once. */
+    precomputedScope.encodePathOnce = true;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_FALSE( memcmp( expectedSignature, signature, signatureLen ) == 0 );
+
+    precomputedScope.scopeSuffixLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    precomputedScope.pScopeSuffix = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    precomputedScope.pScopeSuffix = "/" REGION "/" SERVICE "/aws4_request";
+    precomputedScope.scopeSuffixLen = STR_LIT_LEN( "/" REGION "/" SERVICE "/aws4_request" );
+    precomputedScope.authPrefixLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    precomputedScope.pAuthPrefix = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+}
+
+/**
+ * @brief Test the case when some input parameters are precanonicalized.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Precanonicalized()
 {
     SigV4Status_t returnStatus;
 
@@ -881,6 +2256,350 @@ void test_SigV4_GenerateHTTPAuthorization_Precanonicalized()
     TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
 }
 
+/**
+ * @brief Test that headers which are already lowercase and trimmed, but in raw
+ * HTTP format, produce the same signature as the headers they were made from.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Headers_Are_Trimmed()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char longHeader[ SIGV4_PROCESSING_BUFFER_LENGTH ];
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->pHeaders = TRIMMED_HEADERS;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( TRIMMED_HEADERS );
+    params.pHttpParameters->flags = SIGV4_HTTP_HEADERS_ARE_TRIMMED_FLAG;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* A header that does not fit in the processing buffer is rejected. */
+    memset( longHeader, ( int ) 'a', sizeof( longHeader ) );
+    memcpy( longHeader, "h:", 2U );
+    memcpy( &longHeader[ sizeof( longHeader ) - 4U ], "\r\n\r\n", 4U );
+    params.pHttpParameters->pHeaders = longHeader;
+    params.pHttpParameters->headersLen = sizeof( longHeader );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+}
+
+/**
+ * @brief Test that query parameters are sorted on their encoded form, both
+ * when there is space to sort them through and when they are sorted in place.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Query_Sorted_When_Encoded()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char longQuery[ 5U * 54U ];
+    char sortedLongQuery[ sizeof( longQuery ) ];
+    size_t i;
+
+    /* "%C3%A9" sorts before "az", although the raw 0xC3 sorts after 'z'. */
+    params.pHttpParameters->pQuery = "%C3%A9=1&az=2";
+    params.pHttpParameters->queryLen = STR_LIT_LEN( "%C3%A9=1&az=2" );
+    params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->pQuery = "az=2&\xC3\xA9=1";
+    params.pHttpParameters->queryLen = STR_LIT_LEN( "az=2&\xC3\xA9=1" );
+    params.pHttpParameters->flags = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* A query that takes more than half of the remaining processing buffer. */
+    memset( longQuery, ( int ) 'v', sizeof( longQuery ) );
+    memset( sortedLongQuery, ( int ) 'v', sizeof( sortedLongQuery ) );
+
+    for( i = 0U; i < 5U; i++ )
+    {
+        longQuery[ i * 54U ] = ( char ) ( 'e' - i );
+        longQuery[ ( i * 54U ) + 1U ] = '=';
+        longQuery[ ( i * 54U ) + 53U ] = '&';
+        sortedLongQuery[ i * 54U ] = ( char ) ( 'a' + i );
+        sortedLongQuery[ ( i * 54U ) + 1U ] = '=';
+        sortedLongQuery[ ( i * 54U ) + 53U ] = '&';
+    }
+
+    params.pHttpParameters->pHeaders = "Host: a\r\n\r\n";
+    params.pHttpParameters->headersLen = STR_LIT_LEN( "Host: a\r\n\r\n" );
+    params.pHttpParameters->pQuery = sortedLongQuery;
+    params.pHttpParameters->queryLen = sizeof( sortedLongQuery ) - 1U;
+    params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->pQuery = longQuery;
+    params.pHttpParameters->queryLen = sizeof( longQuery ) - 1U;
+    params.pHttpParameters->flags = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* Parameters stored both before and after the one moved into place. */
+    for( i = 0U; i < 5U; i++ )
+    {
+        longQuery[ i * 54U ] = "baecd"[ i ];
+    }
+
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+}
+
+/**
+ * @brief Test that well-known header names are recognized without
+ * case-sensitivity, and sorted along with other header names.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Well_Known_Headers()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    const char * pSignedHeaders = "SignedHeaders=accept;content-type;host;post;x-amz-date,";
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->pHeaders = UPPERCASE_HEADERS;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( UPPERCASE_HEADERS );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* "Post" falls into the slot of "host", but is not taken for it. */
+    params.pHttpParameters->pHeaders = HEADERS_WITH_UNKNOWN_NAMES;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( HEADERS_WITH_UNKNOWN_NAMES );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_LESS_THAN( AUTH_BUF_LENGTH, authBufLen );
+    authBuf[ authBufLen ] = '\0';
+    TEST_ASSERT_NOT_NULL( strstr( authBuf, pSignedHeaders ) );
+
+    /* A name sorts before the longer names that start with it, whatever the
+     * order of the request. */
+    params.pHttpParameters->pHeaders = HEADERS_WITH_PREFIX_NAMES;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( HEADERS_WITH_PREFIX_NAMES );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    authBuf[ authBufLen ] = '\0';
+    TEST_ASSERT_NOT_NULL( strstr( authBuf, "SignedHeaders=host;x-a;x-ab;x-amz-date," ) );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+    params.pHttpParameters->pHeaders = HEADERS_WITH_PREFIX_NAMES_REVERSED;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( HEADERS_WITH_PREFIX_NAMES_REVERSED );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* Names that only differ in case are the same header, and are both signed. */
+    params.pHttpParameters->pHeaders = "X-A: b\r\nHost: iam.amazonaws.com\r\nx-a: a\r\nX-Amz-Date: "DATE "\r\n\r\n";
+    params.pHttpParameters->headersLen = strlen( params.pHttpParameters->pHeaders );
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_NOT_NULL( strstr( authBuf, "SignedHeaders=host;x-a;x-a;x-amz-date," ) );
+}
+
+/**
+ * @brief Test that pre-canonicalized inputs, which are hashed in place, are
+ * signed the same as the inputs they are the canonical form of.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Canonical_Inputs_Hashed_In_Place()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char * pLongPath = malloc( SIGV4_PROCESSING_BUFFER_LENGTH );
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->pHeaders = CANONICAL_HEADERS;
+    params.pHttpParameters->headersLen = STR_LIT_LEN( CANONICAL_HEADERS );
+    params.pHttpParameters->flags = SIGV4_HTTP_PATH_IS_CANONICAL_FLAG |
+                                    SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG |
+                                    SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* A canonical path is not limited by the length of the processing buffer. */
+    TEST_ASSERT_NOT_NULL( pLongPath );
+    memset( pLongPath, ( int ) 'p', SIGV4_PROCESSING_BUFFER_LENGTH );
+    pLongPath[ 0 ] = '/';
+    params.pHttpParameters->pPath = pLongPath;
+    params.pHttpParameters->pathLen = SIGV4_PROCESSING_BUFFER_LENGTH;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    free( pLongPath );
+}
+
+/**
+ * @brief Test that inputs wrapping around a ring buffer sign the same as
+ * contiguous inputs, wherever they wrap.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Wrapped_Inputs()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    char payloadDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t payloadDigestLen = sizeof( payloadDigest );
+    const char * pPayload = "Action=ListUsers&Version=2010-05-08";
+    const char * pLongHeaders = "Host: iam.amazonaws.com\r\nX-Amz-Meta: " PATH_FIRST_ENCODE_AND_LF_OOM "\r\n\r\n";
+    size_t i;
+
+    params.pHttpParameters->pPayload = pPayload;
+    params.pHttpParameters->payloadLen = strlen( pPayload );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    for( i = 0U; i < HEADERS_LENGTH; i++ )
+    {
+        params.pHttpParameters->pHeaders = HEADERS;
+        params.pHttpParameters->headersLen = HEADERS_LENGTH - i;
+        params.pHttpParameters->pHeadersWrap = &( HEADERS[ HEADERS_LENGTH - i ] );
+        params.pHttpParameters->headersWrapLen = i;
+        params.pHttpParameters->pQuery = QUERY;
+        params.pHttpParameters->queryLen = QUERY_LENGTH - ( i % QUERY_LENGTH );
+        params.pHttpParameters->pQueryWrap = &( QUERY[ QUERY_LENGTH - ( i % QUERY_LENGTH ) ] );
+        params.pHttpParameters->queryWrapLen = i % QUERY_LENGTH;
+        params.pHttpParameters->payloadLen = strlen( pPayload ) - ( i % strlen( pPayload ) );
+        params.pHttpParameters->pPayloadWrap = &( pPayload[ params.pHttpParameters->payloadLen ] );
+        params.pHttpParameters->payloadWrapLen = i % strlen( pPayload );
+        authBufLen = AUTH_BUF_LENGTH;
+        returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+        TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+    }
+
+    /* Canonical inputs are hashed in their two parts, and so is a payload digest. */
+    returnStatus = SigV4_HashPayload( &cryptoInterface, pPayload, strlen( pPayload ), payloadDigest, &payloadDigestLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    params.pHttpParameters->pHeaders = CANONICAL_HEADERS;
+    params.pHttpParameters->headersLen = 20U;
+    params.pHttpParameters->pHeadersWrap = &( CANONICAL_HEADERS[ 20 ] );
+    params.pHttpParameters->headersWrapLen = STR_LIT_LEN( CANONICAL_HEADERS ) - 20U;
+    params.pHttpParameters->pPayload = payloadDigest;
+    params.pHttpParameters->payloadLen = 10U;
+    params.pHttpParameters->pPayloadWrap = &( payloadDigest[ 10 ] );
+    params.pHttpParameters->payloadWrapLen = payloadDigestLen - 10U;
+    params.pHttpParameters->flags = SIGV4_HTTP_ALL_ARE_CANONICAL_FLAG | SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pHttpParameters->payloadWrapLen = 0U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    /* The line that straddles the end of the ring buffer must fit in the processing buffer. */
+    params.pHttpParameters->flags = 0U;
+    params.pHttpParameters->pPayloadWrap = NULL;
+    params.pHttpParameters->pHeaders = pLongHeaders;
+    params.pHttpParameters->headersLen = 100U;
+    params.pHttpParameters->pHeadersWrap = &( pLongHeaders[ 100 ] );
+    params.pHttpParameters->headersWrapLen = strlen( pLongHeaders ) - 100U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    /* Parsing stops at the first part of the query that fails. */
+    params.pHttpParameters->pHeaders = HEADERS;
+    params.pHttpParameters->headersLen = HEADERS_LENGTH;
+    params.pHttpParameters->pHeadersWrap = NULL;
+    params.pHttpParameters->headersWrapLen = 0U;
+    params.pHttpParameters->pQuery = "a=1&b=2&c=3&d=4&e=5&f=6&";
+    params.pHttpParameters->queryLen = STR_LIT_LEN( "a=1&b=2&c=3&d=4&e=5&f=6&" );
+    params.pHttpParameters->pQueryWrap = "g=7";
+    params.pHttpParameters->queryWrapLen = STR_LIT_LEN( "g=7" );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4MaxQueryPairCountExceeded, returnStatus );
+}
+
+/**
+ * @brief Test that headers and a query held entirely in their wrapped part,
+ * as when a ring buffer wraps right at their start, sign the same as
+ * contiguous inputs.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Wrapped_At_Start()
+{
+    SigV4Status_t returnStatus;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* The first parts may be empty... */
+    params.pHttpParameters->pHeaders = HEADERS;
+    params.pHttpParameters->headersLen = 0U;
+    params.pHttpParameters->pHeadersWrap = HEADERS;
+    params.pHttpParameters->headersWrapLen = HEADERS_LENGTH;
+    params.pHttpParameters->pQuery = QUERY;
+    params.pHttpParameters->queryLen = 0U;
+    params.pHttpParameters->pQueryWrap = QUERY;
+    params.pHttpParameters->queryWrapLen = QUERY_LENGTH;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* ...or NULL. */
+    params.pHttpParameters->pHeaders = NULL;
+    params.pHttpParameters->pQuery = NULL;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* Canonical inputs are hashed from their wrapped part alone. */
+    params.pHttpParameters->pHeadersWrap = CANONICAL_HEADERS;
+    params.pHttpParameters->headersWrapLen = STR_LIT_LEN( CANONICAL_HEADERS );
+    params.pHttpParameters->flags = SIGV4_HTTP_ALL_ARE_CANONICAL_FLAG;
+    authBufLen = AUTH_BUF_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    /* The headers must still not be empty as a whole. */
+    params.pHttpParameters->flags = 0U;
+    params.pHttpParameters->headersWrapLen = 0U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    params.pHttpParameters->pHeadersWrap = NULL;
+    params.pHttpParameters->headersWrapLen = HEADERS_LENGTH;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+
+    /* A NULL first part must have no length. */
+    params.pHttpParameters->headersLen = HEADERS_LENGTH;
+    params.pHttpParameters->pHeadersWrap = HEADERS;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
+}
+
 /* Test that the library fails when invalid HTTP headers are passed. */
 void test_SigV4_GenerateHTTPAuthorization_InvalidHTTPHeaders()
 {
@@ -900,9 +2619,21 @@ void test_SigV4_GenerateHTTPAuthorization_InvalidHTTPHeaders()
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
 
-    params.pHttpParameters->pHeaders = INVALID_PRECANON_HEADERS_NO_HEADER_KEY;
-    params.pHttpParameters->headersLen = strlen( INVALID_PRECANON_HEADERS_NO_HEADER_KEY );
-    params.pHttpParameters->flags = SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG;
+    params.pHttpParameters->pHeaders = INVALID_PRECANON_HEADERS_NO_HEADER_KEY;
+    params.pHttpParameters->headersLen = strlen( INVALID_PRECANON_HEADERS_NO_HEADER_KEY );
+    params.pHttpParameters->flags = SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
+
+    /* A header must have a name, in either form. */
+    params.pHttpParameters->pHeaders = "Host: iam.amazonaws.com\n:a\n";
+    params.pHttpParameters->headersLen = STR_LIT_LEN( "Host: iam.amazonaws.com\n:a\n" );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
+
+    params.pHttpParameters->pHeaders = ":a\r\n\r\n";
+    params.pHttpParameters->headersLen = STR_LIT_LEN( ":a\r\n\r\n" );
+    params.pHttpParameters->flags = 0;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4InvalidHttpHeaders, returnStatus );
 }
@@ -915,21 +2646,22 @@ void test_SigV4_GenerateHTTPAuthorization_InvalidHTTPHeaders()
 void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
 {
     SigV4Status_t returnStatus;
+    SigV4SigningKeyCache_t signingKeyCache;
 
     authBufLen = params.pCryptoInterface->hashDigestLen * 2;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
 
-    /* Insufficient memory error when there is not enough space to write the
-     * Method data in the processing buffer. This case is created by using a method string
-     * longer than the processing buffer length. */
+    /* The Method data is hashed in place, so a method string longer than the
+     * processing buffer length does not cause OOM. */
     char * pMethodData = malloc( SIGV4_PROCESSING_BUFFER_LENGTH );
 
     memset( pMethodData, ( int ) 'M', SIGV4_PROCESSING_BUFFER_LENGTH );
+    resetInputParams();
     params.pHttpParameters->pHttpMethod = pMethodData;
     params.pHttpParameters->httpMethodLen = SIGV4_PROCESSING_BUFFER_LENGTH;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
-    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
     free( pMethodData );
 
     /* BEGIN: Coverage for generateCanonicalURI(). */
@@ -988,15 +2720,14 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
     /* END: Coverage for writeCanonicalQueryParameters(). */
 
-    /* BEGIN: Coverage for writeLineToCanonicalRequest(). */
-    /* Writing a precanonicalized query to the processing buffer causes OOM. */
+    /* A precanonicalized query is hashed in place, so a query longer than the
+     * processing buffer does not cause OOM. */
     resetInputParams();
     params.pHttpParameters->pQuery = PRECANON_QUERY_TOO_LONG;
     params.pHttpParameters->queryLen = STR_LIT_LEN( PRECANON_QUERY_TOO_LONG );
     params.pHttpParameters->flags = SIGV4_HTTP_QUERY_IS_CANONICAL_FLAG;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
-    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
-    /* END: Coverage for writeLineToCanonicalRequest(). */
+    TEST_ASSERT_EQUAL( SigV4Success, returnStatus );
 
     /* Test case of insufficient memory when "String to Sign" cannot be stored in processing buffer.
      * This scenario is produced by using a long AWS Region string (which is one of the parameters of String To Sign). */
@@ -1012,16 +2743,16 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     free( longRegion );
 
     /* Test case of insufficient memory when hexstring of hash cannot be stored in processing buffer.
-     * This case is created by using long pre-canonicalized headers that does not leave space for Payload
-     * hash in the processing buffer. */
+     * This case is created by using a pre-canonicalized header with a long name, whose signed headers
+     * list does not leave space for Payload hash in the processing buffer. */
     size_t headersLen = SIGV4_PROCESSING_BUFFER_LENGTH - ( SIGV4_HASH_MAX_DIGEST_LENGTH * 2 );
     char * longPrecanonHeader = malloc( headersLen );
 
     TEST_ASSERT_NOT_NULL( longPrecanonHeader );
-    longPrecanonHeader[ 0 ] = 'H';
-    longPrecanonHeader[ 1 ] = ':';
-    /* Fill gibberish string data in the buffer for the precanonical header. */
-    memset( longPrecanonHeader + 2, ( char ) 'V', headersLen - 3 );
+    /* Fill gibberish string data in the buffer for the precanonical header name. */
+    memset( longPrecanonHeader, ( char ) 'h', headersLen - 3 );
+    longPrecanonHeader[ headersLen - 3 ] = ':';
+    longPrecanonHeader[ headersLen - 2 ] = 'V';
     longPrecanonHeader[ headersLen - 1 ] = '\n';
     resetInputParams();
     params.pHttpParameters->pPath = NULL;
@@ -1033,16 +2764,23 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     params.pHttpParameters->flags = SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    /* Same as above, but with a payload digest supplied by the application. */
+    params.pHttpParameters->pPayload = EMPTY_PAYLOAD_DIGEST;
+    params.pHttpParameters->payloadLen = STR_LIT_LEN( EMPTY_PAYLOAD_DIGEST );
+    params.pHttpParameters->flags = SIGV4_HTTP_HEADERS_ARE_CANONICAL_FLAG | SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
     free( longPrecanonHeader );
 
     /* Test case of insufficient memory from failure to encode a special character when
      * writing canonical path. This is achieved by using a long path that ends with the special
      * character for which there doesn't exist space in the processing buffer. */
-    size_t longPathLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN;
+    size_t longPathLen = SIGV4_PROCESSING_BUFFER_LENGTH;
     char specialCharAtEndOfLongPath[ longPathLen ];
 
     specialCharAtEndOfLongPath[ 0 ] = '/';
-    memset( specialCharAtEndOfLongPath + 1, ( int ) '-', longPathLen );
+    memset( specialCharAtEndOfLongPath + 1, ( int ) '-', longPathLen - 1U );
     specialCharAtEndOfLongPath[ longPathLen - 1 ] = '*';
     resetInputParams();
     params.pHttpParameters->pPath = specialCharAtEndOfLongPath;
@@ -1053,8 +2791,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     /* Test case of insufficient memory when there is no space in the processing buffer for
      * double encoding '=' character, that is part of query parameter value, while creating
      * canonical query. */
-    size_t longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen -
-                          LINEFEED_CHAR_LEN - HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN;
+    size_t longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN;
     char * longQuery = malloc( longQueryLen );
 
     TEST_ASSERT_NOT_NULL( longQuery );
@@ -1075,7 +2812,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     /* Case of insufficient memory when adding Header part of Canonical Header to processing buffer.
      * This case is created by using a long header name that causes space to run out when adding
      * Canonical Headers.  */
-    headersLen = ( SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    headersLen = ( SIGV4_PROCESSING_BUFFER_LENGTH -
                    HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN -
                    /* Empty Query*/
                    LINEFEED_CHAR_LEN ) +
@@ -1106,7 +2843,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     /* Case of insufficient memory when newline character after Canonical Headers to processing buffer.
      * This case is created by using a long header name that causes no space availability for the
      * new line character after the Canonical headers in the processing buffer .  */
-    headersLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    headersLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                  HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN -
                  /* Empty Query*/
                  LINEFEED_CHAR_LEN +
@@ -1133,13 +2870,14 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
 
     /* Case of insufficient memory when adding signed headers to processing buffer.
      * This case is created by using a long header name that causes the Signed Header part of the
-     * Canonical Request run out of memory.  */
-    headersLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+     * Canonical Request run out of memory. The pre-canonicalized headers themselves are hashed
+     * in place, so only the Signed Headers take space after the path and query. */
+    headersLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                  HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN -
                  /* Empty Query*/
-                 LINEFEED_CHAR_LEN -
-                 /* New line after Canonical Headers just before writing Signed Headers. */
-                 LINEFEED_CHAR_LEN;
+                 LINEFEED_CHAR_LEN +
+                 /* The ':' and newline characters that follow the header name. */
+                 2U;
     longPrecanonHeader = malloc( headersLen );
     TEST_ASSERT_NOT_NULL( longPrecanonHeader );
     /* Set gibberish header key data. */
@@ -1161,7 +2899,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     /* Case of insufficient memory when adding '=' character between query parameter and value.
     * This case is created by using a long query parameter that causes the processing buffer
     * to have no space when writing the equals to separator after the query parameter name.  */
-    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                    HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN +
                    /* '=' separate and parameter value. */
                    2U;
@@ -1183,7 +2921,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     /* Case of insufficient memory when adding '&' character between query parameter entries.
      * This case is created by using a long query parameter that causes the processing buffer
      * to have no space when encoding the '&' character for the second query parameter.  */
-    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                    HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN +
                    /* 2nd query parameter entry. */
                    4U;
@@ -1206,7 +2944,7 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
      * buffer.
      * This case is created by using a long query parameter that leaves no space for the newline character
      * after the canonical query data. */
-    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                    HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN;
     longQuery = malloc( longQueryLen );
     TEST_ASSERT_NOT_NULL( longQuery );
@@ -1222,6 +2960,25 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
     free( longQuery );
 
+    /* The same case without query parameters, using a long path that leaves no
+     * space for the newline character after the empty canonical query. We use S3
+     * service so that the path is encoded once. */
+    longQueryLen = SIGV4_PROCESSING_BUFFER_LENGTH - LINEFEED_CHAR_LEN;
+    longQuery = malloc( longQueryLen );
+    TEST_ASSERT_NOT_NULL( longQuery );
+    memset( longQuery, ( int ) 'P', longQueryLen );
+    longQuery[ 0 ] = '/';
+    resetInputParams();
+    params.pService = S3_SERVICE_NAME;
+    params.serviceLen = S3_SERVICE_NAME_LEN;
+    params.pHttpParameters->pPath = longQuery;
+    params.pHttpParameters->pathLen = longQueryLen;
+    params.pHttpParameters->pQuery = NULL;
+    params.pHttpParameters->queryLen = 0U;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+    free( longQuery );
+
     /* Test case when there is insufficient processing buffer space for writing signing key.
      * This case is created by using a long Region value that causes the "String to Sign" data
      * to crowd out space for the Signing Key. */
@@ -1229,14 +2986,38 @@ void test_SigV4_GenerateHTTPAuthorization_InsufficientMemory()
     size_t longRegionLen = SIGV4_PROCESSING_BUFFER_LENGTH - lenOfStringToSignWithoutRegion;
 
     /*size_t longRegionLen = SIGV4_PROCESSING_BUFFER_LENGTH - 4 * SIGV4_HASH_MAX_DIGEST_LENGTH; */
-    longRegion = malloc( longRegionLen );
+    /* The buffer is long enough to be the long algorithm below too. */
+    longRegion = malloc( longRegionLen + SIGV4_AWS4_HMAC_SHA256_LENGTH );
     /* Fill gibberish in the long region name. */
-    memset( longRegion, ( int ) 'R', longRegionLen );
+    memset( longRegion, ( int ) 'R', longRegionLen + SIGV4_AWS4_HMAC_SHA256_LENGTH );
     resetInputParams();
     params.pRegion = longRegion;
     params.regionLen = longRegionLen;
     returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
     TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    /* Test case when the signing key is cached, but there is insufficient processing
+     * buffer space for computing the signature. A long algorithm crowds out the
+     * buffer like the long region, without making the scope too long to cache. */
+    memset( &signingKeyCache, 0, sizeof( signingKeyCache ) );
+    signingKeyCache.scopeIdLen = snprintf( signingKeyCache.pScopeId, sizeof( signingKeyCache.pScopeId ),
+                                           "%s/%.8s/%s/%s", ACCESS_KEY_ID, DATE, REGION, SERVICE );
+    ( void ) SHA256( ( const unsigned char * ) SECRET_KEY, SECRET_KEY_LEN, signingKeyCache.pSecretDigest );
+    signingKeyCache.secretAccessKeyLen = SECRET_KEY_LEN;
+    signingKeyCache.signingKeyLen = SIGV4_HASH_MAX_DIGEST_LENGTH;
+    params.pRegion = REGION;
+    params.regionLen = strlen( REGION );
+    params.pAlgorithm = longRegion;
+    params.algorithmLen = longRegionLen - strlen( REGION ) + SIGV4_AWS4_HMAC_SHA256_LENGTH;
+    params.pSigningKeyCache = &signingKeyCache;
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+
+    /* A signing key that cannot be derived is not cached. */
+    memset( &signingKeyCache, 0, sizeof( signingKeyCache ) );
+    returnStatus = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, returnStatus );
+    TEST_ASSERT_EQUAL( 0U, signingKeyCache.signingKeyLen );
     free( longRegion );
 }
 
@@ -1310,6 +3091,899 @@ void test_SigV4_Hash_Key_Prefix_Small_Than_Block_Size()
     TEST_ASSERT_EQUAL_MESSAGE( SigV4HashError, returnStatus, "2nd call to hashInit should fail when hashing SigV4 key prefix." );
 }
 
+/**
+ * @brief Sign the test request with the native HMAC interfaces set to OpenSSL's
+ * HMAC and return the status, resetting the HMAC failure counters first.
+ */
+static SigV4Status_t signWithNativeHmac( void * pHmacContext )
+{
+    hmacInitCalledCount = 0U;
+    hmacUpdateCalledCount = 0U;
+    hmacFinalCalledCount = 0U;
+    params.pCryptoInterface->hmacInit = hmac_init_failable;
+    params.pCryptoInterface->hmacUpdate = hmac_update_failable;
+    params.pCryptoInterface->hmacFinal = hmac_final_failable;
+    params.pCryptoInterface->pHmacContext = pHmacContext;
+    authBufLen = AUTH_BUF_LENGTH;
+
+    return SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen );
+}
+
+/**
+ * @brief Test that the native HMAC interfaces replace the built-in HMAC and
+ * produce the same signature.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Native_Hmac()
+{
+    void * pHmacContext = NULL;
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    const char * pSecretKeys[] = { SECRET_KEY, SECRET_KEY_LONGER_THAN_HASH_BLOCK };
+    size_t i;
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLCryptoInit( &opensslHmac, &opensslHmacContext ) );
+    pHmacContext = opensslHmac.pHmacContext;
+
+    for( i = 0U; i < ( sizeof( pSecretKeys ) / sizeof( pSecretKeys[ 0 ] ) ); i++ )
+    {
+        resetInputParams();
+        params.pCredentials->pSecretAccessKey = pSecretKeys[ i ];
+        params.pCredentials->secretAccessKeyLen = strlen( pSecretKeys[ i ] );
+        TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+        TEST_ASSERT_EQUAL( sizeof( expectedSignature ), signatureLen );
+        memcpy( expectedSignature, signature, signatureLen );
+
+        /* Four rounds derive the signing key and one signs the request. */
+        TEST_ASSERT_EQUAL( SigV4Success, signWithNativeHmac( pHmacContext ) );
+        TEST_ASSERT_EQUAL( 5U, hmacInitCalledCount );
+        TEST_ASSERT_EQUAL( 5U, hmacFinalCalledCount );
+        TEST_ASSERT_EQUAL( sizeof( expectedSignature ), signatureLen );
+        TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, signatureLen );
+    }
+
+    /* The built-in HMAC is used unless all of the interfaces are set. */
+    params.pCryptoInterface->hmacFinal = NULL;
+    hmacInitCalledCount = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 0U, hmacInitCalledCount );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, signatureLen );
+
+    params.pCryptoInterface->hmacUpdate = NULL;
+    params.pCryptoInterface->hmacFinal = hmac_final_failable;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 0U, hmacInitCalledCount );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, signatureLen );
+
+    /* Errors of the native HMAC interfaces are hash errors. */
+    for( i = 0U; i < 5U; i++ )
+    {
+        hmacInitCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, signWithNativeHmac( pHmacContext ) );
+        hmacInitCallToFail = SIZE_MAX;
+
+        hmacUpdateCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, signWithNativeHmac( pHmacContext ) );
+        hmacUpdateCallToFail = SIZE_MAX;
+
+        hmacFinalCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, signWithNativeHmac( pHmacContext ) );
+        hmacFinalCallToFail = SIZE_MAX;
+    }
+
+    /* Hashing down a key longer than a block still uses the hash interfaces. */
+    resetFailableHashParams();
+    hashInitCallToFail = 2U;
+    TEST_ASSERT_EQUAL( SigV4HashError, signWithNativeHmac( pHmacContext ) );
+
+    SigV4_OpenSSLCryptoCleanup( &opensslHmacContext );
+}
+
+/**
+ * @brief Test that the vectored hash update replaces consecutive hash updates
+ * and produces the same signature.
+ */
+void test_SigV4_GenerateHTTPAuthorization_Vectored_Hash_Update()
+{
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t i;
+
+    params.pCredentials->pSecretAccessKey = SECRET_KEY_LONGER_THAN_HASH_BLOCK;
+    params.pCredentials->secretAccessKeyLen = strlen( SECRET_KEY_LONGER_THAN_HASH_BLOCK );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    memcpy( expectedSignature, signature, signatureLen );
+
+    /* Each hash of the payload, the canonical request, the long key, and the
+     * ten inner and outer hashes of the HMACs takes one call. */
+    params.pCryptoInterface->hashUpdateV = sha256_update_v_failable;
+    hashUpdateVCalledCount = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 13U, hashUpdateVCalledCount );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, signatureLen );
+
+    for( i = 0U; i < 13U; i++ )
+    {
+        hashUpdateVCalledCount = 0U;
+        hashUpdateVCallToFail = i;
+        authBufLen = AUTH_BUF_LENGTH;
+        TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    }
+
+    hashUpdateVCallToFail = SIZE_MAX;
+}
+
+/**
+ * @brief Sign the test request with @p pAdapter and compare the signature with
+ * the one of the test's own crypto interface.
+ */
+static void assertAdapterSignature( SigV4CryptoInterface_t * pAdapter )
+{
+    char expectedSignature[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+
+    params.pCryptoInterface = &cryptoInterface;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    memcpy( expectedSignature, signature, sizeof( expectedSignature ) );
+
+    params.pCryptoInterface = pAdapter;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL_MEMORY( expectedSignature, signature, sizeof( expectedSignature ) );
+}
+
+/**
+ * @brief Test the portable SHA-256 crypto adapter.
+ */
+void test_SigV4_Sha256_Crypto_Adapter()
+{
+    SigV4Sha256Context_t sha256Context;
+    SigV4CryptoInterface_t adapter;
+    uint8_t input[ 300 ];
+    uint8_t digest[ SIGV4_SHA256_DIGEST_LENGTH ], expectedDigest[ SIGV4_SHA256_DIGEST_LENGTH ];
+    size_t inputLen, split;
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_Sha256CryptoInit( NULL, &sha256Context ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_Sha256CryptoInit( &adapter, NULL ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_Sha256CryptoInit( &adapter, &sha256Context ) );
+    TEST_ASSERT_NULL( adapter.hmacInit );
+
+    /* Every input length up to several blocks, split in two updates at every
+     * third position, hashes the same as OpenSSL. */
+    for( inputLen = 0U; inputLen < sizeof( input ); inputLen++ )
+    {
+        input[ inputLen ] = ( uint8_t ) ( inputLen * 7U );
+        SHA256( input, inputLen, expectedDigest );
+
+        for( split = 0U; split <= inputLen; split += 3U )
+        {
+            TEST_ASSERT_EQUAL( 0, adapter.hashInit( adapter.pHashContext ) );
+            TEST_ASSERT_EQUAL( 0, adapter.hashUpdate( adapter.pHashContext, input, split ) );
+            TEST_ASSERT_EQUAL( 0, adapter.hashUpdate( adapter.pHashContext, &input[ split ], inputLen - split ) );
+            TEST_ASSERT_EQUAL( 0, adapter.hashFinal( adapter.pHashContext, digest, sizeof( digest ) ) );
+            TEST_ASSERT_EQUAL_MEMORY( expectedDigest, digest, sizeof( digest ) );
+        }
+    }
+
+    TEST_ASSERT_EQUAL( 0, adapter.hashInit( adapter.pHashContext ) );
+    TEST_ASSERT_EQUAL( -1, adapter.hashFinal( adapter.pHashContext, digest, sizeof( digest ) - 1U ) );
+
+    assertAdapterSignature( &adapter );
+}
+
+/**
+ * @brief Test the OpenSSL crypto adapter and its duplicates.
+ */
+void test_SigV4_OpenSSL_Crypto_Adapter()
+{
+    SigV4OpenSSLContext_t opensslContext, opensslCopy;
+    SigV4CryptoInterface_t adapter, adapterCopy;
+    uint8_t digest[ SIGV4_HASH_MAX_DIGEST_LENGTH ];
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLCryptoInit( NULL, &opensslContext ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLCryptoInit( &adapter, NULL ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLCryptoInit( &adapter, &opensslContext ) );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_BLOCK_LENGTH, adapter.hashBlockLen );
+    TEST_ASSERT_EQUAL( SIGV4_HASH_MAX_DIGEST_LENGTH, adapter.hashDigestLen );
+    TEST_ASSERT_NOT_NULL( adapter.hmacInit );
+    assertAdapterSignature( &adapter );
+
+    /* The built-in HMAC on the OpenSSL hash gives the same signature. */
+    adapter.hmacInit = NULL;
+    assertAdapterSignature( &adapter );
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLCryptoDuplicate( NULL, &opensslCopy, &opensslContext ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLCryptoDuplicate( &adapterCopy, NULL, &opensslContext ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLCryptoDuplicate( &adapterCopy, &opensslCopy, NULL ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLCryptoDuplicate( &adapterCopy, &opensslCopy, &opensslContext ) );
+
+    /* The duplicate stays usable once the original is released. */
+    SigV4_OpenSSLCryptoCleanup( &opensslContext );
+    assertAdapterSignature( &adapterCopy );
+
+    TEST_ASSERT_EQUAL( 0, adapterCopy.hashInit( adapterCopy.pHashContext ) );
+    TEST_ASSERT_EQUAL( -1, adapterCopy.hashFinal( adapterCopy.pHashContext, digest, sizeof( digest ) - 1U ) );
+    TEST_ASSERT_EQUAL( 0, adapterCopy.hmacInit( adapterCopy.pHmacContext, ( const uint8_t * ) "key", 3U ) );
+    TEST_ASSERT_EQUAL( -1, adapterCopy.hmacFinal( adapterCopy.pHmacContext, digest, sizeof( digest ) - 1U ) );
+
+    SigV4_OpenSSLCryptoCleanup( &opensslCopy );
+    SigV4_OpenSSLCryptoCleanup( NULL );
+}
+
+/* The get-vanilla request of the SigV4A test suite, its credentials, and the
+ * public point of the key they derive. */
+#define SIGV4A_ACCESS_KEY_ID          "AKIDEXAMPLE"
+#define SIGV4A_DATE                   "20150830T123600Z"
+#define SIGV4A_SERVICE                "service"
+#define SIGV4A_HEADERS                "Host:example.amazonaws.com\r\nX-Amz-Date:" SIGV4A_DATE "\r\nX-Amz-Region-Set:us-east-1\r\n\r\n"
+#define SIGV4A_CANONICAL_REQUEST                                                       \
+    "GET\n/\n\nhost:example.amazonaws.com\nx-amz-date:" SIGV4A_DATE                     \
+    "\nx-amz-region-set:us-east-1\n\nhost;x-amz-date;x-amz-region-set\n" EMPTY_PAYLOAD_DIGEST
+#define SIGV4A_CREDENTIAL_SCOPE       "20150830/" SIGV4A_SERVICE "/aws4_request"
+#define SIGV4A_STRING_TO_SIGN_LENGTH                                                     \
+    ( STR_LIT_LEN( SIGV4_AWS4_ECDSA_P256_SHA256 "\n" SIGV4A_DATE "\n" SIGV4A_CREDENTIAL_SCOPE "\n" ) + \
+      ( 2U * SHA256_DIGEST_LENGTH ) )
+#define SIGV4A_AUTH_PREFIX                                                                         \
+    SIGV4_AWS4_ECDSA_P256_SHA256 " Credential=" SIGV4A_ACCESS_KEY_ID "/20150830/" SIGV4A_SERVICE \
+    "/aws4_request, SignedHeaders=host;x-amz-date;x-amz-region-set, Signature="
+#define SIGV4A_PUBLIC_KEY                                                                  \
+    "\x04\xb6\x61\x8f\x6a\x65\x74\x0a\x99\xe6\x50\xb3\x3b\x6b\x4b\x5b\xd0\xd4\x3b\x17\x6d" \
+    "\x72\x1a\x3e\xdf\xea\x7e\x7d\x2d\x56\xd9\x36\xb1\x86\x5e\xd2\x2a\x7e\xad\xc9\xc5\xcb" \
+    "\x9d\x2c\xba\xca\x1b\x36\x99\x13\x9f\xed\xc5\x04\x3d\xc6\x66\x18\x64\x21\x83\x30\xc8" \
+    "\xe5\x18"
+
+/**
+ * @brief Set up the parameters to sign the SigV4A get-vanilla request through
+ * the failable wrappers of the OpenSSL ECDSA interface.
+ */
+static void resetSigV4AParams( SigV4EcdsaInterface_t * pEcdsaInterface,
+                               SigV4EcdsaKeyCache_t * pEcdsaKeyCache )
+{
+    resetInputParams();
+    creds.pAccessKeyId = SIGV4A_ACCESS_KEY_ID;
+    creds.accessKeyIdLen = STR_LIT_LEN( SIGV4A_ACCESS_KEY_ID );
+    params.pAlgorithm = SIGV4_AWS4_ECDSA_P256_SHA256;
+    params.algorithmLen = SIGV4_AWS4_ECDSA_P256_SHA256_LENGTH;
+    params.pDateIso8601 = SIGV4A_DATE;
+    params.pRegion = NULL;
+    params.regionLen = 0U;
+    params.pService = SIGV4A_SERVICE;
+    params.serviceLen = STR_LIT_LEN( SIGV4A_SERVICE );
+    httpParams.pQuery = NULL;
+    httpParams.queryLen = 0U;
+    httpParams.pHeaders = SIGV4A_HEADERS;
+    httpParams.headersLen = STR_LIT_LEN( SIGV4A_HEADERS );
+
+    pEcdsaInterface->loadKey = ecdsa_load_key_failable;
+    pEcdsaInterface->sign = ecdsa_sign_failable;
+    pEcdsaInterface->pEcdsaContext = &opensslEcdsaContext;
+    params.pEcdsaInterface = pEcdsaInterface;
+    params.pEcdsaKeyCache = pEcdsaKeyCache;
+    ecdsaLoadKeyCalledCount = 0U;
+    ecdsaSignCalledCount = 0U;
+    ecdsaSignatureLen = SIZE_MAX;
+}
+
+/**
+ * @brief Check that the Authorization header value in authBuf holds a valid
+ * signature of the SigV4A get-vanilla request by the key of the test suite.
+ */
+static void assertSigV4ASignature( void )
+{
+    uint8_t digest[ SHA256_DIGEST_LENGTH ];
+    uint8_t derSignature[ SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH ];
+    uint8_t publicKey[ 65 ];
+    char stringToSign[ SIGV4A_STRING_TO_SIGN_LENGTH + 1U ];
+    size_t publicKeyLen = 0U, derSignatureLen, i, stringToSignLen;
+    int written;
+    unsigned int byte;
+    EVP_PKEY_CTX * pVerifyContext;
+
+    /* The key derived from the credentials is the one of the test suite. */
+    TEST_ASSERT_EQUAL( 1, EVP_PKEY_get_octet_string_param( opensslEcdsaContext.pKey, OSSL_PKEY_PARAM_PUB_KEY,
+                                                           publicKey, sizeof( publicKey ), &publicKeyLen ) );
+    TEST_ASSERT_EQUAL( sizeof( publicKey ), publicKeyLen );
+    TEST_ASSERT_EQUAL_MEMORY( SIGV4A_PUBLIC_KEY, publicKey, sizeof( publicKey ) );
+
+    /* The string to sign has no region in its credential scope. */
+    SHA256( ( const uint8_t * ) SIGV4A_CANONICAL_REQUEST, STR_LIT_LEN( SIGV4A_CANONICAL_REQUEST ), digest );
+    written = snprintf( stringToSign, sizeof( stringToSign ), "%s\n%s\n%s\n",
+                        SIGV4_AWS4_ECDSA_P256_SHA256, SIGV4A_DATE, SIGV4A_CREDENTIAL_SCOPE );
+    TEST_ASSERT_EQUAL( SIGV4A_STRING_TO_SIGN_LENGTH - ( 2U * SHA256_DIGEST_LENGTH ), written );
+    stringToSignLen = ( size_t ) written;
+
+    for( i = 0U; i < sizeof( digest ); i++ )
+    {
+        written = snprintf( &stringToSign[ stringToSignLen ], sizeof( stringToSign ) - stringToSignLen, "%02x", digest[ i ] );
+        TEST_ASSERT_EQUAL( 2, written );
+        stringToSignLen += ( size_t ) written;
+    }
+
+    TEST_ASSERT_EQUAL( SIGV4A_STRING_TO_SIGN_LENGTH, stringToSignLen );
+    SHA256( ( const uint8_t * ) stringToSign, stringToSignLen, digest );
+    TEST_ASSERT_EQUAL_MEMORY( digest, ecdsaSignedDigest, sizeof( digest ) );
+
+    TEST_ASSERT_EQUAL( STR_LIT_LEN( SIGV4A_AUTH_PREFIX ) + signatureLen, authBufLen );
+    TEST_ASSERT_EQUAL_MEMORY( SIGV4A_AUTH_PREFIX, authBuf, STR_LIT_LEN( SIGV4A_AUTH_PREFIX ) );
+    TEST_ASSERT_EQUAL_PTR( &authBuf[ STR_LIT_LEN( SIGV4A_AUTH_PREFIX ) ], signature );
+    TEST_ASSERT_EQUAL( 0U, signatureLen % 2U );
+    TEST_ASSERT_TRUE( signatureLen <= ( SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH * 2U ) );
+
+    derSignatureLen = signatureLen / 2U;
+
+    for( i = 0U; i < derSignatureLen; i++ )
+    {
+        TEST_ASSERT_EQUAL( 1, sscanf( &signature[ i * 2U ], "%2x", &byte ) );
+        derSignature[ i ] = ( uint8_t ) byte;
+    }
+
+    pVerifyContext = EVP_PKEY_CTX_new_from_pkey( NULL, opensslEcdsaContext.pKey, NULL );
+    TEST_ASSERT_NOT_NULL( pVerifyContext );
+    TEST_ASSERT_EQUAL( 1, EVP_PKEY_verify_init( pVerifyContext ) );
+    TEST_ASSERT_EQUAL( 1, EVP_PKEY_verify( pVerifyContext, derSignature, derSignatureLen, digest, sizeof( digest ) ) );
+    EVP_PKEY_CTX_free( pVerifyContext );
+}
+
+/**
+ * @brief Test SigV4A signing against the key and request of the SigV4A test
+ * suite, and the reuse of the imported key through the ECDSA key cache.
+ */
+void test_SigV4_GenerateHTTPAuthorization_SigV4A()
+{
+    SigV4EcdsaInterface_t ecdsaInterface;
+    SigV4EcdsaKeyCache_t ecdsaKeyCache = { 0 };
+    SigV4EcdsaInterface_t otherEcdsa;
+    SigV4OpenSSLEcdsaContext_t otherEcdsaContext;
+    SigV4IoVec_t iov[ SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+    size_t iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    char iovBuf[ 200 ];
+    char iovAuth[ AUTH_BUF_LENGTH ];
+    char longAccessKeyId[ SIGV4_SIGNING_KEY_CACHE_ID_LENGTH + 1U ];
+    char rotatedSecretKey[ SECRET_KEY_LEN ];
+    uint8_t carriedKey[ SIGV4_ECDSA_P256_PRIVATE_KEY_LENGTH ];
+    size_t iovAuthLen = 0U, i;
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLEcdsaInit( NULL, &opensslEcdsaContext ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_OpenSSLEcdsaInit( &opensslEcdsa, NULL ) );
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLEcdsaInit( &opensslEcdsa, &opensslEcdsaContext ) );
+    resetSigV4AParams( &ecdsaInterface, &ecdsaKeyCache );
+
+    /* No key is imported yet. */
+    TEST_ASSERT_EQUAL( -1, opensslEcdsa.sign( &opensslEcdsaContext, ecdsaSignedDigest, sizeof( ecdsaSignedDigest ),
+                                              ( uint8_t * ) iovBuf, &iovAuthLen ) );
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 1U, ecdsaLoadKeyCalledCount );
+    assertSigV4ASignature();
+
+    /* The key stays imported for the access key ID. */
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 1U, ecdsaLoadKeyCalledCount );
+    assertSigV4ASignature();
+
+    /* Another access key ID of the same length imports its own key, and one
+     * too long for the cache is imported for every request. */
+    creds.pAccessKeyId = "AKIDEXAMPLF";
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 2U, ecdsaLoadKeyCalledCount );
+    memset( longAccessKeyId, 'A', sizeof( longAccessKeyId ) );
+    creds.pAccessKeyId = longAccessKeyId;
+    creds.accessKeyIdLen = sizeof( longAccessKeyId );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 0U, ecdsaKeyCache.accessKeyIdLen );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 4U, ecdsaLoadKeyCalledCount );
+    creds.pAccessKeyId = SIGV4A_ACCESS_KEY_ID;
+    creds.accessKeyIdLen = STR_LIT_LEN( SIGV4A_ACCESS_KEY_ID );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 5U, ecdsaLoadKeyCalledCount );
+    assertSigV4ASignature();
+
+    /* The segments make up the same value, with an empty region. */
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, iovBuf, sizeof( iovBuf ) ) );
+    TEST_ASSERT_EQUAL( 5U, ecdsaLoadKeyCalledCount );
+    TEST_ASSERT_EQUAL( 0U, iov[ 6 ].dataLen + iov[ 7 ].dataLen );
+
+    for( i = 0U; i < iovCount; i++ )
+    {
+        memcpy( &iovAuth[ iovAuthLen ], iov[ i ].pData, iov[ i ].dataLen );
+        iovAuthLen += iov[ i ].dataLen;
+    }
+
+    memcpy( authBuf, iovAuth, iovAuthLen );
+    authBufLen = iovAuthLen;
+    signature = &authBuf[ STR_LIT_LEN( SIGV4A_AUTH_PREFIX ) ];
+    signatureLen = iov[ SIGV4_AUTHORIZATION_IOVEC_COUNT - 1U ].dataLen;
+    assertSigV4ASignature();
+
+    /* A rotated secret of the same access key ID, or another ECDSA context,
+     * imports the key again. */
+    memcpy( rotatedSecretKey, SECRET_KEY, SECRET_KEY_LEN );
+    rotatedSecretKey[ 0 ] ^= 1;
+    creds.pSecretAccessKey = rotatedSecretKey;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 6U, ecdsaLoadKeyCalledCount );
+    creds.pSecretAccessKey = SECRET_KEY;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 7U, ecdsaLoadKeyCalledCount );
+    assertSigV4ASignature();
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLEcdsaInit( &otherEcdsa, &otherEcdsaContext ) );
+    ecdsaInterface.pEcdsaContext = &otherEcdsaContext;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 8U, ecdsaLoadKeyCalledCount );
+    assertSigV4ASignature();
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 8U, ecdsaLoadKeyCalledCount );
+    creds.secretAccessKeyLen = SECRET_KEY_LEN - 1U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 9U, ecdsaLoadKeyCalledCount );
+    creds.secretAccessKeyLen = SECRET_KEY_LEN;
+    SigV4_OpenSSLEcdsaCleanup( &otherEcdsaContext );
+
+    /* Without a cache, the key is derived for every request, and a key whose
+     * HMAC is out of range is derived with the next counter. The HMAC is
+     * native so that its output can be replaced. */
+    resetSigV4AParams( &ecdsaInterface, NULL );
+    hmacFinalCalledCount = 0U;
+    hmacOutOfRangeCount = 1U;
+    cryptoInterface.hmacInit = hmac_init_failable;
+    cryptoInterface.hmacUpdate = hmac_update_failable;
+    cryptoInterface.hmacFinal = hmac_final_out_of_range;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLCryptoInit( &opensslHmac, &opensslHmacContext ) );
+    cryptoInterface.pHmacContext = opensslHmac.pHmacContext;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 2U, hmacFinalCalledCount );
+    TEST_ASSERT_EQUAL( 1U, ecdsaLoadKeyCalledCount );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( 2U, ecdsaLoadKeyCalledCount );
+
+    /* Adding one to a candidate carries through its low 0xFF bytes. */
+    cryptoInterface.hmacFinal = hmac_final_carry;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    memset( carriedKey, 0, sizeof( carriedKey ) );
+    carriedKey[ 0 ] = 1U;
+    TEST_ASSERT_EQUAL_MEMORY( carriedKey, ecdsaLoadedKey, sizeof( carriedKey ) );
+    cryptoInterface.hmacFinal = hmac_final_out_of_range;
+
+    /* The derivation gives up when no counter yields a key in range. */
+    hmacFinalCalledCount = 0U;
+    hmacOutOfRangeCount = SIZE_MAX;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SIGV4A_KDF_MAX_COUNTER, hmacFinalCalledCount );
+    hmacFinalCallToFail = 0U;
+    hmacFinalCalledCount = 0U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    hmacFinalCallToFail = SIZE_MAX;
+    SigV4_OpenSSLCryptoCleanup( &opensslHmacContext );
+
+    SigV4_OpenSSLEcdsaCleanup( &opensslEcdsaContext );
+    SigV4_OpenSSLEcdsaCleanup( NULL );
+}
+
+/**
+ * @brief Test the errors of SigV4A signing.
+ */
+void test_SigV4_GenerateHTTPAuthorization_SigV4A_Errors()
+{
+    SigV4EcdsaInterface_t ecdsaInterface;
+    SigV4EcdsaKeyCache_t ecdsaKeyCache = { 0 };
+    char longName[ 198 ];
+    SigV4IoVec_t iov[ SIGV4_AUTHORIZATION_IOVEC_COUNT ];
+    size_t iovCount = SIGV4_AUTHORIZATION_IOVEC_COUNT;
+    char iovBuf[ 200 ];
+    size_t hashCount, i;
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLEcdsaInit( &opensslEcdsa, &opensslEcdsaContext ) );
+    resetSigV4AParams( &ecdsaInterface, &ecdsaKeyCache );
+
+    /* SigV4A needs both ECDSA interfaces and SHA-256. */
+    params.pEcdsaInterface = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    params.pEcdsaInterface = &ecdsaInterface;
+    ecdsaInterface.loadKey = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaInterface.loadKey = ecdsa_load_key_failable;
+    ecdsaInterface.sign = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaInterface.sign = ecdsa_sign_failable;
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH - 1U;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    cryptoInterface.hashDigestLen = SIGV4_HASH_MAX_DIGEST_LENGTH;
+
+    /* Another algorithm of the same length is SigV4, which needs a region. */
+    params.pAlgorithm = "AWS4-ECDSA-P256-SHA255";
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    params.pAlgorithm = SIGV4_AWS4_ECDSA_P256_SHA256;
+
+    /* A failed import is not recorded in the cache. */
+    ecdsaLoadKeyCallToFail = 0U;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaLoadKeyCallToFail = SIZE_MAX;
+    TEST_ASSERT_EQUAL( 0U, ecdsaKeyCache.accessKeyIdLen );
+
+    ecdsaSignCallToFail = 0U;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaSignCallToFail = SIZE_MAX;
+    TEST_ASSERT_EQUAL( 2U, ecdsaLoadKeyCalledCount );
+
+    /* Signatures of no length, or longer than a DER signature can be, are
+     * rejected. */
+    ecdsaSignatureLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaSignatureLen = SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH + 1U;
+    TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    ecdsaSignatureLen = SIZE_MAX;
+
+    /* Hash failures, including the one of the digest of the string to sign
+     * and the one of the secret for the key cache, are reported. The failable
+     * hash leaves its digests unwritten, so every request starts from an
+     * empty cache. */
+    resetFailableHashParams();
+    ecdsaKeyCache.accessKeyIdLen = 0U;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    hashCount = hashInitCalledCount;
+
+    for( i = 0U; i < hashCount; i++ )
+    {
+        resetFailableHashParams();
+        hashInitCallToFail = i;
+        ecdsaKeyCache.accessKeyIdLen = 0U;
+        authBufLen = AUTH_BUF_LENGTH;
+        TEST_ASSERT_EQUAL( SigV4HashError, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    }
+
+    resetSigV4AParams( &ecdsaInterface, &ecdsaKeyCache );
+
+    /* The buffers must have room for the longest signature. */
+    authBufLen = STR_LIT_LEN( SIGV4A_AUTH_PREFIX ) + ( SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH * 2U ) - 1U;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory,
+                       SigV4_GenerateHTTPAuthorizationIov( &params, iov, &iovCount, iovBuf,
+                                                           STR_LIT_LEN( "host;x-amz-date;x-amz-region-set" ) + ( SIGV4_ECDSA_P256_MAX_SIGNATURE_LENGTH * 2U ) - 1U ) );
+
+    /* A long service name leaves no room after the string to sign for the
+     * digest and the signature, and a long access key ID none for the key
+     * derivation. */
+    memset( longName, 'a', sizeof( longName ) );
+    params.pService = longName;
+    params.serviceLen = sizeof( longName );
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    params.serviceLen = 150U;
+    creds.pAccessKeyId = longName;
+    creds.accessKeyIdLen = 60U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+    creds.accessKeyIdLen = 50U;
+    authBufLen = AUTH_BUF_LENGTH;
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &signature, &signatureLen ) );
+
+    SigV4_OpenSSLEcdsaCleanup( &opensslEcdsaContext );
+}
+
+/* The presigned URL example of the Amazon S3 documentation, whose query is
+ * given for any date and validity. */
+#define PRESIGN_SECRET_KEY    "wJalrXUtnFEMI/K7MDENG/bPxRfiCYEXAMPLEKEY"
+#define PRESIGN_DATE          "20130524T000000Z"
+#define PRESIGN_PATH          "/test.txt"
+#define PRESIGN_HEADERS       "Host: examplebucket.s3.amazonaws.com\r\n\r\n"
+#define PRESIGN_QUERY( date, expires )                                                         \
+    "X-Amz-Algorithm=AWS4-HMAC-SHA256&X-Amz-Credential=" ACCESS_KEY_ID                          \
+    "/20130524/us-east-1/s3/aws4_request&X-Amz-Date=" date "&X-Amz-Expires=" expires "&X-Amz-" \
+    "SignedHeaders=host"
+#define PRESIGN_SIGNATURE     "aeeed9bbccd4d02ee5c0109b86d86835f995330da4c265957d157751f604d404"
+
+static char presignSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ];
+static size_t presignSignatureLen;
+static char presignSigningDate[ SIGV4_ISO_STRING_LEN ];
+
+/**
+ * @brief Set up the parameters to sign the presigned URL example.
+ */
+static void resetPresignParams( void )
+{
+    resetInputParams();
+    creds.pSecretAccessKey = PRESIGN_SECRET_KEY;
+    creds.secretAccessKeyLen = STR_LIT_LEN( PRESIGN_SECRET_KEY );
+    params.pService = "s3";
+    params.serviceLen = 2U;
+    httpParams.flags = SIGV4_HTTP_IS_PRESIGNED_URL;
+    httpParams.pPath = PRESIGN_PATH;
+    httpParams.pathLen = STR_LIT_LEN( PRESIGN_PATH );
+    httpParams.pHeaders = PRESIGN_HEADERS;
+    httpParams.headersLen = STR_LIT_LEN( PRESIGN_HEADERS );
+}
+
+/**
+ * @brief Sign the presigned URL example at a date, with a query of that date.
+ */
+static SigV4Status_t generatePresigned( SigV4PresignCache_t * pPresignCache,
+                                        const char * pDate,
+                                        const char * pQuery )
+{
+    params.pDateIso8601 = pDate;
+    httpParams.pQuery = pQuery;
+    httpParams.queryLen = strlen( pQuery );
+    presignSignatureLen = sizeof( presignSignature );
+    memset( presignSigningDate, 0, sizeof( presignSigningDate ) );
+
+    return SigV4_GeneratePresignedSignature( &params, pPresignCache, presignSignature,
+                                             &presignSignatureLen, presignSigningDate );
+}
+
+/**
+ * @brief Test that a presigned URL signature is reused, along with its date,
+ * within its time bucket while enough of its validity remains.
+ */
+void test_SigV4_GeneratePresignedSignature_Cache()
+{
+    SigV4PresignCache_t presignCache;
+    size_t i;
+
+    resetPresignParams();
+    memset( &presignCache, 0, sizeof( presignCache ) );
+    presignCache.bucketSeconds = 3600U;
+    presignCache.minRemainingSeconds = 600U;
+
+    /* The signature matches the documented one, with or without a cache. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( NULL, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    TEST_ASSERT_EQUAL( 64U, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_SIGNATURE, presignSignature, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_DATE, presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_SIGNATURE, presignSignature, presignSignatureLen );
+    TEST_ASSERT_EQUAL( 1U, presignCache.useCounter );
+
+    /* Later in the same bucket, the request is served from the cache, with the
+     * date it was signed for. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T001500Z", PRESIGN_QUERY( "20130524T001500Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_SIGNATURE, presignSignature, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_DATE, presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( 2U, presignCache.useCounter );
+
+    /* Requests in the next bucket, to another path, or from a clock that went
+     * back are signed again. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T010000Z", PRESIGN_QUERY( "20130524T010000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T010000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_FALSE( memcmp( PRESIGN_SIGNATURE, presignSignature, presignSignatureLen ) == 0 );
+    httpParams.pPath = "/other.txt";
+    httpParams.pathLen = STR_LIT_LEN( "/other.txt" );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T011000Z", PRESIGN_QUERY( "20130524T011000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T011000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T010500Z", PRESIGN_QUERY( "20130524T010500Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T010500Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T011500Z", PRESIGN_QUERY( "20130524T011500Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T011000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+
+    /* Signatures with too little validity left are not reused. */
+    presignCache.minRemainingSeconds = 86000U;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T012000Z", PRESIGN_QUERY( "20130524T012000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T012000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+    presignCache.minRemainingSeconds = 0U;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020000Z", PRESIGN_QUERY( "20130524T020000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020200Z", PRESIGN_QUERY( "20130524T020200Z", "60" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T020200Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+
+    /* Requests that cannot be cached are signed without touching the cache. */
+    i = presignCache.useCounter;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Date=20130524T020300Z" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=60&X-Amz-Date" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=1m&X-Amz-Date=1" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=1234567890&X-Amz-Date=1" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "19691231T235959Z", PRESIGN_QUERY( "19691231T235959Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "21060101T000000Z", PRESIGN_QUERY( "21060101T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20131324T000000Z", PRESIGN_QUERY( "20131324T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T240000Z", PRESIGN_QUERY( "20130524T240000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130431T000000Z", PRESIGN_QUERY( "20130431T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130229T000000Z", PRESIGN_QUERY( "20130229T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "21000229T000000Z", PRESIGN_QUERY( "21000229T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20240230T000000Z", PRESIGN_QUERY( "20240230T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130500T000000Z", PRESIGN_QUERY( "20130500T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=&X-Amz-Date=1" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=-1&X-Amz-Date=1" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T020300Z", "X-Amz-Expires=60&Y-Amz-Date=1" ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524 000000Z", PRESIGN_QUERY( "20130524 000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T000000X", PRESIGN_QUERY( "20130524T000000X", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "2O130524T000000Z", PRESIGN_QUERY( "2O130524T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "2013O524T000000Z", PRESIGN_QUERY( "2013O524T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "201305Z4T000000Z", PRESIGN_QUERY( "201305Z4T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T0O0000Z", PRESIGN_QUERY( "20130524T0O0000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T00O000Z", PRESIGN_QUERY( "20130524T00O000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T0000O0Z", PRESIGN_QUERY( "20130524T0000O0Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130024T000000Z", PRESIGN_QUERY( "20130024T000000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T006000Z", PRESIGN_QUERY( "20130524T006000Z", "60" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T000060Z", PRESIGN_QUERY( "20130524T000060Z", "60" ) ) );
+    httpParams.pHeadersWrap = "";
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "60" ) ) );
+    httpParams.pHeadersWrap = NULL;
+    httpParams.pQueryWrap = "";
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "60" ) ) );
+    httpParams.pQueryWrap = NULL;
+    presignCache.bucketSeconds = 0U;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "60" ) ) );
+    TEST_ASSERT_EQUAL( i, presignCache.useCounter );
+
+    /* Signing more requests than the cache holds replaces the least recently
+     * used one, so the path signed last is still cached. */
+    presignCache.bucketSeconds = 86400U;
+
+    for( i = 0U; i <= SIGV4_PRESIGN_CACHE_ENTRY_COUNT; i++ )
+    {
+        httpParams.pathLen = STR_LIT_LEN( "/other.txt" ) - i;
+        TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T030000Z", PRESIGN_QUERY( "20130524T030000Z", "86400" ) ) );
+    }
+
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T040000Z", PRESIGN_QUERY( "20130524T040000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20130524T030000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+
+    /* Leap days are valid dates, in years divisible by 400 too. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20240229T000000Z", PRESIGN_QUERY( "20240229T000000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20240229T010000Z", PRESIGN_QUERY( "20240229T010000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20240229T000000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20000229T000000Z", PRESIGN_QUERY( "20000229T000000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20000229T010000Z", PRESIGN_QUERY( "20000229T010000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20000229T000000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+
+    /* Dates after a leap day are converted too. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20240301T000000Z", PRESIGN_QUERY( "20240301T000000Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20240301T235959Z", PRESIGN_QUERY( "20240301T235959Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( "20240301T000000Z", presignSigningDate, SIGV4_ISO_STRING_LEN );
+}
+
+/**
+ * @brief Test that a SigV4A presigned URL, whose scope has no region, is cached
+ * like a SigV4 one.
+ */
+void test_SigV4_GeneratePresignedSignature_SigV4A()
+{
+    SigV4EcdsaInterface_t ecdsaInterface;
+    SigV4EcdsaKeyCache_t ecdsaKeyCache = { 0 };
+    SigV4PresignCache_t presignCache;
+    char firstSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ];
+    size_t firstSignatureLen;
+
+    TEST_ASSERT_EQUAL( SigV4Success, SigV4_OpenSSLEcdsaInit( &opensslEcdsa, &opensslEcdsaContext ) );
+    resetSigV4AParams( &ecdsaInterface, &ecdsaKeyCache );
+    httpParams.flags = SIGV4_HTTP_IS_PRESIGNED_URL;
+    memset( &presignCache, 0, sizeof( presignCache ) );
+    presignCache.bucketSeconds = 3600U;
+
+    /* ECDSA signatures differ on every signing, so an equal signature is one
+     * served from the cache. */
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, SIGV4A_DATE, "X-Amz-Date=" SIGV4A_DATE "&X-Amz-Expires=60" ) );
+    TEST_ASSERT_EQUAL( 1U, ecdsaSignCalledCount );
+    memcpy( firstSignature, presignSignature, presignSignatureLen );
+    firstSignatureLen = presignSignatureLen;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20150830T123700Z", "X-Amz-Date=20150830T123700Z&X-Amz-Expires=60" ) );
+    TEST_ASSERT_EQUAL( 1U, ecdsaSignCalledCount );
+    TEST_ASSERT_EQUAL( firstSignatureLen, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( firstSignature, presignSignature, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( SIGV4A_DATE, presignSigningDate, SIGV4_ISO_STRING_LEN );
+    TEST_ASSERT_EQUAL( 2U, presignCache.useCounter );
+
+    /* A NULL region or path is part of the key as empty, whatever its
+     * length. */
+    params.regionLen = STR_LIT_LEN( REGION );
+    httpParams.pPath = NULL;
+    httpParams.pathLen = 5U;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, SIGV4A_DATE, "X-Amz-Date=" SIGV4A_DATE "&X-Amz-Expires=60" ) );
+    TEST_ASSERT_EQUAL( 2U, ecdsaSignCalledCount );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20150830T123700Z", "X-Amz-Date=20150830T123700Z&X-Amz-Expires=60" ) );
+    TEST_ASSERT_EQUAL( 2U, ecdsaSignCalledCount );
+
+    SigV4_OpenSSLEcdsaCleanup( &opensslEcdsaContext );
+}
+
+/**
+ * @brief Test that presigned URLs signing different payload digests are not
+ * served each other's signature from the cache.
+ */
+void test_SigV4_GeneratePresignedSignature_PayloadDigest()
+{
+    SigV4PresignCache_t presignCache;
+    char uncachedSignature[ SIGV4_MAX_ENCODED_SIGNATURE_LENGTH ];
+    size_t uncachedSignatureLen;
+    const char * pDigestA = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    const char * pDigestB = "2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824";
+
+    resetPresignParams();
+    httpParams.flags |= SIGV4_HTTP_PAYLOAD_IS_DIGEST;
+    httpParams.payloadLen = strlen( pDigestB );
+    memset( &presignCache, 0, sizeof( presignCache ) );
+    presignCache.bucketSeconds = 3600U;
+
+    httpParams.pPayload = pDigestB;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( NULL, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    memcpy( uncachedSignature, presignSignature, presignSignatureLen );
+    uncachedSignatureLen = presignSignatureLen;
+
+    httpParams.pPayload = pDigestA;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    TEST_ASSERT_FALSE( ( presignSignatureLen == uncachedSignatureLen ) &&
+                       ( memcmp( presignSignature, uncachedSignature, uncachedSignatureLen ) == 0 ) );
+    httpParams.pPayload = pDigestB;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    TEST_ASSERT_EQUAL( uncachedSignatureLen, presignSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( uncachedSignature, presignSignature, uncachedSignatureLen );
+
+    /* A digest wrapping around a ring buffer is part of the key too. */
+    httpParams.payloadLen = 10U;
+    httpParams.pPayloadWrap = &( pDigestB[ 10 ] );
+    httpParams.payloadWrapLen = strlen( pDigestB ) - 10U;
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( uncachedSignature, presignSignature, uncachedSignatureLen );
+    TEST_ASSERT_EQUAL( SigV4Success, generatePresigned( &presignCache, "20130524T001500Z", PRESIGN_QUERY( "20130524T001500Z", "86400" ) ) );
+    TEST_ASSERT_EQUAL_MEMORY( uncachedSignature, presignSignature, uncachedSignatureLen );
+    TEST_ASSERT_EQUAL_MEMORY( PRESIGN_DATE, presignSigningDate, SIGV4_ISO_STRING_LEN );
+}
+
+/**
+ * @brief Test the parameter checks and hash failures of presigned URL signing.
+ */
+void test_SigV4_GeneratePresignedSignature_Errors()
+{
+    SigV4PresignCache_t presignCache;
+    char pSigningDate[ SIGV4_ISO_STRING_LEN ];
+    size_t i;
+
+    resetPresignParams();
+    memset( &presignCache, 0, sizeof( presignCache ) );
+    presignCache.bucketSeconds = 3600U;
+    presignSignatureLen = sizeof( presignSignature );
+
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GeneratePresignedSignature( NULL, &presignCache, presignSignature, &presignSignatureLen, pSigningDate ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GeneratePresignedSignature( &params, &presignCache, NULL, &presignSignatureLen, pSigningDate ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GeneratePresignedSignature( &params, &presignCache, presignSignature, NULL, pSigningDate ) );
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GeneratePresignedSignature( &params, &presignCache, presignSignature, &presignSignatureLen, NULL ) );
+    params.pCredentials = NULL;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, SigV4_GeneratePresignedSignature( &params, &presignCache, presignSignature, &presignSignatureLen, pSigningDate ) );
+    params.pCredentials = &creds;
+
+    /* Only presigned URLs are signed. */
+    httpParams.flags = 0U;
+    TEST_ASSERT_EQUAL( SigV4InvalidParameter, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    httpParams.flags = SIGV4_HTTP_IS_PRESIGNED_URL;
+
+    /* Errors in the request are reported. */
+    TEST_ASSERT_EQUAL( SigV4MaxQueryPairCountExceeded, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) "&a=b" ) );
+
+    presignSignatureLen = 63U;
+    TEST_ASSERT_EQUAL( SigV4InsufficientMemory, SigV4_GeneratePresignedSignature( &params, &presignCache, presignSignature, &presignSignatureLen, pSigningDate ) );
+
+    /* Hash failures while computing the key, or while signing, are reported. */
+    for( i = 0U; i < 2U; i++ )
+    {
+        resetFailableHashParams();
+        hashInitCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+
+        resetFailableHashParams();
+        updateHashCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+
+        resetFailableHashParams();
+        finalHashCallToFail = i;
+        TEST_ASSERT_EQUAL( SigV4HashError, generatePresigned( &presignCache, PRESIGN_DATE, PRESIGN_QUERY( PRESIGN_DATE, "86400" ) ) );
+    }
+
+    TEST_ASSERT_EQUAL( 0U, presignCache.useCounter );
+}
+
 /**
  * @brief Test the case when the query string or header parameters exceed the max.
  */
@@ -1384,7 +4058,7 @@ void test_SigV4_GenerateAuthorization_Headers_Without_X_Amz_Content_Sha256_Heade
 void test_SigV4_GenerateAuthorization_Header_Key_Or_Value_With_All_White_Spaces()
 {
     SigV4Status_t returnStatus;
-    size_t headersLen = SIGV4_PROCESSING_BUFFER_LENGTH - httpParams.httpMethodLen - LINEFEED_CHAR_LEN -
+    size_t headersLen = SIGV4_PROCESSING_BUFFER_LENGTH -
                         HTTP_EMPTY_PATH_LEN - LINEFEED_CHAR_LEN -
                         /* Empty Query*/
                         LINEFEED_CHAR_LEN +
@@ -1411,3 +4085,60 @@ void test_SigV4_GenerateAuthorization_Header_Key_Or_Value_With_All_White_Spaces(
     TEST_ASSERT_EQUAL( SigV4InvalidParameter, returnStatus );
     free( longHeader );
 }
+
+/* ============================ Testing quickSort =========================== */
+
+/* Length and log2 of the arrays sorted in degenerate orders. */
+#define DEGENERATE_ORDER_LENGTH    1024U
+#define DEGENERATE_ORDER_LOG2      10U
+
+/**
+ * @brief Sort an array in a degenerate order, and verify that it is sorted
+ * within 8 * n * log2( n ) comparisons; a quadratic sort of this length takes
+ * over 50 * n * log2( n ).
+ */
+static void sortDegenerateOrderAndVerify( int32_t * pArray )
+{
+    cmpIntegerCount = 0U;
+    sortAndVerify( pArray, DEGENERATE_ORDER_LENGTH );
+    TEST_ASSERT_LESS_OR_EQUAL( 8U * DEGENERATE_ORDER_LENGTH * DEGENERATE_ORDER_LOG2, cmpIntegerCount );
+}
+
+/**
+ * @brief Test that orderings on which a last-item pivot degenerates, which are
+ * finished with heapsort, are sorted in O( n * log( n ) ) comparisons.
+ */
+void test_quickSort_Degenerate_Orders()
+{
+    static int32_t items[ DEGENERATE_ORDER_LENGTH ];
+    size_t i;
+
+    /* Sorted, reverse sorted, organ pipe and all-equal orders. */
+    for( i = 0U; i < DEGENERATE_ORDER_LENGTH; i++ )
+    {
+        items[ i ] = ( int32_t ) i;
+    }
+
+    sortDegenerateOrderAndVerify( items );
+
+    for( i = 0U; i < DEGENERATE_ORDER_LENGTH; i++ )
+    {
+        items[ i ] = ( int32_t ) ( DEGENERATE_ORDER_LENGTH - i );
+    }
+
+    sortDegenerateOrderAndVerify( items );
+
+    for( i = 0U; i < DEGENERATE_ORDER_LENGTH; i++ )
+    {
+        items[ i ] = ( int32_t ) ( ( i < ( DEGENERATE_ORDER_LENGTH / 2U ) ) ? i : ( DEGENERATE_ORDER_LENGTH - i ) );
+    }
+
+    sortDegenerateOrderAndVerify( items );
+
+    for( i = 0U; i < DEGENERATE_ORDER_LENGTH; i++ )
+    {
+        items[ i ] = 7;
+    }
+
+    sortDegenerateOrderAndVerify( items );
+}
@@ -0,0 +1,441 @@
+/*
+ * SigV4 Library v1.3.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sigv4_benchmark.c
+ * @brief Measures the signing pipeline on each available crypto adapter.
+ *
+ * For every adapter, the benchmark signs a typical request, signs it again
+ * with the built-in HMAC if the adapter has a native one, and hashes a large
+ * payload. It checks that all adapters produce the same signature and prints
+ * the time per signature and the payload hashing throughput.
+ *
+ * Usage: sigv4_benchmark [iterations]
+ */
+
+/* clock_gettime() is a POSIX interface. */
+#define _POSIX_C_SOURCE    199309L
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sigv4.h"
+#include "sigv4_crypto_sha256.h"
+
+#ifdef SIGV4_BENCHMARK_OPENSSL
+    #include "sigv4_crypto_openssl.h"
+#endif
+
+#ifdef SIGV4_BENCHMARK_MBEDTLS
+    #include "sigv4_crypto_mbedtls.h"
+#endif
+
+/**
+ * @brief The number of signatures per measurement if none is given.
+ */
+#define DEFAULT_ITERATIONS       20000UL
+
+/**
+ * @brief The length of the payload hashed to measure throughput.
+ */
+#define PAYLOAD_LENGTH           ( 1024UL * 1024UL )
+
+/**
+ * @brief The number of times the payload is hashed per measurement.
+ */
+#define PAYLOAD_ITERATIONS       16UL
+
+/**
+ * @brief The length of the buffer for the Authorization header value.
+ */
+#define AUTH_BUFFER_LENGTH       512U
+
+/**
+ * @brief The headers of the signed request.
+ */
+#define REQUEST_HEADERS                                          \
+    "Host: iam.amazonaws.com\r\n"                                \
+    "Content-Type: application/x-www-form-urlencoded; charset=utf-8\r\n" \
+    "X-Amz-Date: 20150830T123600Z\r\n\r\n"
+
+/**
+ * @brief The query of the signed request.
+ */
+#define REQUEST_QUERY            "Action=ListUsers&Version=2010-05-08"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The state of one crypto adapter.
+ */
+typedef union BenchmarkContext
+{
+    SigV4Sha256Context_t sha256;   /**< @brief The portable adapter. */
+    #ifdef SIGV4_BENCHMARK_OPENSSL
+        SigV4OpenSSLContext_t openssl; /**< @brief The OpenSSL adapter. */
+    #endif
+    #ifdef SIGV4_BENCHMARK_MBEDTLS
+        SigV4MbedTLSContext_t mbedtls; /**< @brief The mbedTLS adapter. */
+    #endif
+} BenchmarkContext_t;
+
+/**
+ * @brief A crypto adapter to measure.
+ */
+typedef struct BenchmarkBackend
+{
+    const char * pName;                                         /**< @brief The name printed in the results. */
+    SigV4Status_t ( * init )( SigV4CryptoInterface_t * pCryptoInterface,
+                              BenchmarkContext_t * pContext );  /**< @brief Fills the crypto interface. */
+    void ( * cleanup )( BenchmarkContext_t * pContext );        /**< @brief Releases the adapter, or NULL. */
+} BenchmarkBackend_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialize the portable adapter.
+ */
+static SigV4Status_t initSha256( SigV4CryptoInterface_t * pCryptoInterface,
+                                 BenchmarkContext_t * pContext )
+{
+    return SigV4_Sha256CryptoInit( pCryptoInterface, &pContext->sha256 );
+}
+
+#ifdef SIGV4_BENCHMARK_OPENSSL
+
+/**
+ * @brief Initialize the OpenSSL adapter.
+ */
+    static SigV4Status_t initOpenSSL( SigV4CryptoInterface_t * pCryptoInterface,
+                                      BenchmarkContext_t * pContext )
+    {
+        return SigV4_OpenSSLCryptoInit( pCryptoInterface, &pContext->openssl );
+    }
+
+/**
+ * @brief Release the OpenSSL adapter.
+ */
+    static void cleanupOpenSSL( BenchmarkContext_t * pContext )
+    {
+        SigV4_OpenSSLCryptoCleanup( &pContext->openssl );
+    }
+
+#endif /* ifdef SIGV4_BENCHMARK_OPENSSL */
+
+#ifdef SIGV4_BENCHMARK_MBEDTLS
+
+/**
+ * @brief Initialize the mbedTLS adapter.
+ */
+    static SigV4Status_t initMbedTLS( SigV4CryptoInterface_t * pCryptoInterface,
+                                      BenchmarkContext_t * pContext )
+    {
+        return SigV4_MbedTLSCryptoInit( pCryptoInterface, &pContext->mbedtls );
+    }
+
+/**
+ * @brief Release the mbedTLS adapter.
+ */
+    static void cleanupMbedTLS( BenchmarkContext_t * pContext )
+    {
+        SigV4_MbedTLSCryptoCleanup( &pContext->mbedtls );
+    }
+
+#endif /* ifdef SIGV4_BENCHMARK_MBEDTLS */
+
+/**
+ * @brief The crypto adapters to measure. The first one is the reference for
+ * the signature.
+ */
+static const BenchmarkBackend_t backends[] =
+{
+    { "sha256 (portable)", initSha256,  NULL           },
+    #ifdef SIGV4_BENCHMARK_OPENSSL
+        { "openssl",           initOpenSSL, cleanupOpenSSL },
+    #endif
+    #ifdef SIGV4_BENCHMARK_MBEDTLS
+        { "mbedtls",           initMbedTLS, cleanupMbedTLS },
+    #endif
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read a monotonic clock.
+ *
+ * @return The time in nanoseconds.
+ */
+static double nowNs( void )
+{
+    struct timespec now;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( ( double ) now.tv_sec * 1e9 ) + ( double ) now.tv_nsec;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Sign the benchmark request @p iterations times.
+ *
+ * @param[in] pCryptoInterface The crypto interface to sign with.
+ * @param[in] iterations The number of signatures.
+ * @param[out] pSignature The signature of the last iteration.
+ * @param[out] pNsPerSignature The average time per signature.
+ *
+ * @return The status of the last signature.
+ */
+static SigV4Status_t measureSigning( SigV4CryptoInterface_t * pCryptoInterface,
+                                     unsigned long iterations,
+                                     char * pSignature,
+                                     double * pNsPerSignature )
+{
+    SigV4Credentials_t credentials;
+    SigV4HttpParameters_t httpParams;
+    SigV4Parameters_t params;
+    char authBuf[ AUTH_BUFFER_LENGTH ];
+    size_t authBufLen = 0U, signatureLen = 0U;
+    char * pSignatureStart = NULL;
+    SigV4Status_t status = SigV4Success;
+    unsigned long i;
+    double start;
+
+    ( void ) memset( &credentials, 0, sizeof( credentials ) );
+    ( void ) memset( &httpParams, 0, sizeof( httpParams ) );
+    ( void ) memset( &params, 0, sizeof( params ) );
+
+    credentials.pAccessKeyId = "AKIDEXAMPLE";
+    credentials.accessKeyIdLen = strlen( credentials.pAccessKeyId );
+    credentials.pSecretAccessKey = "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY";
+    credentials.secretAccessKeyLen = strlen( credentials.pSecretAccessKey );
+
+    httpParams.pHttpMethod = "GET";
+    httpParams.httpMethodLen = 3U;
+    httpParams.pPath = "/";
+    httpParams.pathLen = 1U;
+    httpParams.pQuery = REQUEST_QUERY;
+    httpParams.queryLen = sizeof( REQUEST_QUERY ) - 1U;
+    httpParams.pHeaders = REQUEST_HEADERS;
+    httpParams.headersLen = sizeof( REQUEST_HEADERS ) - 1U;
+
+    params.pCredentials = &credentials;
+    params.pDateIso8601 = "20150830T123600Z";
+    params.pAlgorithm = SIGV4_AWS4_HMAC_SHA256;
+    params.algorithmLen = SIGV4_AWS4_HMAC_SHA256_LENGTH;
+    params.pRegion = "us-east-1";
+    params.regionLen = 9U;
+    params.pService = "iam";
+    params.serviceLen = 3U;
+    params.pCryptoInterface = pCryptoInterface;
+    params.pHttpParameters = &httpParams;
+
+    start = nowNs();
+
+    for( i = 0UL; ( i < iterations ) && ( status == SigV4Success ); i++ )
+    {
+        authBufLen = sizeof( authBuf );
+        status = SigV4_GenerateHTTPAuthorization( &params, authBuf, &authBufLen, &pSignatureStart, &signatureLen );
+    }
+
+    *pNsPerSignature = ( nowNs() - start ) / ( double ) iterations;
+
+    if( status == SigV4Success )
+    {
+        ( void ) memcpy( pSignature, pSignatureStart, signatureLen );
+        pSignature[ signatureLen ] = '\0';
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Hash a large payload several times.
+ *
+ * @param[in] pCryptoInterface The crypto interface to hash with.
+ * @param[in] pPayload The payload of #PAYLOAD_LENGTH bytes.
+ * @param[out] pMegabytesPerSecond The hashing throughput.
+ *
+ * @return The status of the last hash.
+ */
+static SigV4Status_t measureHashing( const SigV4CryptoInterface_t * pCryptoInterface,
+                                     const char * pPayload,
+                                     double * pMegabytesPerSecond )
+{
+    char hexDigest[ SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ];
+    size_t hexDigestLen = 0U;
+    SigV4Status_t status = SigV4Success;
+    unsigned long i;
+    double start;
+
+    start = nowNs();
+
+    for( i = 0UL; ( i < PAYLOAD_ITERATIONS ) && ( status == SigV4Success ); i++ )
+    {
+        hexDigestLen = sizeof( hexDigest );
+        status = SigV4_HashPayload( pCryptoInterface, pPayload, PAYLOAD_LENGTH, hexDigest, &hexDigestLen );
+    }
+
+    *pMegabytesPerSecond = ( ( double ) ( PAYLOAD_LENGTH * PAYLOAD_ITERATIONS ) / ( 1024.0 * 1024.0 ) ) /
+                           ( ( nowNs() - start ) / 1e9 );
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Print one row of results and check its signature against the
+ * reference.
+ *
+ * @return 0 if the signature matches, 1 otherwise.
+ */
+static int reportRow( const char * pName,
+                      const char * pVariant,
+                      double nsPerSignature,
+                      double megabytesPerSecond,
+                      const char * pSignature,
+                      char * pReferenceSignature )
+{
+    int mismatch = 0;
+
+    if( pReferenceSignature[ 0 ] == '\0' )
+    {
+        ( void ) strcpy( pReferenceSignature, pSignature );
+    }
+    else if( strcmp( pReferenceSignature, pSignature ) != 0 )
+    {
+        mismatch = 1;
+    }
+    else
+    {
+        /* Empty else. */
+    }
+
+    if( megabytesPerSecond > 0.0 )
+    {
+        ( void ) printf( "%-20s %-14s %12.0f %12.1f%s\n", pName, pVariant, nsPerSignature,
+                         megabytesPerSecond, ( mismatch != 0 ) ? "  SIGNATURE MISMATCH" : "" );
+    }
+    else
+    {
+        ( void ) printf( "%-20s %-14s %12.0f %12s%s\n", pName, pVariant, nsPerSignature,
+                         "-", ( mismatch != 0 ) ? "  SIGNATURE MISMATCH" : "" );
+    }
+
+    return mismatch;
+}
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    SigV4CryptoInterface_t cryptoInterface;
+    BenchmarkContext_t context;
+    char signature[ ( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ) + 1U ];
+    char referenceSignature[ ( SIGV4_HASH_MAX_DIGEST_LENGTH * 2U ) + 1U ] = { 0 };
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    double nsPerSignature = 0.0, megabytesPerSecond = 0.0;
+    char * pPayload = NULL;
+    size_t i;
+    int failures = 0;
+
+    if( argc > 1 )
+    {
+        iterations = strtoul( argv[ 1 ], NULL, 10 );
+    }
+
+    pPayload = malloc( PAYLOAD_LENGTH );
+
+    if( ( iterations == 0UL ) || ( pPayload == NULL ) )
+    {
+        ( void ) fprintf( stderr, "usage: %s [iterations]\n", argv[ 0 ] );
+        failures = 1;
+    }
+    else
+    {
+        ( void ) memset( pPayload, 'a', PAYLOAD_LENGTH );
+        ( void ) printf( "%lu signatures per measurement, %lu x %lu byte payload\n\n",
+                         iterations, PAYLOAD_ITERATIONS, PAYLOAD_LENGTH );
+        ( void ) printf( "%-20s %-14s %12s %12s\n", "backend", "hmac", "ns/signature", "hash MB/s" );
+    }
+
+    for( i = 0U; ( failures == 0 ) && ( i < ( sizeof( backends ) / sizeof( backends[ 0 ] ) ) ); i++ )
+    {
+        if( backends[ i ].init( &cryptoInterface, &context ) != SigV4Success )
+        {
+            ( void ) printf( "%-20s failed to initialize\n", backends[ i ].pName );
+            failures++;
+        }
+        else
+        {
+            if( ( measureSigning( &cryptoInterface, iterations, signature, &nsPerSignature ) != SigV4Success ) ||
+                ( measureHashing( &cryptoInterface, pPayload, &megabytesPerSecond ) != SigV4Success ) )
+            {
+                ( void ) printf( "%-20s failed to sign\n", backends[ i ].pName );
+                failures++;
+            }
+            else
+            {
+                failures += reportRow( backends[ i ].pName,
+                                       ( cryptoInterface.hmacInit != NULL ) ? "native" : "built-in",
+                                       nsPerSignature, megabytesPerSecond, signature, referenceSignature );
+            }
+
+            /* Measure the built-in HMAC on the same hash functions too. */
+            if( ( failures == 0 ) && ( cryptoInterface.hmacInit != NULL ) )
+            {
+                cryptoInterface.hmacInit = NULL;
+                cryptoInterface.hmacUpdate = NULL;
+                cryptoInterface.hmacFinal = NULL;
+
+                if( measureSigning( &cryptoInterface, iterations, signature, &nsPerSignature ) != SigV4Success )
+                {
+                    ( void ) printf( "%-20s failed to sign\n", backends[ i ].pName );
+                    failures++;
+                }
+                else
+                {
+                    failures += reportRow( backends[ i ].pName, "built-in", nsPerSignature, 0.0,
+                                           signature, referenceSignature );
+                }
+            }
+
+            if( backends[ i ].cleanup != NULL )
+            {
+                backends[ i ].cleanup( &context );
+            }
+        }
+    }
+
+    free( pPayload );
+
+    return ( failures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -55,6 +55,37 @@ function(create_test test_name
             )
 endfunction()
 
+#function to create a test executable for the C++ interface; the test
+#defines its own main() running its tests through Unity
+function(create_cpp_test test_name
+                         test_src
+                         link_list
+                         include_list)
+    include (CTest)
+    add_executable(${test_name} ${test_src})
+    set_target_properties(${test_name} PROPERTIES
+            CXX_STANDARD 17
+            CXX_STANDARD_REQUIRED ON
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/bin/tests"
+        )
+    target_include_directories(${test_name} PUBLIC
+                               ${include_list}
+        )
+    target_link_directories(${test_name} PUBLIC
+                            ${CMAKE_CURRENT_BINARY_DIR}/lib
+        )
+
+    # link all libraries sent through parameters
+    foreach(link IN LISTS link_list)
+        target_link_libraries(${test_name} ${link})
+    endforeach()
+    target_link_libraries(${test_name} -lgcov unity)
+    add_test(NAME ${test_name}
+             COMMAND ${CMAKE_BINARY_DIR}/bin/tests/${test_name}
+             WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+            )
+endfunction()
+
 # Run the C preprocessor on target files.
 # Takes a CMAKE list of arguments to pass to the C compiler
 function(preprocess_mock_list mock_name file_list compiler_args)